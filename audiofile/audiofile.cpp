@@ -67,6 +67,22 @@ bool AudioFile::open(const QByteArray& b)
       return sf != 0;
       }
 
+//---------------------------------------------------------
+//   open
+//    read the audio data from the file on demand
+//---------------------------------------------------------
+
+bool AudioFile::open(const QString& path)
+      {
+      file.setFileName(path);
+      if (!file.open(QIODevice::ReadOnly))
+            return false;
+      sf  = sf_open_virtual(&sfio, SFM_READ, &info, this);
+      hasInstrument = sf_command(sf, SFC_GET_INSTRUMENT, &inst, sizeof(inst)) == SF_TRUE;
+      _type = info.format & SF_FORMAT_OGG ? fltp : s16p;
+      return sf != 0;
+      }
+
 //---------------------------------------------------------
 //   readData
 //---------------------------------------------------------
@@ -108,6 +124,18 @@ sf_count_t AudioFile::readData(short* data, sf_count_t frames)
 
 sf_count_t AudioFile::seek(sf_count_t offset, int whence)
       {
+      if (file.isOpen()) {
+            switch(whence) {
+                  case SEEK_CUR:
+                        offset += file.pos();
+                        break;
+                  case SEEK_END:
+                        offset += file.size();
+                        break;
+                  }
+            file.seek(offset);
+            return file.pos();
+            }
       switch(whence) {
             case SEEK_SET:
                   idx = offset;
@@ -128,6 +156,8 @@ sf_count_t AudioFile::seek(sf_count_t offset, int whence)
 
 sf_count_t AudioFile::read(void* ptr, sf_count_t count)
       {
+      if (file.isOpen())
+            return qMax(sf_count_t(0), sf_count_t(file.read((char*)ptr, count)));
       count = qMin(count, (sf_count_t)(buf.size() - idx));
       memcpy(ptr, buf.data() + idx, count);
       idx += count;
@@ -30,6 +30,7 @@ class AudioFile {
       SF_INSTRUMENT inst;
       bool hasInstrument;
       QByteArray buf;  // used during read of Sample
+      QFile file;      // read from file instead of buf if open
       int idx;
       FormatType _type;
 
@@ -38,6 +39,8 @@ class AudioFile {
       ~AudioFile();
 
       bool open(const QByteArray&);
+      bool open(const QString& path);
+      bool seekFrame(sf_count_t frame) { return sf_seek(sf, frame, SEEK_SET) == frame; }
       const char* error() const     { return sf_strerror(sf); }
       sf_count_t readData(short* data, sf_count_t frames);
 
@@ -45,8 +48,8 @@ class AudioFile {
       sf_count_t frames() const     { return info.frames; }
       int samplerate() const { return info.samplerate; }
 
-      sf_count_t getFileLen() const { return buf.size(); }
-      sf_count_t tell() const       { return idx; }
+      sf_count_t getFileLen() const { return file.isOpen() ? file.size() : buf.size(); }
+      sf_count_t tell() const       { return file.isOpen() ? file.pos() : idx; }
       sf_count_t read(void* ptr, sf_count_t count);
       sf_count_t write(const void* ptr, sf_count_t count);
       sf_count_t seek(sf_count_t offset, int whence);
@@ -74,10 +74,10 @@ static inline float f_max(float x, float a)
 //   round_to_zero
 //---------------------------------------------------------
 
-static inline void round_to_zero(volatile float *f)
+static inline void round_to_zero(float& f)
       {
-      *f += 1e-18f;
-      *f -= 1e-18f;
+      f += 1e-18f;
+      f -= 1e-18f;
       }
 
 // Linearly interpolate [ = a * (1 - f) + b * f]
@@ -220,41 +220,70 @@ void Compressor::process(int frames, float* ip, float *op)
       const float ef_a     = ga * 0.25f;
       const float ef_ai    = 1.0f - ef_a;
 
-      for (int pos = 0; pos < frames; pos++) {
-            const float la = fabs(ip[pos * 2]);
-            const float ra = fabs(ip[pos * 2 + 1]);
-            const float lev_in = f_max(la, ra);
-
-            sum += lev_in * lev_in;
-            if (amp > env_rms)
-                  env_rms = env_rms * ga + amp * (1.0f - ga);
-            else
-                  env_rms = env_rms * gr + amp * (1.0f - gr);
-            round_to_zero(&env_rms);
-            if (lev_in > env_peak)
-                  env_peak = env_peak * ga + lev_in * (1.0f - ga);
-            else
-                  env_peak = env_peak * gr + lev_in * (1.0f - gr);
-            round_to_zero(&env_peak);
-            if ((count++ & 3) == 3) {
-                  amp = rms.process(sum * 0.25f);
-                  sum = 0.0f;
-                  if (qIsNaN(env_rms))     // This can happen sometimes, but I don't know why
-                        env_rms = 0.0f;
-                  env = LIN_INTERP(rms_peak, env_rms, env_peak);
-                  if (env <= knee_min)
-                        gain_t = 1.0f;
-                  else if (env < knee_max) {
-                        const float x = -(_threshold - _knee - lin2db(env)) / _knee;
-                        gain_t = db2lin(-_knee * rs * x * x * 0.25f);
-                        }
+      //
+      // the envelope follower is serial, level detection and
+      // the gain are separate passes over a block of frames
+      // the compiler can vectorize
+      //
+      static const int BLOCK = 256;
+      float level[BLOCK];
+      float g[BLOCK];
+
+      float e_rms  = env_rms;
+      float e_peak = env_peak;
+      float s      = sum;
+      float gn     = gain;
+
+      for (int frame = 0; frame < frames; frame += BLOCK) {
+            const int n     = qMin(BLOCK, frames - frame);
+            const float* in = ip + frame * 2;
+            float* o        = op + frame * 2;
+
+            for (int pos = 0; pos < n; pos++)
+                  level[pos] = f_max(fabsf(in[pos * 2]), fabsf(in[pos * 2 + 1]));
+
+            for (int pos = 0; pos < n; pos++) {
+                  const float lev_in = level[pos];
+
+                  s += lev_in * lev_in;
+                  if (amp > e_rms)
+                        e_rms = e_rms * ga + amp * (1.0f - ga);
+                  else
+                        e_rms = e_rms * gr + amp * (1.0f - gr);
+                  round_to_zero(e_rms);
+                  if (lev_in > e_peak)
+                        e_peak = e_peak * ga + lev_in * (1.0f - ga);
                   else
-                        gain_t = db2lin((_threshold - lin2db(env)) * rs);
+                        e_peak = e_peak * gr + lev_in * (1.0f - gr);
+                  round_to_zero(e_peak);
+                  if ((count++ & 3) == 3) {
+                        amp = rms.process(s * 0.25f);
+                        s = 0.0f;
+                        if (qIsNaN(e_rms))     // This can happen sometimes, but I don't know why
+                              e_rms = 0.0f;
+                        env = LIN_INTERP(rms_peak, e_rms, e_peak);
+                        if (env <= knee_min)
+                              gain_t = 1.0f;
+                        else if (env < knee_max) {
+                              const float x = -(_threshold - _knee - lin2db(env)) / _knee;
+                              gain_t = db2lin(-_knee * rs * x * x * 0.25f);
+                              }
+                        else
+                              gain_t = db2lin((_threshold - lin2db(env)) * rs);
+                        }
+                  gn = gn * ef_a + gain_t * ef_ai;
+                  g[pos] = gn;
+                  }
+
+            for (int pos = 0; pos < n; pos++) {
+                  o[pos * 2]     = in[pos * 2] * g[pos] * mug;
+                  o[pos * 2 + 1] = in[pos * 2 + 1] * g[pos] * mug;
                   }
-            gain          = gain * ef_a + gain_t * ef_ai;
-            op[pos * 2]   = ip[pos * 2] * gain * mug;
-            op[pos * 2+1] = ip[pos * 2 + 1] * gain * mug;
             }
+      env_rms  = e_rms;
+      env_peak = e_peak;
+      sum      = s;
+      gain     = gn;
 
 //      printf("gain %f\n", gain);
 
@@ -19,6 +19,11 @@
 #include <math.h>
 #include "zita.h"
 
+#if defined(__SSE2__) || defined(_M_X64)
+#define ZITA_SSE
+#include <emmintrin.h>
+#endif
+
 namespace Ms {
 
 enum {
@@ -162,54 +167,45 @@ void Pareq::calcpar1(int nsamp, float g, float f)
 
 void Pareq::process1(int nsamp, float* data)
       {
-      int nchan = 2;
+      // both channels in one pass, they are independent
       float c1 = _c1;
       float c2 = _c2;
       float gg = _gg;
-
-      if (_state == SMOOTH) {
-            for (int i = 0; i < nchan; i++) {
-                  float z1 = _z1 [i];
-                  float z2 = _z2 [i];
-                  c1       = _c1;
-                  c2       = _c2;
-                  gg = _gg;
-                  for (int j = 0; j < nsamp; j++) {
-                        c1 += _dc1;
-                        c2 += _dc2;
-                        gg += _dgg;
-                        float* p = data + j * 2 + i;
-                        float x = *p;
-                        float y = x - c2 * z2;
-                        *p = x - gg * (z2 + c2 * y - x);
-                        y -= c1 * z1;
-                        z2 = z1 + c1 * y;
-                        z1 = y + 1e-20f;
-                        }
-                  _z1 [i] = z1;
-                  _z2 [i] = z2;
+      float z1l = _z1 [0];
+      float z2l = _z2 [0];
+      float z1r = _z1 [1];
+      float z2r = _z2 [1];
+      const bool smooth = _state == SMOOTH;
+
+      for (int j = 0; j < nsamp; j++) {
+            if (smooth) {
+                  c1 += _dc1;
+                  c2 += _dc2;
+                  gg += _dgg;
                   }
+            float* p = data + j * 2;
+            float xl = p[0];
+            float xr = p[1];
+            float yl = xl - c2 * z2l;
+            float yr = xr - c2 * z2r;
+            p[0] = xl - gg * (z2l + c2 * yl - xl);
+            p[1] = xr - gg * (z2r + c2 * yr - xr);
+            yl -= c1 * z1l;
+            yr -= c1 * z1r;
+            z2l = z1l + c1 * yl;
+            z2r = z1r + c1 * yr;
+            z1l = yl + 1e-20f;
+            z1r = yr + 1e-20f;
+            }
+      _z1 [0] = z1l;
+      _z2 [0] = z2l;
+      _z1 [1] = z1r;
+      _z2 [1] = z2r;
+      if (smooth) {
             _c1 = c1;
             _c2 = c2;
             _gg = gg;
             }
-      else {
-            for (int i = 0; i < nchan; i++) {
-                  float z1 = _z1 [i];
-                  float z2 = _z2 [i];
-                  for (int j = 0; j < nsamp; j++) {
-                        float* p = data + j * 2 + i;
-                        float x = *p;
-                        float y = x - c2 * z2;
-                        *p = x - gg * (z2 + c2 * y - x);
-                        y -= c1 * z1;
-                        z2 = z1 + c1 * y;
-                        z1 = y + 1e-20f;
-                        }
-                  _z1 [i] = z1;
-                  _z2 [i] = z2;
-                  }
-            }
       }
 
 Diff1::~Diff1()
@@ -417,16 +413,254 @@ void ZitaReverb::prepare (int nfram)
       _pareq2.prepare (nfram);
       }
 
+#ifdef ZITA_SSE
+static const int LINE_BLOCK = 64;      // frames processed by processLines() at once
+
 //---------------------------------------------------------
-//   process
+//   readLine
+//    copy n values starting at idx from a circular line
+//    into every 8th value of dst
 //---------------------------------------------------------
 
-void ZitaReverb::process (int nfram, float* inp, float* out)
+static void readLine(const float* line, int size, int idx, int n, float* dst)
+      {
+      int k = qMin(n, size - idx);
+      for (int i = 0; i < k; ++i)
+            dst[i * 8] = line[idx + i];
+      for (int i = k; i < n; ++i)
+            dst[i * 8] = line[i - k];
+      }
+
+//---------------------------------------------------------
+//   writeLine
+//    reverse of readLine, return the new index
+//---------------------------------------------------------
+
+static int writeLine(float* line, int size, int idx, int n, const float* src)
+      {
+      int k = qMin(n, size - idx);
+      for (int i = 0; i < k; ++i)
+            line[idx + i] = src[i * 8];
+      for (int i = k; i < n; ++i)
+            line[i - k] = src[i * 8];
+      return k < n ? n - k : (idx + n == size ? 0 : idx + n);
+      }
+
+//---------------------------------------------------------
+//   processLines
+//    Vector version of the inner loop of process(), with
+//    the eight delay lines in the lanes of a (0-3) and b
+//    (4-7). Every lane does the operations of the scalar
+//    code in the same order, so the output is the same.
+//    A line is read one sample before the same position
+//    is written, so as long as a block is not longer than
+//    the shortest line, all values read in the block are
+//    known before it starts: they are copied out of the
+//    lines first, and the values written are copied back
+//    afterwards.
+//---------------------------------------------------------
+
+void ZitaReverb::processLines(int n, const float* inp, float* out)
+      {
+      alignas(16) float v[8];
+      alignas(16) float dl[LINE_BLOCK * 8];     // Delay output, then input
+      alignas(16) float zl[LINE_BLOCK * 8];     // Diff1 output, then input
+
+      int block = LINE_BLOCK;
+      for (int j = 0; j < 8; ++j)
+            block = qMin(block, qMin(_diff1[j]._size, _delay[j]._size));
+
+      for (int j = 0; j < 8; ++j)
+            v[j] = _diff1[j]._c;
+      const __m128 ca = _mm_load_ps(v);
+      const __m128 cb = _mm_load_ps(v + 4);
+      for (int j = 0; j < 8; ++j)
+            v[j] = _filt1[j]._gmf;
+      const __m128 gmfa = _mm_load_ps(v);
+      const __m128 gmfb = _mm_load_ps(v + 4);
+      for (int j = 0; j < 8; ++j)
+            v[j] = _filt1[j]._glo;
+      const __m128 gloa = _mm_load_ps(v);
+      const __m128 glob = _mm_load_ps(v + 4);
+      for (int j = 0; j < 8; ++j)
+            v[j] = _filt1[j]._wlo;
+      const __m128 wloa = _mm_load_ps(v);
+      const __m128 wlob = _mm_load_ps(v + 4);
+      for (int j = 0; j < 8; ++j)
+            v[j] = _filt1[j]._whi;
+      const __m128 whia = _mm_load_ps(v);
+      const __m128 whib = _mm_load_ps(v + 4);
+      for (int j = 0; j < 8; ++j)
+            v[j] = _filt1[j]._slo;
+      __m128 sloa = _mm_load_ps(v);
+      __m128 slob = _mm_load_ps(v + 4);
+      for (int j = 0; j < 8; ++j)
+            v[j] = _filt1[j]._shi;
+      __m128 shia = _mm_load_ps(v);
+      __m128 shib = _mm_load_ps(v + 4);
+
+      const __m128 g      = _mm_set1_ps(sqrtf(0.125f));
+      const __m128 denorm = _mm_set1_ps(1e-10f);
+      // xor masks changing the sign of some lanes, x + (-y) is x - y
+      const __m128 neg13  = _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f);
+      const __m128 neg23  = _mm_setr_ps(0.0f, 0.0f, -0.0f, -0.0f);
+
+      while (n) {
+            int m = qMin(n, block);
+            for (int j = 0; j < 8; ++j) {
+                  readLine(_delay[j]._line, _delay[j]._size, _delay[j]._i, m, dl + j);
+                  readLine(_diff1[j]._line, _diff1[j]._size, _diff1[j]._i, m, zl + j);
+                  }
+            for (int f = 0; f < m; ++f) {
+                  _vdelay0.write(inp[0]);
+                  _vdelay1.write(inp[1]);
+                  float t0 = 0.3f * _vdelay0.read();
+                  float t1 = 0.3f * _vdelay1.read();
+                  float* d = dl + f * 8;
+                  float* z = zl + f * 8;
+
+                  __m128 xa = _mm_add_ps(_mm_load_ps(d), _mm_xor_ps(_mm_set1_ps(t0), neg23));
+                  __m128 xb = _mm_add_ps(_mm_load_ps(d + 4), _mm_xor_ps(_mm_set1_ps(t1), neg23));
+
+                  // Diff1
+                  __m128 za = _mm_load_ps(z);
+                  __m128 zb = _mm_load_ps(z + 4);
+                  xa = _mm_sub_ps(xa, _mm_mul_ps(ca, za));
+                  xb = _mm_sub_ps(xb, _mm_mul_ps(cb, zb));
+                  _mm_store_ps(z, xa);
+                  _mm_store_ps(z + 4, xb);
+                  xa = _mm_add_ps(za, _mm_mul_ps(ca, xa));
+                  xb = _mm_add_ps(zb, _mm_mul_ps(cb, xb));
+
+                  // mix the lines
+                  xa = _mm_add_ps(_mm_shuffle_ps(xa, xa, _MM_SHUFFLE(2, 3, 0, 1)), _mm_xor_ps(xa, neg13));
+                  xb = _mm_add_ps(_mm_shuffle_ps(xb, xb, _MM_SHUFFLE(2, 3, 0, 1)), _mm_xor_ps(xb, neg13));
+                  xa = _mm_add_ps(_mm_shuffle_ps(xa, xa, _MM_SHUFFLE(1, 0, 3, 2)), _mm_xor_ps(xa, neg23));
+                  xb = _mm_add_ps(_mm_shuffle_ps(xb, xb, _MM_SHUFFLE(1, 0, 3, 2)), _mm_xor_ps(xb, neg23));
+                  __m128 ya = _mm_add_ps(xa, xb);
+                  xb = _mm_sub_ps(xa, xb);
+                  xa = ya;
+
+                  _mm_store_ps(v, xa);
+                  _g1 += _d1;
+                  out[0] = _g1 * (v[1] + v[2]);
+                  out[1] = _g1 * (v[1] - v[2]);
+
+                  // Filt1
+                  xa   = _mm_mul_ps(g, xa);
+                  xb   = _mm_mul_ps(g, xb);
+                  sloa = _mm_add_ps(sloa, _mm_add_ps(_mm_mul_ps(wloa, _mm_sub_ps(xa, sloa)), denorm));
+                  slob = _mm_add_ps(slob, _mm_add_ps(_mm_mul_ps(wlob, _mm_sub_ps(xb, slob)), denorm));
+                  xa   = _mm_add_ps(xa, _mm_mul_ps(gloa, sloa));
+                  xb   = _mm_add_ps(xb, _mm_mul_ps(glob, slob));
+                  shia = _mm_add_ps(shia, _mm_mul_ps(whia, _mm_sub_ps(xa, shia)));
+                  shib = _mm_add_ps(shib, _mm_mul_ps(whib, _mm_sub_ps(xb, shib)));
+                  _mm_store_ps(d, _mm_mul_ps(gmfa, shia));
+                  _mm_store_ps(d + 4, _mm_mul_ps(gmfb, shib));
+
+                  inp += 2;
+                  out += 2;
+                  }
+            for (int j = 0; j < 8; ++j) {
+                  _delay[j]._i = writeLine(_delay[j]._line, _delay[j]._size, _delay[j]._i, m, dl + j);
+                  _diff1[j]._i = writeLine(_diff1[j]._line, _diff1[j]._size, _diff1[j]._i, m, zl + j);
+                  }
+            n -= m;
+            }
+
+      _mm_store_ps(v, sloa);
+      _mm_store_ps(v + 4, slob);
+      for (int j = 0; j < 8; ++j)
+            _filt1[j]._slo = v[j];
+      _mm_store_ps(v, shia);
+      _mm_store_ps(v + 4, shib);
+      for (int j = 0; j < 8; ++j)
+            _filt1[j]._shi = v[j];
+      }
+#endif
+
+//---------------------------------------------------------
+//   processScalar
+//    the inner loop of process(), one line after the other
+//---------------------------------------------------------
+
+void ZitaReverb::processScalar(int n, const float* inp, float* out)
       {
       float t, g, x0, x1, x2, x3, x4, x5, x6, x7;
       g = sqrtf (0.125f);
 
+      const float* p0 = inp;
+      const float* p1 = inp + 1;
+      float* q0 = out;
+      float* q1 = out + 1;
+
+      for (int i = 0; i < n * 2; i += 2) {
+            _vdelay0.write (p0 [i]);
+            _vdelay1.write (p1 [i]);
+
+            t = 0.3f * _vdelay0.read ();
+            x0 = _diff1 [0].process (_delay [0].read () + t);
+            x1 = _diff1 [1].process (_delay [1].read () + t);
+            x2 = _diff1 [2].process (_delay [2].read () - t);
+            x3 = _diff1 [3].process (_delay [3].read () - t);
+            t = 0.3f * _vdelay1.read ();
+            x4 = _diff1 [4].process (_delay [4].read () + t);
+            x5 = _diff1 [5].process (_delay [5].read () + t);
+            x6 = _diff1 [6].process (_delay [6].read () - t);
+            x7 = _diff1 [7].process (_delay [7].read () - t);
+
+            t = x0 - x1; x0 += x1;  x1 = t;
+            t = x2 - x3; x2 += x3;  x3 = t;
+            t = x4 - x5; x4 += x5;  x5 = t;
+            t = x6 - x7; x6 += x7;  x7 = t;
+            t = x0 - x2; x0 += x2;  x2 = t;
+            t = x1 - x3; x1 += x3;  x3 = t;
+            t = x4 - x6; x4 += x6;  x6 = t;
+            t = x5 - x7; x5 += x7;  x7 = t;
+            t = x0 - x4; x0 += x4;  x4 = t;
+            t = x1 - x5; x1 += x5;  x5 = t;
+            t = x2 - x6; x2 += x6;  x6 = t;
+            t = x3 - x7; x3 += x7;  x7 = t;
+
+            _g1 += _d1;
+
+            q0 [i] = _g1 * (x1 + x2);
+            q1 [i] = _g1 * (x1 - x2);
+
+            _delay [0].write (_filt1 [0].process (g * x0));
+            _delay [1].write (_filt1 [1].process (g * x1));
+            _delay [2].write (_filt1 [2].process (g * x2));
+            _delay [3].write (_filt1 [3].process (g * x3));
+            _delay [4].write (_filt1 [4].process (g * x4));
+            _delay [5].write (_filt1 [5].process (g * x5));
+            _delay [6].write (_filt1 [6].process (g * x6));
+            _delay [7].write (_filt1 [7].process (g * x7));
+            }
+      }
 
+//---------------------------------------------------------
+//   setVectorized
+//    use processLines() if val is set, return false if it
+//    is not available
+//---------------------------------------------------------
+
+bool ZitaReverb::setVectorized(bool val)
+      {
+#ifdef ZITA_SSE
+      _vectorized = val;
+      return true;
+#else
+      _vectorized = false;
+      return !val;
+#endif
+      }
+
+//---------------------------------------------------------
+//   process
+//---------------------------------------------------------
+
+void ZitaReverb::process (int nfram, float* inp, float* out)
+      {
       while (nfram) {
             if (!_nsamp) {
                   prepare(_fragm);
@@ -435,53 +669,12 @@ void ZitaReverb::process (int nfram, float* inp, float* out)
 
             int k = _nsamp < nfram ? _nsamp : nfram;
 
-            float* p0 = inp;
-            float* p1 = inp + 1;
-            float* q0 = out;
-            float* q1 = out + 1;
-
-            for (int i = 0; i < k * 2; i += 2) {
-                  _vdelay0.write (p0 [i]);
-                  _vdelay1.write (p1 [i]);
-
-                  t = 0.3f * _vdelay0.read ();
-                  x0 = _diff1 [0].process (_delay [0].read () + t);
-                  x1 = _diff1 [1].process (_delay [1].read () + t);
-                  x2 = _diff1 [2].process (_delay [2].read () - t);
-                  x3 = _diff1 [3].process (_delay [3].read () - t);
-                  t = 0.3f * _vdelay1.read ();
-                  x4 = _diff1 [4].process (_delay [4].read () + t);
-                  x5 = _diff1 [5].process (_delay [5].read () + t);
-                  x6 = _diff1 [6].process (_delay [6].read () - t);
-                  x7 = _diff1 [7].process (_delay [7].read () - t);
-
-                  t = x0 - x1; x0 += x1;  x1 = t;
-                  t = x2 - x3; x2 += x3;  x3 = t;
-                  t = x4 - x5; x4 += x5;  x5 = t;
-                  t = x6 - x7; x6 += x7;  x7 = t;
-                  t = x0 - x2; x0 += x2;  x2 = t;
-                  t = x1 - x3; x1 += x3;  x3 = t;
-                  t = x4 - x6; x4 += x6;  x6 = t;
-                  t = x5 - x7; x5 += x7;  x7 = t;
-                  t = x0 - x4; x0 += x4;  x4 = t;
-                  t = x1 - x5; x1 += x5;  x5 = t;
-                  t = x2 - x6; x2 += x6;  x6 = t;
-                  t = x3 - x7; x3 += x7;  x7 = t;
-
-                  _g1 += _d1;
-
-                  q0 [i] = _g1 * (x1 + x2);
-                  q1 [i] = _g1 * (x1 - x2);
-
-                  _delay [0].write (_filt1 [0].process (g * x0));
-                  _delay [1].write (_filt1 [1].process (g * x1));
-                  _delay [2].write (_filt1 [2].process (g * x2));
-                  _delay [3].write (_filt1 [3].process (g * x3));
-                  _delay [4].write (_filt1 [4].process (g * x4));
-                  _delay [5].write (_filt1 [5].process (g * x5));
-                  _delay [6].write (_filt1 [6].process (g * x6));
-                  _delay [7].write (_filt1 [7].process (g * x7));
-                  }
+#ifdef ZITA_SSE
+            if (_vectorized)
+                  processLines(k, inp, out);
+            else
+#endif
+                  processScalar(k, inp, out);
             _pareq1.process (k, out);
             _pareq2.process (k, out);
 
@@ -235,8 +235,11 @@ class ZitaReverb : public Effect
 
       int _fragm;
       int _nsamp;
+      bool _vectorized { true };          // processLines() if built with SSE
 
       void prepare(int n);
+      void processLines(int n, const float* inp, float* out);
+      void processScalar(int n, const float* inp, float* out);
 
    public:
       ZitaReverb() : Effect() {}
@@ -246,6 +249,7 @@ class ZitaReverb : public Effect
       void fini();
 
       virtual void process(int n, float* inp, float* out);
+      bool setVectorized(bool);
 
       void set_delay(float v) { _ipdel = v; _cntA1++; }
       float delay() const     { return _ipdel; }
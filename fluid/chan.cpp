@@ -40,11 +40,12 @@ Channel::Channel(Fluid* s, int num)
 
 //---------------------------------------------------------
 //   reset
+//    without selectPreset the preset is left to the caller
 //---------------------------------------------------------
 
-void Channel::reset()
+void Channel::reset(bool selectPreset)
       {
-      init();
+      init(selectPreset);
       initCtrl();
       }
 
@@ -52,10 +53,11 @@ void Channel::reset()
 //   init
 //---------------------------------------------------------
 
-void Channel::init()
+void Channel::init(bool selectPreset)
       {
       sfontnum      = 0;
-      setPreset(synth->find_preset(banknum, prognum));
+      if (selectPreset)
+            setPreset(synth->find_preset(banknum, prognum));
       interp_method = FLUID_INTERP_DEFAULT;
       nrpn_select   = 0;
       }
@@ -222,6 +224,8 @@ void Channel::setPreset(Preset* p)
       if (_preset != p) {
             if (p)
                   p->loadSamples();
+            if (_preset)
+                  _preset->unloadSamples();
             _preset = p;
             }
       }
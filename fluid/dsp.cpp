@@ -21,6 +21,7 @@
 #include "fluid.h"
 #include "voice.h"
 #include "sfont.h"
+#include "dspkernels.h"
 
 namespace FluidS {
 
@@ -130,6 +131,7 @@ void Voice::dsp_float_config()
                   }
             }
       fluid_check_fpe("interpolation table calculation");
+      initDspKernels();
       }
 
 //-------------------------------------------------------------------
@@ -0,0 +1,136 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2018 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "dspkernels.h"
+
+//
+// the vector kernels are only built for x86-64, where the scalar
+// code uses SSE too and gives the same results
+//
+#if defined(__x86_64__) || defined(_M_X64)
+#define FLUID_X86_64
+#include <emmintrin.h>
+#endif
+
+namespace FluidS {
+
+//---------------------------------------------------------
+//   mix
+//---------------------------------------------------------
+
+static void mix(const float* buf, int n, float* out, float* reverb, float* chorus,
+   float ampLeft, float ampRight, float ampReverb, float ampChorus)
+      {
+      for (int i = 0; i < n; ++i) {
+            float v    = buf[i];
+
+            float vv   = v  * ampLeft;
+            *out++     += vv;
+            *reverb++  += vv * ampReverb;
+            *chorus++  += vv * ampChorus;
+
+            vv         = v  * ampRight;
+            *out++     += vv;
+            *reverb++  += vv * ampReverb;
+            *chorus++  += vv * ampChorus;
+            }
+      }
+
+static const DspKernels scalarKernels { mix };
+
+#ifdef FLUID_X86_64
+
+//---------------------------------------------------------
+//   mixSse2
+//    two frames at once
+//---------------------------------------------------------
+
+static void mixSse2(const float* buf, int n, float* out, float* reverb, float* chorus,
+   float ampLeft, float ampRight, float ampReverb, float ampChorus)
+      {
+      const __m128 pan = _mm_setr_ps(ampLeft, ampRight, ampLeft, ampRight);
+      const __m128 rev = _mm_set1_ps(ampReverb);
+      const __m128 cho = _mm_set1_ps(ampChorus);
+      int i = 0;
+      for (; i + 2 <= n; i += 2) {
+            __m128 vv = _mm_mul_ps(_mm_setr_ps(buf[i], buf[i], buf[i + 1], buf[i + 1]), pan);
+            _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), vv));
+            _mm_storeu_ps(reverb, _mm_add_ps(_mm_loadu_ps(reverb), _mm_mul_ps(vv, rev)));
+            _mm_storeu_ps(chorus, _mm_add_ps(_mm_loadu_ps(chorus), _mm_mul_ps(vv, cho)));
+            out    += 4;
+            reverb += 4;
+            chorus += 4;
+            }
+      mix(buf + i, n - i, out, reverb, chorus, ampLeft, ampRight, ampReverb, ampChorus);
+      }
+
+static const DspKernels sse2Kernels { mixSse2 };
+
+#endif // FLUID_X86_64
+
+std::atomic<const DspKernels*> currentDspKernels { &scalarKernels };
+
+//---------------------------------------------------------
+//   dspIsaSupported
+//---------------------------------------------------------
+
+bool dspIsaSupported(DspIsa isa)
+      {
+      switch (isa) {
+            case DspIsa::SCALAR:
+                  return true;
+#ifdef FLUID_X86_64
+            case DspIsa::SSE2:
+                  return true;            // part of x86-64
+#endif
+            default:
+                  return false;
+            }
+      }
+
+//---------------------------------------------------------
+//   setDspIsa
+//    return false if isa is not supported by the cpu
+//---------------------------------------------------------
+
+bool setDspIsa(DspIsa isa)
+      {
+      if (!dspIsaSupported(isa))
+            return false;
+      switch (isa) {
+            case DspIsa::SCALAR:
+                  currentDspKernels = &scalarKernels;
+                  break;
+#ifdef FLUID_X86_64
+            case DspIsa::SSE2:
+                  currentDspKernels = &sse2Kernels;
+                  break;
+#endif
+            default:
+                  break;
+            }
+      return true;
+      }
+
+//---------------------------------------------------------
+//   initDspKernels
+//    select the best kernels for this cpu
+//---------------------------------------------------------
+
+void initDspKernels()
+      {
+      if (!setDspIsa(DspIsa::SSE2))
+            setDspIsa(DspIsa::SCALAR);
+      }
+
+}     // namespace FluidS
+
@@ -0,0 +1,55 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2018 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __DSPKERNELS_H__
+#define __DSPKERNELS_H__
+
+#include <atomic>
+
+namespace FluidS {
+
+//---------------------------------------------------------
+//   DspIsa
+//    instruction sets the kernels are available for
+//---------------------------------------------------------
+
+enum class DspIsa : char {
+      SCALAR, SSE2
+      };
+
+typedef void (*MixKernel)(const float* buf, int n, float* out, float* reverb, float* chorus,
+   float ampLeft, float ampRight, float ampReverb, float ampChorus);
+
+//---------------------------------------------------------
+//   DspKernels
+//    The interpolation loops in dsp.cpp stay scalar: the
+//    serial phase and amplitude steps, which must not
+//    change for bit identical output, take as long as
+//    the arithmetic of a frame.
+//---------------------------------------------------------
+
+struct DspKernels {
+      MixKernel mix;                // gain, pan, reverb and chorus send of a voice
+      };
+
+// the kernels in use; synthesizers on several threads may
+// select them at the same time
+extern std::atomic<const DspKernels*> currentDspKernels;
+inline const DspKernels* dspKernels() { return currentDspKernels.load(std::memory_order_relaxed); }
+
+extern bool dspIsaSupported(DspIsa);
+extern bool setDspIsa(DspIsa);
+extern void initDspKernels();
+
+}     // namespace FluidS
+#endif
+
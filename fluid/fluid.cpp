@@ -99,6 +99,7 @@ void Fluid::init(float sampleRate)
 
       for (int i = 0; i < 512; i++)
             freeVoices.append(new Voice(this));
+      renderList.reserve(512);
       }
 
 //---------------------------------------------------------
@@ -117,12 +118,19 @@ Fluid::~Fluid()
 
 //---------------------------------------------------------
 //   freeVoice
+//    voices turned off while rendering are freed by
+//    process() afterwards
 //---------------------------------------------------------
 
 void Fluid::freeVoice(Voice* v)
       {
-      if (activeVoices.removeOne(v))
+      if (rendering)
+            return;
+      if (activeVoices.removeOne(v)) {
             freeVoices.append(v);
+            if (v->sample)
+                  v->sample->release();
+            }
       }
 
 //---------------------------------------------------------
@@ -217,10 +225,12 @@ void Fluid::damp_voices(int chan)
 
 void Fluid::allNotesOff(int chan)
       {
-      for(Voice* v : activeVoices) {
-            if (chan == -1 || v->chan == chan)
-                  v->noteoff();
-            }
+      execute([this, chan]() {
+            for(Voice* v : activeVoices) {
+                  if (chan == -1 || v->chan == chan)
+                        v->noteoff();
+                  }
+            });
       }
 
 //---------------------------------------------------------
@@ -231,10 +241,12 @@ void Fluid::allNotesOff(int chan)
 
 void Fluid::allSoundsOff(int chan)
       {
-      for(Voice* v : activeVoices) {
-            if (chan == -1 || v->chan == chan)
-                  v->off();
-            }
+      execute([this, chan]() {
+            for(Voice* v : activeVoices) {
+                  if (chan == -1 || v->chan == chan)
+                        v->off();
+                  }
+            });
       }
 
 //---------------------------------------------------------
@@ -398,10 +410,14 @@ void Fluid::update_presets()
 
 void Fluid::process(unsigned len, float* out, float* effect1, float* effect2)
       {
-      if (mutex.tryLock()) {
-            for (Voice* v : activeVoices)
-                  v->write(len, out, effect1, effect2);
-            mutex.unlock();
+      renderList.assign(activeVoices.begin(), activeVoices.end());
+      rendering = true;
+      renderVoices(int(renderList.size()), len, out, effect1, effect2,
+         [this](int i, unsigned n, float* o, float* e1, float* e2) { renderList[i]->write(n, o, e1, e2); });
+      rendering = false;
+      for (Voice* v : renderList) {
+            if (v->status == FLUID_VOICE_OFF)
+                  freeVoice(v);
             }
       }
 
@@ -559,17 +575,36 @@ void Fluid::start_voice(Voice* voice)
       }
 
 //---------------------------------------------------------
-//   updatePatchList
+//   findPreset
+//    the preset with bank and prog in fonts, whose banks
+//    are moved by offsets
 //---------------------------------------------------------
 
-void Fluid::updatePatchList()
+static Preset* findPreset(const QList<SFont*>& fonts, const std::vector<int>& offsets, int bank, int prog)
       {
-      qDeleteAll(patches);
-      patches.clear();
+      for (int i = 0; i < fonts.size(); ++i) {
+            for (Preset* p : fonts[i]->getPresets()) {
+                  if (p->get_banknum() + offsets[i] == bank && p->get_num() == prog)
+                        return p;
+                  }
+            }
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   setSoundFonts
+//    The patch list and the channel presets for fonts are
+//    made, and the samples of the presets loaded, by the
+//    calling thread. The audio thread only swaps them in.
+//---------------------------------------------------------
 
+void Fluid::setSoundFonts(QList<SFont*> fonts, bool voicesOff, bool resetChannels)
+      {
+      QList<MidiPatch*> newPatches;
+      std::vector<int> offsets;
       int bankOffset = 0;
-      for (SFont* sf : sfonts) {
-            sf->setBankOffset(bankOffset);
+      for (SFont* sf : fonts) {
+            offsets.push_back(bankOffset);
             int banks = 0;
             for (Preset* p : sf->getPresets()) {
                   MidiPatch* patch = new MidiPatch;
@@ -580,14 +615,58 @@ void Fluid::updatePatchList()
                   patch->bank = p->get_banknum() + bankOffset;
                   patch->prog = p->get_num();
                   patch->name = p->get_name();
-                  patches.append(patch);
+                  newPatches.append(patch);
                   }
             bankOffset += (banks + 1);
             }
-      /* try to set the correct presets */
+
+      // the presets program_change() would select
       int n = channel.size();
-      for (int i = 0; i < n; i++)
-            program_change(i, channel[i]->getPrognum());
+      std::vector<std::pair<int, int>> programs(n);
+      std::vector<Preset*> presets(n);
+      for (int i = 0; i < n; i++) {
+            int bank = channel[i]->getBanknum();
+            int prog = channel[i]->getPrognum();
+            Preset* p = findPreset(fonts, offsets, bank, prog);
+            if (!p)
+                  p = findPreset(fonts, offsets, 0, prog);
+            if (!p)
+                  p = findPreset(fonts, offsets, 0, 0);
+            if (p)
+                  p->loadSamples();
+            programs[i] = { bank, prog };
+            presets[i]  = p;
+            }
+
+      execute([this, &fonts, &newPatches, &offsets, &programs, &presets, voicesOff, resetChannels]() {
+            if (voicesOff) {
+                  while (!activeVoices.isEmpty())
+                        activeVoices.front()->off();
+                  }
+            sfonts.swap(fonts);
+            patches.swap(newPatches);
+            for (int i = 0; i < sfonts.size(); ++i)
+                  sfonts[i]->setBankOffset(offsets[i]);
+            for (int i = 0; i < int(presets.size()); i++) {
+                  Channel* c = channel[i];
+                  if (resetChannels)
+                        c->reset(false);
+                  if (int(c->getBanknum()) == programs[i].first && c->getPrognum() == programs[i].second) {
+                        Preset* p = presets[i];
+                        c->setSfontnum(p ? p->sfont->id() : 0);
+                        presets[i] = c->replacePreset(p);
+                        }
+                  else  // changed in the meantime
+                        program_change(i, c->getPrognum());
+                  }
+            });
+
+      // the old presets, or the ones not used
+      for (Preset* p : presets) {
+            if (p)
+                  p->unloadSamples();
+            }
+      qDeleteAll(newPatches);
       }
 
 //---------------------------------------------------------
@@ -614,19 +693,10 @@ bool Fluid::loadSoundFonts(const QStringList& sl)
             qDebug("Fluid:loadSoundFonts: already loaded");
             return true;
             }
-      QMutexLocker locker(&mutex);
-      for(Voice* v : activeVoices)
-            v->off();
-      for(Channel* c : channel)
-            c->reset();
-      for (SFont* sf : sfonts)
-            sfunload(sf->id());
-      locker.unlock();
       bool ok = true;
-
+      QList<SFont*> fonts;
       QFileInfoList l = sfFiles();
-      for (int i = sl.size() - 1; i >= 0; --i) {
-            QString s = sl[i];
+      for (const QString& s : sl) {
             if (s.isEmpty())
                   continue;
             QString path;
@@ -638,19 +708,21 @@ bool Fluid::loadSoundFonts(const QStringList& sl)
                         break;
                         }
                   }
+            SFont* sf = path.isEmpty() ? 0 : readSoundFont(path);
             if (path.isEmpty()) {
                   qDebug("Fluid: sf <%s> not found", qPrintable(s));
                   ok = false;
                   }
-            else {
-                  locker.relock();
-                  if (sfload(path) == -1) {
-                        qDebug("loading sf failed: <%s>", qPrintable(path));
-                        ok = false;
-                        }
-                  locker.unlock();
+            else if (!sf) {
+                  qDebug("loading sf failed: <%s>", qPrintable(path));
+                  ok = false;
                   }
+            else
+                  fonts.append(sf);
             }
+      QList<SFont*> old = sfonts;
+      setSoundFonts(fonts, true, true);
+      qDeleteAll(old);
       return ok;
       }
 
@@ -661,7 +733,6 @@ bool Fluid::loadSoundFonts(const QStringList& sl)
 
 bool Fluid::addSoundFont(const QString& s)
       {
-      QMutexLocker locker(&mutex);
       bool rv = (sfload(s) == -1) ? false : true;
       return rv;
       }
@@ -673,45 +744,50 @@ bool Fluid::addSoundFont(const QString& s)
 
 bool Fluid::removeSoundFont(const QString& s)
       {
-      QMutexLocker locker(&mutex);
-      for(Voice* v : activeVoices)
-            v->off();
-      SFont* sf = get_sfont_by_name(s);
-      sfunload(sf->id());
-      return true;
+      SFont* sf = get_sfont_by_name(s);   // the list is only replaced by this thread
+      if (!sf)
+            return false;
+      return sfunload(sf->id());
       }
 
 //---------------------------------------------------------
-//   sfload
+//   readSoundFont
+//    return 0 on error
 //---------------------------------------------------------
 
-int Fluid::sfload(const QString& filename)
+SFont* Fluid::readSoundFont(const QString& filename)
       {
       if (filename.isEmpty())
-            return -1;
+            return 0;
 
       SFont* sf = new SFont(this);
       try {
             if (!sf->read(filename)) {
                   delete sf;
-                  sf = 0;
-                  return -1;
+                  return 0;
                   }
             }
       catch(...) {
             delete sf;
-            sf = 0;
-            return -1;
+            return 0;
             }
-
       sf->setId(++sfont_id);
+      return sf;
+      }
 
-      /* insert the sfont as the first one on the list */
-      sfonts.prepend(sf);
-
-      /* reset the presets for all channels */
+//---------------------------------------------------------
+//   sfload
+//    insert the sound font as the first one on the list
+//---------------------------------------------------------
 
-      updatePatchList();
+int Fluid::sfload(const QString& filename)
+      {
+      SFont* sf = readSoundFont(filename);
+      if (!sf)
+            return -1;
+      QList<SFont*> fonts = sfonts;
+      fonts.prepend(sf);
+      setSoundFonts(fonts, false, false);
       return sf->id();
       }
 
@@ -722,15 +798,13 @@ int Fluid::sfload(const QString& filename)
 bool Fluid::sfunload(int id)
       {
       SFont* sf = get_sfont_by_id(id);
-
       if (!sf) {
             qDebug("No SoundFont with id = %d", id);
             return false;
             }
-
-      sfonts.removeAll(sf);   // remove the SoundFont from the list
-      updatePatchList();
-
+      QList<SFont*> fonts = sfonts;
+      fonts.removeAll(sf);
+      setSoundFonts(fonts, true, false);
       delete sf;
       return true;
       }
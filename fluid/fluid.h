@@ -263,11 +263,12 @@ class Channel {
       void setGen(int n, float v, char a) { gen[n] = v; gen_abs[n] = a; }
       float getGen(int n) const           { return gen[n]; }
       char getGenAbs(int n) const         { return gen_abs[n]; }
-      void init();
+      void init(bool selectPreset = true);
       void initCtrl();
       void setCC(int n, int val)          { cc[n] = val; }
-      void reset();
+      void reset(bool selectPreset = true);
       void setPreset(Preset* p);
+      Preset* replacePreset(Preset* p)    { Preset* o = _preset; _preset = p; return o; }
       Preset* preset() const              { return _preset;  }
       unsigned int getSfontnum() const    { return sfontnum; }
       void setSfontnum(unsigned int s)    { sfontnum = s;    }
@@ -300,6 +301,8 @@ class Fluid : public Synthesizer {
 
       QList<Voice*> freeVoices;           // unused synthesis processes
       QList<Voice*> activeVoices;         // active synthesis processes
+      std::vector<Voice*> renderList;     // activeVoices while they are rendered
+      bool rendering = false;             // defer freeVoice() while rendering
       QString _error;                     // last error message
 
       static bool initialized;
@@ -311,8 +314,7 @@ class Fluid : public Synthesizer {
       int _loadProgress = 0;
       bool _loadWasCanceled = false;
 
-      QMutex mutex;
-      void updatePatchList();
+      void setSoundFonts(QList<SFont*> fonts, bool voicesOff, bool resetChannels);
 
    protected:
       int _state;                         // the synthesizer state
@@ -326,6 +328,7 @@ class Fluid : public Synthesizer {
       SFont* get_sfont_by_name(const QString& name);
       SFont* get_sfont_by_id(int id);
       SFont* get_sfont(int idx) const     { return sfonts[idx];   }
+      SFont* readSoundFont(const QString& filename);
       bool sfunload(int id);
       int sfload(const QString& filename);
 
@@ -52,6 +52,8 @@ SFont::SFont(Fluid* f)
       synth       = f;
       samplepos   = 0;
       samplesize  = 0;
+      _sampleMap  = 0;
+      _sampleMapFailed = false;
       _bankOffset = 0;
       }
 
@@ -102,6 +104,27 @@ bool SFont::read(const QString& s)
       return true;
       }
 
+//---------------------------------------------------------
+//   sampleMap
+//    map the sample data of the file into memory, the
+//    pages are shared with other processes using the
+//    same sound font
+//---------------------------------------------------------
+
+const uchar* SFont::sampleMap()
+      {
+      if (!_sampleMap && !_sampleMapFailed) {
+            if (f.open(QIODevice::ReadOnly))
+                  _sampleMap = f.map(samplepos, samplesize);
+            if (!_sampleMap) {
+                  qDebug("SFont: cannot map sample data of <%s>", qPrintable(f.fileName()));
+                  f.close();
+                  _sampleMapFailed = true;
+                  }
+            }
+      return _sampleMap;
+      }
+
 //---------------------------------------------------------
 //   get_preset
 //---------------------------------------------------------
@@ -147,7 +170,6 @@ Preset::~Preset()
 
 void Preset::loadSamples()
       {
-      bool locked = sfont->synth->mutex.tryLock();
       if (_global_zone && _global_zone->instrument) {
             Instrument* i = _global_zone->instrument;
             if (i->global_zone && i->global_zone->sample)
@@ -163,8 +185,30 @@ void Preset::loadSamples()
             for(Zone* iz : i->zones)
                   iz->sample->load();
             }
-      if (locked)
-            sfont->synth->mutex.unlock();
+      }
+
+//---------------------------------------------------------
+//   unloadSamples
+//    the preset is no longer associated with a channel
+//---------------------------------------------------------
+
+void Preset::unloadSamples()
+      {
+      if (_global_zone && _global_zone->instrument) {
+            Instrument* i = _global_zone->instrument;
+            if (i->global_zone && i->global_zone->sample)
+                  i->global_zone->sample->unload();
+            for(Zone* iz : i->zones)
+                  iz->sample->unload();
+            }
+
+      for(Zone* z : zones) {
+            Instrument* i = z->instrument;
+            if (i->global_zone && i->global_zone->sample)
+                  i->global_zone->sample->unload();
+            for(Zone* iz : i->zones)
+                  iz->sample->unload();
+            }
       }
 
 //---------------------------------------------------------
@@ -197,12 +241,19 @@ bool Preset::noteon(Fluid* synth, unsigned id, int chan, int key, int vel, doubl
                            instrument */
                         if (inst_zone->inside_range(key, vel) && (sample != 0)) {
 
+                              /* make sure the sample data is available, the voice
+                                 releases it when it is freed */
+                              if (!sample->acquire())
+                                    continue;
+
                               /* this is a good zone. allocate a new synthesis process and
                                  initialize it */
 
                               Voice* voice = synth->alloc_voice(id, sample, chan, key, vel, nt);
-                              if (voice == 0)
+                              if (voice == 0) {
+                                    sample->release();
                                     return false;
+                                    }
 
                               /* Instrumentrument level, generators */
 
@@ -588,6 +639,7 @@ Sample::Sample(SFont* s)
       {
       sf          = s;
       _valid      = false;
+      _mapped     = false;
       start       = 0;
       end         = 0;
       loopstart   = 0;
@@ -599,6 +651,12 @@ Sample::Sample(SFont* s)
       data        = 0;
       amplitude_that_reaches_noise_floor_is_valid = false;
       amplitude_that_reaches_noise_floor = 0.0;
+#ifdef SOUNDFONT3
+      oggStart    = 0;
+      oggSize     = 0;
+      refCount    = 0;
+      pins        = 0;
+#endif
       }
 
 //---------------------------------------------------------
@@ -607,43 +665,47 @@ Sample::Sample(SFont* s)
 
 Sample::~Sample()
       {
-      delete[] data;
+#ifdef SOUNDFONT3
+      if (sampletype & FLUID_SAMPLETYPE_OGG_VORBIS) {
+            SampleCache::instance()->remove(this);
+            return;
+            }
+#endif
+      if (!_mapped)
+            delete[] data;
       }
 
 //---------------------------------------------------------
 //   load
+//    Ogg Vorbis samples are decoded by the SampleCache and
+//    kept until unload(). Uncompressed samples refer to the
+//    mapped file if possible.
 //---------------------------------------------------------
 
 void Sample::load()
       {
-      if (!_valid || data)
-            return;
-      QFile fd(sf->get_name());
-      if (!fd.open(QIODevice::ReadOnly))
-            return;
+#ifdef SOUNDFONT3
       if (sampletype & FLUID_SAMPLETYPE_OGG_VORBIS) {
-            if (!fd.seek(sf->samplePos() + start))
-                  return;
-            }
-      else {
-            if (!fd.seek(sf->samplePos() + start * sizeof(short)))
-                  return;
+            SampleCache::instance()->load(this);
+            return;
             }
+#endif
+      if (!_valid || data || (sampletype & FLUID_SAMPLETYPE_OGG_VORBIS))
+            return;
       unsigned int size = end - start;
 
-      if (sampletype & FLUID_SAMPLETYPE_OGG_VORBIS) {
-#ifdef SOUNDFONT3
-            char* p = new char[size];
-            if (fd.read(p, size) != size) {
-                  printf("  read %d failed\n", size);
-                  delete[] p;
-                  return;
-                  }
-            decompressOggVorbis(p, size);
-            delete[] p;
-#endif
+      const uchar* map = sf->sampleMap();
+      if (map && QSysInfo::ByteOrder == QSysInfo::LittleEndian
+         && (quintptr(map) % sizeof(short)) == 0 && end * sizeof(short) <= sf->getSamplesize()) {
+            data    = const_cast<short*>(reinterpret_cast<const short*>(map)) + start;
+            _mapped = true;
             }
       else {
+            QFile fd(sf->get_name());
+            if (!fd.open(QIODevice::ReadOnly))
+                  return;
+            if (!fd.seek(sf->samplePos() + start * sizeof(short)))
+                  return;
             data = new short[size];
             size *= sizeof(short);
 
@@ -662,14 +724,28 @@ void Sample::load()
                         data[i] = s;
                         }
                   }
-            end       -= (start + 1);       // marks last sample, contrary to SF spec.
-            loopstart -= start;
-            loopend   -= start;
-            start      = 0;
             }
+      end       -= (start + 1);       // marks last sample, contrary to SF spec.
+      loopstart -= start;
+      loopend   -= start;
+      start      = 0;
       optimize();
       }
 
+//---------------------------------------------------------
+//   unload
+//    the decoded data of an Ogg Vorbis sample may be
+//    dropped after the last unload()
+//---------------------------------------------------------
+
+void Sample::unload()
+      {
+#ifdef SOUNDFONT3
+      if (sampletype & FLUID_SAMPLETYPE_OGG_VORBIS)
+            SampleCache::instance()->unload(this);
+#endif
+      }
+
 //---------------------------------------------------------
 //   inRom
 //---------------------------------------------------------
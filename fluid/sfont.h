@@ -23,6 +23,8 @@
 #ifndef _FLUID_DEFSFONT_H
 #define _FLUID_DEFSFONT_H
 
+#include <atomic>
+#include <list>
 #include "config.h"
 #include "fluid.h"
 
@@ -54,6 +56,8 @@ class SFont {
       QFile f;
       unsigned samplepos;           // the position in the file at which the sample data starts
       unsigned samplesize;          // the size of the sample data
+      uchar* _sampleMap;            // sample data mapped into memory
+      bool _sampleMapFailed;
 
       QList<Instrument*> instruments;
       QList<Preset*> presets;
@@ -109,6 +113,7 @@ class SFont {
       bool read(const QString& file);
 
       int load_sampledata();
+      const uchar* sampleMap();
       unsigned int samplePos() const            { return samplepos;  }
       int id() const                            { return _id; }
       void setId(int i)                         { _id = i;    }
@@ -116,6 +121,7 @@ class SFont {
       void setSamplesize(unsigned v)            { samplesize = v; }
       unsigned getSamplesize() const            { return samplesize; }
       const QList<Preset*> getPresets() const   { return presets; }
+      const QList<Sample*>& samples() const     { return sample; }
       SFVersion version() const                 { return _version; }
       int bankOffset() const                    { return _bankOffset; }
       void setBankOffset(int val)               { _bankOffset = val; }
@@ -129,6 +135,11 @@ class SFont {
 
 class Sample {
       bool _valid;
+      bool _mapped;                 // data points into the mapped sound font file
+#ifdef SOUNDFONT3
+      int pins;                     // loadSamples() of selected presets, guarded by the cache
+      void setDecodedFrames(int frames);
+#endif
 
    public:
       SFont* sf;
@@ -151,18 +162,89 @@ class Sample {
       bool amplitude_that_reaches_noise_floor_is_valid;
       double amplitude_that_reaches_noise_floor;
 
+#ifdef SOUNDFONT3
+      /* Ogg Vorbis samples are decoded when a preset using
+         them is selected and kept in the SampleCache. start and
+         end refer to the compressed data until the sample is
+         decoded for the first time. */
+      unsigned int oggStart;
+      unsigned int oggSize;
+      std::atomic<int> refCount;    // voices playing the decoded data
+#endif
+
       Sample(SFont*);
       ~Sample();
 
       bool inRom() const;
       void optimize();
       void load();
+      void unload();
       bool valid() const    { return _valid; }
       void setValid(bool v) { _valid = v; }
 #ifdef SOUNDFONT3
-      bool decompressOggVorbis(char* p, int size);
+      static short* decompressOggVorbis(const char* p, int size, int* frames);
+      // called at note on, the data was decoded by load()
+      bool acquire() {
+            if (!(sampletype & FLUID_SAMPLETYPE_OGG_VORBIS))
+                  return true;
+            if (!data || !_valid)
+                  return false;
+            ++refCount;
+            return true;
+            }
+      void release()        { if (sampletype & FLUID_SAMPLETYPE_OGG_VORBIS) --refCount; }
+#else
+      bool acquire()        { return !(sampletype & FLUID_SAMPLETYPE_OGG_VORBIS); }
+      void release()        {}
 #endif
+
+      friend class SampleCache;
+      };
+
+#ifdef SOUNDFONT3
+//---------------------------------------------------------
+//   SampleCache
+//    Decoded Ogg Vorbis samples, shared by all synthesizer
+//    instances of the process. The samples of a preset are
+//    decoded when it is selected for a channel, so a note on
+//    does not wait for the decoder. Decoded data which no
+//    selected preset uses and no voice plays is dropped in
+//    least recently used order if the cache grows beyond
+//    maxSize bytes.
+//---------------------------------------------------------
+
+class SampleCache {
+      typedef std::pair<QString, unsigned> Key;     // sound font file, offset of compressed data
+      struct Entry {
+            short* data;
+            int frames;
+            size_t bytes;
+            int pins;                     // sum of Sample::pins of samples
+            QList<Sample*> samples;       // samples using data
+            std::list<Key>::iterator unused;    // position in unusedList if not pinned
+            };
+
+      QMutex mutex;
+      std::map<Key, Entry> entries;
+      std::list<Key> unusedList;          // entries which are not pinned, oldest first
+      size_t size;
+      size_t maxSize;
+
+      SampleCache();
+      static Key key(const Sample*);
+      void evict();
+
+   public:
+      static const size_t defaultMaxSize = 256 * 1024 * 1024;
+
+      static SampleCache* instance();
+      bool load(Sample*);
+      void unload(Sample*);
+      void remove(Sample*);
+      void setMaxSize(size_t n);
+      size_t cachedBytes();
       };
+#endif
 
 //---------------------------------------------------------
 //   Zone
@@ -238,6 +320,7 @@ class Preset {
 
       Zone* global_zone()                       { return _global_zone; }
       void loadSamples();
+      void unloadSamples();
       QList<Zone*> getZones()                   { return zones; }
       };
 
@@ -8,27 +8,39 @@ namespace FluidS {
 
 //---------------------------------------------------------
 //   decompressOggVorbis
+//    return the decoded sample data or 0 on error
 //---------------------------------------------------------
 
-bool Sample::decompressOggVorbis(char* src, int size)
+short* Sample::decompressOggVorbis(const char* src, int size, int* frames)
       {
       AudioFile af;
       QByteArray ba(src, size);
 
-      start = 0;
-      end   = 0;
+      *frames = 0;
       if (!af.open(ba)) {
             qDebug("Sample::decompressOggVorbis: open failed: %s", af.error());
-            return false;
+            return 0;
             }
-      int frames = af.frames();
-      data = new short[frames * af.channels()];
-      if (frames != af.readData(data, frames)) {
+      int n = af.frames();
+      short* data = new short[n * af.channels()];
+      if (n != af.readData(data, n)) {
             qDebug("Sample read failed: %s", af.error());
             delete[] data;
-            data = 0;
+            return 0;
             }
-      end = frames - 1;
+      *frames = n;
+      return data;
+      }
+
+//---------------------------------------------------------
+//   setDecodedFrames
+//    adjust sample positions to the decoded data
+//---------------------------------------------------------
+
+void Sample::setDecodedFrames(int frames)
+      {
+      start = 0;
+      end   = frames - 1;
 
       if (loopend > end ||loopstart >= loopend || loopstart <= start) {
             /* can pad loop by 8 samples and ensure at least 4 for loop (2*8+4) */
@@ -45,7 +57,213 @@ bool Sample::decompressOggVorbis(char* src, int size)
             qDebug("invalid sample");
             setValid(false);
             }
+      }
+
+//---------------------------------------------------------
+//   SampleCache
+//---------------------------------------------------------
+
+SampleCache::SampleCache()
+      {
+      size    = 0;
+      maxSize = defaultMaxSize;
+      }
+
+//---------------------------------------------------------
+//   instance
+//---------------------------------------------------------
+
+SampleCache* SampleCache::instance()
+      {
+      static SampleCache cache;
+      return &cache;
+      }
+
+//---------------------------------------------------------
+//   key
+//---------------------------------------------------------
+
+SampleCache::Key SampleCache::key(const Sample* sample)
+      {
+      return Key(sample->sf->get_name(), sample->sf->samplePos() + sample->oggStart);
+      }
+
+//---------------------------------------------------------
+//   load
+//    Keep the decoded data of sample until it is unloaded,
+//    decode it if it is not cached. The data is decoded
+//    without holding the lock, so other synthesizers are
+//    not blocked by it. Return false if the sample cannot
+//    be decoded.
+//---------------------------------------------------------
+
+bool SampleCache::load(Sample* sample)
+      {
+      QMutexLocker locker(&mutex);
+      ++sample->pins;
+      if (!sample->valid())
+            return false;
+      if (!sample->oggSize) {
+            sample->oggStart = sample->start;
+            sample->oggSize  = sample->end - sample->start;
+            }
+      Key k = key(sample);
+      auto i = entries.find(k);
+      if (i == entries.end()) {
+            locker.unlock();
+
+            QFile fd(k.first);
+            if (!fd.open(QIODevice::ReadOnly) || !fd.seek(k.second))
+                  return false;
+            QByteArray ba = fd.read(sample->oggSize);
+            if (ba.size() != int(sample->oggSize)) {
+                  qDebug("SampleCache: read %d failed", sample->oggSize);
+                  return false;
+                  }
+            int frames;
+            short* data = Sample::decompressOggVorbis(ba.constData(), ba.size(), &frames);
+            if (!data)
+                  return false;
+
+            locker.relock();
+            i = entries.find(k);
+            if (i == entries.end()) {
+                  Entry e;
+                  e.data   = data;
+                  e.frames = frames;
+                  e.bytes  = frames * sizeof(short);
+                  e.pins   = 0;
+                  e.unused = unusedList.end();
+                  i = entries.insert(std::make_pair(k, e)).first;
+                  size += e.bytes;
+                  }
+            else        // decoded by another synthesizer in the meantime
+                  delete[] data;
+            }
+      Entry& e = i->second;
+      if (!sample->data) {
+            sample->data = e.data;
+            e.samples.append(sample);
+            sample->setDecodedFrames(e.frames);
+            sample->optimize();
+            e.pins += sample->pins;
+            }
+      else
+            ++e.pins;
+      if (e.unused != unusedList.end()) {
+            unusedList.erase(e.unused);
+            e.unused = unusedList.end();
+            }
+      if (size > maxSize)
+            evict();
+      return sample->valid();
+      }
+
+//---------------------------------------------------------
+//   unload
+//---------------------------------------------------------
+
+void SampleCache::unload(Sample* sample)
+      {
+      QMutexLocker locker(&mutex);
+      if (!sample->pins)
+            return;
+      --sample->pins;
+      if (!sample->data)
+            return;
+      auto i = entries.find(key(sample));
+      if (i == entries.end())
+            return;
+      Entry& e = i->second;
+      if (--e.pins == 0) {
+            e.unused = unusedList.insert(unusedList.end(), i->first);
+            if (size > maxSize)
+                  evict();
+            }
+      }
 
-      return true;
+//---------------------------------------------------------
+//   remove
+//    called when sample is deleted
+//---------------------------------------------------------
+
+void SampleCache::remove(Sample* sample)
+      {
+      QMutexLocker locker(&mutex);
+      if (!sample->data)
+            return;
+      auto i = entries.find(key(sample));
+      if (i != entries.end()) {
+            Entry& e = i->second;
+            e.samples.removeOne(sample);
+            e.pins -= sample->pins;
+            if (e.samples.empty()) {
+                  if (e.unused != unusedList.end())
+                        unusedList.erase(e.unused);
+                  size -= e.bytes;
+                  delete[] e.data;
+                  entries.erase(i);
+                  }
+            else if (e.pins == 0 && e.unused == unusedList.end())
+                  e.unused = unusedList.insert(unusedList.end(), i->first);
+            }
+      sample->data = 0;
+      sample->pins = 0;
       }
+
+//---------------------------------------------------------
+//   evict
+//    drop data which is not pinned and not played, oldest
+//    first, until the cache fits into maxSize again; the
+//    lock must be held. Voices only acquire pinned data, so
+//    the refCount of the samples of an unpinned entry can
+//    only go down while we look at it.
+//---------------------------------------------------------
+
+void SampleCache::evict()
+      {
+      for (auto k = unusedList.begin(); k != unusedList.end() && size > maxSize;) {
+            auto i = entries.find(*k);
+            Entry& e = i->second;
+            bool playing = false;
+            for (const Sample* s : e.samples) {
+                  if (s->refCount) {
+                        playing = true;
+                        break;
+                        }
+                  }
+            if (playing) {
+                  ++k;
+                  continue;
+                  }
+            for (Sample* s : e.samples)
+                  s->data = 0;
+            size -= e.bytes;
+            delete[] e.data;
+            entries.erase(i);
+            k = unusedList.erase(k);
+            }
+      }
+
+//---------------------------------------------------------
+//   setMaxSize
+//---------------------------------------------------------
+
+void SampleCache::setMaxSize(size_t n)
+      {
+      QMutexLocker locker(&mutex);
+      maxSize = n;
+      evict();
+      }
+
+//---------------------------------------------------------
+//   cachedBytes
+//---------------------------------------------------------
+
+size_t SampleCache::cachedBytes()
+      {
+      QMutexLocker locker(&mutex);
+      return size;
+      }
+
 } // namespace
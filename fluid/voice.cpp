@@ -23,6 +23,7 @@
 #include "sfont.h"
 #include "gen.h"
 #include "voice.h"
+#include "dspkernels.h"
 
 namespace FluidS {
 
@@ -1891,19 +1892,7 @@ void Voice::effects(int startBufIdx, int count, float* out, float* reverb, float
                   }
             }
 
-      for (int i = startBufIdx; i < startBufIdx + count; ++i) {
-            float v    = dsp_buf[i];
-
-            float vv   = v  * amp_left;
-            *out++     += vv;
-            *reverb++  += vv * amp_reverb;
-            *chorus++  += vv * amp_chorus;
-
-            vv         = v  * amp_right;
-            *out++     += vv;
-            *reverb++  += vv * amp_reverb;
-            *chorus++  += vv * amp_chorus;
-            }
+      dspKernels()->mix(dsp_buf.data() + startBufIdx, count, out, reverb, chorus, amp_left, amp_right, amp_reverb, amp_chorus);
       }
 }
 
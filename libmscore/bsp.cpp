@@ -38,8 +38,9 @@ class RemoveItemBspTreeVisitor : public BspTreeVisitor
       {
    public:
       Element* item;
+      int removed { 0 };
 
-      inline void visit(QList<Element*> *items) { items->removeAll(item); }
+      inline void visit(QList<Element*> *items) { removed += items->removeAll(item); }
       };
 
 //---------------------------------------------------------
@@ -124,10 +125,36 @@ void BspTree::insert(Element* element)
 //---------------------------------------------------------
 
 void BspTree::remove(Element* element)
+      {
+      remove(element, element->pageBoundingRect());
+      }
+
+//---------------------------------------------------------
+//   remove
+//    remove element, which was inserted with the bounding
+//    rect oldRect. Return false if it was not found.
+//---------------------------------------------------------
+
+bool BspTree::remove(Element* element, const QRectF& oldRect)
       {
       RemoveItemBspTreeVisitor removeVisitor;
       removeVisitor.item = element;
-      climbTree(&removeVisitor, element->pageBoundingRect());
+      climbTree(&removeVisitor, oldRect);
+      return removeVisitor.removed > 0;
+      }
+
+//---------------------------------------------------------
+//   move
+//    update the position of element, which was inserted
+//    with the bounding rect oldRect
+//---------------------------------------------------------
+
+bool BspTree::move(Element* element, const QRectF& oldRect)
+      {
+      if (!remove(element, oldRect))
+            return false;
+      insert(element);
+      return true;
       }
 
 //---------------------------------------------------------
@@ -64,6 +64,8 @@ class BspTree
 
       void insert(Element* item);
       void remove(Element* item);
+      bool remove(Element* item, const QRectF& oldRect);
+      bool move(Element* item, const QRectF& oldRect);
 
       QList<Element*> items(const QRectF& rect);
       QList<Element*> items(const QPointF& pos);
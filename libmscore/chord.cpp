@@ -50,6 +50,8 @@
 
 namespace Ms {
 
+DEFINE_MEMORY_POOL(Chord)
+
 //---------------------------------------------------------
 //   LedgerLineData
 //---------------------------------------------------------
@@ -984,8 +986,9 @@ void Chord::read(XmlReader& e)
 bool Chord::readProperties(XmlReader& e)
       {
       const QStringRef& tag(e.name());
+      const XmlTag tid = e.tagId();
 
-      if (tag == "Note") {
+      if (tid == XmlTag::NOTE) {
             Note* note = new Note(score());
             // the note needs to know the properties of the track it belongs to
             note->setTrack(track());
@@ -995,65 +998,65 @@ bool Chord::readProperties(XmlReader& e)
             }
       else if (ChordRest::readProperties(e))
             ;
-      else if (tag == "Stem") {
+      else if (tid == XmlTag::STEM) {
             Stem* s = new Stem(score());
             s->read(e);
             add(s);
             }
-      else if (tag == "Hook") {
+      else if (tid == XmlTag::HOOK) {
             _hook = new Hook(score());
             _hook->read(e);
             add(_hook);
             }
-      else if (tag == "appoggiatura") {
+      else if (tid == XmlTag::APPOGGIATURA) {
             _noteType = NoteType::APPOGGIATURA;
             e.readNext();
             }
-      else if (tag == "acciaccatura") {
+      else if (tid == XmlTag::ACCIACCATURA) {
             _noteType = NoteType::ACCIACCATURA;
             e.readNext();
             }
-      else if (tag == "grace4") {
+      else if (tid == XmlTag::GRACE4) {
             _noteType = NoteType::GRACE4;
             e.readNext();
             }
-      else if (tag == "grace16") {
+      else if (tid == XmlTag::GRACE16) {
             _noteType = NoteType::GRACE16;
             e.readNext();
             }
-      else if (tag == "grace32") {
+      else if (tid == XmlTag::GRACE32) {
             _noteType = NoteType::GRACE32;
             e.readNext();
             }
-      else if (tag == "grace8after") {
+      else if (tid == XmlTag::GRACE8AFTER) {
             _noteType = NoteType::GRACE8_AFTER;
             e.readNext();
             }
-      else if (tag == "grace16after") {
+      else if (tid == XmlTag::GRACE16AFTER) {
             _noteType = NoteType::GRACE16_AFTER;
             e.readNext();
             }
-      else if (tag == "grace32after") {
+      else if (tid == XmlTag::GRACE32AFTER) {
             _noteType = NoteType::GRACE32_AFTER;
             e.readNext();
             }
-      else if (tag == "StemSlash") {
+      else if (tid == XmlTag::STEM_SLASH) {
             StemSlash* ss = new StemSlash(score());
             ss->read(e);
             add(ss);
             }
       else if (readProperty(tag, e, Pid::STEM_DIRECTION))
             ;
-      else if (tag == "noStem")
+      else if (tid == XmlTag::NO_STEM)
             _noStem = e.readInt();
-      else if (tag == "Arpeggio") {
+      else if (tid == XmlTag::ARPEGGIO) {
             _arpeggio = new Arpeggio(score());
             _arpeggio->setTrack(track());
             _arpeggio->read(e);
             _arpeggio->setParent(this);
             }
       // old glissando format, chord-to-chord, attached to its final chord
-      else if (tag == "Glissando") {
+      else if (tid == XmlTag::GLISSANDO) {
             // the measure we are reading is not inserted in the score yet
             // as well as, possibly, the glissando intended initial chord;
             // then we cannot fully link the glissando right now;
@@ -1073,15 +1076,15 @@ bool Chord::readProperties(XmlReader& e)
                   }
             finalNote->addSpannerBack(gliss);
             }
-      else if (tag == "Tremolo") {
+      else if (tid == XmlTag::TREMOLO) {
             _tremolo = new Tremolo(score());
             _tremolo->setTrack(track());
             _tremolo->read(e);
             _tremolo->setParent(this);
             }
-      else if (tag == "tickOffset")       // obsolete
+      else if (tid == XmlTag::TICK_OFFSET)       // obsolete
             ;
-      else if (tag == "ChordLine") {
+      else if (tid == XmlTag::CHORD_LINE) {
             ChordLine* cl = new ChordLine(score());
             cl->read(e);
             add(cl);
@@ -20,6 +20,7 @@
 
 #include <functional>
 #include "chordrest.h"
+#include "mempool.h"
 
 namespace Ms {
 
@@ -92,6 +93,8 @@ class Chord final : public ChordRest {
       void layoutTablature();
       qreal noteHeadWidth() const;
 
+      DECLARE_MEMORY_POOL
+
    public:
       Chord(Score* s = 0);
       Chord(const Chord&, bool link = false);
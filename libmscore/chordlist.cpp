@@ -461,9 +461,39 @@ void ParsedChord::correctXmlText(const QString& s)
 //---------------------------------------------------------
 //  parse
 //    returns true if chord was parseable
+//    The result only depends on the arguments (of the chord
+//    list only whether there is one), so it is looked up in
+//    a cache shared by all scores and their parts.
 //---------------------------------------------------------
 
 bool ParsedChord::parse(const QString& s, const ChordList* cl, bool syntaxOnly, bool preferMinor)
+      {
+      static const int MAX_CACHED = 10000;
+      static QMutex mutex;
+      static QHash<QPair<QString, int>, ParsedChord> cache;
+
+      const QPair<QString, int> key(s, (cl ? 1 : 0) | (syntaxOnly ? 2 : 0) | (preferMinor ? 4 : 0));
+      {
+      QMutexLocker lock(&mutex);
+      auto i = cache.constFind(key);
+      if (i != cache.constEnd()) {
+            *this = i.value();
+            return _parseable;
+            }
+      }
+      bool rv = doParse(s, cl, syntaxOnly, preferMinor);
+      QMutexLocker lock(&mutex);
+      if (cache.size() >= MAX_CACHED)
+            cache.clear();
+      cache.insert(key, *this);
+      return rv;
+      }
+
+//---------------------------------------------------------
+//  doParse
+//---------------------------------------------------------
+
+bool ParsedChord::doParse(const QString& s, const ChordList* cl, bool syntaxOnly, bool preferMinor)
       {
       QString tok1, tok1L, tok2, tok2L;
       QString extensionDigits = "123456789";
@@ -1559,6 +1589,30 @@ void ChordDescription::write(XmlWriter& xml) const
 
 int ChordList::privateID = -1000;
 
+//---------------------------------------------------------
+//   chord list file cache
+//    the lists read from description files, the scores and
+//    parts reading the same files share them (copy on write)
+//---------------------------------------------------------
+
+static QMutex fileCacheMutex;
+static QHash<QString, ChordList> fileCache;
+
+//---------------------------------------------------------
+//   onlyFiles
+//    true if the list holds just what was read from _files,
+//    a change of the map detaches it from the cached list
+//---------------------------------------------------------
+
+bool ChordList::onlyFiles() const
+      {
+      if (_files.isEmpty())
+            return isEmpty() && symbols.isEmpty() && fonts.isEmpty() && chordTokenList.isEmpty()
+               && renderListRoot.isEmpty() && renderListBase.isEmpty();
+      auto i = fileCache.constFind(_files);
+      return i != fileCache.constEnd() && isSharedWith(i.value());
+      }
+
 //---------------------------------------------------------
 //   read
 //---------------------------------------------------------
@@ -1715,6 +1769,19 @@ bool ChordList::read(const QString& name)
 
       if (name.isEmpty())
             return false;
+
+      QString key;
+      {
+      QMutexLocker lock(&fileCacheMutex);
+      if (onlyFiles()) {
+            key = _files + path + " " + QFileInfo(path).lastModified().toString(Qt::ISODate) + "\n";
+            auto i = fileCache.constFind(key);
+            if (i != fileCache.constEnd()) {
+                  *this = i.value();
+                  return true;
+                  }
+            }
+      }
       QFile f(path);
       if (!f.open(QIODevice::ReadOnly)) {
             MScore::lastError = QObject::tr("Cannot open chord description:\n%1\n%2").arg(f.fileName()).arg(f.errorString());
@@ -1730,6 +1797,11 @@ bool ChordList::read(const QString& name)
                   // QStringList sl = version.split('.');
                   // int _mscVersion = sl[0].toInt() * 100 + sl[1].toInt();
                   read(e);
+                  if (!key.isEmpty()) {
+                        _files = key;
+                        QMutexLocker lock(&fileCacheMutex);
+                        fileCache.insert(key, *this);
+                        }
                   return true;
                   }
             }
@@ -1788,6 +1860,7 @@ bool ChordList::loaded() const
 
 void ChordList::unload()
       {
+      _files.clear();
       clear();
       symbols.clear();
       fonts.clear();
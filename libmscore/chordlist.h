@@ -125,6 +125,7 @@ class ChordToken {
 class ParsedChord {
    public:
       bool parse(const QString&, const ChordList*, bool syntaxOnly = false, bool preferMinor = false);
+      bool doParse(const QString&, const ChordList*, bool syntaxOnly, bool preferMinor);  // parse() without the cache
       QString fromXml(const QString&, const QString&, const QString&, const QString&, const QList<HDegree>&, const ChordList*);
       const QList<RenderAction>& renderList(const ChordList*);
       bool parseable() const                    { return _parseable; }
@@ -228,6 +229,9 @@ struct ChordFont {
 
 class ChordList : public QMap<int, ChordDescription> {
       QMap<QString, ChordSymbol> symbols;
+      QString _files;         // the files read into an empty list, key of the file cache
+
+      bool onlyFiles() const;
 
    public:
       QList<ChordFont> fonts;
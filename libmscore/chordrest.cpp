@@ -209,8 +209,9 @@ void ChordRest::writeProperties(XmlWriter& xml) const
 bool ChordRest::readProperties(XmlReader& e)
       {
       const QStringRef& tag(e.name());
+      const XmlTag tid = e.tagId();
 
-      if (tag == "durationType") {
+      if (tid == XmlTag::DURATION_TYPE) {
             setDurationType(e.readElementText());
             if (actualDurationType().type() != TDuration::DurationType::V_MEASURE) {
                   if (score()->mscVersion() < 112 && (type() == ElementType::REST) &&
@@ -237,7 +238,7 @@ bool ChordRest::readProperties(XmlReader& e)
                         }
                   }
             }
-      else if (tag == "BeamMode") {
+      else if (tid == XmlTag::BEAM_MODE) {
             QString val(e.readElementText());
             Beam::Mode bm = Beam::Mode::AUTO;
             if (val == "auto")
@@ -258,17 +259,17 @@ bool ChordRest::readProperties(XmlReader& e)
                   bm = Beam::Mode(val.toInt());
             _beamMode = Beam::Mode(bm);
             }
-      else if (tag == "Articulation") {
+      else if (tid == XmlTag::ARTICULATION) {
             Articulation* atr = new Articulation(score());
             atr->setTrack(track());
             atr->read(e);
             add(atr);
             }
-      else if (tag == "leadingSpace" || tag == "trailingSpace") {
+      else if (tid == XmlTag::LEADING_SPACE || tid == XmlTag::TRAILING_SPACE) {
             qDebug("ChordRest: %s obsolete", tag.toLocal8Bit().data());
             e.skipCurrentElement();
             }
-      else if (tag == "Beam") {
+      else if (tid == XmlTag::BEAM) {
             int id = e.readInt();
             Beam* beam = e.findBeam(id);
             if (beam)
@@ -276,11 +277,11 @@ bool ChordRest::readProperties(XmlReader& e)
             else
                   qDebug("Beam id %d not found", id);
             }
-      else if (tag == "small")
+      else if (tid == XmlTag::SMALL)
             _small = e.readInt();
-      else if (tag == "duration")
+      else if (tid == XmlTag::DURATION)
             setDuration(e.readFraction());
-      else if (tag == "ticklen") {      // obsolete (version < 1.12)
+      else if (tid == XmlTag::TICKLEN) {      // obsolete (version < 1.12)
             int mticks = score()->sigmap()->timesig(e.tick()).timesig().ticks();
             int i = e.readInt();
             if (i == 0)
@@ -295,11 +296,11 @@ bool ChordRest::readProperties(XmlReader& e)
                   setDurationType(TDuration(f));
                   }
             }
-      else if (tag == "dots")
+      else if (tid == XmlTag::DOTS)
             setDots(e.readInt());
-      else if (tag == "move")
+      else if (tid == XmlTag::MOVE)
             _staffMove = e.readInt();
-      else if (tag == "Slur") {
+      else if (tid == XmlTag::SLUR) {
             int id = e.intAttribute("id");
             if (id == 0)
                   id = e.intAttribute("number");                  // obsolete
@@ -374,17 +375,17 @@ bool ChordRest::readProperties(XmlReader& e)
                   }
             e.readNext();
             }
-      else if (tag == "Lyrics") {
+      else if (tid == XmlTag::LYRICS) {
             Element* element = new Lyrics(score());
             element->setTrack(e.track());
             element->read(e);
             add(element);
             }
-      else if (tag == "pos") {
+      else if (tid == XmlTag::POS) {
             QPointF pt = e.readPoint();
             setUserOff(pt * spatium());
             }
-      else if (tag == "offset")
+      else if (tid == XmlTag::OFFSET)
             DurationElement::readProperties(e);
       else if (!DurationElement::readProperties(e))
             return false;
@@ -74,6 +74,7 @@
 #include "tremolo.h"
 #include "rehearsalmark.h"
 #include "sym.h"
+#include "mempool.h"
 
 namespace Ms {
 
@@ -87,6 +88,9 @@ void CmdState::reset()
       _updateMode         = UpdateMode::DoNothing;
       _startTick          = -1;
       _endTick            = -1;
+      _startStaff         = -1;
+      _endStaff           = -1;
+      _allStaves          = false;
       }
 
 //---------------------------------------------------------
@@ -102,6 +106,54 @@ void CmdState::setTick(int t)
       setUpdateMode(UpdateMode::Layout);
       }
 
+//---------------------------------------------------------
+//   setStaff
+//    staffIdx -1 means the change affects all staves
+//---------------------------------------------------------
+
+void CmdState::setStaff(int staffIdx)
+      {
+      if (staffIdx == -1) {
+            _allStaves = true;
+            return;
+            }
+      if (_startStaff == -1 || staffIdx < _startStaff)
+            _startStaff = staffIdx;
+      if (_endStaff == -1 || staffIdx > _endStaff)
+            _endStaff = staffIdx;
+      }
+
+//---------------------------------------------------------
+//   PlaylistRange::add
+//    add the region changed by a command
+//---------------------------------------------------------
+
+void PlaylistRange::add(const CmdState& cs)
+      {
+      if (_all)
+            return;
+      if (cs.startTick() == -1) {
+            // change not attributed to a tick range
+            _all = true;
+            return;
+            }
+      if (_startTick == -1) {
+            _startTick  = cs.startTick();
+            _endTick    = cs.endTick();
+            _startStaff = cs.startStaff();
+            _endStaff   = cs.endStaff();
+            return;
+            }
+      _startTick = qMin(_startTick, cs.startTick());
+      _endTick   = qMax(_endTick, cs.endTick());
+      if (_startStaff == -1 || cs.startStaff() == -1)
+            _startStaff = _endStaff = -1;
+      else {
+            _startStaff = qMin(_startStaff, cs.startStaff());
+            _endStaff   = qMax(_endStaff, cs.endStaff());
+            }
+      }
+
 //---------------------------------------------------------
 //   setUpdateMode
 //---------------------------------------------------------
@@ -129,6 +181,8 @@ void Score::startCmd()
             qDebug("===startCmd()");
 
       cmdState().reset();
+      // a layout read from file is no longer valid once the score is edited
+      masterScore()->setLayoutCache(0);
 
       // Start collecting low-level undo operations for a
       // user-visible undo action.
@@ -153,6 +207,9 @@ void Score::undoRedo(bool undo, EditData* ed)
             undoStack()->undo(ed);
       else
             undoStack()->redo(ed);
+      masterScore()->setLayoutCache(0);
+      masterScore()->_playlistRange.add(cmdState());
+      masterScore()->_playlistDirty = true;
       update();
       updateSelection();
       }
@@ -176,6 +233,7 @@ void Score::endCmd(bool rollback)
       if (rollback)
             undoStack()->current()->unwind();
 
+      CmdState cs = cmdState();           // reset by update()
       update();
 
       if (MScore::debugMode)
@@ -184,11 +242,13 @@ void Score::endCmd(bool rollback)
       undoStack()->endMacro(noUndo);
 
       if (dirty()) {
-            masterScore()->_playlistDirty = true;  // TODO: flag individual operations
+            masterScore()->_playlistDirty = true;
+            masterScore()->_playlistRange.add(cs);
             masterScore()->_autosaveDirty = true;
             }
       MuseScoreCore::mscoreCore->endCmd();
       cmdState().reset();
+      MemoryPool::report("endCmd");
       }
 
 #ifndef NDEBUG
@@ -217,6 +277,8 @@ void Score::update()
             CmdState& cs = ms->cmdState();
             ms->deletePostponed();
             if (cs.layoutRange()) {
+                  // part scores share the undo stack and linked elements
+                  // with the master score, lay them out one after the other
                   for (Score* s : ms->scoreList())
                         s->doLayoutRange(cs.startTick(), cs.endTick());
                   updateAll = true;
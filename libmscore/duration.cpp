@@ -120,7 +120,7 @@ Fraction DurationElement::ftick() const
 
 bool DurationElement::readProperties(XmlReader& e)
       {
-      if (e.name() == "Tuplet") {
+      if (e.tagId() == XmlTag::TUPLET) {
             int i = e.readInt();
             Tuplet* t = e.findTuplet(i);
             if (!t) {
@@ -501,17 +501,17 @@ void Element::writeProperties(XmlWriter& xml) const
 
 bool Element::readProperties(XmlReader& e)
       {
-      const QStringRef& tag(e.name());
+      const XmlTag tid = e.tagId();
 
-      if (tag == "track")
+      if (tid == XmlTag::TRACK)
             setTrack(e.readInt() + e.trackOffset());
-      else if (tag == "color")
+      else if (tid == XmlTag::COLOR)
             setColor(e.readColor());
-      else if (tag == "visible")
+      else if (tid == XmlTag::VISIBLE)
             setVisible(e.readInt());
-      else if (tag == "selected") // obsolete
+      else if (tid == XmlTag::SELECTED) // obsolete
             e.readInt();
-      else if (tag == "lid") {
+      else if (tid == XmlTag::LID) {
             int id = e.readInt();
             _links = e.linkIds().value(id);
             if (!_links) {
@@ -534,18 +534,18 @@ bool Element::readProperties(XmlReader& e)
             Q_ASSERT(!_links->contains(this));
             _links->append(this);
             }
-      else if (tag == "tick") {
+      else if (tid == XmlTag::TICK) {
             int val = e.readInt();
             if (val >= 0)
                   e.initTick(score()->fileDivision(val));
             }
-      else if (tag == "offset" || tag == "pos") {
+      else if (tid == XmlTag::OFFSET || tid == XmlTag::POS) {
             setUserOff(e.readPoint() * score()->spatium());
             setAutoplace(false);
             }
-      else if (tag == "voice")
+      else if (tid == XmlTag::VOICE)
             setTrack((_track/VOICES)*VOICES + e.readInt());
-      else if (tag == "tag") {
+      else if (tid == XmlTag::TAG) {
             QString val(e.readElementText());
             for (int i = 1; i < MAX_TAGS; i++) {
                   if (score()->layerTags()[i] == val) {
@@ -554,9 +554,9 @@ bool Element::readProperties(XmlReader& e)
                         }
                   }
             }
-      else if (tag == "placement")
+      else if (tid == XmlTag::PLACEMENT)
             _placement = Placement(Ms::getProperty(Pid::PLACEMENT, e).toInt());
-      else if (tag == "z")
+      else if (tid == XmlTag::Z)
             setZ(e.readInt());
       else
             return false;
@@ -1593,7 +1593,7 @@ Fraction Element::ftick() const
 
 void Element::triggerLayout() const
       {
-      score()->setLayout(tick());
+      score()->setLayoutStaff(tick(), staff());
       }
 
 //---------------------------------------------------------
@@ -1866,7 +1866,7 @@ void Element::autoplaceSegmentElement(qreal minDistance)
             bool cnm = (s2.right() > m->width()) && m->nextMeasure() && m->nextMeasure()->system() == m->system();
             if (cnm) {
                   Measure* nm = m->nextMeasure();
-                  s1.add(nm->staffShape(si).translated(QPointF(m->width(), 0.0)));
+                  s1.add(nm->staffShape(si), QPointF(m->width(), 0.0));
                   }
             qreal d = placeAbove() ? s2.minVerticalDistance(s1) : s1.minVerticalDistance(s2);
             if (d > -minDistance) {
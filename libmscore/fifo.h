@@ -35,13 +35,19 @@ class FifoBase {
       std::atomic<int> counter; // objects in fifo
       int maxCount;
 
-      void push();
-      void pop();
+      void push() {
+            widx = (widx + 1) % maxCount;
+            ++counter;
+            }
+      void pop() {
+            ridx = (ridx + 1) % maxCount;
+            --counter;
+            }
 
    public:
       FifoBase()              { clear(); }
       virtual ~FifoBase()     {}
-      void clear();
+      void clear()            { ridx = 0; widx = 0; counter = 0; }
       int count() const       { return counter; }
       bool empty() const    { return counter == 0; }
       bool isFull() const     { return maxCount == counter; }
@@ -24,6 +24,7 @@
 #include "keysig.h"
 #include "layoutbreak.h"
 #include "layout.h"
+#include "layoutcache.h"
 #include "lyrics.h"
 #include "marker.h"
 #include "measure.h"
@@ -46,6 +47,7 @@
 #include "text.h"
 #include "tie.h"
 #include "timesig.h"
+#include "trace.h"
 #include "tremolo.h"
 #include "tuplet.h"
 #include "undo.h"
@@ -81,6 +83,8 @@ void Score::rebuildBspTree()
       {
       for (Page* page : pages())
             page->rebuildBspTree();
+      for (System* s : _systems)
+            s->newLayoutGeneration();
       }
 
 //---------------------------------------------------------
@@ -1174,6 +1178,7 @@ void Score::beamGraceNotes(Chord* mainNote, bool after)
 
 void Score::layoutSpanner()
       {
+      TRACE_SCOPE("layout", "layoutSpanner");
       int tracks = ntracks();
       for (int track = 0; track < tracks; ++track) {
             for (Segment* segment = firstSegment(SegmentType::All); segment; segment = segment->next1()) {
@@ -2290,6 +2295,7 @@ void layoutDrumsetChord(Chord* c, const Drumset* drumset, StaffType* st, qreal s
 
 void Score::getNextMeasure(LayoutContext& lc)
       {
+      TRACE_SCOPE("layout", "getNextMeasure");
       lc.prevMeasure = lc.curMeasure;
       lc.curMeasure  = lc.nextMeasure;
       if (!lc.curMeasure)
@@ -2710,7 +2716,7 @@ static void applyLyricsMax(Segment& s, int staffIdx, qreal yMax)
                               }
                         }
                   s.staffShape(staffIdx).add(sh);
-                  s.measure()->staffShape(staffIdx).add(sh.translated(s.pos()));
+                  s.measure()->staffShape(staffIdx).add(sh, s.pos());
                   }
             }
       }
@@ -2736,7 +2742,7 @@ static void applyLyricsMin(ChordRest* cr, int staffIdx, qreal yMin)
                   }
             }
       cr->segment()->staffShape(staffIdx).add(sh);
-      cr->measure()->staffShape(staffIdx).add(sh.translated(cr->pos() + cr->segment()->pos()));
+      cr->measure()->staffShape(staffIdx).add(sh, cr->pos() + cr->segment()->pos());
       }
 
 static void applyLyricsMin(Measure* m, int staffIdx, qreal yMin)
@@ -2764,7 +2770,7 @@ static void restoreBeams(Measure* m)
                         ChordRest* cr = toChordRest(e);
                         if (isTopBeam(cr)) {
                               cr->beam()->layout();
-                              s->staffShape(cr->staffIdx()).add(cr->beam()->shape().translated(-(cr->segment()->pos()+m->pos())));
+                              s->staffShape(cr->staffIdx()).add(cr->beam()->shape(), -(cr->segment()->pos()+m->pos()));
                               }
                         }
                   }
@@ -2780,6 +2786,7 @@ static void restoreBeams(Measure* m)
 
 void Score::layoutLyrics(System* system)
       {
+      TRACE_SCOPE("layout", "layoutLyrics");
       std::vector<int> visibleStaves;
       for (int staffIdx = system->firstVisibleStaff(); staffIdx < nstaves(); staffIdx = system->nextVisibleStaff(staffIdx))
             visibleStaves.push_back(staffIdx);
@@ -2937,7 +2944,7 @@ void processLines(System* system, std::vector<Spanner*> lines, bool align)
                   // spanner shape must be translated from system coordinate space
                   // to measure coordinate space
                   Shape* shape = &m->staffShape(ss->staffIdx());
-                  shape->add(ss->shape().translated(ss->pos() - m->pos()));
+                  shape->add(ss->shape(), ss->pos() - m->pos());
                   }
             }
       }
@@ -2948,6 +2955,7 @@ void processLines(System* system, std::vector<Spanner*> lines, bool align)
 
 System* Score::collectSystem(LayoutContext& lc)
       {
+      TRACE_SCOPE("layout", "collectSystem");
       if (!lc.curMeasure)
             return 0;
       Measure* measure  = _systems.empty() ? 0 : _systems.back()->lastMeasure();
@@ -2964,6 +2972,22 @@ System* Score::collectSystem(LayoutContext& lc)
       qreal systemWidth = styleD(Sid::pagePrintableWidth) * DPI;
       system->setWidth(systemWidth);
 
+      // with a valid layout cache the number of measures
+      // in this system is known in advance
+      int cachedMeasures = -1;
+      if (lc.cache) {
+            if (lc.cacheSystem < lc.cache->systems())
+                  cachedMeasures = lc.cache->measures(lc.cacheSystem);
+            else
+                  lc.cache = 0;
+            }
+      // where to start again if the cache does not match
+      MeasureBase* startPrevMeasure = lc.prevMeasure;
+      MeasureBase* startCurMeasure  = lc.curMeasure;
+      MeasureBase* startNextMeasure = lc.nextMeasure;
+      int startMeasureNo            = lc.measureNo;
+      bool startRangeDone           = lc.rangeDone;
+
       while (lc.curMeasure) {    // collect measure for system
             System* oldSystem = lc.curMeasure->system();
             system->appendMeasure(lc.curMeasure);
@@ -3009,12 +3033,17 @@ System* Score::collectSystem(LayoutContext& lc)
                   // vbox:
                   getNextMeasure(lc);
                   system->layout2();   // compute staff distances
+                  if (cachedMeasures != -1) {
+                        if (cachedMeasures != 1)
+                              lc.cache = 0;
+                        ++lc.cacheSystem;
+                        }
                   return system;
                   }
             // check if lc.curMeasure fits, remove if not
             // collect at least one measure and the break
 
-            bool doBreak = (system->measures().size() > 1) && ((minWidth + ww) > systemWidth);
+            bool doBreak = (cachedMeasures == -1) && (system->measures().size() > 1) && ((minWidth + ww) > systemWidth);
             if (doBreak) {
                   if (lc.prevMeasure->noBreak() && system->measures().size() > 2) {
                         // remove last two measures
@@ -3077,6 +3106,8 @@ System* Score::collectSystem(LayoutContext& lc)
                         lineBreak = false;
                         break;
                   }
+            if (cachedMeasures != -1 && int(system->measures().size()) >= cachedMeasures)
+                  lineBreak = true;
 
             getNextMeasure(lc);
 
@@ -3192,6 +3223,31 @@ System* Score::collectSystem(LayoutContext& lc)
             }
       system->setWidth(pos.x());
 
+      if (cachedMeasures != -1) {
+            // the result has to match the cached layout, otherwise
+            // the cache is ignored for the remaining systems
+            bool valid = int(system->measures().size()) == cachedMeasures;
+            for (int i = 0; valid && i < cachedMeasures; ++i)
+                  valid = qAbs(system->measures()[i]->width() - lc.cache->width(lc.cacheSystem, i)) < 0.01;
+            if (!valid) {
+                  // collect the system again without the cache
+                  qDebug("layout cache does not match at system %d", lc.cacheSystem);
+                  lc.cache = 0;
+                  _systems.removeOne(system);
+                  for (MeasureBase* mb : system->measures())
+                        mb->setSystem(0);
+                  system->clear();
+                  lc.systemList.prepend(system);
+                  lc.prevMeasure = startPrevMeasure;
+                  lc.curMeasure  = startCurMeasure;
+                  lc.nextMeasure = startNextMeasure;
+                  lc.measureNo   = startMeasureNo;
+                  lc.rangeDone   = startRangeDone;
+                  return collectSystem(lc);
+                  }
+            ++lc.cacheSystem;
+            }
+
       //
       // compute measure shape
       //
@@ -3256,7 +3312,7 @@ System* Score::collectSystem(LayoutContext& lc)
                                     cr->beam()->layout();
                                     Shape shape(cr->beam()->shape().translated(-(cr->segment()->pos()+mb->pos())));
                                     s->staffShape(cr->staffIdx()).add(shape);
-                                    m->staffShape(cr->staffIdx()).add(shape.translated(s->pos()));
+                                    m->staffShape(cr->staffIdx()).add(shape, s->pos());
                                     }
                               if (e->isChord()) {
                                     Chord* c = toChord(e);
@@ -3324,7 +3380,7 @@ System* Score::collectSystem(LayoutContext& lc)
                         while (de->tuplet() && de->tuplet()->elements().front() == de) {
                               Tuplet* t = de->tuplet();
                               t->layout();
-                              s->staffShape(t->staffIdx()).add(t->shape().translated(-s->pos()));
+                              s->staffShape(t->staffIdx()).add(t->shape(), -s->pos());
                               m->staffShape(t->staffIdx()).add(t->shape());
                               de = de->tuplet();
                               }
@@ -3336,9 +3392,9 @@ System* Score::collectSystem(LayoutContext& lc)
       for (Dynamic* d : dynamics) {
             int si = d->staffIdx();
             Segment* s = d->segment();
-            s->staffShape(si).add(d->shape().translated(d->pos()));
+            s->staffShape(si).add(d->shape(), d->pos());
             Measure* m = s->measure();
-            m->staffShape(si).add(d->shape().translated(s->pos() + d->pos()));
+            m->staffShape(si).add(d->shape(), s->pos() + d->pos());
             }
 
       //
@@ -3403,9 +3459,9 @@ System* Score::collectSystem(LayoutContext& lc)
                               // to measure coordinate space
                               Shape* shape = &m->staffShape(sp->staffIdx());
                               if (ss->isLyricsLineSegment())
-                                    shape->add(ss->shape().translated(-m->pos()));
+                                    shape->add(ss->shape(), -m->pos());
                               else
-                                    shape->add(ss->shape().translated(ss->pos() - m->pos()));
+                                    shape->add(ss->shape(), ss->pos() - m->pos());
                               }
                         }
                   }
@@ -3430,8 +3486,8 @@ System* Score::collectSystem(LayoutContext& lc)
                         else if (e->isFermata()) {
                               e->layout();
                               int si = e->staffIdx();
-                              s->staffShape(si).add(e->shape().translated(e->pos()));
-                              m->staffShape(si).add(e->shape().translated(s->pos() + e->pos()));
+                              s->staffShape(si).add(e->shape(), e->pos());
+                              m->staffShape(si).add(e->shape(), s->pos() + e->pos());
                               }
                         }
                   }
@@ -3496,6 +3552,7 @@ System* Score::collectSystem(LayoutContext& lc)
 
 void LayoutContext::collectPage()
       {
+      TRACE_SCOPE("layout", "collectPage");
       const qreal slb = score->styleP(Sid::staffLowerBorder);
       bool breakPages = score->layoutMode() != LayoutMode::SYSTEM;
       qreal y         = prevSystem ? prevSystem->y() + prevSystem->height() : page->tm();
@@ -3546,6 +3603,7 @@ void LayoutContext::collectPage()
                   }
 #endif
             page->appendSystem(curSystem);
+            ++cachePageSystem;
             y += curSystem->height();
 
             //
@@ -3579,6 +3637,7 @@ void LayoutContext::collectPage()
                         MasterScore* ms = static_cast<MasterScore*>(score)->next();
                         if (ms) {
                               score = ms;
+                              cache = 0;
                               QList<System*>& systems = ms->systems();
                               if (systems.empty() || systems.front()->measures().empty()) {
                                     systemList         = systems;
@@ -3609,7 +3668,9 @@ void LayoutContext::collectPage()
 
             bool breakPage = !curSystem || (breakPages && prevSystem->pageBreak());
 
-            if (!breakPage) {
+            if (!breakPage && cache && cachePageSystem <= cache->systems())
+                  breakPage = breakPages && cache->pageBreak(cachePageSystem - 1);
+            else if (!breakPage) {
                   qreal dist = prevSystem->minDistance(curSystem) + curSystem->height();
                   Box* vbox = curSystem->vbox();
                   if (vbox)
@@ -3682,7 +3743,12 @@ void LayoutContext::collectPage()
                   m->layout2();
                   }
             }
-      page->rebuildBspTree();
+      // systems before startTick are unchanged, unless they moved
+      page->invalidateBspTree(startTick, INT_MAX);
+      for (System* s : page->systems()) {
+            if (s->measures().empty() || s->measures().back()->endTick() > startTick)
+                  s->newLayoutGeneration();
+            }
       }
 
 //---------------------------------------------------------
@@ -3701,6 +3767,7 @@ void Score::doLayout()
 
 void Score::doLayoutRange(int stick, int etick)
       {
+      TRACE_SCOPE("layout", "doLayoutRange");
       if (stick == -1 && etick == -1)
             abort();
       if (!last()) {
@@ -3753,6 +3820,7 @@ void Score::doLayoutRange(int stick, int etick)
 
 //      qDebug("start <%s> tick %d, system %p", m->name(), m->tick(), m->system());
       lc.score        = m->score();
+      lc.startTick    = layoutAll ? 0 : m->tick();
 
       if (lineMode()) {
             layoutLinear(layoutAll, lc);
@@ -3822,6 +3890,12 @@ void Score::doLayoutRange(int stick, int etick)
             pages().clear();
 
             lc.nextMeasure = _measures.first();
+
+            if (isMaster()) {
+                  LayoutCache* cache = masterScore()->layoutCache();
+                  if (cache && cache->styleKey() == LayoutCache::styleKey(this))
+                        lc.cache = cache;
+                  }
             }
 
       lc.prevMeasure = 0;
@@ -3862,6 +3936,8 @@ void Score::doLayoutRange(int stick, int etick)
       lc.page->setPos(x, y);
 
       lc.layout();
+      TRACE_COUNTER("layout", "systems", _systems.size());
+      TRACE_COUNTER("layout", "pages", npages());
 
       for (MuseScoreView* v : viewer)
             v->layoutChanged();
@@ -3925,7 +4001,7 @@ void LayoutContext::layout()
       else {
             Page* p = curSystem->page();
             if (p && (p != page))
-                  p->rebuildBspTree();
+                  p->invalidateBspTree(startTick, INT_MAX);
             }
       score->systems().append(systemList);     // TODO
       }
@@ -17,6 +17,7 @@ namespace Ms {
 
 class Segment;
 class Page;
+class LayoutCache;
 
 //---------------------------------------------------------
 //   LayoutContext
@@ -44,8 +45,13 @@ struct LayoutContext {
       MeasureBase* curMeasure  { 0 };
       MeasureBase* nextMeasure { 0 };
       int measureNo            { 0 };
+      int startTick            { 0 };      // first measure laid out
       int endTick;
 
+      LayoutCache* cache       { 0 };     // system and page breaks from file
+      int cacheSystem          { 0 };     // next system to collect
+      int cachePageSystem      { 0 };     // number of systems placed on pages
+
       void layoutLinear();
       void layoutMeasureLinear(MeasureBase*);
 
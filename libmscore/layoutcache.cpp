@@ -0,0 +1,148 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2018 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "config.h"
+#include "layoutcache.h"
+#include "score.h"
+#include "system.h"
+#include "page.h"
+#include "style.h"
+#include "xml.h"
+
+namespace Ms {
+
+const char* LayoutCache::fileName = "Layout/layout.xml";
+
+//---------------------------------------------------------
+//   contentKey
+//---------------------------------------------------------
+
+QByteArray LayoutCache::contentKey(const QByteArray& scoreData)
+      {
+      return QCryptographicHash::hash(scoreData, QCryptographicHash::Sha1).toHex();
+      }
+
+//---------------------------------------------------------
+//   styleKey
+//    The complete style is hashed as the default values
+//    are not saved with the score and may differ between
+//    installations. So may the fonts the text style font
+//    faces resolve to, their metrics are hashed as well.
+//---------------------------------------------------------
+
+QByteArray LayoutCache::styleKey(Score* score)
+      {
+      QBuffer buffer;
+      buffer.open(QIODevice::WriteOnly);
+      XmlWriter xml(score, &buffer);
+      xml << VERSION << " " << MSCVERSION << "\n";
+      score->style().save(xml, false);
+
+      std::set<QString> faces { score->styleSt(Sid::MusicalTextFont) };
+      for (int i = 0; i < int(Tid::TEXT_STYLES); ++i) {
+            for (const StyledProperty& p : *textStyle(Tid(i))) {
+                  if (p.pid == Pid::FONT_FACE)
+                        faces.insert(score->styleSt(p.sid));
+                  }
+            }
+      for (const QString& face : faces) {
+            QFont font(face);
+            font.setPointSizeF(20.0);
+            QFontMetricsF fm(font);
+            xml << face << ": " << QFontInfo(font).family() << " " << fm.height() << " " << fm.averageCharWidth() << "\n";
+            }
+      xml.flush();
+      return QCryptographicHash::hash(buffer.data(), QCryptographicHash::Sha1).toHex();
+      }
+
+//---------------------------------------------------------
+//   create
+//    record the current page layout of score
+//---------------------------------------------------------
+
+void LayoutCache::create(Score* score, const QByteArray& key)
+      {
+      _key      = key;
+      _styleKey = styleKey(score);
+      _systems.clear();
+      for (System* system : score->systems()) {
+            SystemEntry se;
+            se.pageBreak = !system->page() || system->page()->systems().back() == system;
+            for (MeasureBase* mb : system->measures())
+                  se.widths.push_back(mb->width());
+            _systems.push_back(se);
+            }
+      }
+
+//---------------------------------------------------------
+//   write
+//---------------------------------------------------------
+
+void LayoutCache::write(XmlWriter& xml) const
+      {
+      xml.stag("LayoutCache");
+      xml.tag("key", QString(_key));
+      xml.tag("styleKey", QString(_styleKey));
+      const XmlWriter::Attributes pageBreak { { "pageBreak", "1" } };
+      for (const SystemEntry& se : _systems) {
+            QStringList sl;
+            for (qreal w : se.widths)
+                  sl.append(QString::number(w, 'f', 3));
+            if (se.pageBreak)
+                  xml.tag("System", pageBreak, sl.join(' '));
+            else
+                  xml.tag("System", sl.join(' '));
+            }
+      xml.etag();
+      }
+
+//---------------------------------------------------------
+//   read
+//    return false if the cache is unreadable
+//---------------------------------------------------------
+
+bool LayoutCache::read(XmlReader& e)
+      {
+      _systems.clear();
+      while (e.readNextStartElement()) {
+            if (e.name() != "LayoutCache") {
+                  e.skipCurrentElement();
+                  continue;
+                  }
+            while (e.readNextStartElement()) {
+                  const QStringRef& tag(e.name());
+                  if (tag == "key")
+                        _key = e.readElementText().toLatin1();
+                  else if (tag == "styleKey")
+                        _styleKey = e.readElementText().toLatin1();
+                  else if (tag == "System") {
+                        SystemEntry se;
+                        se.pageBreak = e.intAttribute("pageBreak", 0);
+                        for (const QString& s : e.readElementText().split(' ', QString::SkipEmptyParts)) {
+                              bool ok;
+                              se.widths.push_back(s.toDouble(&ok));
+                              if (!ok)
+                                    return false;
+                              }
+                        if (se.widths.empty())
+                              return false;
+                        _systems.push_back(se);
+                        }
+                  else
+                        e.unknown();
+                  }
+            }
+      return !e.hasError() && !_key.isEmpty() && !_systems.empty();
+      }
+
+}
+
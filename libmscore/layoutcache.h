@@ -0,0 +1,61 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2018 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __LAYOUTCACHE_H__
+#define __LAYOUTCACHE_H__
+
+namespace Ms {
+
+class Score;
+class XmlWriter;
+class XmlReader;
+
+//---------------------------------------------------------
+//   LayoutCache
+//    System and page breaks of a laid out score, saved
+//    in the .mscz container. It is only valid for the
+//    score content, style and program version it was
+//    created with.
+//---------------------------------------------------------
+
+class LayoutCache {
+      struct SystemEntry {
+            bool pageBreak;               // system is the last one on its page
+            std::vector<qreal> widths;    // width of every MeasureBase in the system
+            };
+
+      QByteArray _key;                    // hash of score file content
+      QByteArray _styleKey;               // hash of style and program version
+      std::vector<SystemEntry> _systems;
+
+   public:
+      static const char* fileName;
+
+      static QByteArray contentKey(const QByteArray& scoreData);
+      static QByteArray styleKey(Score*);
+
+      void create(Score*, const QByteArray& key);
+      void write(XmlWriter&) const;
+      bool read(XmlReader&);
+
+      const QByteArray& key() const       { return _key;      }
+      const QByteArray& styleKey() const  { return _styleKey; }
+
+      int systems() const                 { return int(_systems.size()); }
+      int measures(int systemIdx) const   { return int(_systems[systemIdx].widths.size()); }
+      bool pageBreak(int systemIdx) const { return _systems[systemIdx].pageBreak; }
+      qreal width(int systemIdx, int idx) const { return _systems[systemIdx].widths[idx]; }
+      };
+
+}     // namespace Ms
+#endif
+
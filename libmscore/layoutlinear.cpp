@@ -37,6 +37,7 @@
 #include "tempo.h"
 #include "fermata.h"
 #include "lyrics.h"
+#include "trace.h"
 
 namespace Ms {
 
@@ -54,6 +55,7 @@ void layoutDrumsetChord(Chord* c, const Drumset* drumset, StaffType* st, qreal s
 
 void Score::layoutLinear(bool layoutAll, LayoutContext& lc)
       {
+      TRACE_SCOPE("layout", "layoutLinear");
       Page* page;
       System* system;
 
@@ -61,10 +63,13 @@ void Score::layoutLinear(bool layoutAll, LayoutContext& lc)
       if (true) {
             qDeleteAll(systems());
             systems().clear();
-            qDeleteAll(pages());
-            pages().clear();
 
             page = new Page(this);
+            // keep the element trees of the measures not laid out again
+            if (!layoutAll && !pages().empty())
+                  page->adoptBspTree(pages().front());
+            qDeleteAll(pages());
+            pages().clear();
             pages().push_back(page);
             page->bbox().setRect(0.0, 0.0, loWidth(), loHeight());
             page->setNo(0);
@@ -476,7 +481,7 @@ void LayoutContext::layoutLinear()
       page->setPos(0, 0);
       system->setPos(page->lm(), page->tm() + score->styleP(Sid::staffUpperBorder));
       page->setWidth(system->width());
-      page->rebuildBspTree();
+      page->invalidateBspTree(startTick, endTick);
       }
 
 //---------------------------------------------------------
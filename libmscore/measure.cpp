@@ -1880,13 +1880,14 @@ void Measure::read(XmlReader& e, int staffIdx)
 
       while (e.readNextStartElement()) {
             const QStringRef& tag(e.name());
+            const XmlTag tid = e.tagId();
 
-            if (tag == "move")
+            if (tid == XmlTag::MOVE)
                   e.initTick(e.readFraction().ticks() + tick());
-            else if (tag == "tick") {
+            else if (tid == XmlTag::TICK) {
                   e.initTick(score()->fileDivision(e.readInt()));
                   }
-            else if (tag == "BarLine") {
+            else if (tid == XmlTag::BAR_LINE) {
                   BarLine* barLine = new BarLine(score());
                   barLine->setTrack(e.track());
                   barLine->read(e);
@@ -1917,7 +1918,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                         barLine->layout();
                         }
                   }
-            else if (tag == "Chord") {
+            else if (tid == XmlTag::CHORD) {
                   Chord* chord = new Chord(score());
                   chord->setTrack(e.track());
                   chord->read(e);
@@ -1936,7 +1937,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                         e.incTick(crticks);
                         }
                   }
-            else if (tag == "Rest") {
+            else if (tid == XmlTag::REST) {
                   Rest* rest = new Rest(score());
                   rest->setDurationType(TDuration::DurationType::V_MEASURE);
                   rest->setDuration(timesig()/timeStretch);
@@ -1950,7 +1951,7 @@ void Measure::read(XmlReader& e, int staffIdx)
 
                   e.incTick(rest->actualTicks());
                   }
-            else if (tag == "Breath") {
+            else if (tid == XmlTag::BREATH) {
                   Breath* breath = new Breath(score());
                   breath->setTrack(e.track());
                   int tick = e.tick();
@@ -1958,7 +1959,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                   segment = getSegment(SegmentType::Breath, tick);
                   segment->add(breath);
                   }
-            else if (tag == "endSpanner") {
+            else if (tid == XmlTag::END_SPANNER) {
                   int id = e.attribute("id").toInt();
                   Spanner* spanner = e.findSpanner(id);
                   if (spanner) {
@@ -1979,7 +1980,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                         }
                   e.readNext();
                   }
-            else if (tag == "Slur") {
+            else if (tid == XmlTag::SLUR) {
                   Slur *sl = new Slur(score());
                   sl->setTick(e.tick());
                   sl->read(e);
@@ -1994,15 +1995,15 @@ void Measure::read(XmlReader& e, int staffIdx)
                         }
                   score()->addSpanner(sl);
                   }
-            else if (tag == "HairPin"
-               || tag == "Pedal"
-               || tag == "Ottava"
-               || tag == "Trill"
-               || tag == "TextLine"
-               || tag == "LetRing"
-               || tag == "Vibrato"
-               || tag == "PalmMute"
-               || tag == "Volta") {
+            else if (tid == XmlTag::HAIR_PIN
+               || tid == XmlTag::PEDAL
+               || tid == XmlTag::OTTAVA
+               || tid == XmlTag::TRILL
+               || tid == XmlTag::TEXT_LINE
+               || tid == XmlTag::LET_RING
+               || tid == XmlTag::VIBRATO
+               || tid == XmlTag::PALM_MUTE
+               || tid == XmlTag::VOLTA) {
                   Spanner* sp = toSpanner(Element::name2Element(tag, score()));
                   sp->setTrack(e.track());
                   sp->setTick(e.tick());
@@ -2019,7 +2020,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                         sp->setTrack2(sv->track2);
                         }
                   }
-            else if (tag == "RepeatMeasure") {
+            else if (tid == XmlTag::REPEAT_MEASURE) {
                   RepeatMeasure* rm = new RepeatMeasure(score());
                   rm->setTrack(e.track());
                   rm->read(e);
@@ -2027,7 +2028,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                   segment->add(rm);
                   e.incTick(ticks());
                   }
-            else if (tag == "Clef") {
+            else if (tid == XmlTag::CLEF) {
                   Clef* clef = new Clef(score());
                   clef->setTrack(e.track());
                   clef->read(e);
@@ -2055,7 +2056,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                   segment = getSegment(header ? SegmentType::HeaderClef : SegmentType::Clef, e.tick());
                   segment->add(clef);
                   }
-            else if (tag == "TimeSig") {
+            else if (tid == XmlTag::TIME_SIG) {
                   TimeSig* ts = new TimeSig(score());
                   ts->setTrack(e.track());
                   ts->read(e);
@@ -2085,7 +2086,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                               }
                         }
                   }
-            else if (tag == "KeySig") {
+            else if (tid == XmlTag::KEY_SIG) {
                   KeySig* ks = new KeySig(score());
                   ks->setTrack(e.track());
                   ks->read(e);
@@ -2108,7 +2109,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                               staff->setKey(curTick, ks->keySigEvent());
                         }
                   }
-            else if (tag == "Text") {
+            else if (tid == XmlTag::TEXT) {
                   StaffText* t = new StaffText(score());
                   t->setTrack(e.track());
                   t->read(e);
@@ -2125,25 +2126,25 @@ void Measure::read(XmlReader& e, int staffIdx)
             //----------------------------------------------------
             // Annotation
 
-            else if (tag == "Dynamic") {
+            else if (tid == XmlTag::DYNAMIC) {
                   Dynamic* dyn = new Dynamic(score());
                   dyn->setTrack(e.track());
                   dyn->read(e);
                   segment = getSegment(SegmentType::ChordRest, e.tick());
                   segment->add(dyn);
                   }
-            else if (tag == "Harmony"
-               || tag == "FretDiagram"
-               || tag == "TremoloBar"
-               || tag == "Symbol"
-               || tag == "Tempo"
-               || tag == "StaffText"
-               || tag == "SystemText"
-               || tag == "RehearsalMark"
-               || tag == "InstrumentChange"
-               || tag == "StaffState"
-               || tag == "FiguredBass"
-               || tag == "Fermata"
+            else if (tid == XmlTag::HARMONY
+               || tid == XmlTag::FRET_DIAGRAM
+               || tid == XmlTag::TREMOLO_BAR
+               || tid == XmlTag::SYMBOL
+               || tid == XmlTag::TEMPO
+               || tid == XmlTag::STAFF_TEXT
+               || tid == XmlTag::SYSTEM_TEXT
+               || tid == XmlTag::REHEARSAL_MARK
+               || tid == XmlTag::INSTRUMENT_CHANGE
+               || tid == XmlTag::STAFF_STATE
+               || tid == XmlTag::FIGURED_BASS
+               || tid == XmlTag::FERMATA
                ) {
                   Element* el = Element::name2Element(tag, score());
                   // hack - needed because tick tags are unreliable in 1.3 scores
@@ -2153,14 +2154,14 @@ void Measure::read(XmlReader& e, int staffIdx)
                   segment = getSegment(SegmentType::ChordRest, e.tick());
                   segment->add(el);
                   }
-            else if (tag == "Marker" || tag == "Jump"
+            else if (tid == XmlTag::MARKER || tid == XmlTag::JUMP
                ) {
                   Element* el = Element::name2Element(tag, score());
                   el->setTrack(e.track());
                   el->read(e);
                   add(el);
                   }
-            else if (tag == "Image") {
+            else if (tid == XmlTag::IMAGE) {
                   if (MScore::noImages)
                         e.skipCurrentElement();
                   else {
@@ -2172,21 +2173,21 @@ void Measure::read(XmlReader& e, int staffIdx)
                         }
                   }
             //----------------------------------------------------
-            else if (tag == "stretch") {
+            else if (tid == XmlTag::STRETCH) {
                   double val = e.readDouble();
                   if (val < 0.0)
                         val = 0;
                   setUserStretch(val);
                   }
-            else if (tag == "noOffset")
+            else if (tid == XmlTag::NO_OFFSET)
                   setNoOffset(e.readInt());
-            else if (tag == "measureNumberMode")
+            else if (tid == XmlTag::MEASURE_NUMBER_MODE)
                   setMeasureNumberMode(MeasureNumberMode(e.readInt()));
-            else if (tag == "irregular")
+            else if (tid == XmlTag::IRREGULAR)
                   setIrregular(e.readBool());
-            else if (tag == "breakMultiMeasureRest")
+            else if (tid == XmlTag::BREAK_MULTI_MEASURE_REST)
                   _breakMultiMeasureRest = e.readBool();
-            else if (tag == "sysInitBarLineType") {
+            else if (tid == XmlTag::SYS_INIT_BAR_LINE_TYPE) {
                   const QString& val(e.readElementText());
                   BarLine* barLine = new BarLine(score());
                   barLine->setTrack(e.track());
@@ -2194,7 +2195,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                   segment = getSegmentR(SegmentType::BeginBarLine, 0);
                   segment->add(barLine);
                   }
-            else if (tag == "Tuplet") {
+            else if (tid == XmlTag::TUPLET) {
                   Tuplet* tuplet = new Tuplet(score());
                   tuplet->setTrack(e.track());
                   tuplet->setTick(e.tick());
@@ -2202,15 +2203,15 @@ void Measure::read(XmlReader& e, int staffIdx)
                   tuplet->read(e);
                   e.addTuplet(tuplet);
                   }
-            else if (tag == "startRepeat") {
+            else if (tid == XmlTag::START_REPEAT) {
                   setRepeatStart(true);
                   e.readNext();
                   }
-            else if (tag == "endRepeat") {
+            else if (tid == XmlTag::END_REPEAT) {
                   _repeatCount = e.readInt();
                   setRepeatEnd(true);
                   }
-            else if (tag == "vspacer" || tag == "vspacerDown") {
+            else if (tid == XmlTag::VSPACER || tid == XmlTag::VSPACER_DOWN) {
                   if (!_mstaves[staffIdx]->vspacerDown()) {
                         Spacer* spacer = new Spacer(score());
                         spacer->setSpacerType(SpacerType::DOWN);
@@ -2219,7 +2220,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                         }
                   _mstaves[staffIdx]->vspacerDown()->setGap(e.readDouble() * _spatium);
                   }
-            else if (tag == "vspacerFixed") {
+            else if (tid == XmlTag::VSPACER_FIXED) {
                   if (!_mstaves[staffIdx]->vspacerDown()) {
                         Spacer* spacer = new Spacer(score());
                         spacer->setSpacerType(SpacerType::FIXED);
@@ -2228,7 +2229,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                         }
                   _mstaves[staffIdx]->vspacerDown()->setGap(e.readDouble() * _spatium);
                   }
-            else if (tag == "vspacerUp") {
+            else if (tid == XmlTag::VSPACER_UP) {
                   if (!_mstaves[staffIdx]->vspacerUp()) {
                         Spacer* spacer = new Spacer(score());
                         spacer->setSpacerType(SpacerType::UP);
@@ -2237,20 +2238,20 @@ void Measure::read(XmlReader& e, int staffIdx)
                         }
                   _mstaves[staffIdx]->vspacerUp()->setGap(e.readDouble() * _spatium);
                   }
-            else if (tag == "visible")
+            else if (tid == XmlTag::VISIBLE)
                   _mstaves[staffIdx]->setVisible(e.readInt());
-            else if (tag == "slashStyle")
+            else if (tid == XmlTag::SLASH_STYLE)
                   _mstaves[staffIdx]->setSlashStyle(e.readInt());
-            else if (tag == "Beam") {
+            else if (tid == XmlTag::BEAM) {
                   Beam* beam = new Beam(score());
                   beam->setTrack(e.track());
                   beam->read(e);
                   beam->setParent(0);
                   e.addBeam(beam);
                   }
-            else if (tag == "Segment")
+            else if (tid == XmlTag::SEGMENT)
                   segment->read(e);
-            else if (tag == "MeasureNumber") {
+            else if (tid == XmlTag::MEASURE_NUMBER) {
                   Text* noText = new Text(score(), Tid::MEASURE_NUMBER);
                   noText->read(e);
                   noText->setFlag(ElementFlag::ON_STAFF, true);
@@ -2258,12 +2259,12 @@ void Measure::read(XmlReader& e, int staffIdx)
                   noText->setParent(this);
                   _mstaves[noText->staffIdx()]->setNoText(noText);
                   }
-            else if (tag == "SystemDivider") {
+            else if (tid == XmlTag::SYSTEM_DIVIDER) {
                   SystemDivider* sd = new SystemDivider(score());
                   sd->read(e);
                   add(sd);
                   }
-            else if (tag == "Ambitus") {
+            else if (tid == XmlTag::AMBITUS) {
                   Ambitus* range = new Ambitus(score());
                   range->read(e);
                   segment = getSegment(SegmentType::Ambitus, e.tick());
@@ -2271,7 +2272,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                   range->setTrack(trackZeroVoice(e.track()));
                   segment->add(range);
                   }
-            else if (tag == "multiMeasureRest") {
+            else if (tid == XmlTag::MULTI_MEASURE_REST) {
                   _mmRestCount = e.readInt();
                   // set tick to previous measure
                   setTick(e.lastMeasure()->tick());
@@ -0,0 +1,159 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2018 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <cstddef>
+#include "mempool.h"
+#include "mscore.h"
+#include "trace.h"
+
+namespace Ms {
+
+static const size_t CHUNK_SIZE = 64 * 1024;
+
+static QMutex poolsMutex;
+
+//---------------------------------------------------------
+//   allPools
+//    never freed, elements may be deleted after main()
+//---------------------------------------------------------
+
+static std::vector<MemoryPool*>& allPools()
+      {
+      static std::vector<MemoryPool*>* pools = new std::vector<MemoryPool*>;
+      return *pools;
+      }
+
+//---------------------------------------------------------
+//   MemoryPool
+//---------------------------------------------------------
+
+MemoryPool::MemoryPool(const char* name, size_t size)
+   : _name(name), _objectSize(size)
+      {
+      // keep every slot aligned like memory from operator new
+      const size_t align = alignof(std::max_align_t);
+      _size = (qMax(size, sizeof(void*)) + align - 1) / align * align;
+      QMutexLocker lock(&poolsMutex);
+      allPools().push_back(this);
+      }
+
+//---------------------------------------------------------
+//   alloc
+//---------------------------------------------------------
+
+void* MemoryPool::alloc(size_t size)
+      {
+      if (size != _objectSize)
+            return ::operator new(size);
+      QMutexLocker lock(&_mutex);
+      ++_allocs;
+#ifdef MSCORE_NO_MEMORY_POOLS
+      lock.unlock();
+      return ::operator new(size);
+#endif
+      if (_free) {
+            void* p = _free;
+            _free = *static_cast<void**>(p);
+            return p;
+            }
+      if (_next == _end) {
+            const size_t n = qMax(CHUNK_SIZE / _size, size_t(16));
+            _next = static_cast<char*>(::operator new(n * _size));
+            _end  = _next + n * _size;
+            ++_chunks;
+            }
+      void* p = _next;
+      _next += _size;
+      return p;
+      }
+
+//---------------------------------------------------------
+//   free
+//---------------------------------------------------------
+
+void MemoryPool::free(void* p, size_t size)
+      {
+      if (!p)
+            return;
+      if (size != _objectSize) {
+            ::operator delete(p);
+            return;
+            }
+      QMutexLocker lock(&_mutex);
+      ++_frees;
+#ifdef MSCORE_NO_MEMORY_POOLS
+      lock.unlock();
+      ::operator delete(p);
+      return;
+#endif
+      *static_cast<void**>(p) = _free;
+      _free = p;
+      }
+
+//---------------------------------------------------------
+//   allocs
+//---------------------------------------------------------
+
+qint64 MemoryPool::allocs()
+      {
+      QMutexLocker lock(&_mutex);
+      return _allocs;
+      }
+
+//---------------------------------------------------------
+//   frees
+//---------------------------------------------------------
+
+qint64 MemoryPool::frees()
+      {
+      QMutexLocker lock(&_mutex);
+      return _frees;
+      }
+
+//---------------------------------------------------------
+//   pools
+//---------------------------------------------------------
+
+const std::vector<MemoryPool*>& MemoryPool::pools()
+      {
+      return allPools();
+      }
+
+//---------------------------------------------------------
+//   report
+//    the number of objects in use as trace counters and,
+//    in debug builds with -d, the allocations since the
+//    last report
+//---------------------------------------------------------
+
+void MemoryPool::report(const char* operation)
+      {
+      QMutexLocker l(&poolsMutex);
+      for (MemoryPool* pool : allPools()) {
+            QMutexLocker lock(&pool->_mutex);
+            TRACE_COUNTER("memory", pool->_name, pool->_allocs - pool->_frees);
+#ifndef NDEBUG
+            if (MScore::debugMode && (pool->_allocs != pool->_reportedAllocs || pool->_frees != pool->_reportedFrees)) {
+                  qDebug("%s: %-8s new %lld delete %lld, in use %lld in %d chunks",
+                     operation, pool->_name,
+                     pool->_allocs - pool->_reportedAllocs, pool->_frees - pool->_reportedFrees,
+                     pool->_allocs - pool->_frees, pool->_chunks);
+                  }
+#else
+            Q_UNUSED(operation);
+#endif
+            pool->_reportedAllocs = pool->_allocs;
+            pool->_reportedFrees  = pool->_frees;
+            }
+      }
+
+}     // namespace Ms
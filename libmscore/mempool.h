@@ -0,0 +1,83 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2018 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __MEMPOOL_H__
+#define __MEMPOOL_H__
+
+#include "config.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   MemoryPool
+//    allocates the objects of one class from large chunks,
+//    deleted objects are kept on a free list for reuse.
+//    Objects of a derived class with a different size are
+//    allocated with the global operator new.
+//    Chunks are never returned, a pool lives as long as
+//    the process.
+//    Built with MSCORE_NO_MEMORY_POOLS every object comes
+//    from the global operator new, so ASan and valgrind
+//    see each allocation. The counters still work.
+//---------------------------------------------------------
+
+class MemoryPool {
+      const char* _name;
+      size_t _size;                 // slot size
+      size_t _objectSize;
+      QMutex _mutex;
+      void* _free      { 0 };       // free list, linked through the first word of a slot
+      char* _next      { 0 };       // unused part of the last chunk
+      char* _end       { 0 };
+      int _chunks      { 0 };
+
+      qint64 _allocs   { 0 };
+      qint64 _frees    { 0 };
+      qint64 _reportedAllocs { 0 };
+      qint64 _reportedFrees  { 0 };
+
+   public:
+      MemoryPool(const char* name, size_t size);
+
+      void* alloc(size_t size);
+      void free(void* p, size_t size);
+
+      const char* name() const { return _name; }
+      qint64 allocs();
+      qint64 frees();
+      qint64 inUse()           { return allocs() - frees(); }
+
+      static const std::vector<MemoryPool*>& pools();
+      static void report(const char* operation);
+      };
+
+//---------------------------------------------------------
+//   DECLARE_MEMORY_POOL
+//    in the class declaration, DEFINE_MEMORY_POOL(class)
+//    in its .cpp file
+//---------------------------------------------------------
+
+#define DECLARE_MEMORY_POOL \
+   public: \
+      static MemoryPool* pool(); \
+      static void* operator new(size_t size)            { return pool()->alloc(size); } \
+      static void operator delete(void* p, size_t size) { pool()->free(p, size); }
+
+#define DEFINE_MEMORY_POOL(T) \
+      MemoryPool* T::pool() \
+            { \
+            static MemoryPool* p = new MemoryPool(#T, sizeof(T)); \
+            return p; \
+            }
+
+}     // namespace Ms
+#endif
@@ -109,10 +109,12 @@ int     MScore::mtcType;
 
 bool    MScore::noExcerpts = false;
 bool    MScore::noImages = false;
-bool    MScore::pdfPrinting = false;
-bool    MScore::svgPrinting = false;
+bool    MScore::layoutCache = false;
+thread_local bool    MScore::pdfPrinting = false;
+thread_local bool    MScore::svgPrinting = false;
 
-double  MScore::pixelRatio  = 0.8;        // DPI / logicalDPI
+double  MScore::defaultPixelRatio = 0.8;                // DPI / logicalDPI
+thread_local double  MScore::pixelRatio = MScore::defaultPixelRatio;
 
 MPaintDevice* MScore::_paintDevice;
 
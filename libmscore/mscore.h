@@ -386,10 +386,14 @@ class MScore : public QObject {
 
       static bool noExcerpts;
       static bool noImages;
-
-      static bool pdfPrinting;
-      static bool svgPrinting;
-      static double pixelRatio;
+      static bool layoutCache;            // save page layout in .mscz files and reuse it on load
+
+      // set while exporting, per thread as the converter
+      // reads and lays out scores on worker threads
+      static thread_local bool pdfPrinting;
+      static thread_local bool svgPrinting;
+      static double defaultPixelRatio;    // set at startup, the pixelRatio every thread starts with
+      static thread_local double pixelRatio;
 
       static qreal verticalPageGap;
       static qreal horizontalPageGapEven;
@@ -58,6 +58,8 @@
 
 namespace Ms {
 
+DEFINE_MEMORY_POOL(Note)
+
 //---------------------------------------------------------
 //   noteHeads
 //    notehead groups
@@ -1306,22 +1308,23 @@ void Note::read(XmlReader& e)
 bool Note::readProperties(XmlReader& e)
       {
       const QStringRef& tag(e.name());
+      const XmlTag tid = e.tagId();
 
-      if (tag == "pitch")
+      if (tid == XmlTag::PITCH)
             _pitch = e.readInt();
-      else if (tag == "tpc") {
+      else if (tid == XmlTag::TPC) {
             _tpc[0] = e.readInt();
             _tpc[1] = _tpc[0];
             }
-      else if (tag == "track")            // for performance
+      else if (tid == XmlTag::TRACK)            // for performance
             setTrack(e.readInt());
-      else if (tag == "Accidental") {
+      else if (tid == XmlTag::ACCIDENTAL) {
             Accidental* a = new Accidental(score());
             a->setTrack(track());
             a->read(e);
             add(a);
             }
-      else if (tag == "Tie") {
+      else if (tid == XmlTag::TIE) {
             Tie* tie = new Tie(score());
             tie->setParent(this);
             tie->setTrack(track());
@@ -1329,50 +1332,50 @@ bool Note::readProperties(XmlReader& e)
             tie->setStartNote(this);
             _tieFor = tie;
             }
-      else if (tag == "tpc2")
+      else if (tid == XmlTag::TPC2)
             _tpc[1] = e.readInt();
-      else if (tag == "small")
+      else if (tid == XmlTag::SMALL)
             setSmall(e.readInt());
-      else if (tag == "mirror")
+      else if (tid == XmlTag::MIRROR)
             setProperty(Pid::MIRROR_HEAD, Ms::getProperty(Pid::MIRROR_HEAD, e));
-      else if (tag == "dotPosition")
+      else if (tid == XmlTag::DOT_POSITION)
             setProperty(Pid::DOT_POSITION, Ms::getProperty(Pid::DOT_POSITION, e));
-      else if (tag == "fixed")
+      else if (tid == XmlTag::FIXED)
             setFixed(e.readBool());
-      else if (tag == "fixedLine")
+      else if (tid == XmlTag::FIXED_LINE)
             setFixedLine(e.readInt());
-      else if (tag == "head")
+      else if (tid == XmlTag::HEAD)
             setProperty(Pid::HEAD_GROUP, Ms::getProperty(Pid::HEAD_GROUP, e));
-      else if (tag == "velocity")
+      else if (tid == XmlTag::VELOCITY)
             setVeloOffset(e.readInt());
-      else if (tag == "play")
+      else if (tid == XmlTag::PLAY)
             setPlay(e.readInt());
-      else if (tag == "tuning")
+      else if (tid == XmlTag::TUNING)
             setTuning(e.readDouble());
-      else if (tag == "fret")
+      else if (tid == XmlTag::FRET)
             setFret(e.readInt());
-      else if (tag == "string")
+      else if (tid == XmlTag::STRING)
             setString(e.readInt());
-      else if (tag == "ghost")
+      else if (tid == XmlTag::GHOST)
             setGhost(e.readInt());
-      else if (tag == "headType")
+      else if (tid == XmlTag::HEAD_TYPE)
             setProperty(Pid::HEAD_TYPE, Ms::getProperty(Pid::HEAD_TYPE, e));
-      else if (tag == "veloType")
+      else if (tid == XmlTag::VELO_TYPE)
             setProperty(Pid::VELO_TYPE, Ms::getProperty(Pid::VELO_TYPE, e));
-      else if (tag == "line")
+      else if (tid == XmlTag::LINE)
             setLine(e.readInt());
-      else if (tag == "Fingering") {
+      else if (tid == XmlTag::FINGERING) {
             Fingering* f = new Fingering(score());
             f->read(e);
             add(f);
             }
-      else if (tag == "Symbol") {
+      else if (tid == XmlTag::SYMBOL) {
             Symbol* s = new Symbol(score());
             s->setTrack(track());
             s->read(e);
             add(s);
             }
-      else if (tag == "Image") {
+      else if (tid == XmlTag::IMAGE) {
             if (MScore::noImages)
                   e.skipCurrentElement();
             else {
@@ -1382,22 +1385,21 @@ bool Note::readProperties(XmlReader& e)
                   add(image);
                   }
             }
-      else if (tag == "Bend") {
+      else if (tid == XmlTag::BEND) {
             Bend* b = new Bend(score());
             b->setTrack(track());
             b->read(e);
             add(b);
             }
-      else if (tag == "NoteDot") {
+      else if (tid == XmlTag::NOTE_DOT) {
             NoteDot* dot = new NoteDot(score());
             dot->read(e);
             add(dot);
             }
-      else if (tag == "Events") {
+      else if (tid == XmlTag::EVENTS) {
             _playEvents.clear();    // remove default event
             while (e.readNextStartElement()) {
-                  const QStringRef& tag(e.name());
-                  if (tag == "Event") {
+                  if (e.tagId() == XmlTag::EVENT) {
                         NoteEvent ne;
                         ne.read(e);
                         _playEvents.append(ne);
@@ -1408,7 +1410,7 @@ bool Note::readProperties(XmlReader& e)
             if (chord())
                   chord()->setPlayEventType(PlayEventType::User);
             }
-      else if (tag == "endSpanner") {
+      else if (tid == XmlTag::END_SPANNER) {
             int id = e.intAttribute("id");
             Spanner* sp = e.findSpanner(id);
             if (sp) {
@@ -1445,8 +1447,8 @@ bool Note::readProperties(XmlReader& e)
                   }
             e.readNext();
             }
-      else if (tag == "TextLine"
-            || tag == "Glissando") {
+      else if (tid == XmlTag::TEXT_LINE
+            || tid == XmlTag::GLISSANDO) {
             Spanner* sp = toSpanner(Element::name2Element(tag, score()));
             // check this is not a lower-to-higher cross-staff spanner we already got
             int id = e.intAttribute("id");
@@ -1481,7 +1483,7 @@ bool Note::readProperties(XmlReader& e)
                   sp->setParent(this);
                   }
             }
-      else if (tag == "offset")
+      else if (tid == XmlTag::OFFSET)
             Element::readProperties(e);
       else if (Element::readProperties(e))
             ;
@@ -25,6 +25,7 @@
 #include "shape.h"
 #include "tremolo.h"
 #include "key.h"
+#include "mempool.h"
 
 namespace Ms {
 
@@ -270,6 +271,8 @@ class Note final : public Element {
       bool isNoteName() const;
       SymId noteHead() const;
 
+      DECLARE_MEMORY_POOL
+
    public:
       Note(Score* s = 0);
       Note(const Note&, bool link = false);
@@ -20,6 +20,8 @@
 
 namespace Ms {
 
+DEFINE_MEMORY_POOL(NoteDot)
+
 //---------------------------------------------------------
 //   NoteDot
 //---------------------------------------------------------
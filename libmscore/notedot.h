@@ -14,6 +14,7 @@
 #define __NOTEDOT_H__
 
 #include "element.h"
+#include "mempool.h"
 
 namespace Ms {
 
@@ -26,6 +27,8 @@ class Rest;
 
 class NoteDot final : public Element {
 
+      DECLARE_MEMORY_POOL
+
    public:
       NoteDot(Score* = 0);
       virtual NoteDot* clone() const override     { return new NoteDot(*this); }
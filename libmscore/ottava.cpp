@@ -360,11 +360,13 @@ bool Ottava::setProperty(Pid propertyId, const QVariant& val)
                   break;
 
             case Pid::SPANNER_TICKS:
+                  triggerLayout();        // the old range changes pitch too
                   setTicks(val.toInt());
                   staff()->updateOttava();
                   break;
 
             case Pid::SPANNER_TICK:
+                  triggerLayout();        // the old range changes pitch too
                   setTick(val.toInt());
                   staff()->updateOttava();
                   break;
@@ -55,7 +55,10 @@ static const ElementStyle footerStyle {
 Page::Page(Score* s)
    : Element(s, ElementFlag::NOT_SELECTABLE), _no(0)
       {
-      bspTreeValid = false;
+      bspTreeValid  = false;
+      bspKeepBlocks = false;
+      bspStartTick  = 0;
+      bspEndTick    = 0;
       }
 
 Page::~Page()
@@ -71,7 +74,11 @@ QList<Element*> Page::items(const QRectF& r)
 #ifdef USE_BSP
       if (!bspTreeValid)
             doRebuildBspTree();
-      QList<Element*> el = bspTree.items(r);
+      QList<Element*> el = bspPageBlock.tree.items(r);
+      for (BspBlock& b : bspBlocks) {
+            if (b.rect.intersects(r))
+                  el.append(b.tree.items(r));
+            }
       return el;
 #else
       Q_UNUSED(r)
@@ -84,7 +91,12 @@ QList<Element*> Page::items(const QPointF& p)
 #ifdef USE_BSP
       if (!bspTreeValid)
             doRebuildBspTree();
-      return bspTree.items(p);
+      QList<Element*> el = bspPageBlock.tree.items(p);
+      for (BspBlock& b : bspBlocks) {
+            if (b.rect.contains(p))
+                  el.append(b.tree.items(p));
+            }
+      return el;
 #else
       Q_UNUSED(p)
       return QList<Element*>();
@@ -232,49 +244,215 @@ void Page::scanElements(void* data, void (*func)(void*, Element*), bool all)
       func(data, this);
       }
 
+//---------------------------------------------------------
+//   invalidateBspTree
+//    the measures from stick to etick were laid out again
+//---------------------------------------------------------
+
+void Page::invalidateBspTree(int stick, int etick)
+      {
+      if (bspTreeValid) {
+            bspKeepBlocks = true;
+            bspStartTick  = stick;
+            bspEndTick    = etick;
+            }
+      else if (bspKeepBlocks) {
+            bspStartTick = qMin(bspStartTick, stick);
+            bspEndTick   = qMax(bspEndTick, etick);
+            }
+      bspTreeValid = false;
+      }
+
+//---------------------------------------------------------
+//   adoptBspTree
+//    take over the blocks of page, which is replaced by
+//    this page
+//---------------------------------------------------------
+
+void Page::adoptBspTree(Page* page)
+      {
 #ifdef USE_BSP
+      bspBlocks     = std::move(page->bspBlocks);
+      bspKeepBlocks = page->bspTreeValid || page->bspKeepBlocks;
+      bspStartTick  = page->bspTreeValid ? INT_MAX : page->bspStartTick;
+      bspEndTick    = page->bspTreeValid ? -1 : page->bspEndTick;
+      bspTreeValid  = false;
+      page->bspBlocks.clear();
+      page->rebuildBspTree();
+#else
+      Q_UNUSED(page)
+#endif
+      }
+
 //---------------------------------------------------------
-//   bspInsert
+//   moveBspItem
+//    e was moved from oldRect without a layout
 //---------------------------------------------------------
 
-static void bspInsert(void* bspTree, Element* e)
+void Page::moveBspItem(Element* e, const QRectF& oldRect)
       {
-      ((BspTree*) bspTree)->insert(e);
+      // the system looks different now, see TileCache
+      for (Element* p = e->parent(); p; p = p->parent()) {
+            if (p->isSystem()) {
+                  toSystem(p)->newLayoutGeneration();
+                  break;
+                  }
+            }
+#ifdef USE_BSP
+      if (!bspTreeValid)            // tree is rebuilt anyway
+            return;
+      if (bspPageBlock.tree.move(e, oldRect)) {
+            bspPageBlock.rect |= e->pageBoundingRect();
+            return;
+            }
+      for (BspBlock& b : bspBlocks) {
+            if (b.rect.intersects(oldRect) && b.tree.move(e, oldRect)) {
+                  b.rect |= e->pageBoundingRect();
+                  return;
+                  }
+            }
+#else
+      Q_UNUSED(oldRect)
+#endif
+      rebuildBspTree();
       }
 
-static void countElements(void* data, Element* /*e*/)
+//---------------------------------------------------------
+//   bspItems
+//    e and the elements it reports in scanElements, which
+//    all move with it, with their current page rects
+//---------------------------------------------------------
+
+static void collectBspItem(void* data, Element* e)
       {
-      ++(*(int*)data);
+      ((std::vector<std::pair<Element*, QRectF>>*) data)->push_back({ e, e->pageBoundingRect() });
+      }
+
+std::vector<std::pair<Element*, QRectF>> Page::bspItems(Element* e)
+      {
+      std::vector<std::pair<Element*, QRectF>> items;
+      e->scanElements(&items, collectBspItem, false);
+      return items;
+      }
+
+//---------------------------------------------------------
+//   moveBspItems
+//    the elements of oldItems were moved from their rects
+//    without a layout
+//---------------------------------------------------------
+
+void Page::moveBspItems(const std::vector<std::pair<Element*, QRectF>>& oldItems)
+      {
+      for (const auto& i : oldItems)
+            moveBspItem(i.first, i.second);
+      }
+
+#ifdef USE_BSP
+static const int BSP_BLOCK_MEASURES = 16;
+
+//---------------------------------------------------------
+//   bspCollect
+//---------------------------------------------------------
+
+static void bspCollect(void* data, Element* e)
+      {
+      ((std::vector<Element*>*) data)->push_back(e);
+      }
+
+//---------------------------------------------------------
+//   blockGeometry
+//    everything the page position of the elements of the
+//    measures depends on, besides the measures themselves
+//---------------------------------------------------------
+
+static QVector<qreal> blockGeometry(System* system, const std::vector<MeasureBase*>& measures)
+      {
+      QVector<qreal> g;
+      g.reserve(2 + system->staves()->size() * 2 + int(measures.size()) * 3);
+      g.append(system->x());
+      g.append(system->y());
+      for (const SysStaff* st : *system->staves()) {
+            g.append(st->y());
+            g.append(st->show());
+            }
+      for (const MeasureBase* mb : measures) {
+            g.append(mb->x());
+            g.append(mb->y());
+            g.append(mb->width());
+            }
+      return g;
+      }
+
+//---------------------------------------------------------
+//   buildBspBlock
+//    scan the measures of b, or the page and system
+//    elements for system 0
+//---------------------------------------------------------
+
+void Page::buildBspBlock(BspBlock& b, System* system)
+      {
+      std::vector<Element*> el;
+      if (system) {
+            for (MeasureBase* mb : b.measures)
+                  mb->scanElements(&el, bspCollect, false);
+            }
+      else {
+            for (System* s : _systems)
+                  s->scanElements(&el, bspCollect, false);
+            bspCollect(&el, this);
+            }
+      b.rect = QRectF();
+      for (Element* e : el)
+            b.rect |= e->pageBoundingRect();
+      b.tree.initialize(b.rect, int(el.size()));
+      for (Element* e : el)
+            b.tree.insert(e);
       }
 
 //---------------------------------------------------------
 //   doRebuildBspTree
+//    The elements are split into blocks of measures, so a
+//    layout of a range of measures only rebuilds the blocks
+//    of that range and those that moved. In continuous view
+//    the page is the whole score.
 //---------------------------------------------------------
 
 void Page::doRebuildBspTree()
       {
-      int n = 0;
-      scanElements(&n, countElements, false);
-
-      QRectF r;
-      if (score()->layoutMode() == LayoutMode::LINE) {
-            qreal w = 0.0;
-            qreal h = 0.0;
-            if (!_systems.empty()) {
-                  h = _systems.front()->height();
-                  if (!_systems.front()->measures().empty()) {
-                        MeasureBase* mb = _systems.front()->measures().back();
-                        w = mb->x() + mb->width();
+      std::vector<BspBlock> old;
+      if (bspKeepBlocks)
+            old.swap(bspBlocks);
+      bspBlocks.clear();
+
+      // only the pointers of the old blocks are used, their
+      // measures may be gone
+      QHash<MeasureBase*, int> oldIndex;
+      for (int i = 0; i < int(old.size()); ++i)
+            oldIndex.insert(old[i].measures.front(), i);
+
+      for (System* s : _systems) {
+            const std::vector<MeasureBase*>& ml = s->measures();
+            for (size_t i = 0; i < ml.size(); i += BSP_BLOCK_MEASURES) {
+                  BspBlock b;
+                  b.measures.assign(ml.begin() + i, ml.begin() + qMin(i + BSP_BLOCK_MEASURES, ml.size()));
+                  b.geometry = blockGeometry(s, b.measures);
+                  bool dirty = b.measures.front()->tick() <= bspEndTick
+                     && b.measures.back()->endTick() >= bspStartTick;
+                  auto oi = oldIndex.find(b.measures.front());
+                  if (!dirty && oi != oldIndex.end()) {
+                        BspBlock& ob = old[oi.value()];
+                        if (ob.measures == b.measures && ob.geometry == b.geometry) {
+                              bspBlocks.push_back(std::move(ob));
+                              continue;
+                              }
                         }
+                  buildBspBlock(b, s);
+                  bspBlocks.push_back(std::move(b));
                   }
-            r = QRectF(0.0, 0.0, w, h);
             }
-      else
-            r = abbox();
-
-      bspTree.initialize(r, n);
-      scanElements(&bspTree, &bspInsert, false);
-      bspTreeValid = true;
+      buildBspBlock(bspPageBlock, 0);
+      bspTreeValid  = true;
+      bspKeepBlocks = false;
       }
 #endif
 
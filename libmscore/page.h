@@ -35,10 +35,30 @@ class Page final : public Element {
       QList<System*> _systems;
       int _no;                      // page number
 #ifdef USE_BSP
-      BspTree bspTree;
+      //---------------------------------------------------
+      //    BspBlock
+      //    tree of the elements of up to BSP_BLOCK_MEASURES
+      //    measures of one system. It is reused by the next
+      //    rebuild if its measures were not laid out again
+      //    and did not move.
+      //---------------------------------------------------
+
+      struct BspBlock {
+            std::vector<MeasureBase*> measures;
+            QVector<qreal> geometry;      // positions the element rects depend on
+            QRectF rect;                  // bounding rect of all elements
+            BspTree tree;
+            };
+      std::vector<BspBlock> bspBlocks;
+      BspBlock bspPageBlock;              // page and system elements
+
       void doRebuildBspTree();
+      void buildBspBlock(BspBlock&, System*);
 #endif
       bool bspTreeValid;
+      bool bspKeepBlocks;                 // only rebuild the blocks of bspStartTick - bspEndTick
+      int bspStartTick;
+      int bspEndTick;
 
       QString replaceTextMacros(const QString&) const;
       void drawHeaderFooter(QPainter*, int area, const QString&) const;
@@ -70,7 +90,12 @@ class Page final : public Element {
 
       QList<Element*> items(const QRectF& r);
       QList<Element*> items(const QPointF& p);
-      void rebuildBspTree()   { bspTreeValid = false; }
+      void rebuildBspTree()   { bspTreeValid = false; bspKeepBlocks = false; }
+      void invalidateBspTree(int stick, int etick);
+      void adoptBspTree(Page*);
+      void moveBspItem(Element*, const QRectF& oldRect);
+      static std::vector<std::pair<Element*, QRectF>> bspItems(Element*);
+      void moveBspItems(const std::vector<std::pair<Element*, QRectF>>& oldItems);
       QPointF pagePos() const { return QPointF(); }     ///< position in page coordinates
       QList<Element*> elements();               ///< list of visible elements
       QRectF tbbox();                           // tight bounding box, excluding white space
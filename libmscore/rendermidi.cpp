@@ -16,6 +16,8 @@
 */
 
 #include <set>
+#include <algorithm>
+#include <iterator>
 
 #include "score.h"
 #include "volta.h"
@@ -51,6 +53,7 @@
 #include "undo.h"
 #include "utils.h"
 #include "sym.h"
+#include "trace.h"
 
 namespace Ms {
 
@@ -465,6 +468,7 @@ void Score::updateRepeatList(bool expandRepeats)
                   }
             while (m);
             repeatList()->append(s);
+            repeatList()->update();
             }
       else
             repeatList()->unwind();
@@ -1776,6 +1780,41 @@ void Score::renderMetronome(EventMap* events, Measure* m, int tickOffset)
             events->insert(std::pair<int,NPlayEvent>(tick + tickOffset, NPlayEvent(timeSig.rtick2beatType(rtick))));
       }
 
+//---------------------------------------------------------
+//   veloChangeRange
+//    tick range where two velocity lists differ;
+//    returns false if they are equal
+//---------------------------------------------------------
+
+static bool veloChangeRange(const VeloList& o, const VeloList& n, int endTick, int* stick, int* etick)
+      {
+      std::set<int> ticks;
+      for (auto i = o.cbegin(); i != o.cend(); ++i)
+            ticks.insert(i.key());
+      for (auto i = n.cbegin(); i != n.cend(); ++i)
+            ticks.insert(i.key());
+      int first = -1;
+      int last  = -1;
+      for (int tick : ticks) {
+            auto io = o.find(tick);
+            auto in = n.find(tick);
+            if (io != o.end() && in != n.end() && io->type == in->type && io->val == in->val)
+                  continue;
+            if (first == -1)
+                  first = tick;
+            last = tick;
+            }
+      if (first == -1)
+            return false;
+      // a change also affects the ramp leading to it and
+      // everything up to the following velocity event
+      auto i = ticks.find(first);
+      *stick = (i == ticks.begin()) ? 0 : *std::prev(i);
+      i = ticks.upper_bound(last);
+      *etick = (i == ticks.end()) ? endTick : *i;
+      return true;
+      }
+
 //---------------------------------------------------------
 //   renderMidi
 //    export score to event list
@@ -1783,6 +1822,7 @@ void Score::renderMetronome(EventMap* events, Measure* m, int tickOffset)
 
 void Score::renderMidi(EventMap* events)
       {
+      TRACE_SCOPE("playback", "renderMidi");
       updateSwing();
       createPlayEvents();
 
@@ -1813,5 +1853,321 @@ void Score::renderMidi(EventMap* events)
                         break;
                   }
             }
+      TRACE_COUNTER("playback", "events", events->size());
+      }
+
+//---------------------------------------------------------
+//   renderMidi
+//    render the playlist of the sequencer completely and
+//    remember in cache what it was rendered with, for
+//    patching it later
+//---------------------------------------------------------
+
+void Score::renderMidi(EventMap* events, PlaylistCache* cache)
+      {
+      renderMidi(events);
+      cache->_key = playlistKey();
+      savePlaylistVelocities(cache);
+      }
+
+//---------------------------------------------------------
+//   savePlaylistVelocities
+//---------------------------------------------------------
+
+void Score::savePlaylistVelocities(PlaylistCache* cache)
+      {
+      cache->_velo.clear();
+      for (Staff* st : _staves)
+            cache->_velo.push_back(st->velocities());
+      }
+
+//---------------------------------------------------------
+//   playlistKey
+//    a rendered playlist can only be patched as long as
+//    repeats, time signatures, staves and channels did
+//    not change, otherwise it is rendered again completely
+//---------------------------------------------------------
+
+std::vector<int> Score::playlistKey()
+      {
+      std::vector<int> key;
+      for (const RepeatSegment* rs : *repeatList()) {
+            key.push_back(rs->tick);
+            key.push_back(rs->utick);
+            key.push_back(rs->len());
+            }
+      for (const auto& i : *sigmap()) {
+            key.push_back(i.first);
+            key.push_back(i.second.nominal().numerator());
+            key.push_back(i.second.nominal().denominator());
+            }
+      key.push_back(nstaves());
+      for (const Part* part : _parts) {
+            key.push_back(part->nstaves());
+            for (const auto& i : *part->instruments()) {
+                  key.push_back(i.first);
+                  for (const Channel* c : i.second->channel())
+                        key.push_back(c->channel);
+                  }
+            }
+      return key;
+      }
+
+//---------------------------------------------------------
+//   needsFullRender
+//    changes in the range which affect the playback of
+//    the rest of the score
+//---------------------------------------------------------
+
+static bool needsFullRender(Measure* sm, Measure* em, const std::set<Part*>& parts)
+      {
+      for (Measure* m = sm; m; m = m->nextMeasure()) {
+            for (Segment* s = m->first(SegmentType::ChordRest); s; s = s->next(SegmentType::ChordRest)) {
+                  for (const Element* e : s->annotations()) {
+                        if (e->isInstrumentChange())
+                              return true;
+                        if (!e->isStaffTextBase())
+                              continue;
+                        const StaffTextBase* st = toStaffTextBase(e);
+                        if (st->swing() || st->setAeolusStops() || !st->channelActions()->isEmpty())
+                              return true;
+                        for (int voice = 0; voice < VOICES; ++voice) {
+                              if (!st->channelName(voice).isEmpty())
+                                    return true;
+                              }
+                        }
+                  }
+            if (m == em)
+                  break;
+            }
+      Score* score = sm->score();
+      for (const auto& i : score->spannerMap().findOverlapping(sm->tick(), em->endTick())) {
+            Spanner* sp = i.value;
+            if ((sp->isPedal() || sp->isLetRing() || sp->isVibrato()) && parts.count(sp->part()))
+                  return true;
+            }
+      return false;
+      }
+
+//---------------------------------------------------------
+//   renderMidi
+//    patch events rendered before with cache for the
+//    changed range of the score; returns false if the
+//    events have to be rendered again completely
+//---------------------------------------------------------
+
+bool Score::renderMidi(EventMap* events, const PlaylistRange& range, PlaylistCache* cache)
+      {
+      TRACE_SCOPE("playback", "renderMidiRange");
+      if (range.all() || !cache->valid() || !firstMeasure())
+            return false;
+      if (range.empty())
+            return true;
+
+      updateSwing();
+      updateRepeatList(MScore::playRepeats);
+      _foundPlayPosAfterRepeats = false;
+      masterScore()->updateChannel();
+      updateVelo();
+      if (playlistKey() != cache->_key || int(cache->_velo.size()) != nstaves())
+            return false;
+
+      int stick = range.startTick();
+      int etick = range.endTick();
+
+      //
+      // collect parts to render, velocity changes may
+      // affect other staves and ticks outside of the range
+      //
+      std::set<Part*> parts;
+      for (int staffIdx = 0; staffIdx < nstaves(); ++staffIdx) {
+            if (range.startStaff() == -1 || (staffIdx >= range.startStaff() && staffIdx <= range.endStaff()))
+                  parts.insert(staff(staffIdx)->part());
+            }
+      for (int staffIdx = 0; staffIdx < nstaves(); ++staffIdx) {
+            int vs, ve;
+            if (veloChangeRange(cache->_velo[staffIdx], staff(staffIdx)->velocities(), lastMeasure()->endTick(), &vs, &ve)) {
+                  parts.insert(staff(staffIdx)->part());
+                  stick = qMin(stick, vs);
+                  etick = qMax(etick, ve);
+                  }
+            }
+
+      // parts sharing a channel are rendered together
+      std::set<int> channels;
+      for (bool changed = true; changed;) {
+            changed = false;
+            for (Part* part : _parts) {
+                  bool inRange = parts.count(part);
+                  for (const auto& i : *part->instruments()) {
+                        for (const Channel* c : i.second->channel()) {
+                              if (inRange)
+                                    channels.insert(c->channel);
+                              else if (channels.count(c->channel)) {
+                                    parts.insert(part);
+                                    changed = true;
+                                    }
+                              }
+                        }
+                  }
+            }
+      std::vector<Staff*> rstaves;
+      for (Staff* st : _staves) {
+            if (parts.count(st->part()))
+                  rstaves.push_back(st);
+            }
+
+      //
+      // extend the range to whole measures, to the start of
+      // ties leading into the range, to the measure following
+      // it (a removed tie changes its first note) and to
+      // measure repeats of the last measure
+      //
+      Measure* sm = tick2measure(stick);
+      Measure* em = tick2measure(etick);
+      if (!sm || !em)
+            return false;
+      for (Staff* st : rstaves) {
+            int strack = st->idx() * VOICES;
+            for (Segment* s = sm->first(SegmentType::ChordRest); s; s = s->next(SegmentType::ChordRest)) {
+                  for (int track = strack; track < strack + VOICES; ++track) {
+                        Element* e = s->element(track);
+                        if (!e || !e->isChord())
+                              continue;
+                        for (Note* n : toChord(e)->notes()) {
+                              while (n->tieBack() && n->tieBack()->startNote())
+                                    n = n->tieBack()->startNote();
+                              stick = qMin(stick, n->chord()->tick());
+                              }
+                        }
+                  }
+            }
+      sm = tick2measure(stick);
+      if (em->nextMeasure())
+            em = em->nextMeasure();
+      for (Measure* m = em->nextMeasure(); m; m = m->nextMeasure()) {
+            bool repeat = false;
+            for (Staff* st : rstaves)
+                  repeat = repeat || m->isRepeatMeasure(st);
+            if (!repeat)
+                  break;
+            em = m;
+            }
+      if (needsFullRender(sm, em, parts))
+            return false;
+
+      int wstart = sm->tick();
+      int wend   = em->endTick();
+
+      for (Staff* st : rstaves) {
+            if (!st->primaryStaff())
+                  continue;
+            int strack = st->idx() * VOICES;
+            for (Measure* m = sm; m; m = m->nextMeasure()) {
+                  for (Segment* s = m->first(SegmentType::ChordRest); s; s = s->next(SegmentType::ChordRest)) {
+                        for (int track = strack; track < strack + VOICES; ++track) {
+                              Element* e = s->element(track);
+                              if (e && e->isChord())
+                                    createPlayEvents(toChord(e));
+                              }
+                        }
+                  if (m == em)
+                        break;
+                  }
+            }
+
+      //
+      // render the range for all repeat segments
+      //
+      EventMap nevents;
+      std::vector<std::pair<int, int>> windows;       // utick ranges
+      for (const RepeatSegment* rs : *repeatList()) {
+            int s = qMax(wstart, rs->tick);
+            int e = qMin(wend, rs->tick + rs->len());
+            if (s >= e)
+                  continue;
+            int tickOffset = rs->utick - rs->tick;
+            windows.push_back(std::make_pair(s + tickOffset, e + tickOffset));
+            for (Staff* st : rstaves) {
+                  Measure* lastMeasure = 0;
+                  for (Measure* m = tick2measure(s)->prevMeasure(); m; m = m->prevMeasure()) {
+                        if (!m->isRepeatMeasure(st)) {
+                              lastMeasure = m;
+                              break;
+                              }
+                        }
+                  for (Measure* m = tick2measure(s); m && m->tick() < e; m = m->nextMeasure()) {
+                        if (lastMeasure && m->isRepeatMeasure(st))
+                              collectMeasureEvents(&nevents, lastMeasure, st, tickOffset + m->tick() - lastMeasure->tick());
+                        else {
+                              lastMeasure = m;
+                              collectMeasureEvents(&nevents, m, st, tickOffset);
+                              }
+                        }
+                  }
+            for (Measure* m = tick2measure(s); m && m->tick() < e; m = m->nextMeasure())
+                  renderMetronome(&nevents, m, tickOffset);
+            }
+      // events of notes tied beyond a note with ornaments
+      // are created before the range; give up on those
+      for (const auto& ev : nevents) {
+            if (ev.second.type() != ME_NOTEON || ev.second.velo() == 0)
+                  continue;
+            bool inWindow = false;
+            for (const auto& w : windows)
+                  inWindow = inWindow || (ev.first >= w.first && ev.first < w.second);
+            if (!inWindow)
+                  return false;
+            }
+
+      //
+      // find old events of the range: all events of the
+      // rendered channels inside the range and the note off
+      // events of notes started inside the range
+      //
+      std::vector<EventMap::iterator> oldEvents;
+      for (const auto& w : windows) {
+            std::vector<const NPlayEvent*> pending;     // notes started in range
+            for (auto i = events->lower_bound(w.first - 1); i != events->end(); ++i) {
+                  const NPlayEvent& ev = i->second;
+                  if (i->first >= w.second && pending.empty())
+                        break;
+                  if (ev.type() == ME_TICK1 || ev.type() == ME_TICK2) {
+                        if (i->first >= w.first && i->first < w.second)
+                              oldEvents.push_back(i);
+                        continue;
+                        }
+                  if (!channels.count(ev.channel()))
+                        continue;
+                  if (ev.type() == ME_PITCHBEND || (ev.type() == ME_CONTROLLER && ev.controller() == CTRL_SUSTAIN))
+                        return false;
+                  if (ev.type() == ME_NOTEON) {
+                        if (ev.velo() != 0) {
+                              if (i->first >= w.first && i->first < w.second) {
+                                    pending.push_back(&ev);
+                                    oldEvents.push_back(i);
+                                    }
+                              continue;
+                              }
+                        auto p = std::find_if(pending.begin(), pending.end(), [&ev](const NPlayEvent* on) {
+                              return on->note() == ev.note() && on->channel() == ev.channel() && on->pitch() == ev.pitch();
+                              });
+                        if (p != pending.end()) {
+                              pending.erase(p);
+                              oldEvents.push_back(i);
+                              }
+                        continue;
+                        }
+                  int tick = (ev.dataA() == CTRL_PROGRAM) ? i->first + 1 : i->first;
+                  if (tick >= w.first && tick < w.second)
+                        oldEvents.push_back(i);
+                  }
+            }
+      for (auto i : oldEvents)
+            events->erase(i);
+      events->insert(nevents.begin(), nevents.end());
+
+      savePlaylistVelocities(cache);
+      return true;
       }
 }
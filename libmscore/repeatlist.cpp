@@ -19,6 +19,8 @@
 #include "marker.h"
 #include "jump.h"
 
+#include <algorithm>
+
 namespace Ms {
 
 //---------------------------------------------------------
@@ -149,8 +151,6 @@ int RepeatSegment::playbackCount(Measure * const m) const
 RepeatList::RepeatList(Score* s)
       {
       _score = s;
-      idx1  = 0;
-      idx2  = 0;
       }
 
 //---------------------------------------------------------
@@ -185,6 +185,157 @@ void RepeatList::update()
             utick        += s->len();
             t            += tl->tick2time(s->tick + s->len()) - ct;
             }
+      updateTickIndex();
+      updateTempoPoints();
+      }
+
+//---------------------------------------------------------
+//   updateTickIndex
+//    Split the score into intervals between segment
+//    boundaries and find the first segment playing each
+//    interval. Segments are processed in playback order,
+//    next[] skips intervals already taken.
+//---------------------------------------------------------
+
+void RepeatList::updateTickIndex()
+      {
+      _tickBounds.clear();
+      for (const RepeatSegment* s : *this) {
+            _tickBounds.push_back(s->tick);
+            _tickBounds.push_back(s->tick + s->len());
+            }
+      std::sort(_tickBounds.begin(), _tickBounds.end());
+      _tickBounds.erase(std::unique(_tickBounds.begin(), _tickBounds.end()), _tickBounds.end());
+
+      int n = int(_tickBounds.size());
+      _tickSegment.assign(n, -1);
+      std::vector<int> next(n + 1);
+      for (int i = 0; i <= n; ++i)
+            next[i] = i;
+      auto findFree = [&next](int i) {
+            while (next[i] != i) {
+                  next[i] = next[next[i]];
+                  i = next[i];
+                  }
+            return i;
+            };
+      for (int idx = 0; idx < size(); ++idx) {
+            const RepeatSegment* s = at(idx);
+            if (s->len() <= 0)
+                  continue;
+            int i1 = int(std::lower_bound(_tickBounds.begin(), _tickBounds.end(), s->tick) - _tickBounds.begin());
+            int i2 = int(std::lower_bound(_tickBounds.begin(), _tickBounds.end(), s->tick + s->len()) - _tickBounds.begin());
+            for (int i = findFree(i1); i < i2; i = findFree(i + 1)) {
+                  _tickSegment[i] = idx;
+                  next[i] = i + 1;
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   updateTempoPoints
+//---------------------------------------------------------
+
+void RepeatList::updateTempoPoints()
+      {
+      const TempoMap* tl = _score->tempomap();
+      _tempoPoints.clear();
+      _tempoPoints.reserve(tl->size());
+      for (const auto& e : *tl)
+            _tempoPoints.push_back({ e.first, e.second.time, e.second.pause, e.second.tempo });
+      _relTempo = tl->relTempo();
+      _tempoSN  = tl->tempoSN();
+      }
+
+//---------------------------------------------------------
+//   tick2time
+//    same as TempoMap::tick2time() with a binary search
+//    in the copied tempo points
+//---------------------------------------------------------
+
+qreal RepeatList::tick2time(int tick) const
+      {
+      const TempoMap* tl = _score->tempomap();
+      if (_tempoSN != tl->tempoSN())
+            return tl->tick2time(tick);
+
+      qreal time  = 0.0;
+      qreal delta = qreal(tick);
+      qreal tempo = 2.0;
+
+      if (!_tempoPoints.empty()) {
+            int ptick = 0;
+            auto e = std::lower_bound(_tempoPoints.begin(), _tempoPoints.end(), tick,
+               [](const TempoPoint& p, int t) { return p.tick < t; });
+            if (e == _tempoPoints.end() || (e->tick != tick && e != _tempoPoints.begin()))
+                  --e;
+            if (e->tick <= tick) {
+                  ptick = e->tick;
+                  tempo = e->tempo;
+                  time  = e->time;
+                  }
+            delta = qreal(tick - ptick);
+            }
+      else
+            qDebug("TempoMap: empty");
+      time += delta / (MScore::division * tempo * _relTempo);
+      return time;
+      }
+
+//---------------------------------------------------------
+//   time2tick
+//    same as TempoMap::time2tick(): the first point with
+//    time >= t is either the end of a pause containing t
+//    or the end of the linear piece containing t
+//---------------------------------------------------------
+
+int RepeatList::time2tick(qreal time) const
+      {
+      const TempoMap* tl = _score->tempomap();
+      if (_tempoSN != tl->tempoSN())
+            return tl->time2tick(time);
+
+      int tick    = 0;
+      qreal delta = 0.0;
+      qreal tempo = 2.0;
+
+      auto e = std::lower_bound(_tempoPoints.begin(), _tempoPoints.end(), time,
+         [](const TempoPoint& p, qreal t) { return p.time < t; });
+      if (e != _tempoPoints.begin()) {
+            auto pe = e - 1;
+            delta = pe->time;
+            tick  = pe->tick;
+            tempo = pe->tempo;
+            }
+      if (e != _tempoPoints.end() && (time > e->time - e->pause))
+            delta = (time - (e->time - e->pause) + delta);
+      delta = time - delta;
+      tick += lrint(delta * _relTempo * MScore::division * tempo);
+      return tick;
+      }
+
+//---------------------------------------------------------
+//   utick2segment
+//    return the segment playing utick, 0 if utick is
+//    before the first segment
+//---------------------------------------------------------
+
+const RepeatSegment* RepeatList::utick2segment(int utick) const
+      {
+      auto i = std::upper_bound(begin(), end(), utick,
+         [](int t, const RepeatSegment* s) { return t < s->utick; });
+      return i == begin() ? 0 : *(i - 1);
+      }
+
+//---------------------------------------------------------
+//   utime2segment
+//---------------------------------------------------------
+
+const RepeatSegment* RepeatList::utime2segment(qreal utime) const
+      {
+      auto i = std::upper_bound(begin(), end(), utime,
+         [](qreal t, const RepeatSegment* s) { return t < s->utime; });
+      return i == begin() ? 0 : *(i - 1);
       }
 
 //---------------------------------------------------------
@@ -193,18 +344,13 @@ void RepeatList::update()
 
 int RepeatList::utick2tick(int tick) const
       {
-      unsigned n = size();
-      if (n == 0)
+      if (empty())
             return tick;
       if (tick < 0)
             return 0;
-      unsigned ii = (idx1 < n) && (tick >= at(idx1)->utick) ? idx1 : 0;
-      for (unsigned i = ii; i < n; ++i) {
-            if ((tick >= at(i)->utick) && ((i + 1 == n) || (tick < at(i+1)->utick))) {
-                  idx1 = i;
-                  return tick - (at(i)->utick - at(i)->tick);
-                  }
-            }
+      const RepeatSegment* s = utick2segment(tick);
+      if (s)
+            return tick - (s->utick - s->tick);
       if (MScore::debugMode) {
             qFatal("tick %d not found in RepeatList", tick);
             }
@@ -213,13 +359,20 @@ int RepeatList::utick2tick(int tick) const
 
 //---------------------------------------------------------
 //   tick2utick
+//    return the utick of the first playback of tick
 //---------------------------------------------------------
 
 int RepeatList::tick2utick(int tick) const
       {
-      for (const RepeatSegment* s : *this) {
-            if (tick >= s->tick && tick < (s->tick + s->len() ))
+      if (empty())
+            return tick;
+      auto b = std::upper_bound(_tickBounds.begin(), _tickBounds.end(), tick);
+      if (b != _tickBounds.begin() && b != _tickBounds.end()) {
+            int idx = _tickSegment[b - _tickBounds.begin() - 1];
+            if (idx != -1) {
+                  const RepeatSegment* s = at(idx);
                   return s->utick + (tick - s->tick);
+                  }
             }
       return last()->utick + (tick - last()->tick);
       }
@@ -230,16 +383,11 @@ int RepeatList::tick2utick(int tick) const
 
 qreal RepeatList::utick2utime(int tick) const
       {
-      unsigned n = size();
-      unsigned ii = (idx1 < n) && (tick >= at(idx1)->utick) ? idx1 : 0;
-      for (unsigned i = ii; i < n; ++i) {
-            if ((tick >= at(i)->utick) && ((i + 1 == n) || (tick < at(i+1)->utick))) {
-                  int t     = tick - (at(i)->utick - at(i)->tick);
-                  qreal tt = _score->tempomap()->tick2time(t) + at(i)->timeOffset;
-                  return tt;
-                  }
-            }
-      return 0.0;
+      const RepeatSegment* s = utick2segment(tick);
+      if (!s)
+            return 0.0;
+      int t = tick - (s->utick - s->tick);
+      return tick2time(t) + s->timeOffset;
       }
 
 //---------------------------------------------------------
@@ -248,14 +396,9 @@ qreal RepeatList::utick2utime(int tick) const
 
 int RepeatList::utime2utick(qreal t) const
       {
-      unsigned n = size();
-      unsigned ii = (idx2 < n) && (t >= at(idx2)->utime) ? idx2 : 0;
-      for (unsigned i = ii; i < n; ++i) {
-            if ((t >= at(i)->utime) && ((i + 1 == n) || (t < at(i+1)->utime))) {
-                  idx2 = i;
-                  return _score->tempomap()->time2tick(t - at(i)->timeOffset) + (at(i)->utick - at(i)->tick);
-                  }
-            }
+      const RepeatSegment* s = utime2segment(t);
+      if (s)
+            return time2tick(t - s->timeOffset) + (s->utick - s->tick);
       if (MScore::debugMode) {
             qFatal("time %f not found in RepeatList", t);
             }
@@ -49,8 +49,27 @@ class RepeatSegment {
 
 class RepeatList: public QList<RepeatSegment*>
       {
+      //---------------------------------------------------
+      //   TempoPoint
+      //    copy of a TempoMap event, the tempo map is
+      //    linear between two points
+      //---------------------------------------------------
+
+      struct TempoPoint {
+            int tick;
+            qreal time;
+            qreal pause;
+            qreal tempo;
+            };
+
       Score* _score;
-      mutable unsigned idx1, idx2;   // cached values
+
+      // built by update():
+      std::vector<int> _tickBounds;             // sorted start and end ticks of all segments
+      std::vector<int> _tickSegment;            // first segment playing [_tickBounds[i], _tickBounds[i+1]), -1 if none
+      std::vector<TempoPoint> _tempoPoints;
+      qreal _relTempo         { 1.0 };
+      int _tempoSN            { -1 };           // serial number of the tempo map copied to _tempoPoints
 
       RepeatSegment* rs;            // tmp value during unwind()
       std::map<Volta*, Measure*> _voltaRanges; // open volta possibly ends past the end of its spanner, used during unwind
@@ -62,6 +81,12 @@ class RepeatList: public QList<RepeatSegment*>
       Measure* findStartRepeat(Measure * const) const;
       int findStartFromRepeatCount(Measure * const startFrom) const;
       bool isFinalPlaythrough(Measure * const measure, QList<RepeatSegment*>::const_iterator repeatSegmentIt) const;
+      const RepeatSegment* utick2segment(int utick) const;
+      const RepeatSegment* utime2segment(qreal utime) const;
+      void updateTickIndex();
+      void updateTempoPoints();
+      qreal tick2time(int tick) const;
+      int time2tick(qreal time) const;
 
    public:
       RepeatList(Score* s);
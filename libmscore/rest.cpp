@@ -22,6 +22,8 @@
 #include "chord.h"
 #include "note.h"
 #include "measure.h"
+#include "system.h"
+#include "page.h"
 #include "undo.h"
 #include "staff.h"
 #include "harmony.h"
@@ -32,6 +34,8 @@
 
 namespace Ms {
 
+DEFINE_MEMORY_POOL(Rest)
+
 //---------------------------------------------------------
 //    Rest
 //--------------------------------------------------------
@@ -150,6 +154,8 @@ QRectF Rest::drag(EditData& ed)
       {
       QPointF s(ed.delta);
       QRectF r(abbox());
+      // dots, symbols and lyrics move with the rest
+      std::vector<std::pair<Element*, QRectF>> items = Page::bspItems(this);
 
       // Limit horizontal drag range
       static const qreal xDragRange = spatium() * 5;
@@ -157,7 +163,11 @@ QRectF Rest::drag(EditData& ed)
             s.rx() = xDragRange * (s.x() < 0 ? -1.0 : 1.0);
       setUserOff(QPointF(s.x(), s.y()));
       layout();
-      score()->rebuildBspTree();
+      System* system = measure()->system();
+      if (system && system->page())
+            system->page()->moveBspItems(items);
+      else
+            score()->rebuildBspTree();
       return abbox() | r;
       }
 
@@ -870,14 +880,14 @@ void Rest::write(XmlWriter& xml) const
 void Rest::read(XmlReader& e)
       {
       while (e.readNextStartElement()) {
-            const QStringRef& tag(e.name());
-            if (tag == "Symbol") {
+            const XmlTag tid = e.tagId();
+            if (tid == XmlTag::SYMBOL) {
                   Symbol* s = new Symbol(score());
                   s->setTrack(track());
                   s->read(e);
                   add(s);
                   }
-            else if (tag == "Image") {
+            else if (tid == XmlTag::IMAGE) {
                   if (MScore::noImages)
                         e.skipCurrentElement();
                   else {
@@ -887,7 +897,7 @@ void Rest::read(XmlReader& e)
                         add(image);
                         }
                   }
-            else if (tag == "NoteDot") {
+            else if (tid == XmlTag::NOTE_DOT) {
                   NoteDot* dot = new NoteDot(score());
                   dot->read(e);
                   add(dot);
@@ -15,6 +15,7 @@
 
 #include "chordrest.h"
 #include "notedot.h"
+#include "mempool.h"
 
 namespace Ms {
 
@@ -41,6 +42,8 @@ class Rest : public ChordRest {
       virtual void setUserOff(const QPointF& o) override;
 
 
+      DECLARE_MEMORY_POOL
+
    public:
       Rest(Score* s = 0);
       Rest(Score*, const TDuration&);
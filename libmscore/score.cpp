@@ -16,6 +16,7 @@
 */
 
 #include <assert.h>
+#include <algorithm>
 #include "score.h"
 #include "key.h"
 #include "sig.h"
@@ -70,6 +71,8 @@
 #include "rehearsalmark.h"
 #include "breath.h"
 #include "instrchange.h"
+#include "layoutcache.h"
+#include "tilecache.h"
 
 namespace Ms {
 
@@ -140,6 +143,7 @@ void MeasureBaseList::push_front(MeasureBase* e)
 
 void MeasureBaseList::add(MeasureBase* e)
       {
+      invalidateTickIndex();
       MeasureBase* el = e->next();
       if (el == 0) {
             push_back(e);
@@ -161,6 +165,7 @@ void MeasureBaseList::add(MeasureBase* e)
 
 void MeasureBaseList::remove(MeasureBase* el)
       {
+      invalidateTickIndex();
       --_size;
       if (el->prev())
             el->prev()->setNext(el->next());
@@ -178,6 +183,7 @@ void MeasureBaseList::remove(MeasureBase* el)
 
 void MeasureBaseList::insert(MeasureBase* fm, MeasureBase* lm)
       {
+      invalidateTickIndex();
       ++_size;
       for (MeasureBase* m = fm; m != lm; m = m->next())
             ++_size;
@@ -199,6 +205,7 @@ void MeasureBaseList::insert(MeasureBase* fm, MeasureBase* lm)
 
 void MeasureBaseList::remove(MeasureBase* fm, MeasureBase* lm)
       {
+      invalidateTickIndex();
       --_size;
       for (MeasureBase* m = fm; m != lm; m = m->next())
             --_size;
@@ -220,6 +227,7 @@ void MeasureBaseList::remove(MeasureBase* fm, MeasureBase* lm)
 
 void MeasureBaseList::change(MeasureBase* ob, MeasureBase* nb)
       {
+      invalidateTickIndex();
       nb->setPrev(ob->prev());
       nb->setNext(ob->next());
       if (ob->prev())
@@ -237,6 +245,48 @@ void MeasureBaseList::change(MeasureBase* ob, MeasureBase* nb)
             e->setParent(nb);
       }
 
+//---------------------------------------------------------
+//   rebuildTickIndex
+//    collect all measures in list order; as measure ticks
+//    are ascending along the list, the index stays sorted
+//    by tick until the list itself is changed
+//---------------------------------------------------------
+
+void MeasureBaseList::rebuildTickIndex() const
+      {
+      _tickIndex.clear();
+      _tickIndex.reserve(_size);
+      for (MeasureBase* mb = _first; mb; mb = mb->next()) {
+            if (mb->isMeasure())
+                  _tickIndex.push_back(toMeasure(mb));
+            }
+      _tickIndexValid = true;
+      ++_tickIndexRebuilds;
+      }
+
+//---------------------------------------------------------
+//   tick2measure
+//    binary search for the last measure starting at or
+//    before tick
+//---------------------------------------------------------
+
+Measure* MeasureBaseList::tick2measure(int tick) const
+      {
+      if (!_tickIndexValid)
+            rebuildTickIndex();
+      if (_tickIndex.empty())
+            return 0;
+      auto i = std::upper_bound(_tickIndex.begin(), _tickIndex.end(), tick,
+         [](int t, const Measure* m) { return t < m->tick(); });
+      if (i == _tickIndex.begin())
+            return 0;
+      Measure* m = *(i - 1);
+      // check last measure
+      if (i == _tickIndex.end() && tick > m->endTick())
+            return 0;
+      return m;
+      }
+
 //---------------------------------------------------------
 //   Score
 //---------------------------------------------------------
@@ -320,6 +370,7 @@ Score::~Score()
       qDeleteAll(_parts);
       qDeleteAll(_staves);
       qDeleteAll(_systems);
+      delete _thumbnailTiles;
 //      qDeleteAll(_pages);
       _masterScore = 0;
       }
@@ -461,6 +512,8 @@ void Score::fixTicks()
 
             tick += measureTicks;
             }
+      if (!_measures.tickIndexValid())
+            _measures.rebuildTickIndex();
       // Now done in getNextMeasure(), do we keep?
       if (tempomap()->empty())
             tempomap()->setTempo(0, 2.0);
@@ -1306,6 +1359,8 @@ void Score::addElement(Element* element)
                         }
                   cmdState().layoutFlags |= LayoutFlag::FIX_PITCH_VELO;
                   o->staff()->updateOttava();
+                  // the pitch of every note up to the end changes
+                  setLayoutStaff(o->tick2(), o->staff());
                   _playlistDirty = true;
                   }
                   break;
@@ -1364,7 +1419,7 @@ void Score::addElement(Element* element)
             default:
                   break;
             }
-      setLayout(element->tick());
+      setLayoutStaff(element->tick(), element->staff());
       }
 
 //---------------------------------------------------------
@@ -1377,7 +1432,7 @@ void Score::addElement(Element* element)
 void Score::removeElement(Element* element)
       {
       Element* parent = element->parent();
-      setLayout(element->tick());
+      setLayoutStaff(element->tick(), element->staff());
 
 //      qDebug("Score(%p) Element(%p)(%s) parent %p(%s)",
 //         this, element, element->name(), parent, parent ? parent->name() : "");
@@ -1470,6 +1525,7 @@ void Score::removeElement(Element* element)
                         }
                   o->staff()->updateOttava();
                   cmdState().layoutFlags |= LayoutFlag::FIX_PITCH_VELO;
+                  setLayoutStaff(o->tick2(), o->staff());
                   _playlistDirty = true;
                   }
                   break;
@@ -1901,7 +1957,7 @@ void Score::removeAudio()
 
 bool& Score::isScoreLoaded()
       {
-      static bool scoreLoaded = false;
+      static thread_local bool scoreLoaded = false;     // scores may be read on several threads
       return scoreLoaded;
       }
 
@@ -4244,12 +4300,26 @@ MasterScore::MasterScore(const MStyle& s)
 MasterScore::~MasterScore()
       {
       delete _revisions;
+      delete _layoutCache;
       delete _repeatList;
       delete _sigmap;
       delete _tempomap;
       qDeleteAll(_excerpts);
       }
 
+//---------------------------------------------------------
+//   setLayoutCache
+//    MasterScore takes ownership of the cache
+//---------------------------------------------------------
+
+void MasterScore::setLayoutCache(LayoutCache* c)
+      {
+      if (_layoutCache == c)
+            return;
+      delete _layoutCache;
+      _layoutCache = c;
+      }
+
 //---------------------------------------------------------
 //   setMovements
 //---------------------------------------------------------
@@ -4365,6 +4435,7 @@ void MasterScore::setLayoutAll()
       {
       _cmdState.setTick(0);
       _cmdState.setTick(measures()->last() ? measures()->last()->endTick() : 0);
+      _cmdState.setStaff(-1);
       }
 
 //---------------------------------------------------------
@@ -4373,8 +4444,54 @@ void MasterScore::setLayoutAll()
 
 void MasterScore::setLayout(int t)
       {
-      if (t >= 0)
+      if (t >= 0) {
             _cmdState.setTick(t);
+            _cmdState.setStaff(-1);
+            }
+      }
+
+void MasterScore::setLayout(int t, int staffIdx)
+      {
+      if (t >= 0) {
+            _cmdState.setTick(t);
+            _cmdState.setStaff(staffIdx);
+            }
+      }
+
+//---------------------------------------------------------
+//   setLayoutStaff
+//    like setLayout(), but also remember the staff
+//    which was changed; staves of part scores are mapped
+//    to the linked staff of the master score
+//---------------------------------------------------------
+
+void Score::setLayoutStaff(int tick, Staff* staff)
+      {
+      int staffIdx = -1;
+      if (staff && staff->score() == masterScore())
+            staffIdx = staff->idx();
+      else if (staff && staff->links()) {
+            for (ScoreElement* se : *staff->links()) {
+                  if (se->score() == masterScore()) {
+                        staffIdx = toStaff(se)->idx();
+                        break;
+                        }
+                  }
+            }
+      _masterScore->setLayout(tick, staffIdx);
+      }
+
+//---------------------------------------------------------
+//   setPlaylistDirty
+//    the playlist has to be rendered again completely
+//---------------------------------------------------------
+
+void Score::setPlaylistDirty()
+      {
+      _playlistDirty = true;
+      _playlistRange.setAll();
+      if (_masterScore && _masterScore != this)
+            _masterScore->_playlistRange.setAll();
       }
 
 //---------------------------------------------------------
@@ -26,6 +26,7 @@
 #include "spannermap.h"
 #include "layoutbreak.h"
 #include "property.h"
+#include "velo.h"
 
 namespace Ms {
 
@@ -86,6 +87,8 @@ struct Channel;
 struct Interval;
 struct TEvent;
 struct LayoutContext;
+class LayoutCache;
+class TileCache;
 
 enum class Tid;
 enum class ClefType : signed char;
@@ -140,6 +143,10 @@ class MeasureBaseList {
       MeasureBase* _first;
       MeasureBase* _last;
 
+      mutable std::vector<Measure*> _tickIndex;  // all measures in list order, sorted by tick
+      mutable bool _tickIndexValid { false };
+      mutable int _tickIndexRebuilds { 0 };
+
       void push_back(MeasureBase* e);
       void push_front(MeasureBase* e);
 
@@ -147,13 +154,19 @@ class MeasureBaseList {
       MeasureBaseList();
       MeasureBase* first() const { return _first; }
       MeasureBase* last()  const { return _last; }
-      void clear()               { _first = _last = 0; _size = 0; }
+      void clear()               { _first = _last = 0; _size = 0; invalidateTickIndex(); }
       void add(MeasureBase*);
       void remove(MeasureBase*);
       void insert(MeasureBase*, MeasureBase*);
       void remove(MeasureBase*, MeasureBase*);
       void change(MeasureBase* o, MeasureBase* n);
       int size() const { return _size; }
+
+      void invalidateTickIndex()          { _tickIndexValid = false; _tickIndex.clear(); }
+      bool tickIndexValid() const         { return _tickIndexValid; }
+      void rebuildTickIndex() const;
+      Measure* tick2measure(int tick) const;
+      int tickIndexRebuilds() const       { return _tickIndexRebuilds; }
       };
 
 //---------------------------------------------------------
@@ -245,6 +258,9 @@ class CmdState {
       UpdateMode _updateMode { UpdateMode::DoNothing };
       int _startTick {-1};            // start tick for mode LayoutTick
       int _endTick   {-1};              // end tick for mode LayoutTick
+      int _startStaff {-1};           // staves touched by the command, master score index
+      int _endStaff   {-1};
+      bool _allStaves { false };      // a change could not be attributed to a staff
 
    public:
       LayoutFlags layoutFlags;
@@ -262,11 +278,57 @@ class CmdState {
       void setTick(int t);
       int startTick() const    { return _startTick; }
       int endTick() const      { return _endTick; }
+      void setStaff(int staffIdx);
+      int startStaff() const   { return _allStaves ? -1 : _startStaff; }
+      int endStaff() const     { return _allStaves ? -1 : _endStaff;   }
 #ifndef NDEBUG
       void dump();
 #endif
       };
 
+//---------------------------------------------------------
+//   PlaylistRange
+//    part of the playlist which needs to be rendered again
+//    since the sequencer last collected its events
+//---------------------------------------------------------
+
+class PlaylistRange {
+      bool _all        { true };
+      int _startTick   { -1 };
+      int _endTick     { -1 };
+      int _startStaff  { -1 };
+      int _endStaff    { -1 };        // inclusive; -1: all staves
+
+   public:
+      void reset()               { _all = false; _startTick = _endTick = _startStaff = _endStaff = -1; }
+      void setAll()              { _all = true; }
+      void add(const CmdState&);
+      bool all() const           { return _all; }
+      bool empty() const         { return !_all && _startTick == -1; }
+      int startTick() const      { return _startTick;  }
+      int endTick() const        { return _endTick;    }
+      int startStaff() const     { return _startStaff; }
+      int endStaff() const       { return _endStaff;   }
+      };
+
+//---------------------------------------------------------
+//   PlaylistCache
+//    what a playlist was rendered with, kept by the owner
+//    of the playlist so that other renders of the score
+//    (audio export) do not change it
+//---------------------------------------------------------
+
+class PlaylistCache {
+      std::vector<int> _key;              // repeats, time signatures, staves and channels
+      std::vector<VeloList> _velo;        // staff velocities
+
+      friend class Score;
+
+   public:
+      void clear()               { _key.clear(); _velo.clear(); }
+      bool valid() const         { return !_key.empty(); }
+      };
+
 //---------------------------------------------------------
 //   UpdateState
 //---------------------------------------------------------
@@ -409,6 +471,7 @@ class Score : public QObject, public ScoreElement {
       //
       QList<Page*> _pages;          // pages are build from systems
       QList<System*> _systems;      // measures are akkumulated to systems
+      TileCache* _thumbnailTiles { 0 };   // the first page, see createThumbnail()
 
       InputState _is;
       MStyle _style;
@@ -426,6 +489,7 @@ class Score : public QObject, public ScoreElement {
       bool _showVBox              { true  };
       bool _printing              { false };      ///< True if we are drawing to a printer
       bool _playlistDirty         { true  };
+      PlaylistRange _playlistRange;           ///< region changed since the playlist was last collected
       bool _autosaveDirty         { true  };
       bool _savedCapture          { false };      ///< True if we saved an image capture
       bool _saved                 { false };    ///< True if project was already saved; only on first
@@ -694,6 +758,7 @@ class Score : public QObject, public ScoreElement {
       virtual inline void setUpdateAll();
       virtual inline void setLayoutAll();
       virtual inline void setLayout(int);
+      void setLayoutStaff(int tick, Staff* staff);
       virtual inline CmdState& cmdState();
       virtual inline void addLayoutFlags(LayoutFlags);
       virtual inline void setInstrumentsChanged(bool);
@@ -796,7 +861,9 @@ class Score : public QObject, public ScoreElement {
       void setAutosaveDirty(bool v)  { _autosaveDirty = v;    }
       bool autosaveDirty() const     { return _autosaveDirty; }
       bool playlistDirty()           { return _playlistDirty; }
-      void setPlaylistDirty()        { _playlistDirty = true; }
+      void setPlaylistDirty();
+      const PlaylistRange& playlistRange() const { return _playlistRange; }
+      void resetPlaylistRange()      { _playlistRange.reset(); }
 
       void spell();
       void spell(int startStaff, int endStaff, Segment* startSegment, Segment* endSegment);
@@ -855,6 +922,10 @@ class Score : public QObject, public ScoreElement {
       bool pasteStaff(XmlReader&, Segment* dst, int staffIdx);
       void pasteSymbols(XmlReader& e, ChordRest* dst);
       void renderMidi(EventMap* events);
+      void renderMidi(EventMap* events, PlaylistCache* cache);
+      bool renderMidi(EventMap* events, const PlaylistRange& range, PlaylistCache* cache);
+      std::vector<int> playlistKey();
+      void savePlaylistVelocities(PlaylistCache* cache);
       void renderStaff(EventMap* events, Staff*);
       void renderSpanners(EventMap* events, int staffIdx);
       void renderMetronome(EventMap* events, Measure* m, int tickOffset);
@@ -1168,6 +1239,7 @@ class MasterScore : public Score {
       RepeatList* _repeatList;
       QList<Excerpt*> _excerpts;
       Revisions* _revisions;
+      LayoutCache* _layoutCache { 0 };          // page layout read from file, valid until first edit
       MasterScore* _next      { 0 };
       MasterScore* _prev      { 0 };
       Movements* _movements   { 0 };
@@ -1223,6 +1295,7 @@ class MasterScore : public Score {
       virtual void setUpdateAll() override;
       virtual void setLayoutAll() override;
       virtual void setLayout(int t) override;
+      void setLayout(int t, int staffIdx);
 
       virtual CmdState& cmdState() override                           { return _cmdState;                     }
       virtual void addLayoutFlags(LayoutFlags val) override           { _cmdState.layoutFlags |= val;         }
@@ -1233,6 +1306,8 @@ class MasterScore : public Score {
       bool instrumentsChanged() const                                 { return _cmdState._instrumentsChanged; }
 
       Revisions* revisions()                                          { return _revisions;                    }
+      LayoutCache* layoutCache() const                                { return _layoutCache;                  }
+      void setLayoutCache(LayoutCache*);
 
       bool isSavable() const;
       void setTempomap(TempoMap* tm);
@@ -21,6 +21,7 @@
 #include "chord.h"
 #include "tuplet.h"
 #include "beam.h"
+#include "layoutcache.h"
 #include "revisions.h"
 #include "page.h"
 #include "part.h"
@@ -46,6 +47,9 @@
 #include "imageStore.h"
 #include "audio.h"
 #include "barline.h"
+#include "tilecache.h"
+#include "trace.h"
+#include "mempool.h"
 #include "thirdparty/qzip/qzipreader_p.h"
 #include "thirdparty/qzip/qzipwriter_p.h"
 #ifdef Q_OS_WIN
@@ -490,38 +494,33 @@ bool Score::saveCompressedFile(QFileInfo& info, bool onlySelection)
 
 QImage Score::createThumbnail()
       {
+      // a score in page mode is laid out, keep the systems
+      // and the tiles painted for the last thumbnail
       LayoutMode mode = layoutMode();
-      setLayoutMode(LayoutMode::PAGE);
-      doLayout();
+      if (mode != LayoutMode::PAGE) {
+            setLayoutMode(LayoutMode::PAGE);
+            doLayout();
+            }
 
       Page* page = pages().at(0);
       QRectF fr  = page->abbox();
       qreal mag  = 256.0 / qMax(fr.width(), fr.height());
-      int w      = int(fr.width() * mag);
-      int h      = int(fr.height() * mag);
-
-      QImage pm(w, h, QImage::Format_ARGB32_Premultiplied);
-
-      int dpm = lrint(DPMM * 1000.0);
-      pm.setDotsPerMeterX(dpm);
-      pm.setDotsPerMeterY(dpm);
-      pm.fill(0xffffffff);
 
       double pr = MScore::pixelRatio;
       MScore::pixelRatio = 1.0;
 
-      QPainter p(&pm);
-      p.setRenderHint(QPainter::Antialiasing, true);
-      p.setRenderHint(QPainter::TextAntialiasing, true);
-      p.scale(mag, mag);
-      print(&p, 0);
-      p.end();
+      if (!_thumbnailTiles)
+            _thumbnailTiles = new TileCache;
+      _thumbnailTiles->prune(this);
+      _thumbnailTiles->setScale(mag);
+      QImage pm = _thumbnailTiles->pageImage(page);
 
       MScore::pixelRatio = pr;
 
       if (layoutMode() != mode) {
             setLayoutMode(mode);
             doLayout();
+            _thumbnailTiles->clear();     // of systems which are gone
             }
       return pm;
       }
@@ -533,6 +532,7 @@ QImage Score::createThumbnail()
 
 bool Score::saveCompressedFile(QIODevice* f, QFileInfo& info, bool onlySelection, bool doCreateThumbnail)
       {
+      TRACE_SCOPE("file", "saveCompressedFile");
       MQZipWriter uz(f);
 
       QString fn = info.completeBaseName() + ".mscx";
@@ -610,6 +610,22 @@ bool Score::saveCompressedFile(QIODevice* f, QFileInfo& info, bool onlySelection
       saveFile(&dbuf, true, onlySelection);
       dbuf.seek(0);
       uz.addFile(fn, dbuf.data());
+
+      //
+      // save page layout
+      //
+      if (MScore::layoutCache && !onlySelection && layoutMode() == LayoutMode::PAGE
+         && !masterScore()->next() && !masterScore()->prev()) {
+            LayoutCache lc;
+            lc.create(this, LayoutCache::contentKey(dbuf.data()));
+            QBuffer lbuf;
+            lbuf.open(QIODevice::ReadWrite);
+            XmlWriter xml(this, &lbuf);
+            xml << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+            lc.write(xml);
+            xml.flush();
+            uz.addFile(LayoutCache::fileName, lbuf.data());
+            }
       uz.close();
       return true;
       }
@@ -693,6 +709,7 @@ extern QString revision;
 
 bool Score::saveFile(QIODevice* f, bool msczFormat, bool onlySelection)
       {
+      TRACE_SCOPE("file", "saveFile");
       XmlWriter xml(this, f);
       xml.setWriteOmr(msczFormat);
       xml.header();
@@ -800,6 +817,22 @@ Score::FileError MasterScore::loadCompressedMsc(QIODevice* io, bool ignoreVersio
 
       FileError retval = read1(e, ignoreVersionError);
 
+      //
+      // read page layout, it is used by the first layout
+      // if the score content is unchanged
+      //
+      if (MScore::layoutCache && retval == FileError::FILE_NO_ERROR) {
+            QByteArray lbuf = uz.fileData(LayoutCache::fileName);
+            if (!lbuf.isEmpty()) {
+                  LayoutCache* lc = new LayoutCache;
+                  XmlReader le(lbuf);
+                  if (lc->read(le) && lc->key() == LayoutCache::contentKey(dbuf))
+                        setLayoutCache(lc);
+                  else
+                        delete lc;
+                  }
+            }
+
 #ifdef OMR
       //
       // load OMR page images
@@ -846,15 +879,19 @@ Score::FileError MasterScore::loadMsc(QString name, bool ignoreVersionError)
 
 Score::FileError MasterScore::loadMsc(QString name, QIODevice* io, bool ignoreVersionError)
       {
+      TRACE_SCOPE("file", "loadMsc");
       Score::isScoreLoaded() = true;
       fileInfo()->setFile(name);
 
+      FileError rv;
       if (name.endsWith(".mscz"))
-            return loadCompressedMsc(io, ignoreVersionError);
+            rv = loadCompressedMsc(io, ignoreVersionError);
       else {
             XmlReader r(io);
-            return read1(r, ignoreVersionError);
+            rv = read1(r, ignoreVersionError);
             }
+      MemoryPool::report("load");
+      return rv;
       }
 
 //---------------------------------------------------------
@@ -916,6 +953,7 @@ void MasterScore::parseVersion(const QString& val)
 
 Score::FileError MasterScore::read1(XmlReader& e, bool ignoreVersionError)
       {
+      TRACE_SCOPE("file", "read");
       while (e.readNextStartElement()) {
             if (e.name() == "museScore") {
                   const QString& version = e.attribute("version");
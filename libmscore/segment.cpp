@@ -39,6 +39,8 @@
 
 namespace Ms {
 
+DEFINE_MEMORY_POOL(Segment)
+
 //---------------------------------------------------------
 //   subTypeName
 //---------------------------------------------------------
@@ -1822,7 +1824,7 @@ void Segment::createShape(int staffIdx)
       for (int track = staffIdx * VOICES; track < (staffIdx + 1) * VOICES; ++track) {
             Element* e = _elist[track];
             if (e) {
-                  s.add(e->shape().translated(e->pos()));
+                  s.add(e->shape(), e->pos());
                   }
             }
 
@@ -1839,7 +1841,7 @@ void Segment::createShape(int staffIdx)
                && !e->isArticulation()
                && !e->isFermata()
                && !e->isStaffText())
-                  s.add(e->shape().translated(e->pos()));
+                  s.add(e->shape(), e->pos());
             }
       }
 
@@ -16,6 +16,7 @@
 #include "element.h"
 #include "shape.h"
 #include "mscore.h"
+#include "mempool.h"
 
 namespace Ms {
 
@@ -105,6 +106,8 @@ class Segment final : public Element {
    protected:
       Element* getElement(int staff);     //??
 
+      DECLARE_MEMORY_POOL
+
    public:
       Segment(Measure* m = 0);
       Segment(Measure*, SegmentType, int tick);
@@ -240,7 +243,6 @@ class Segment final : public Element {
       using Element::prevElement;
       Element* prevElement(int activeStaff);
 
-      std::vector<Shape> shapes()                     { return _shapes; }
       const std::vector<Shape>& shapes() const        { return _shapes; }
       const Shape& staffShape(int staffIdx) const     { return _shapes[staffIdx]; }
       Shape& staffShape(int staffIdx)                 { return _shapes[staffIdx]; }
@@ -10,6 +10,9 @@
 //  the file LICENCE.GPL
 //=============================================================================
 
+#include <algorithm>
+#include <limits>
+
 #include "shape.h"
 #include "segment.h"
 
@@ -56,6 +59,22 @@ Shape Shape::translated(const QPointF& pt) const
       return s;
       }
 
+//---------------------------------------------------------
+//   add
+//    append s translated by offset without creating a
+//    temporary shape
+//---------------------------------------------------------
+
+void Shape::add(const Shape& s, const QPointF& offset)
+      {
+      for (const ShapeElement& r : s)
+#ifndef NDEBUG
+            add(r.translated(offset), r.text);
+#else
+            add(r.translated(offset));
+#endif
+      }
+
 //---------------------------------------------------------
 //   draw
 //    Draw outline of shape. For testing only.
@@ -69,6 +88,63 @@ void Shape::draw(QPainter* p) const
       p->restore();
       }
 
+//---------------------------------------------------------
+//   ShapeInterval
+//    extent of a shape element along the axis in which two
+//    elements have to overlap to collide, and the coordinate
+//    used for the distance
+//---------------------------------------------------------
+
+struct ShapeInterval {
+      qreal lo;
+      qreal hi;
+      qreal val;
+      };
+
+//---------------------------------------------------------
+//   maxOverlapDistance
+//    Computes max(a.val - b.val) over all pairs of
+//    overlapping intervals (a.lo < b.hi && a.hi > b.lo).
+//    b is swept in decreasing lo order; all a reaching
+//    beyond b.lo are entered into a Fenwick tree ordered by
+//    a.lo, so every b is a single prefix maximum query.
+//---------------------------------------------------------
+
+static qreal maxOverlapDistance(std::vector<ShapeInterval>& a, std::vector<ShapeInterval>& b, qreal dist)
+      {
+      if (a.empty() || b.empty())
+            return dist;
+      const qreal minReal = -std::numeric_limits<qreal>::max();
+      const int n = int(a.size());
+
+      std::sort(a.begin(), a.end(), [](const ShapeInterval& i1, const ShapeInterval& i2) { return i1.lo < i2.lo; });
+      std::sort(b.begin(), b.end(), [](const ShapeInterval& i1, const ShapeInterval& i2) { return i1.lo > i2.lo; });
+      std::vector<qreal> lo(n);
+      std::vector<int> byHi(n);
+      for (int i = 0; i < n; ++i) {
+            lo[i]   = a[i].lo;
+            byHi[i] = i;
+            }
+      std::sort(byHi.begin(), byHi.end(), [&a](int i1, int i2) { return a[i1].hi > a[i2].hi; });
+
+      std::vector<qreal> tree(n + 1, minReal);
+      int next = 0;
+      for (const ShapeInterval& r : b) {
+            for (; next < n && a[byHi[next]].hi > r.lo; ++next) {
+                  qreal val = a[byHi[next]].val;
+                  for (int i = byHi[next] + 1; i <= n; i += i & -i)
+                        tree[i] = qMax(tree[i], val);
+                  }
+            int k = int(std::lower_bound(lo.begin(), lo.end(), r.hi) - lo.begin());
+            qreal m = minReal;
+            for (int i = k; i > 0; i -= i & -i)
+                  m = qMax(m, tree[i]);
+            if (m != minReal)
+                  dist = qMax(dist, m - r.val);
+            }
+      return dist;
+      }
+
 //-------------------------------------------------------------------
 //   minHorizontalDistance
 //    a is located right of this shape.
@@ -77,6 +153,18 @@ void Shape::draw(QPainter* p) const
 //-------------------------------------------------------------------
 
 qreal Shape::minHorizontalDistance(const Shape& a) const
+      {
+      if (size() * a.size() <= SORTED_DISTANCE_THRESHOLD)
+            return minHorizontalDistancePairwise(a);
+      return minHorizontalDistanceSorted(a);
+      }
+
+//-------------------------------------------------------------------
+//   minHorizontalDistancePairwise
+//    compare every element of this shape with every element of a
+//-------------------------------------------------------------------
+
+qreal Shape::minHorizontalDistancePairwise(const Shape& a) const
       {
       qreal dist = -1000000.0;      // min real
       for (const QRectF& r2 : a) {
@@ -94,6 +182,72 @@ qreal Shape::minHorizontalDistance(const Shape& a) const
       return dist;
       }
 
+//-------------------------------------------------------------------
+//   minHorizontalDistanceSorted
+//    same result as minHorizontalDistancePairwise() in
+//    O((n+m) log n) for shapes with many elements
+//-------------------------------------------------------------------
+
+qreal Shape::minHorizontalDistanceSorted(const Shape& a) const
+      {
+      qreal dist = -1000000.0;      // min real
+      if (empty() || a.empty())
+            return dist;
+
+      // elements of zero width collide with every element of the other shape
+
+      qreal right = -std::numeric_limits<qreal>::max();
+      qreal left  = std::numeric_limits<qreal>::max();
+      for (const QRectF& r1 : *this)
+            right = qMax(right, r1.right());
+      for (const QRectF& r2 : a)
+            left = qMin(left, r2.left());
+      for (const QRectF& r1 : *this) {
+            if (r1.width() == 0.0)
+                  dist = qMax(dist, r1.right() - left);
+            }
+      for (const QRectF& r2 : a) {
+            if (r2.width() == 0.0)
+                  dist = qMax(dist, right - r2.left());
+            }
+
+      // elements of zero height collide if they are on the same line
+
+      std::vector<std::pair<qreal, qreal>> lines;     // top, right
+      for (const QRectF& r1 : *this) {
+            if (r1.height() == 0.0)
+                  lines.push_back(std::make_pair(r1.top(), r1.right()));
+            }
+      if (!lines.empty()) {
+            std::sort(lines.begin(), lines.end());
+            for (const QRectF& r2 : a) {
+                  if (r2.height() != 0.0)
+                        continue;
+                  // lines are sorted by right within the same top, use the last one
+                  auto i = std::upper_bound(lines.begin(), lines.end(), r2.top(),
+                     [](qreal y, const std::pair<qreal, qreal>& l) { return y < l.first; });
+                  if (i != lines.begin() && (i - 1)->first == r2.top())
+                        dist = qMax(dist, (i - 1)->second - r2.left());
+                  }
+            }
+
+      // all other elements collide if they overlap vertically
+
+      std::vector<ShapeInterval> i1;
+      std::vector<ShapeInterval> i2;
+      i1.reserve(size());
+      i2.reserve(a.size());
+      for (const QRectF& r1 : *this) {
+            if (r1.top() != r1.bottom())
+                  i1.push_back({ r1.top(), r1.bottom(), r1.right() });
+            }
+      for (const QRectF& r2 : a) {
+            if (r2.top() != r2.bottom())
+                  i2.push_back({ r2.top(), r2.bottom(), r2.left() });
+            }
+      return maxOverlapDistance(i1, i2, dist);
+      }
+
 //-------------------------------------------------------------------
 //   minVerticalDistance
 //    a is located below of this shape.
@@ -101,6 +255,18 @@ qreal Shape::minHorizontalDistance(const Shape& a) const
 //-------------------------------------------------------------------
 
 qreal Shape::minVerticalDistance(const Shape& a) const
+      {
+      if (size() * a.size() <= SORTED_DISTANCE_THRESHOLD)
+            return minVerticalDistancePairwise(a);
+      return minVerticalDistanceSorted(a);
+      }
+
+//-------------------------------------------------------------------
+//   minVerticalDistancePairwise
+//    compare every element of this shape with every element of a
+//-------------------------------------------------------------------
+
+qreal Shape::minVerticalDistancePairwise(const Shape& a) const
       {
       qreal dist = -1000000.0;      // min real
       for (const QRectF& r2 : a) {
@@ -116,6 +282,29 @@ qreal Shape::minVerticalDistance(const Shape& a) const
       return dist;
       }
 
+//-------------------------------------------------------------------
+//   minVerticalDistanceSorted
+//    same result as minVerticalDistancePairwise() in
+//    O((n+m) log n) for shapes with many elements
+//-------------------------------------------------------------------
+
+qreal Shape::minVerticalDistanceSorted(const Shape& a) const
+      {
+      std::vector<ShapeInterval> i1;
+      std::vector<ShapeInterval> i2;
+      i1.reserve(size());
+      i2.reserve(a.size());
+      for (const QRectF& r1 : *this) {
+            if (r1.left() != r1.right())
+                  i1.push_back({ r1.left(), r1.right(), r1.bottom() });
+            }
+      for (const QRectF& r2 : a) {
+            if (r2.left() != r2.right())
+                  i2.push_back({ r2.left(), r2.right(), r2.top() });
+            }
+      return maxOverlapDistance(i1, i2, -1000000.0);
+      }
+
 //---------------------------------------------------------
 //   left
 //    compute left border
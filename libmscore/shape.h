@@ -21,6 +21,10 @@ namespace Ms {
 
 class Segment;
 
+// above this number of element pairs the distance functions sort the
+// elements instead of comparing all pairs
+static const int SORTED_DISTANCE_THRESHOLD = 64;
+
 //---------------------------------------------------------
 //   ShapeElement
 //---------------------------------------------------------
@@ -50,6 +54,7 @@ class Shape : std::vector<ShapeElement> {
       void draw(QPainter*) const;
 
       void add(const Shape& s)            { insert(end(), s.begin(), s.end()); }
+      void add(const Shape& s, const QPointF& offset);
 #ifndef NDEBUG
       void add(const QRectF& r, const char* t = 0);
 #else
@@ -65,6 +70,10 @@ class Shape : std::vector<ShapeElement> {
 
       qreal minHorizontalDistance(const Shape&) const;
       qreal minVerticalDistance(const Shape&) const;
+      qreal minHorizontalDistancePairwise(const Shape&) const;
+      qreal minHorizontalDistanceSorted(const Shape&) const;
+      qreal minVerticalDistancePairwise(const Shape&) const;
+      qreal minVerticalDistanceSorted(const Shape&) const;
       qreal topDistance(const QPointF&) const;
       qreal bottomDistance(const QPointF&) const;
       qreal left() const;
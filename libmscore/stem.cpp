@@ -26,6 +26,8 @@
 
 namespace Ms {
 
+DEFINE_MEMORY_POOL(Stem)
+
 static const ElementStyle stemStyle {
       { Sid::stemWidth,                          Pid::LINE_WIDTH              },
       };
@@ -14,6 +14,7 @@
 #define __STEM_H__
 
 #include "element.h"
+#include "mempool.h"
 
 namespace Ms {
 
@@ -30,6 +31,8 @@ class Stem final : public Element {
       qreal _userLen;
       qreal _len       { 0.0 };     // always positive
 
+      DECLARE_MEMORY_POOL
+
    public:
       Stem(Score* = 0);
       Stem &operator=(const Stem&) = delete;
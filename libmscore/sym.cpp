@@ -25,6 +25,10 @@ static FT_Library ftlib;
 
 namespace Ms {
 
+static QMutex fontLoadMutex(QMutex::Recursive); // score fonts are loaded on first use, possibly
+                                                // from several -j conversion threads at once
+static QMutex glyphMutex;                       // protects FT glyph slot and glyph cache
+
 
 //---------------------------------------------------------
 //   scoreFonts
@@ -5644,6 +5648,7 @@ void ScoreFont::draw(SymId id, QPainter* painter, const QSizeF& mag, const QPoin
                   qDebug("ScoreFont::draw: invalid sym %d", int(id));
             return;
             }
+      QMutexLocker locker(&glyphMutex);
       int rv = FT_Load_Glyph(face, sym(id).index(), FT_LOAD_DEFAULT);
       if (rv) {
             qDebug("load glyph id %d, failed: 0x%x", int(id), rv);
@@ -6192,6 +6197,7 @@ ScoreFont* ScoreFont::fontFactory(QString s)
             return fallbackFont();
             }
 
+      QMutexLocker locker(&fontLoadMutex);
       if (!f->face)
             f->load();
       return f;
@@ -6204,6 +6210,7 @@ ScoreFont* ScoreFont::fontFactory(QString s)
 ScoreFont* ScoreFont::fallbackFont()
       {
       ScoreFont* f = &_scoreFonts[FALLBACK_FONT];
+      QMutexLocker locker(&fontLoadMutex);
       if (!f->face)
             f->load();
       return f;
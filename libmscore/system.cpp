@@ -15,6 +15,8 @@
  Implementation of classes SysStaff and System.
 */
 
+#include <atomic>
+
 #include "system.h"
 #include "measure.h"
 #include "segment.h"
@@ -63,6 +65,19 @@ SysStaff::~SysStaff()
 System::System(Score* s)
    : Element(s)
       {
+      newLayoutGeneration();
+      }
+
+//---------------------------------------------------------
+//   newLayoutGeneration
+//    generations are unique for all systems, -j conversions
+//    lay out scores in parallel
+//---------------------------------------------------------
+
+void System::newLayoutGeneration()
+      {
+      static std::atomic<int> generations { 0 };
+      _layoutGeneration = ++generations;
       }
 
 //---------------------------------------------------------
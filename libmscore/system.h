@@ -83,6 +83,7 @@ class System final : public Element {
       qreal _leftMargin              { 0.0    };     ///< left margin for instrument name, brackets etc.
       mutable bool fixedDownDistance { false  };
       qreal _distance;                                 // temp. variable used during layout
+      int _layoutGeneration;                           // changes when the system is laid out again
 
    public:
       System(Score*);
@@ -98,6 +99,9 @@ class System final : public Element {
 
       virtual void scanElements(void* data, void (*func)(void*, Element*), bool all=true) override;
 
+      int layoutGeneration() const                { return _layoutGeneration; }
+      void newLayoutGeneration();
+
       void appendMeasure(MeasureBase*);
 
       Page* page() const                    { return (Page*)parent(); }
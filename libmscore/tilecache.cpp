@@ -0,0 +1,276 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2018 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "tilecache.h"
+#include "score.h"
+#include "page.h"
+#include "system.h"
+#include "mscore.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   clear
+//---------------------------------------------------------
+
+void TileCache::clear()
+      {
+      tiles.clear();
+      }
+
+//---------------------------------------------------------
+//   prune
+//    remove the tiles of systems which are gone
+//---------------------------------------------------------
+
+void TileCache::prune(Score* score)
+      {
+      QSet<const System*> systems;
+      for (const System* s : score->systems())
+            systems.insert(s);
+      for (auto i = tiles.begin(); i != tiles.end();) {
+            if (systems.contains(i.key()))
+                  ++i;
+            else
+                  i = tiles.erase(i);
+            }
+      }
+
+//---------------------------------------------------------
+//   bands
+//    Cut the page image at scale between its systems,
+//    one band per system. The bands start and end on
+//    whole pixel rows and cover the page.
+//---------------------------------------------------------
+
+QList<QRect> TileCache::bands(Page* page, qreal scale)
+      {
+      int width  = int(page->width() * scale);
+      int height = int(page->height() * scale);
+      QList<QRect> bl;
+      const QList<System*>& sl = page->systems();
+      int top = 0;
+      for (int i = 0; i < sl.size(); ++i) {
+            int bottom = height;
+            if (i + 1 < sl.size()) {
+                  qreal y1 = sl[i]->y() + sl[i]->bbox().bottom();
+                  qreal y2 = sl[i+1]->y() + sl[i+1]->bbox().top();
+                  bottom   = qBound(top, qRound((y1 + y2) * .5 * scale), height);
+                  }
+            bl.append(QRect(0, top, width, bottom - top));
+            top = bottom;
+            }
+      if (bl.isEmpty())
+            bl.append(QRect(0, 0, width, height));
+      return bl;
+      }
+
+//---------------------------------------------------------
+//   blankImage
+//---------------------------------------------------------
+
+QImage TileCache::blankImage(const QSize& size)
+      {
+      QImage image(size, QImage::Format_ARGB32_Premultiplied);
+      if (image.isNull())
+            return image;
+      int dpm = lrint(DPMM * 1000.0);
+      image.setDotsPerMeterX(dpm);
+      image.setDotsPerMeterY(dpm);
+      image.fill(0xffffffff);
+      return image;
+      }
+
+//---------------------------------------------------------
+//   pixels
+//    the pixels at scale e can paint, relative to the page;
+//    antialiasing may paint a pixel beyond the bounding box
+//---------------------------------------------------------
+
+QRect TileCache::pixels(const Element* e, qreal scale)
+      {
+      QRectF r = e->pageBoundingRect();
+      return QRectF(r.topLeft() * scale, r.size() * scale).toAlignedRect().adjusted(-2, -2, 2, 2);
+      }
+
+//---------------------------------------------------------
+//   elements
+//    the visible elements which can paint into rect r
+//    (pixels at scale), in z order
+//---------------------------------------------------------
+
+QList<Element*> TileCache::elements(Page* page, const QRect& r, qreal scale)
+      {
+      QRectF fr(QPointF(r.left() - 2, r.top() - 2) / scale, QSizeF(r.width() + 4, r.height() + 4) / scale);
+      QList<Element*> el;
+      for (Element* e : page->items(fr)) {
+            if (e->visible())
+                  el.append(e);
+            }
+      qStableSort(el.begin(), el.end(), elementLessThan);
+      return el;
+      }
+
+//---------------------------------------------------------
+//   areas
+//    the pixels painted by the elements of each system
+//---------------------------------------------------------
+
+QVector<TileCache::Area> TileCache::areas(const QList<Element*>& el, qreal scale)
+      {
+      QVector<Area> al;
+      for (const Element* e : el) {
+            const Element* p = e;
+            while (p && !p->isSystem())
+                  p = p->parent();
+            if (!p)
+                  continue;
+            int g = toSystem(p)->layoutGeneration();
+            auto i = std::find_if(al.begin(), al.end(), [g](const Area& a) { return a.generation == g; });
+            if (i == al.end())
+                  al.append(Area { g, pixels(e, scale) });
+            else
+                  i->rect |= pixels(e, scale);
+            }
+      return al;
+      }
+
+//---------------------------------------------------------
+//   changed
+//    the pixels of the systems which are only in one of
+//    the lists, laid out again or gone
+//---------------------------------------------------------
+
+QRect TileCache::changed(const QVector<Area>& al1, const QVector<Area>& al2)
+      {
+      auto contains = [](const QVector<Area>& al, int g) {
+            return std::any_of(al.begin(), al.end(), [g](const Area& a) { return a.generation == g; });
+            };
+      QRect r;
+      for (const Area& a : al1) {
+            if (!contains(al2, a.generation))
+                  r |= a.rect;
+            }
+      for (const Area& a : al2) {
+            if (!contains(al1, a.generation))
+                  r |= a.rect;
+            }
+      return r;
+      }
+
+//---------------------------------------------------------
+//   render
+//    paint rect r of the image of rect band of the page
+//    at scale (pixels relative to the page) with those
+//    elements which reach into it, the way Score::print()
+//    does
+//---------------------------------------------------------
+
+void TileCache::render(QImage* image, Page* page, const QList<Element*>& el, const QRect& band, const QRect& r, qreal scale)
+      {
+      if (image->isNull())
+            return;
+      Score* score  = page->score();
+      bool printing = score->printing();
+      bool pdf      = MScore::pdfPrinting;
+      score->setPrinting(true);
+      MScore::pdfPrinting = true;         // symbols as text, not as cached screen pixmaps
+
+      QPainter p(image);
+      QRect clip = r.translated(-band.topLeft());
+      p.setClipRect(clip);
+      p.fillRect(clip, Qt::white);
+      p.setRenderHint(QPainter::Antialiasing, true);
+      p.setRenderHint(QPainter::TextAntialiasing, true);
+      p.translate(-band.topLeft());
+      p.scale(scale, scale);
+      for (const Element* e : el) {
+            if (!r.intersects(pixels(e, scale)))
+                  continue;
+            p.save();
+            p.translate(e->pagePos());
+            e->draw(&p);
+            p.restore();
+            }
+      p.end();
+
+      MScore::pdfPrinting = pdf;
+      score->setPrinting(printing);
+      }
+
+//---------------------------------------------------------
+//   paintPage
+//    paint the page with the cached images of its bands,
+//    painter is in page coordinates
+//---------------------------------------------------------
+
+void TileCache::paintPage(QPainter* p, Page* page)
+      {
+      const QList<System*>& sl = page->systems();
+      QVector<int> pageGenerations;
+      for (const System* s : sl)
+            pageGenerations.append(s->layoutGeneration());
+      QList<QRect> bl = bands(page, _scale);
+      p->save();
+      p->scale(1.0 / _scale, 1.0 / _scale);     // pixels at scale
+      for (int i = 0; i < bl.size(); ++i) {
+            const QRect& r = bl[i];
+            if (sl.isEmpty()) {
+                  QImage image = blankImage(r.size());
+                  render(&image, page, elements(page, r, _scale), r, r, _scale);
+                  p->drawImage(r.topLeft(), image);
+                  continue;
+                  }
+            Tile& t = tiles[sl[i]];
+            if (t.scale != _scale || t.rect != r || t.image.isNull()) {
+                  QList<Element*> el = elements(page, r, _scale);
+                  t.scale = _scale;
+                  t.rect  = r;
+                  t.areas = areas(el, _scale);
+                  t.image = blankImage(r.size());
+                  render(&t.image, page, el, r, r, _scale);
+                  }
+            else if (t.pageGenerations != pageGenerations) {
+                  // paint the pixels of the changed systems again
+                  QList<Element*> el = elements(page, r, _scale);
+                  QVector<Area> al   = areas(el, _scale);
+                  QRect dirty        = changed(t.areas, al) & r;
+                  if (!dirty.isEmpty())
+                        render(&t.image, page, el, r, dirty, _scale);
+                  t.areas = al;
+                  }
+            t.pageGenerations = pageGenerations;
+            if (!t.image.isNull())
+                  p->drawImage(r.topLeft(), t.image);
+            }
+      p->restore();
+      }
+
+//---------------------------------------------------------
+//   pageImage
+//    the page at scale, painted from the cache; it is the
+//    image Score::print() paints
+//---------------------------------------------------------
+
+QImage TileCache::pageImage(Page* page)
+      {
+      QImage image = blankImage(QSize(int(page->width() * _scale), int(page->height() * _scale)));
+      if (image.isNull())
+            return image;
+      QPainter p(&image);
+      p.scale(_scale, _scale);
+      paintPage(&p, page);
+      p.end();
+      return image;
+      }
+
+}     // namespace Ms
@@ -0,0 +1,82 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2018 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __TILECACHE_H__
+#define __TILECACHE_H__
+
+#include <QImage>
+#include <QHash>
+
+namespace Ms {
+
+class Score;
+class Page;
+class System;
+class Element;
+
+//---------------------------------------------------------
+//   TileCache
+//    Raster images of the pages of a score at one scale,
+//    for previews like the navigator and the thumbnail.
+//    A page is cut into horizontal bands, one around each
+//    system. A band is painted like Score::print() paints
+//    the page, with all elements that reach into it in
+//    z order, so the bands put together are the printed
+//    page.
+//    Nothing is looked up while no system of the page was
+//    laid out again or moved (System::layoutGeneration()).
+//    Otherwise only the pixels of the systems which
+//    changed are painted again, on the GUI thread: the
+//    symbols are drawn with the fonts of the GUI thread.
+//---------------------------------------------------------
+
+class TileCache {
+      struct Area {
+            int generation;                     // of a system with elements in the band
+            QRect rect;                         // the pixels they paint
+            };
+      struct Tile {
+            QRect rect;                         // pixels at scale, relative to the page
+            qreal scale { 0.0 };
+            QVector<int> pageGenerations;       // of all systems of the page
+            QVector<Area> areas;
+            QImage image;
+            };
+
+      QHash<const System*, Tile> tiles;
+      qreal _scale { 1.0 };
+
+      static QImage blankImage(const QSize&);
+      static QList<QRect> bands(Page*, qreal scale);
+      static QRect pixels(const Element*, qreal scale);
+      static QList<Element*> elements(Page*, const QRect&, qreal scale);
+      static QVector<Area> areas(const QList<Element*>&, qreal scale);
+      static QRect changed(const QVector<Area>&, const QVector<Area>&);
+      static void render(QImage*, Page*, const QList<Element*>&, const QRect& band, const QRect& r, qreal scale);
+
+   public:
+      TileCache() {}
+      TileCache(const TileCache&) = delete;
+      TileCache& operator=(const TileCache&) = delete;
+
+      void setScale(qreal val)                        { _scale = val; }
+      qreal scale() const                             { return _scale; }
+      void clear();
+      void prune(Score*);
+
+      void paintPage(QPainter*, Page*);
+      QImage pageImage(Page*);
+      };
+
+}     // namespace Ms
+#endif
+
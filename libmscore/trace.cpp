@@ -0,0 +1,277 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2018 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "trace.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   TraceEvent
+//    a complete event ('X') or a counter ('C')
+//---------------------------------------------------------
+
+struct TraceEvent {
+      const char* category;
+      const char* name;
+      char phase;
+      int thread;                   // tid in the trace
+      qint64 start;                 // ns
+      qint64 value;                 // end for 'X'
+      };
+
+//---------------------------------------------------------
+//   TraceBuffer
+//    The events of one thread, a ring buffer. Only the
+//    thread writes tail and the events, only clear()
+//    writes start; the events from start to tail, at most
+//    BUFFER_SIZE of them, are in the buffer. save() reads
+//    while the thread records and drops the events which
+//    were overwritten while it copied them.
+//---------------------------------------------------------
+
+struct TraceBuffer {
+      TraceEvent events[Trace::BUFFER_SIZE];
+      std::atomic<unsigned> start { 0 };
+      std::atomic<unsigned> tail  { 0 };
+
+      unsigned overwritten() const {
+            unsigned n = tail.load(std::memory_order_acquire) - start.load(std::memory_order_relaxed);
+            return n > unsigned(Trace::BUFFER_SIZE) ? n - Trace::BUFFER_SIZE : 0;
+            }
+      };
+
+//---------------------------------------------------------
+//   TraceSlot
+//    the buffer of a thread, given back when the thread
+//    finishes
+//---------------------------------------------------------
+
+struct TraceSlot {
+      int idx    { -1 };            // -2: no buffer left for the thread
+      int thread { 0 };
+      ~TraceSlot();
+      };
+
+std::atomic<bool> Trace::_enabled { false };
+const int Trace::BUFFER_SIZE;
+const int Trace::MAX_THREADS;
+
+static QMutex traceMutex;                                  // serializes clear() and save()
+static std::atomic<TraceBuffer*> buffers[Trace::MAX_THREADS];   // never freed
+static std::atomic<bool> usedBuffers[Trace::MAX_THREADS];
+static std::atomic<int> threads { 0 };
+static std::atomic<qint64> unbuffered { 0 };               // events of threads without a buffer
+static thread_local TraceSlot slot;
+
+TraceSlot::~TraceSlot()
+      {
+      if (idx >= 0)
+            usedBuffers[idx].store(false, std::memory_order_release);
+      }
+
+//---------------------------------------------------------
+//   clock
+//---------------------------------------------------------
+
+static QElapsedTimer& clock()
+      {
+      static QElapsedTimer timer;
+      return timer;
+      }
+
+//---------------------------------------------------------
+//   takeBuffer
+//    find a buffer for the calling thread
+//---------------------------------------------------------
+
+static void takeBuffer()
+      {
+      slot.idx    = -2;
+      slot.thread = ++threads;
+      for (int i = 0; i < Trace::MAX_THREADS; ++i) {
+            bool used = false;
+            if (!usedBuffers[i].compare_exchange_strong(used, true, std::memory_order_acquire))
+                  continue;
+            if (!buffers[i].load(std::memory_order_relaxed))
+                  buffers[i].store(new TraceBuffer, std::memory_order_release);
+            slot.idx = i;
+            return;
+            }
+      }
+
+//---------------------------------------------------------
+//   record
+//    add e to the buffer of the calling thread
+//---------------------------------------------------------
+
+static void record(TraceEvent e)
+      {
+      if (slot.idx == -1)
+            takeBuffer();
+      if (slot.idx < 0) {
+            ++unbuffered;
+            return;
+            }
+      TraceBuffer* b = buffers[slot.idx].load(std::memory_order_relaxed);
+      unsigned tail  = b->tail.load(std::memory_order_relaxed);
+      e.thread       = slot.thread;
+      b->events[tail & (Trace::BUFFER_SIZE - 1)] = e;
+      b->tail.store(tail + 1, std::memory_order_release);
+      }
+
+//---------------------------------------------------------
+//   start
+//---------------------------------------------------------
+
+void Trace::start()
+      {
+      QMutexLocker lock(&traceMutex);
+      if (!clock().isValid())
+            clock().start();
+      _enabled = true;
+      }
+
+//---------------------------------------------------------
+//   stop
+//---------------------------------------------------------
+
+void Trace::stop()
+      {
+      _enabled = false;
+      }
+
+//---------------------------------------------------------
+//   clear
+//---------------------------------------------------------
+
+void Trace::clear()
+      {
+      QMutexLocker lock(&traceMutex);
+      for (int i = 0; i < MAX_THREADS; ++i) {
+            TraceBuffer* b = buffers[i].load(std::memory_order_acquire);
+            if (b)
+                  b->start.store(b->tail.load(std::memory_order_acquire), std::memory_order_relaxed);
+            }
+      unbuffered = 0;
+      }
+
+//---------------------------------------------------------
+//   dropped
+//    the events recorded since clear() which are not in
+//    the trace
+//---------------------------------------------------------
+
+qint64 Trace::dropped()
+      {
+      QMutexLocker lock(&traceMutex);
+      qint64 n = unbuffered;
+      for (int i = 0; i < MAX_THREADS; ++i) {
+            TraceBuffer* b = buffers[i].load(std::memory_order_acquire);
+            if (b)
+                  n += b->overwritten();
+            }
+      return n;
+      }
+
+//---------------------------------------------------------
+//   now
+//---------------------------------------------------------
+
+qint64 Trace::now()
+      {
+      return clock().nsecsElapsed();
+      }
+
+//---------------------------------------------------------
+//   complete
+//---------------------------------------------------------
+
+void Trace::complete(const char* category, const char* name, qint64 start, qint64 end)
+      {
+      record({ category, name, 'X', 0, start, end });
+      }
+
+//---------------------------------------------------------
+//   counter
+//---------------------------------------------------------
+
+void Trace::counter(const char* category, const char* name, qint64 value)
+      {
+      record({ category, name, 'C', 0, now(), value });
+      }
+
+//---------------------------------------------------------
+//   save
+//    write the trace in the Chrome trace event format,
+//    times are in microseconds
+//---------------------------------------------------------
+
+bool Trace::save(const QString& path)
+      {
+      QFile f(path);
+      if (!f.open(QIODevice::WriteOnly)) {
+            qDebug("Trace::save: cannot write <%s>", qPrintable(path));
+            return false;
+            }
+      QTextStream out(&f);
+      out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+      out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"MuseScore\"}}";
+      // copy the events, the threads go on recording
+      std::vector<TraceEvent> events;
+      qint64 lost = 0;
+      {
+      QMutexLocker lock(&traceMutex);
+      lost = unbuffered;
+      for (int i = 0; i < MAX_THREADS; ++i) {
+            TraceBuffer* b = buffers[i].load(std::memory_order_acquire);
+            if (!b)
+                  continue;
+            unsigned tail  = b->tail.load(std::memory_order_acquire);
+            unsigned first = b->start.load(std::memory_order_relaxed);
+            if (tail - first > unsigned(BUFFER_SIZE)) {
+                  lost += tail - first - BUFFER_SIZE;
+                  first = tail - BUFFER_SIZE;
+                  }
+            size_t n = events.size();
+            for (unsigned k = first; k != tail; ++k)
+                  events.push_back(b->events[k & (BUFFER_SIZE - 1)]);
+            // the oldest copied events may have been overwritten meanwhile
+            std::atomic_thread_fence(std::memory_order_acquire);
+            unsigned after = b->tail.load(std::memory_order_relaxed);
+            if (after - first > unsigned(BUFFER_SIZE)) {
+                  unsigned over = qMin(after - first - BUFFER_SIZE, tail - first);
+                  events.erase(events.begin() + n, events.begin() + n + over);
+                  lost += over;
+                  }
+            }
+      }
+      if (lost)
+            qWarning("Trace::save: %lld events dropped", lost);
+      for (const TraceEvent& e : events) {
+            out << ",\n{\"cat\":\"" << e.category << "\",\"name\":\"" << e.name
+                << "\",\"ph\":\"" << e.phase << "\",\"pid\":1,\"tid\":" << e.thread
+                << ",\"ts\":" << QString::number(e.start / 1000.0, 'f', 3);
+            if (e.phase == 'X')
+                  out << ",\"dur\":" << QString::number((e.value - e.start) / 1000.0, 'f', 3) << "}";
+            else
+                  out << ",\"args\":{\"" << e.name << "\":" << e.value << "}}";
+            }
+      out << "\n]";
+      if (lost)
+            out << ",\"otherData\":{\"droppedEvents\":" << lost << "}";
+      out << "}\n";
+      out.flush();
+      return f.error() == QFile::NoError;
+      }
+
+}     // namespace Ms
+
@@ -0,0 +1,89 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2018 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <atomic>
+#include "config.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   Trace
+//    Timings and counters of the hot paths, saved as
+//    Chrome trace events (chrome://tracing, Perfetto).
+//    Nothing is recorded until start() is called. Every
+//    thread records into its own fixed size ring buffer,
+//    without locks, so the audio thread never waits. When
+//    the buffer is full the oldest events are dropped.
+//    The buffer of a thread is allocated with its first
+//    event, and taken over by a new thread after the
+//    thread has finished.
+//    Use the TRACE_ macros, they are empty if MuseScore
+//    is built without MSCORE_TRACE.
+//---------------------------------------------------------
+
+class Trace {
+      static std::atomic<bool> _enabled;
+
+   public:
+      static const int BUFFER_SIZE = 1 << 15;     // events per thread, a power of two
+      // threads recording at the same time: the render pool
+      // has up to 31 workers, plus the GUI, audio and -j threads
+      static const int MAX_THREADS = 48;
+
+      static bool enabled()         { return _enabled.load(std::memory_order_relaxed); }
+      static void start();
+      static void stop();
+      static void clear();
+      static bool save(const QString& path);
+      static qint64 dropped();
+
+      static qint64 now();
+      static void complete(const char* category, const char* name, qint64 start, qint64 end);
+      static void counter(const char* category, const char* name, qint64 value);
+      };
+
+//---------------------------------------------------------
+//   TraceScope
+//    records the time from construction to destruction
+//---------------------------------------------------------
+
+class TraceScope {
+      const char* _category;
+      const char* _name;
+      qint64 _start;
+
+   public:
+      TraceScope(const char* category, const char* name)
+         : _category(category), _name(name), _start(Trace::enabled() ? Trace::now() : -1) {}
+      ~TraceScope() {
+            if (_start >= 0)
+                  Trace::complete(_category, _name, _start, Trace::now());
+            }
+      };
+
+#ifdef MSCORE_TRACE
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT2(a, b)
+#define TRACE_SCOPE(category, name) Ms::TraceScope TRACE_CONCAT(traceScope, __LINE__)(category, name)
+#define TRACE_COUNTER(category, name, value) \
+      do { if (Ms::Trace::enabled()) Ms::Trace::counter(category, name, value); } while (0)
+#else
+#define TRACE_SCOPE(category, name)
+#define TRACE_COUNTER(category, name, value) do {} while (0)
+#endif
+
+}     // namespace Ms
+#endif
+
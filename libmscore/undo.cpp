@@ -921,7 +921,7 @@ void ChangePitch::flip(EditData*)
       tpc1  = f_tpc1;
       tpc2  = f_tpc2;
 
-      note->score()->setLayout(note->tick());
+      note->score()->setLayoutStaff(note->tick(), note->staff());
       }
 
 //---------------------------------------------------------
@@ -963,7 +963,7 @@ void ChangeFretting::flip(EditData*)
       fret  = f_fret;
       tpc1  = f_tpc1;
       tpc2  = f_tpc2;
-      note->score()->setLayout(note->tick());
+      note->score()->setLayoutStaff(note->tick(), note->staff());
       }
 
 //---------------------------------------------------------
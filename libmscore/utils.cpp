@@ -49,40 +49,36 @@ Measure* Score::tick2measure(int tick) const
       if (tick == -1)
             return lastMeasure();
 
-//      Q_ASSERT(firstMeasure());
-      Measure* lm = 0;
-      for (Measure* m = firstMeasure(); m; m = m->nextMeasure()) {
-            if (tick < m->tick())
-                  return lm;
-            lm = m;
-            }
-      // check last measure
-      if (lm && (tick >= lm->tick()) && (tick <= lm->endTick()))
-            return lm;
-      qDebug("tick2measure %d (max %d) not found", tick, lm ? lm->tick() : -1);
-      return 0;
+      Measure* m = _measures.tick2measure(tick);
+      if (!m && tick >= 0 && lastMeasure())
+            qDebug("tick2measure %d (max %d) not found", tick, lastMeasure()->tick());
+      return m;
       }
 
 //---------------------------------------------------------
 //   tick2measureMM
+//    the multi measure rest replaces all measures it
+//    spans, so look up the measure and map it to the
+//    multi measure rest covering it
 //---------------------------------------------------------
 
 Measure* Score::tick2measureMM(int tick) const
       {
       if (tick == -1)
             return lastMeasureMM();
-      Measure* lm = 0;
 
-      for (Measure* m = firstMeasureMM(); m; m = m->nextMeasureMM()) {
-            if (tick < m->tick())
-                  return lm;
-            lm = m;
+      Measure* m = _measures.tick2measure(tick);
+      if (!m) {
+            if (tick >= 0 && lastMeasureMM())
+                  qDebug("tick2measureMM %d (max %d) not found", tick, lastMeasureMM()->tick());
+            return 0;
             }
-      // check last measure
-      if (lm && (tick >= lm->tick()) && (tick <= lm->endTick()))
-            return lm;
-      qDebug("tick2measureMM %d (max %d) not found", tick, lm ? lm->tick() : -1);
-      return 0;
+      if (styleB(Sid::createMultiMeasureRests)) {
+            const Measure* mmr = m->mmRest1();
+            if (mmr)
+                  return const_cast<Measure*>(mmr);
+            }
+      return m;
       }
 
 //---------------------------------------------------------
@@ -47,6 +47,43 @@ struct TextStyleMap {
       Tid ss;
       };
 
+//---------------------------------------------------------
+//   XmlTag
+//    the tags tested by the read() methods called most
+//    often while loading a score, see XmlReader::tagId()
+//---------------------------------------------------------
+
+enum class XmlTag : unsigned char {
+      UNKNOWN,
+      // elements
+      ACCIDENTAL, AMBITUS, ARPEGGIO, ARTICULATION, BAR_LINE,
+      BEAM, BEAM_MODE, BEND, BREATH, CHORD,
+      CHORD_LINE, CLEF, DYNAMIC, EVENT, EVENTS,
+      FERMATA, FIGURED_BASS, FINGERING, FRET_DIAGRAM, GLISSANDO,
+      HAIR_PIN, HARMONY, HOOK, IMAGE, INSTRUMENT_CHANGE,
+      JUMP, KEY_SIG, LET_RING, LYRICS, MARKER,
+      MEASURE_NUMBER, NOTE, NOTE_DOT, OTTAVA, PALM_MUTE,
+      PEDAL, REHEARSAL_MARK, REPEAT_MEASURE, REST, SEGMENT,
+      SLUR, STAFF_STATE, STAFF_TEXT, STEM, STEM_SLASH,
+      SYMBOL, SYSTEM_DIVIDER, SYSTEM_TEXT, TEMPO, TEXT,
+      TEXT_LINE, TIE, TIME_SIG, TREMOLO, TREMOLO_BAR,
+      TRILL, TUPLET, VIBRATO, VOLTA,
+      // properties
+      ACCIACCATURA, APPOGGIATURA, BREAK_MULTI_MEASURE_REST, COLOR, DOT_POSITION,
+      DOTS, DURATION, DURATION_TYPE, END_REPEAT, END_SPANNER,
+      FIXED, FIXED_LINE, FRET, GHOST, GRACE16,
+      GRACE16AFTER, GRACE32, GRACE32AFTER, GRACE4, GRACE8AFTER,
+      HEAD, HEAD_TYPE, IRREGULAR, LEADING_SPACE, LID,
+      LINE, MEASURE_NUMBER_MODE, MIRROR, MOVE, MULTI_MEASURE_REST,
+      NO_OFFSET, NO_STEM, OFFSET, PITCH, PLACEMENT,
+      PLAY, POS, SELECTED, SLASH_STYLE, SMALL,
+      START_REPEAT, STRETCH, STRING, SYS_INIT_BAR_LINE_TYPE, TAG,
+      TICK, TICK_OFFSET, TICKLEN, TPC, TPC2,
+      TRACK, TRAILING_SPACE, TUNING, VELO_TYPE, VELOCITY,
+      VISIBLE, VOICE, VSPACER, VSPACER_DOWN, VSPACER_FIXED,
+      VSPACER_UP, Z,
+      };
+
 //---------------------------------------------------------
 //   XmlReader
 //---------------------------------------------------------
@@ -75,6 +112,9 @@ class XmlReader : public QXmlStreamReader {
 
       QList<TextStyleMap> userTextStyles;
 
+      QString _text;                      // buffer of readText(), keeps its capacity
+      const QString& readText();
+
    public:
       XmlReader(QFile* f) : QXmlStreamReader(f), docName(f->fileName()) {}
       XmlReader(const QByteArray& d, const QString& st = QString()) : QXmlStreamReader(d), docName(st)  {}
@@ -85,7 +125,7 @@ class XmlReader : public QXmlStreamReader {
       void unknown();
 
       // attribute helper routines:
-      QString attribute(const char* s) const { return attributes().value(s).toString(); }
+      QString attribute(const char* s) const { return attributes().value(QLatin1String(s)).toString(); }
       QString attribute(const char* s, const QString&) const;
       int intAttribute(const char* s) const;
       int intAttribute(const char* s, int _default) const;
@@ -93,11 +133,13 @@ class XmlReader : public QXmlStreamReader {
       double doubleAttribute(const char* s, double _default) const;
       bool hasAttribute(const char* s) const;
 
+      XmlTag tagId() const;
+
       // helper routines based on readElementText():
-      int readInt()         { return readElementText().toInt();      }
-      int readInt(bool* ok) { return readElementText().toInt(ok);    }
-      int readIntHex()      { return readElementText().toInt(0, 16); }
-      double readDouble()   { return readElementText().toDouble();   }
+      int readInt()         { return readText().toInt();      }
+      int readInt(bool* ok) { return readText().toInt(ok);    }
+      int readIntHex()      { return readText().toInt(0, 16); }
+      double readDouble()   { return readText().toDouble();   }
       double readDouble(double min, double max);
       bool readBool();
       QPointF readPoint();
@@ -153,6 +195,9 @@ class XmlReader : public QXmlStreamReader {
 
 //---------------------------------------------------------
 //   XmlWriter
+//    A QTextStream, all text is encoded by its UTF-8 codec.
+//    The typed tag() overloads only save the QVariant
+//    boxing and formatting.
 //---------------------------------------------------------
 
 class XmlWriter : public QTextStream {
@@ -176,8 +221,14 @@ class XmlWriter : public QTextStream {
       int _beamId         = { 1 };
 
       void putLevel();
+      void newLine();
+      void writeTag(const char* name, const QVariant& data);
+      template <class S> void writeTag(const S& name, const S& ename, const QVariant& data);
+      template <class T> void writeValue(const char* name, const T& value);
 
    public:
+      typedef std::vector<std::pair<const char*, QString>> Attributes;
+
       XmlWriter(Score*);
       XmlWriter(Score* s, QIODevice* dev);
 
@@ -210,7 +261,7 @@ class XmlWriter : public QTextStream {
       const Spanner* findSpanner(int id);
       int spannerId(const Spanner*);      // returns spanner id, allocates new one if none exists
 
-      void sTag(const char* name, Spatium sp) { XmlWriter::tag(name, QVariant(sp.val())); }
+      void sTag(const char* name, Spatium sp) { XmlWriter::tag(name, sp.val()); }
       void pTag(const char* name, PlaceText);
 
       void header();
@@ -227,8 +278,14 @@ class XmlWriter : public QTextStream {
       void tag(Pid id, QVariant data, QVariant defaultData = QVariant());
       void tag(const char* name, QVariant data, QVariant defaultData = QVariant());
       void tag(const QString&, QVariant data);
-      void tag(const char* name, const char* s)    { tag(name, QVariant(s)); }
-      void tag(const char* name, const QString& s) { tag(name, QVariant(s)); }
+      void tag(const char* name, const Attributes&, QVariant data);
+      void tag(const char* name, const char* s);
+      void tag(const char* name, const QString& s);
+      void tag(const char* name, int v);
+      void tag(const char* name, unsigned v)       { tag(name, int(v)); }
+      void tag(const char* name, qint64 v);
+      void tag(const char* name, quint64 v)        { tag(name, qint64(v)); }
+      void tag(const char* name, double v);
       void tag(const char* name, const QWidget*);
 
       void writeXml(const QString&, QString s);
@@ -28,16 +28,15 @@ namespace Ms {
 
 int XmlReader::intAttribute(const char* s, int _default) const
       {
-      if (attributes().hasAttribute(s))
-            // return attributes().value(s).toString().toInt();
-            return attributes().value(s).toInt();
+      if (attributes().hasAttribute(QLatin1String(s)))
+            return attributes().value(QLatin1String(s)).toInt();
       else
             return _default;
       }
 
 int XmlReader::intAttribute(const char* s) const
       {
-      return attributes().value(s).toInt();
+      return attributes().value(QLatin1String(s)).toInt();
       }
 
 //---------------------------------------------------------
@@ -46,13 +45,13 @@ int XmlReader::intAttribute(const char* s) const
 
 double XmlReader::doubleAttribute(const char* s) const
       {
-      return attributes().value(s).toDouble();
+      return attributes().value(QLatin1String(s)).toDouble();
       }
 
 double XmlReader::doubleAttribute(const char* s, double _default) const
       {
-      if (attributes().hasAttribute(s))
-            return attributes().value(s).toDouble();
+      if (attributes().hasAttribute(QLatin1String(s)))
+            return attributes().value(QLatin1String(s)).toDouble();
       else
             return _default;
       }
@@ -63,8 +62,8 @@ double XmlReader::doubleAttribute(const char* s, double _default) const
 
 QString XmlReader::attribute(const char* s, const QString& _default) const
       {
-      if (attributes().hasAttribute(s))
-            return attributes().value(s).toString();
+      if (attributes().hasAttribute(QLatin1String(s)))
+            return attributes().value(QLatin1String(s)).toString();
       else
             return _default;
       }
@@ -75,7 +74,233 @@ QString XmlReader::attribute(const char* s, const QString& _default) const
 
 bool XmlReader::hasAttribute(const char* s) const
       {
-      return attributes().hasAttribute(s);
+      return attributes().hasAttribute(QLatin1String(s));
+      }
+
+//---------------------------------------------------------
+//   xmlTagNames
+//---------------------------------------------------------
+
+struct XmlTagName {
+      XmlTag tag;
+      const char* name;
+      };
+
+static const XmlTagName xmlTagNames[] = {
+      { XmlTag::ACCIDENTAL,             "Accidental" },
+      { XmlTag::AMBITUS,                "Ambitus" },
+      { XmlTag::ARPEGGIO,               "Arpeggio" },
+      { XmlTag::ARTICULATION,           "Articulation" },
+      { XmlTag::BAR_LINE,               "BarLine" },
+      { XmlTag::BEAM,                   "Beam" },
+      { XmlTag::BEAM_MODE,              "BeamMode" },
+      { XmlTag::BEND,                   "Bend" },
+      { XmlTag::BREATH,                 "Breath" },
+      { XmlTag::CHORD,                  "Chord" },
+      { XmlTag::CHORD_LINE,             "ChordLine" },
+      { XmlTag::CLEF,                   "Clef" },
+      { XmlTag::DYNAMIC,                "Dynamic" },
+      { XmlTag::EVENT,                  "Event" },
+      { XmlTag::EVENTS,                 "Events" },
+      { XmlTag::FERMATA,                "Fermata" },
+      { XmlTag::FIGURED_BASS,           "FiguredBass" },
+      { XmlTag::FINGERING,              "Fingering" },
+      { XmlTag::FRET_DIAGRAM,           "FretDiagram" },
+      { XmlTag::GLISSANDO,              "Glissando" },
+      { XmlTag::HAIR_PIN,               "HairPin" },
+      { XmlTag::HARMONY,                "Harmony" },
+      { XmlTag::HOOK,                   "Hook" },
+      { XmlTag::IMAGE,                  "Image" },
+      { XmlTag::INSTRUMENT_CHANGE,      "InstrumentChange" },
+      { XmlTag::JUMP,                   "Jump" },
+      { XmlTag::KEY_SIG,                "KeySig" },
+      { XmlTag::LET_RING,               "LetRing" },
+      { XmlTag::LYRICS,                 "Lyrics" },
+      { XmlTag::MARKER,                 "Marker" },
+      { XmlTag::MEASURE_NUMBER,         "MeasureNumber" },
+      { XmlTag::NOTE,                   "Note" },
+      { XmlTag::NOTE_DOT,               "NoteDot" },
+      { XmlTag::OTTAVA,                 "Ottava" },
+      { XmlTag::PALM_MUTE,              "PalmMute" },
+      { XmlTag::PEDAL,                  "Pedal" },
+      { XmlTag::REHEARSAL_MARK,         "RehearsalMark" },
+      { XmlTag::REPEAT_MEASURE,         "RepeatMeasure" },
+      { XmlTag::REST,                   "Rest" },
+      { XmlTag::SEGMENT,                "Segment" },
+      { XmlTag::SLUR,                   "Slur" },
+      { XmlTag::STAFF_STATE,            "StaffState" },
+      { XmlTag::STAFF_TEXT,             "StaffText" },
+      { XmlTag::STEM,                   "Stem" },
+      { XmlTag::STEM_SLASH,             "StemSlash" },
+      { XmlTag::SYMBOL,                 "Symbol" },
+      { XmlTag::SYSTEM_DIVIDER,         "SystemDivider" },
+      { XmlTag::SYSTEM_TEXT,            "SystemText" },
+      { XmlTag::TEMPO,                  "Tempo" },
+      { XmlTag::TEXT,                   "Text" },
+      { XmlTag::TEXT_LINE,              "TextLine" },
+      { XmlTag::TIE,                    "Tie" },
+      { XmlTag::TIME_SIG,               "TimeSig" },
+      { XmlTag::TREMOLO,                "Tremolo" },
+      { XmlTag::TREMOLO_BAR,            "TremoloBar" },
+      { XmlTag::TRILL,                  "Trill" },
+      { XmlTag::TUPLET,                 "Tuplet" },
+      { XmlTag::VIBRATO,                "Vibrato" },
+      { XmlTag::VOLTA,                  "Volta" },
+      { XmlTag::ACCIACCATURA,           "acciaccatura" },
+      { XmlTag::APPOGGIATURA,           "appoggiatura" },
+      { XmlTag::BREAK_MULTI_MEASURE_REST,"breakMultiMeasureRest" },
+      { XmlTag::COLOR,                  "color" },
+      { XmlTag::DOT_POSITION,           "dotPosition" },
+      { XmlTag::DOTS,                   "dots" },
+      { XmlTag::DURATION,               "duration" },
+      { XmlTag::DURATION_TYPE,          "durationType" },
+      { XmlTag::END_REPEAT,             "endRepeat" },
+      { XmlTag::END_SPANNER,            "endSpanner" },
+      { XmlTag::FIXED,                  "fixed" },
+      { XmlTag::FIXED_LINE,             "fixedLine" },
+      { XmlTag::FRET,                   "fret" },
+      { XmlTag::GHOST,                  "ghost" },
+      { XmlTag::GRACE16,                "grace16" },
+      { XmlTag::GRACE16AFTER,           "grace16after" },
+      { XmlTag::GRACE32,                "grace32" },
+      { XmlTag::GRACE32AFTER,           "grace32after" },
+      { XmlTag::GRACE4,                 "grace4" },
+      { XmlTag::GRACE8AFTER,            "grace8after" },
+      { XmlTag::HEAD,                   "head" },
+      { XmlTag::HEAD_TYPE,              "headType" },
+      { XmlTag::IRREGULAR,              "irregular" },
+      { XmlTag::LEADING_SPACE,          "leadingSpace" },
+      { XmlTag::LID,                    "lid" },
+      { XmlTag::LINE,                   "line" },
+      { XmlTag::MEASURE_NUMBER_MODE,    "measureNumberMode" },
+      { XmlTag::MIRROR,                 "mirror" },
+      { XmlTag::MOVE,                   "move" },
+      { XmlTag::MULTI_MEASURE_REST,     "multiMeasureRest" },
+      { XmlTag::NO_OFFSET,              "noOffset" },
+      { XmlTag::NO_STEM,                "noStem" },
+      { XmlTag::OFFSET,                 "offset" },
+      { XmlTag::PITCH,                  "pitch" },
+      { XmlTag::PLACEMENT,              "placement" },
+      { XmlTag::PLAY,                   "play" },
+      { XmlTag::POS,                    "pos" },
+      { XmlTag::SELECTED,               "selected" },
+      { XmlTag::SLASH_STYLE,            "slashStyle" },
+      { XmlTag::SMALL,                  "small" },
+      { XmlTag::START_REPEAT,           "startRepeat" },
+      { XmlTag::STRETCH,                "stretch" },
+      { XmlTag::STRING,                 "string" },
+      { XmlTag::SYS_INIT_BAR_LINE_TYPE, "sysInitBarLineType" },
+      { XmlTag::TAG,                    "tag" },
+      { XmlTag::TICK,                   "tick" },
+      { XmlTag::TICK_OFFSET,            "tickOffset" },
+      { XmlTag::TICKLEN,                "ticklen" },
+      { XmlTag::TPC,                    "tpc" },
+      { XmlTag::TPC2,                   "tpc2" },
+      { XmlTag::TRACK,                  "track" },
+      { XmlTag::TRAILING_SPACE,         "trailingSpace" },
+      { XmlTag::TUNING,                 "tuning" },
+      { XmlTag::VELO_TYPE,              "veloType" },
+      { XmlTag::VELOCITY,               "velocity" },
+      { XmlTag::VISIBLE,                "visible" },
+      { XmlTag::VOICE,                  "voice" },
+      { XmlTag::VSPACER,                "vspacer" },
+      { XmlTag::VSPACER_DOWN,           "vspacerDown" },
+      { XmlTag::VSPACER_FIXED,          "vspacerFixed" },
+      { XmlTag::VSPACER_UP,             "vspacerUp" },
+      { XmlTag::Z,                      "z" },
+      };
+
+//---------------------------------------------------------
+//   XmlTagTable
+//    hash table of xmlTagNames, open addressing
+//---------------------------------------------------------
+
+class XmlTagTable {
+      static const int SIZE = 512;        // power of two, more than twice the number of tags
+
+      struct Slot {
+            const char* name;
+            int size;
+            XmlTag tag;
+            };
+      Slot _slots[SIZE];
+
+   public:
+      XmlTagTable();
+      XmlTag lookup(const QStringRef& name) const;
+      };
+
+XmlTagTable::XmlTagTable()
+      {
+      for (Slot& slot : _slots)
+            slot = { 0, 0, XmlTag::UNKNOWN };
+      for (const XmlTagName& t : xmlTagNames) {
+            uint h = 0;
+            for (const char* p = t.name; *p; ++p)
+                  h = h * 31 + uchar(*p);
+            int i = h & (SIZE - 1);
+            while (_slots[i].name)
+                  i = (i + 1) & (SIZE - 1);
+            _slots[i] = { t.name, int(strlen(t.name)), t.tag };
+            }
+      }
+
+XmlTag XmlTagTable::lookup(const QStringRef& name) const
+      {
+      const QChar* s = name.unicode();
+      const int n = name.size();
+      uint h = 0;
+      for (int i = 0; i < n; ++i)
+            h = h * 31 + s[i].unicode();
+      for (int i = h & (SIZE - 1); _slots[i].name; i = (i + 1) & (SIZE - 1)) {
+            if (_slots[i].size == n && name == QLatin1String(_slots[i].name, n))
+                  return _slots[i].tag;
+            }
+      return XmlTag::UNKNOWN;
+      }
+
+//---------------------------------------------------------
+//   tagId
+//    the XmlTag of the current element, comparing it
+//    with == XmlTag::X is much cheaper than with
+//    name() == "x", which converts "x" to a QString first
+//---------------------------------------------------------
+
+XmlTag XmlReader::tagId() const
+      {
+      static const XmlTagTable table;
+      return table.lookup(name());
+      }
+
+//---------------------------------------------------------
+//   readText
+//    same as readElementText(), but reads into _text to
+//    avoid allocating a new QString for every value read
+//    by readInt(), readDouble() and readFraction()
+//---------------------------------------------------------
+
+const QString& XmlReader::readText()
+      {
+      _text.resize(0);
+      if (!isStartElement())
+            return _text;
+      for (;;) {
+            switch (readNext()) {
+                  case QXmlStreamReader::Characters:
+                  case QXmlStreamReader::EntityReference:
+                        _text.append(text());
+                        break;
+                  case QXmlStreamReader::EndElement:
+                        return _text;
+                  case QXmlStreamReader::ProcessingInstruction:
+                  case QXmlStreamReader::Comment:
+                        break;
+                  default:
+                        if (!hasError())
+                              raiseError(QObject::tr("Expected character data."));
+                        return _text;
+                  }
+            }
       }
 
 //---------------------------------------------------------
@@ -163,16 +388,16 @@ QRectF XmlReader::readRect()
 Fraction XmlReader::readFraction()
       {
       Q_ASSERT(tokenType() == QXmlStreamReader::StartElement);
-      int z = attribute("z", "0").toInt();
-      int n = attribute("n", "1").toInt();
-      const QString& s(readElementText());
+      int z = intAttribute("z", 0);
+      int n = intAttribute("n", 1);
+      const QString& s(readText());
       if (!s.isEmpty()) {
             int i = s.indexOf('/');
             if (i == -1)
                   qFatal("illegal fraction <%s>", qPrintable(s));
             else {
-                  z = s.left(i).toInt();
-                  n = s.mid(i+1).toInt();
+                  z = s.leftRef(i).toInt();
+                  n = s.midRef(i+1).toInt();
                   }
             }
       return Fraction(z, n);
@@ -219,7 +444,7 @@ void XmlReader::addTuplet(Tuplet* s)
 
 double XmlReader::readDouble(double min, double max)
       {
-      double val = readElementText().toDouble();
+      double val = readDouble();
       if (val < min)
             val = min;
       else if (val > max)
@@ -67,9 +67,24 @@ void XmlWriter::pTag(const char* name, PlaceText place)
 
 void XmlWriter::putLevel()
       {
-      int level = stack.size();
-      for (int i = 0; i < level * 2; ++i)
-            *this << ' ';
+      static const char spaces[] = "                                                                ";
+      const int max = int(sizeof(spaces)) - 1;
+      for (int n = stack.size() * 2; n > 0; n -= max)
+            *this << QLatin1String(spaces, qMin(n, max));
+      }
+
+//---------------------------------------------------------
+//   newLine
+//    The stream is only flushed after the outermost element,
+//    callers may read the device when the document is
+//    complete.
+//---------------------------------------------------------
+
+void XmlWriter::newLine()
+      {
+      *this << '\n';
+      if (stack.isEmpty())
+            flush();
       }
 
 //---------------------------------------------------------
@@ -89,8 +104,9 @@ void XmlWriter::header()
 void XmlWriter::stag(const QString& s)
       {
       putLevel();
-      *this << '<' << s << '>' << endl;
-      stack.append(s.split(' ')[0]);
+      *this << '<' << s << '>';
+      stack.append(s.left(s.indexOf(' ')));
+      newLine();
       }
 
 //---------------------------------------------------------
@@ -101,7 +117,8 @@ void XmlWriter::stag(const QString& s)
 void XmlWriter::etag()
       {
       putLevel();
-      *this << "</" << stack.takeLast() << '>' << endl;
+      *this << "</" << stack.takeLast() << '>';
+      newLine();
       }
 
 //---------------------------------------------------------
@@ -119,7 +136,8 @@ void XmlWriter::tagE(const char* format, ...)
       vsnprintf(buffer, BS, format, args);
       *this << buffer;
       va_end(args);
-      *this << "/>" << endl;
+      *this << "/>";
+      newLine();
       }
 
 //---------------------------------------------------------
@@ -150,7 +168,8 @@ void XmlWriter::ntag(const char* name)
 
 void XmlWriter::netag(const char* s)
       {
-      *this << "</" << s << '>' << endl;
+      *this << "</" << s << '>';
+      newLine();
       }
 
 //---------------------------------------------------------
@@ -302,13 +321,71 @@ void XmlWriter::tag(Pid id, QVariant data, QVariant defaultData)
 void XmlWriter::tag(const char* name, QVariant data, QVariant defaultData)
       {
       if (data != defaultData)
-            tag(QString(name), data);
+            writeTag(name, data);
       }
 
 void XmlWriter::tag(const QString& name, QVariant data)
       {
-      QString ename(name.split(' ')[0]);
+      int n = name.indexOf(' ');
+      writeTag(QStringRef(&name), QStringRef(&name, 0, n < 0 ? name.size() : n), data);
+      }
+
+//---------------------------------------------------------
+//   tag
+//    <mops a="b">value</mops>
+//---------------------------------------------------------
+
+void XmlWriter::tag(const char* name, const Attributes& attributes, QVariant data)
+      {
+      QString s(name);
+      for (const auto& a : attributes)
+            s += QString(" %1=\"%2\"").arg(a.first, xmlString(a.second));
+      tag(s, data);
+      }
+
+//---------------------------------------------------------
+//   asciiName
+//    split the tag name into the name with attributes and
+//    the element name, the tag names are ascii so they
+//    need not be converted to QString
+//---------------------------------------------------------
+
+static bool asciiName(const char* name, QLatin1String& n, QLatin1String& ename)
+      {
+      const char* space = 0;
+      const char* p = name;
+      for (; *p; ++p) {
+            if (*p & 0x80)
+                  return false;
+            if (*p == ' ' && !space)
+                  space = p;
+            }
+      n     = QLatin1String(name, int(p - name));
+      ename = space ? QLatin1String(name, int(space - name)) : n;
+      return true;
+      }
+
+//---------------------------------------------------------
+//   writeTag
+//---------------------------------------------------------
+
+void XmlWriter::writeTag(const char* name, const QVariant& data)
+      {
+      QLatin1String n;
+      QLatin1String ename;
+      if (asciiName(name, n, ename))
+            writeTag(n, ename, data);
+      else
+            tag(QString::fromUtf8(name), data);
+      }
+
+//---------------------------------------------------------
+//   writeTag
+//    name may contain attributes, ename is the element name
+//---------------------------------------------------------
 
+template <class S> void XmlWriter::writeTag(const S& name, const S& ename, const QVariant& data)
+      {
       putLevel();
       switch(data.type()) {
             case QVariant::Bool:
@@ -332,32 +409,32 @@ void XmlWriter::tag(const QString& name, QVariant data)
             case QVariant::Color:
                   {
                   QColor color(data.value<QColor>());
-                  *this << QString("<%1 r=\"%2\" g=\"%3\" b=\"%4\" a=\"%5\"/>\n")
-                     .arg(name).arg(color.red()).arg(color.green()).arg(color.blue()).arg(color.alpha());
+                  *this << "<" << name << QString(" r=\"%1\" g=\"%2\" b=\"%3\" a=\"%4\"/>\n")
+                     .arg(color.red()).arg(color.green()).arg(color.blue()).arg(color.alpha());
                   }
                   break;
             case QVariant::Rect:
                   {
                   const QRect& r(data.value<QRect>());
-                  *this << QString("<%1 x=\"%2\" y=\"%3\" w=\"%4\" h=\"%5\"/>\n").arg(name).arg(r.x()).arg(r.y()).arg(r.width()).arg(r.height());
+                  *this << "<" << name << QString(" x=\"%1\" y=\"%2\" w=\"%3\" h=\"%4\"/>\n").arg(r.x()).arg(r.y()).arg(r.width()).arg(r.height());
                   }
                   break;
             case QVariant::RectF:
                   {
                   const QRectF& r(data.value<QRectF>());
-                  *this << QString("<%1 x=\"%2\" y=\"%3\" w=\"%4\" h=\"%5\"/>\n").arg(name).arg(r.x()).arg(r.y()).arg(r.width()).arg(r.height());
+                  *this << "<" << name << QString(" x=\"%1\" y=\"%2\" w=\"%3\" h=\"%4\"/>\n").arg(r.x()).arg(r.y()).arg(r.width()).arg(r.height());
                   }
                   break;
             case QVariant::PointF:
                   {
                   const QPointF& p(data.value<QPointF>());
-                  *this << QString("<%1 x=\"%2\" y=\"%3\"/>\n").arg(name).arg(p.x()).arg(p.y());
+                  *this << "<" << name << QString(" x=\"%1\" y=\"%2\"/>\n").arg(p.x()).arg(p.y());
                   }
                   break;
             case QVariant::SizeF:
                   {
                   const QSizeF& p(data.value<QSizeF>());
-                  *this << QString("<%1 w=\"%2\" h=\"%3\"/>\n").arg(name).arg(p.width()).arg(p.height());
+                  *this << "<" << name << QString(" w=\"%1\" h=\"%2\"/>\n").arg(p.width()).arg(p.height());
                   }
                   break;
             default: {
@@ -369,10 +446,10 @@ void XmlWriter::tag(const QString& name, QVariant data)
                         }
                   else if (strcmp(type, "Ms::Fraction") == 0) {
                         const Fraction& f = data.value<Fraction>();
-                        *this << QString("<%1>%2/%3</%1>\n").arg(name).arg(f.numerator()).arg(f.denominator());
+                        *this << "<" << name << ">" << f.numerator() << "/" << f.denominator() << "</" << name << ">\n";
                         }
                   else if (strcmp(type, "Ms::Direction") == 0)
-                        *this << QString("<%1>%2</%1>\n").arg(name).arg(toString(data.value<Direction>()));
+                        *this << "<" << name << ">" << toString(data.value<Direction>()) << "</" << name << ">\n";
                   else if (strcmp(type, "Ms::Align") == 0) {
                         Align a = Align(data.toInt());
                         const char* h;
@@ -391,7 +468,7 @@ void XmlWriter::tag(const QString& name, QVariant data)
                               v = "baseline";
                         else
                               v = "top";
-                        *this << QString("<%1>%2,%3</%1>\n").arg(name).arg(h).arg(v);
+                        *this << "<" << name << ">" << h << "," << v << "</" << name << ">\n";
                         }
                   else {
                         qFatal("XmlWriter::tag: unsupported type %d %s", data.type(), type);
@@ -401,6 +478,55 @@ void XmlWriter::tag(const QString& name, QVariant data)
             }
       }
 
+//---------------------------------------------------------
+//   writeValue
+//    <mops>value</mops>
+//---------------------------------------------------------
+
+template <class T> void XmlWriter::writeValue(const char* name, const T& value)
+      {
+      QLatin1String n;
+      QLatin1String ename;
+      putLevel();
+      if (asciiName(name, n, ename))
+            *this << '<' << n << '>' << value << "</" << ename << ">\n";
+      else {
+            const QString s = QString::fromUtf8(name);
+            const int i = s.indexOf(' ');
+            *this << '<' << s << '>' << value << "</" << QStringRef(&s, 0, i < 0 ? s.size() : i) << ">\n";
+            }
+      }
+
+//---------------------------------------------------------
+//   tag
+//    typed versions, the value is not boxed in a QVariant
+//---------------------------------------------------------
+
+void XmlWriter::tag(const char* name, const char* s)
+      {
+      writeValue(name, xmlString(QString::fromUtf8(s)));
+      }
+
+void XmlWriter::tag(const char* name, const QString& s)
+      {
+      writeValue(name, xmlString(s));
+      }
+
+void XmlWriter::tag(const char* name, int v)
+      {
+      writeValue(name, v);
+      }
+
+void XmlWriter::tag(const char* name, qint64 v)
+      {
+      writeValue(name, v);
+      }
+
+void XmlWriter::tag(const char* name, double v)
+      {
+      writeValue(name, v);
+      }
+
 void XmlWriter::tag(const char* name, const QWidget* g)
       {
       tag(name, QRect(g->pos(), g->size()));
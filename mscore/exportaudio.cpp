@@ -29,9 +29,43 @@
 #include "synthesizer/msynthesizer.h"
 #include "musescore.h"
 #include "preferences.h"
+#include "renderaudio.h"
 
 namespace Ms {
 
+//---------------------------------------------------------
+//   createExportSynthesizer
+//---------------------------------------------------------
+
+static MasterSynthesizer* createExportSynthesizer(Score* score, int sampleRate, int renderThreads)
+      {
+      MasterSynthesizer* synth = synthesizerFactory();
+      synth->init();
+      synth->setSampleRate(sampleRate);
+      synth->setRenderThreads(renderThreads);
+      // use score settings in converter mode, current synth settings otherwise
+      bool r = synth->setState(MScore::noGui ? score->synthesizerState() : mscore->synthesizerState());
+      if (!r)
+            synth->init();
+      return synth;
+      }
+
+//---------------------------------------------------------
+//   renderAudio
+//    render the score with the export sample rate and
+//    audioExportThreads synthesizer groups, see
+//    renderScoreAudio()
+//---------------------------------------------------------
+
+bool MuseScore::renderAudio(Score* score, bool normalize, std::function<bool(const float*, unsigned)> write, std::function<bool(float)> updateProgress)
+      {
+      int sampleRate = preferences.getInt(PREF_EXPORT_AUDIO_SAMPLERATE);
+      int threads    = audioExportThreads > 0 ? audioExportThreads : QThread::idealThreadCount();
+      return renderScoreAudio(score, sampleRate, threads, normalize,
+         [score, sampleRate](int renderThreads) { return createExportSynthesizer(score, sampleRate, renderThreads); },
+         write, updateProgress);
+      }
+
 ///
 /// \brief Function to synthesize audio and output it into a generic QIODevice
 /// \param The score to output
@@ -42,158 +76,27 @@ namespace Ms {
 /// If the callback function is non zero an returns false the export will be canceled.
 ///
 bool MuseScore::saveAudio(Score* score, QIODevice *device, std::function<bool(float)> updateProgress)
-    {
-    if (!device) {
-        qDebug() << "Invalid device";
-        return false;
-    }
-
-    if (!device->open(QIODevice::WriteOnly)) {
-        qDebug() << "Could not write to device";
-        return false;
-    }
-
-    EventMap events;
-    score->renderMidi(&events);
-    if(events.size() == 0)
-          return false;
-
-    MasterSynthesizer* synth = synthesizerFactory();
-    synth->init();
-    int sampleRate = preferences.getInt(PREF_EXPORT_AUDIO_SAMPLERATE);
-    synth->setSampleRate(sampleRate);
-    if (MScore::noGui) { // use score settings if possible
-          bool r = synth->setState(score->synthesizerState());
-          if (!r)
-                synth->init();
-          }
-    else { // use current synth settings
-          bool r = synth->setState(mscore->synthesizerState());
-          if (!r)
-                synth->init();
-          }
-
-    int oldSampleRate  = MScore::sampleRate;
-    MScore::sampleRate = sampleRate;
-
-    float peak  = 0.0;
-    double gain = 1.0;
-    EventMap::const_iterator endPos = events.cend();
-    --endPos;
-    const int et = (score->utick2utime(endPos->first) + 1) * MScore::sampleRate;
-    const int maxEndTime = (score->utick2utime(endPos->first) + 3) * MScore::sampleRate;
-
-    bool cancelled = false;
-    int passes = preferences.getBool(PREF_EXPORT_AUDIO_NORMALIZE) ? 2 : 1;
-    for (int pass = 0; pass < passes; ++pass) {
-          EventMap::const_iterator playPos;
-          playPos = events.cbegin();
-          synth->allSoundsOff(-1);
-
-          //
-          // init instruments
-          //
-          foreach(Part* part, score->parts()) {
-                const InstrumentList* il = part->instruments();
-                for(auto i = il->begin(); i!= il->end(); i++) {
-                      for (const Channel* a : i->second->channel()) {
-                            a->updateInitList();
-                            for (MidiCoreEvent e : a->init) {
-                                  if (e.type() == ME_INVALID)
-                                        continue;
-                                  e.setChannel(a->channel);
-                                  int syntiIdx = synth->index(score->masterScore()->midiMapping(a->channel)->articulation->synti);
-								  synth->play(e, syntiIdx);
-                                  }
-                            }
-                      }
-                }
-
-          static const unsigned FRAMES = 512;
-          float buffer[FRAMES * 2];
-          int playTime = 0;
-
-          for (;;) {
-                unsigned frames = FRAMES;
-                //
-                // collect events for one segment
-                //
-                float max = 0.0;
-                memset(buffer, 0, sizeof(float) * FRAMES * 2);
-                int endTime = playTime + frames;
-                float* p = buffer;
-                for (; playPos != events.cend(); ++playPos) {
-                      int f = score->utick2utime(playPos->first) * MScore::sampleRate;
-                      if (f >= endTime)
-                            break;
-                      int n = f - playTime;
-                      if (n) {
-                            synth->process(n, p);
-                            p += 2 * n;
-                            }
-
-                      playTime  += n;
-                      frames    -= n;
-                      const NPlayEvent& e = playPos->second;
-                      if (e.isChannelEvent()) {
-                            int channelIdx = e.channel();
-                            Channel* c = score->masterScore()->midiMapping(channelIdx)->articulation;
-                            if (!c->mute) {
-                                  synth->play(e, synth->index(c->synti));
-                                  }
-                            }
-                      }
-                if (frames) {
-                      synth->process(frames, p);
-                      playTime += frames;
-                      }
-                if (pass == 1) {
-                      for (unsigned i = 0; i < FRAMES * 2; ++i) {
-                            max = qMax(max, qAbs(buffer[i]));
-                            buffer[i] *= gain;
-                            }
-                      }
-                else {
-                      for (unsigned i = 0; i < FRAMES * 2; ++i) {
-                            max = qMax(max, qAbs(buffer[i]));
-                            peak = qMax(peak, qAbs(buffer[i]));
-                            }
-                      }
-                if (pass == (passes - 1))
-                      device->write(reinterpret_cast<const char*>(buffer), 2 * FRAMES * sizeof(float));
-                playTime = endTime;
-                if (updateProgress) {
-                    // normalize to [0, 1] range
-                    if (!updateProgress((pass * et + playTime) / passes / et)) {
-                        cancelled = true;
-                        break;
-                    }
-                      }
-                if (playTime >= et)
-                      synth->allNotesOff(-1);
-                // create sound until the sound decays
-                if (playTime >= et && max*peak < 0.000001)
-                      break;
-                // hard limit
-                if (playTime > maxEndTime)
-                      break;
-                }
-          if (cancelled)
-                break;
-          if (pass == 0 && peak == 0.0) {
-                qDebug("song is empty");
-                break;
-                }
-          gain = 0.99 / peak;
-          }
+      {
+      if (!device) {
+            qDebug() << "Invalid device";
+            return false;
+            }
 
-    MScore::sampleRate = oldSampleRate;
-    delete synth;
+      if (!device->open(QIODevice::WriteOnly)) {
+            qDebug() << "Could not write to device";
+            return false;
+            }
 
-    device->close();
+      bool rv = renderAudio(score, preferences.getBool(PREF_EXPORT_AUDIO_NORMALIZE),
+         [device](const float* buffer, unsigned frames) {
+               qint64 n = 2 * frames * sizeof(float);
+               return device->write(reinterpret_cast<const char*>(buffer), n) == n;
+               },
+         updateProgress);
 
-    return !cancelled;
-}
+      device->close();
+      return rv;
+      }
 
 #ifdef HAS_AUDIOFILE
 
@@ -268,23 +171,7 @@ bool MuseScore::saveAudio(Score* score, const QString& name)
             return false;
             }
 
-      EventMap events;
-      score->renderMidi(&events);
-      if(events.size() == 0)
-            return false;
-
-      MasterSynthesizer* synth = synthesizerFactory();
-	  synth->init();
       int sampleRate = preferences.getInt(PREF_EXPORT_AUDIO_SAMPLERATE);
-	  synth->setSampleRate(sampleRate);
-      bool r = synth->setState(score->synthesizerState());
-      if (!r)
-          synth->init();
-
-      int oldSampleRate  = MScore::sampleRate;
-      MScore::sampleRate = sampleRate;
-
-
       SoundFileDevice device(sampleRate, format, name);
 
       // dummy callback function that will be used if there is no gui
@@ -323,9 +210,6 @@ bool MuseScore::saveAudio(Score* score, const QString& name)
       bool wasCanceled = progress.wasCanceled();
       progress.close();
 
-      MScore::sampleRate = oldSampleRate;
-      delete synth;
-
       if (wasCanceled)
             QFile::remove(name);
 
@@ -85,6 +85,7 @@
 #include "diff/diff_match_patch.h"
 #include "libmscore/chordlist.h"
 #include "libmscore/mscore.h"
+#include "libmscore/trace.h"
 #include "thirdparty/qzip/qzipreader_p.h"
 
 
@@ -326,8 +327,30 @@ MasterScore* MuseScore::readScore(const QString& name)
       if (name.isEmpty())
             return 0;
 
-      MasterScore* score = new MasterScore(MScore::defaultStyle());
       setMidiReopenInProgress(name);
+      MasterScore* score = readScoreFile(name);
+      if (!score)
+            return 0;
+      allowShowMidiPanel(name);
+      addRecentScore(score);
+      return score;
+      }
+
+//---------------------------------------------------------
+//   readScoreFile
+//    read and lay out a score, report errors; does not
+//    touch the gui and may be called from worker threads
+//---------------------------------------------------------
+
+MasterScore* readScoreFile(const QString& name)
+      {
+      // the importers keep global state (like the midi import
+      // operations), only the native format is read concurrently
+      static QMutex importMutex;
+      QString suffix = QFileInfo(name).suffix().toLower();
+      QMutexLocker locker(suffix == "mscz" || suffix == "mscx" ? 0 : &importMutex);
+
+      MasterScore* score = new MasterScore(MScore::defaultStyle());
       Score::FileError rv = Ms::readScore(score, name, false);
       if (rv == Score::FileError::FILE_TOO_OLD || rv == Score::FileError::FILE_TOO_NEW || rv == Score::FileError::FILE_CORRUPTED) {
             if (readScoreError(name, rv, true)) {
@@ -354,12 +377,8 @@ MasterScore* MuseScore::readScore(const QString& name)
             if (rv != Score::FileError::FILE_USER_ABORT && rv != Score::FileError::FILE_IGNORE_ERROR)
                   readScoreError(name, rv, false);
             delete score;
-            score = 0;
             return 0;
             }
-      allowShowMidiPanel(name);
-      if (score)
-            addRecentScore(score);
       return score;
       }
 
@@ -1812,6 +1831,7 @@ bool MuseScore::exportParts()
 
 bool MuseScore::saveAs(Score* cs, bool saveCopy, const QString& path, const QString& ext)
       {
+      TRACE_SCOPE("file", "saveAs");
       bool rv = false;
       QString suffix = "." + ext;
       QString fn(path);
@@ -2139,6 +2159,7 @@ void importExtension(QString name)
 
 Score::FileError readScore(MasterScore* score, QString name, bool ignoreVersionError)
       {
+      TRACE_SCOPE("file", "readScore");
       QFileInfo info(name);
       QString suffix  = info.suffix().toLower();
       score->setName(info.completeBaseName());
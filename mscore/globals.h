@@ -32,6 +32,7 @@ extern bool converterMode;
 extern bool pluginMode;
 extern double guiScaling;
 extern int trimMargin;
+extern int audioExportThreads;
 extern bool noWebView;
 extern bool ignoreWarnings;
 
@@ -29,11 +29,18 @@
 #include "importmxmllogger.h"
 #include "importmxmlpass1.h"
 #include "importmxmlpass2.h"
+#include "importmxmlreader.h"
 #include "preferences.h"
 
 namespace Ms {
 
-Score::FileError importMusicXMLfromBuffer(Score* score, const QString& /*name*/, QIODevice* dev)
+//---------------------------------------------------------
+//   importMusicXMLfromBuffer
+//    replay false makes pass 2 parse the device again,
+//    as it did before the tokens were recorded
+//---------------------------------------------------------
+
+Score::FileError importMusicXMLfromBuffer(Score* score, const QString& /*name*/, QIODevice* dev, bool replay)
       {
       //qDebug("importMusicXMLfromBuffer(score %p, name '%s', dev %p)",
       //       score, qPrintable(name), dev);
@@ -42,17 +49,32 @@ Score::FileError importMusicXMLfromBuffer(Score* score, const QString& /*name*/,
       logger.setLoggingLevel(MxmlLogger::Level::MXML_INFO);
       //logger.setLoggingLevel(MxmlLogger::Level::MXML_TRACE); // also include tracing
 
-      // pass 1
+      QElapsedTimer t;
+      t.start();
+
+      // pass 1, recording the tokens for pass 2
+      MxmlTokens tokens;
       dev->seek(0);
       MusicXMLParserPass1 pass1(score, &logger);
+      if (replay)
+            pass1.recordTokens(&tokens);
       Score::FileError res = pass1.parse(dev);
       if (res != Score::FileError::FILE_NO_ERROR)
             return res;
+      replay = replay && pass1.finishRecording();
+      qint64 pass1Time = t.restart();
 
-      // pass 2
-      dev->seek(0);
+      // pass 2, replaying the tokens unless the recording stopped at an error
       MusicXMLParserPass2 pass2(score, pass1, &logger);
-      return pass2.parse(dev);
+      if (replay)
+            res = pass2.parse(&tokens);
+      else {
+            dev->seek(0);
+            res = pass2.parse(dev);
+            }
+      qDebug("importMusicXMLfromBuffer: pass 1 %lld ms (%d tokens, %zu kB), pass 2 %lld ms%s",
+             pass1Time, tokens.size(), tokens.bytes() / 1024, t.elapsed(), replay ? "" : " (parsed again)");
+      return res;
       }
 
 } // namespace Ms
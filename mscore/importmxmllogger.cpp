@@ -11,6 +11,7 @@
 //=============================================================================
 
 #include "importmxmllogger.h"
+#include "importmxmlreader.h"
 
 namespace Ms {
 
@@ -18,7 +19,7 @@ namespace Ms {
 //   xmlLocation
 //---------------------------------------------------------
 
-static QString xmlLocation(const QXmlStreamReader* const xmlreader)
+static QString xmlLocation(const MxmlReader* const xmlreader)
       {
       QString loc;
       if (xmlreader) {
@@ -32,7 +33,7 @@ static QString xmlLocation(const QXmlStreamReader* const xmlreader)
 //   logDebugTrace
 //---------------------------------------------------------
 
-static void log(MxmlLogger::Level level, const QString& text, const QXmlStreamReader* const xmlreader)
+static void log(MxmlLogger::Level level, const QString& text, const MxmlReader* const xmlreader)
       {
       QString str;
       switch (level) {
@@ -57,7 +58,7 @@ static void log(MxmlLogger::Level level, const QString& text, const QXmlStreamRe
  Log debug (function) trace.
  */
 
-void MxmlLogger::logDebugTrace(const QString& trace, const QXmlStreamReader* const xmlreader)
+void MxmlLogger::logDebugTrace(const QString& trace, const MxmlReader* const xmlreader)
       {
       if (_level <= Level::MXML_TRACE) {
             log(Level::MXML_TRACE, trace, xmlreader);
@@ -72,7 +73,7 @@ void MxmlLogger::logDebugTrace(const QString& trace, const QXmlStreamReader* con
  Log debug \a info (non-fatal events relevant for debugging).
  */
 
-void MxmlLogger::logDebugInfo(const QString& info, const QXmlStreamReader* const xmlreader)
+void MxmlLogger::logDebugInfo(const QString& info, const MxmlReader* const xmlreader)
       {
       if (_level <= Level::MXML_INFO) {
             log(Level::MXML_INFO, info, xmlreader);
@@ -87,7 +88,7 @@ void MxmlLogger::logDebugInfo(const QString& info, const QXmlStreamReader* const
  Log \a error (possibly non-fatal but to be reported to the user anyway).
  */
 
-void MxmlLogger::logError(const QString& error, const QXmlStreamReader* const xmlreader)
+void MxmlLogger::logError(const QString& error, const MxmlReader* const xmlreader)
       {
       if (_level <= Level::MXML_ERROR) {
             log(Level::MXML_ERROR, error, xmlreader);
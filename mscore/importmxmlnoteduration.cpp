@@ -14,6 +14,7 @@
 
 #include "importmxmllogger.h"
 #include "importmxmlnoteduration.h"
+#include "importmxmlreader.h"
 
 namespace Ms {
 
@@ -166,7 +167,7 @@ QString mxmlNoteDuration::checkTiming(const QString& type, const bool rest, cons
  Parse the /score-partwise/part/measure/note/duration node.
  */
 
-void mxmlNoteDuration::duration(QXmlStreamReader& e)
+void mxmlNoteDuration::duration(MxmlReader& e)
       {
       Q_ASSERT(e.isStartElement() && e.name() == "duration");
       _logger->logDebugTrace("MusicXMLParserPass1::duration", &e);
@@ -195,7 +196,7 @@ void mxmlNoteDuration::duration(QXmlStreamReader& e)
  Return true if handled.
  */
 
-bool mxmlNoteDuration::readProperties(QXmlStreamReader& e)
+bool mxmlNoteDuration::readProperties(MxmlReader& e)
       {
       const QStringRef& tag(e.name());
       //qDebug("tag %s", qPrintable(tag.toString()));
@@ -223,7 +224,7 @@ bool mxmlNoteDuration::readProperties(QXmlStreamReader& e)
  Parse the /score-partwise/part/measure/note/time-modification node.
  */
 
-void mxmlNoteDuration::timeModification(QXmlStreamReader& e)
+void mxmlNoteDuration::timeModification(MxmlReader& e)
       {
       Q_ASSERT(e.isStartElement() && e.name() == "time-modification");
       _logger->logDebugTrace("MusicXMLParserPass1::timeModification", &e);
@@ -18,6 +18,7 @@
 namespace Ms {
 
 class MxmlLogger;
+class MxmlReader;
 class Score;
 
 //---------------------------------------------------------
@@ -32,14 +33,14 @@ class mxmlNotePitch
       {
 public:
       mxmlNotePitch(MxmlLogger* logger) : _logger(logger) { /* nothing so far */ }
-      void pitch(QXmlStreamReader& e);
-      bool readProperties(QXmlStreamReader& e, Score* score);
+      void pitch(MxmlReader& e);
+      bool readProperties(MxmlReader& e, Score* score);
       Accidental* acc() const { return _acc; }
       AccidentalType accType() const { return _accType; }
       int alter() const { return _alter; }
       int displayOctave() const { return _displayOctave; }
       int displayStep() const { return _displayStep; }
-      void displayStepOctave(QXmlStreamReader& e);
+      void displayStepOctave(MxmlReader& e);
       int octave() const { return _octave; }
       int step() const { return _step; }
       bool unpitched() const { return _unpitched; }
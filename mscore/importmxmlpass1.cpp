@@ -30,6 +30,7 @@
 #include "libmscore/style.h"
 #include "libmscore/spanner.h"
 #include "libmscore/bracketItem.h"
+#include "libmscore/trace.h"
 
 #include "importmxmllogger.h"
 #include "importmxmlnoteduration.h"
@@ -765,6 +766,7 @@ static void fixupSigmap(MxmlLogger* logger, Score* score, const QVector<Fraction
 
 Score::FileError MusicXMLParserPass1::parse(QIODevice* device)
       {
+      TRACE_SCOPE("file", "musicXmlPass1");
       _logger->logDebugTrace("MusicXMLParserPass1::parse device");
       _parts.clear();
       _e.setDevice(device);
@@ -1078,7 +1080,7 @@ static QString decodeEntities( const QString& src )
  Read the next part of a MusicXML formatted string and convert to MuseScore internal encoding.
  */
 
-static QString nextPartOfFormattedString(QXmlStreamReader& e)
+static QString nextPartOfFormattedString(MxmlReader& e)
       {
       //QString lang       = e.attribute(QString("xml:lang"), "it");
       QString fontWeight = e.attributes().value("font-weight").toString();
@@ -2188,7 +2190,7 @@ void MusicXMLParserPass1::clef(const QString& partId)
 
 // TODO: share between pass 1 and pass 2
 
-static bool determineTimeSig(MxmlLogger* logger, const QXmlStreamReader* const xmlreader,
+static bool determineTimeSig(MxmlLogger* logger, const MxmlReader* const xmlreader,
                              const QString beats, const QString beatType, const QString timeSymbol,
                              TimeSigType& st, int& bts, int& btp)
       {
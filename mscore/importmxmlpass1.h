@@ -22,6 +22,7 @@
 
 #include "libmscore/score.h"
 #include "importxmlfirstpass.h"
+#include "importmxmlreader.h"
 #include "musicxml.h" // for the creditwords and MusicXmlPartGroupList definitions
 #include "musicxmlsupport.h"
 
@@ -72,6 +73,8 @@ public:
       void initPartState(const QString& partId);
       Score::FileError parse(QIODevice* device);
       Score::FileError parse();
+      void recordTokens(MxmlTokens* tokens) { _e.setRecorder(tokens); }
+      bool finishRecording() { return _e.finishRecording(); }
       void scorePartwise();
       void identification();
       void credit(CreditWordsList& credits);
@@ -120,7 +123,7 @@ private:
       void setFirstInstr(const QString& id, const Fraction stime);
 
       // generic pass 1 data
-      QXmlStreamReader _e;
+      MxmlReader _e;
       int _divs;                                ///< Current MusicXML divisions value
       QMap<QString, MusicXmlPart> _parts;       ///< Parts data, mapped on part id
       QVector<Fraction> _measureLength;         ///< Length of each measure
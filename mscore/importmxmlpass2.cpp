@@ -62,6 +62,7 @@
 #include "libmscore/ottava.h"
 #include "libmscore/rehearsalmark.h"
 #include "libmscore/fermata.h"
+#include "libmscore/trace.h"
 
 #include "importmxmllogger.h"
 #include "importmxmlnoteduration.h"
@@ -454,7 +455,7 @@ static Instrument createInstrument(const MusicXMLDrumInstrument& mxmlInstr)
  Set first instrument for Part \a part
  */
 
-static void setFirstInstrument(MxmlLogger* logger, const QXmlStreamReader* const xmlreader,
+static void setFirstInstrument(MxmlLogger* logger, const MxmlReader* const xmlreader,
                                Part* part, const QString& partId,
                                const QString& instrId, const MusicXMLDrumset& mxmlDrumset)
       {
@@ -532,7 +533,7 @@ static QString findDeleteStaffText(Segment* s, int track)
 //   setPartInstruments
 //---------------------------------------------------------
 
-static void setPartInstruments(MxmlLogger* logger, const QXmlStreamReader* const xmlreader,
+static void setPartInstruments(MxmlLogger* logger, const MxmlReader* const xmlreader,
                                Part* part, const QString& partId,
                                Score* score, const MusicXmlInstrList& il, const MusicXMLDrumset& mxmlDrumset)
       {
@@ -686,7 +687,7 @@ static QString decodeEntities( const QString& src )
  Read the next part of a MusicXML formatted string and convert to MuseScore internal encoding.
  */
 
-static QString nextPartOfFormattedString(QXmlStreamReader& e)
+static QString nextPartOfFormattedString(MxmlReader& e)
       {
       //QString lang       = e.attribute(QString("xml:lang"), "it");
       QString fontWeight = e.attributes().value("font-weight").toString();
@@ -751,7 +752,7 @@ static QString nextPartOfFormattedString(QXmlStreamReader& e)
  Add a single lyric to the score or delete it (if number too high)
  */
 
-static void addLyric(MxmlLogger* logger, const QXmlStreamReader* const xmlreader,
+static void addLyric(MxmlLogger* logger, const MxmlReader* const xmlreader,
                      ChordRest* cr, Lyrics* l, int lyricNo, MusicXmlLyricsExtend& extendedLyrics)
       {
       if (lyricNo > MAX_LYRICS) {
@@ -774,7 +775,7 @@ static void addLyric(MxmlLogger* logger, const QXmlStreamReader* const xmlreader
  Add a notes lyrics to the score
  */
 
-static void addLyrics(MxmlLogger* logger, const QXmlStreamReader* const xmlreader,
+static void addLyrics(MxmlLogger* logger, const MxmlReader* const xmlreader,
                       ChordRest* cr,
                       QMap<int, Lyrics*>& numbrdLyrics,
                       QSet<Lyrics*>& extLyrics,
@@ -1550,12 +1551,27 @@ Score::FileError MusicXMLParserPass2::parse(QIODevice* device)
 //   parse
 //---------------------------------------------------------
 
+/**
+ Parse MusicXML by replaying the \a tokens recorded in pass 1.
+ */
+
+Score::FileError MusicXMLParserPass2::parse(const MxmlTokens* tokens)
+      {
+      _e.setTokens(tokens);
+      return parse();
+      }
+
+//---------------------------------------------------------
+//   parse
+//---------------------------------------------------------
+
 /**
  Start the parsing process, after verifying the top-level node is score-partwise
  */
 
 Score::FileError MusicXMLParserPass2::parse()
       {
+      TRACE_SCOPE("file", "musicXmlPass2");
       bool found = false;
       while (_e.readNextStartElement()) {
             if (_e.name() == "score-partwise") {
@@ -4024,7 +4040,7 @@ static Chord* createGraceChord(Score* score, const int track,
  until after allocating the note.
  */
 
-static bool elementMustBePostponed(const QXmlStreamReader& e)
+static bool elementMustBePostponed(const MxmlReader& e)
       {
       return e.name() == "notations"
              || e.name() == "lyric"
@@ -5595,7 +5611,7 @@ void MusicXMLParserPass2::glissando(Note* note, const int tick, const int ticks,
 //---------------------------------------------------------
 
 static void addArpeggio(ChordRest* cr, const QString& arpeggioType,
-                        MxmlLogger* logger, const QXmlStreamReader* const xmlreader)
+                        MxmlLogger* logger, const MxmlReader* const xmlreader)
       {
       // no support for arpeggio on rest
       if (!arpeggioType.isEmpty() && cr->type() == ElementType::CHORD) {
@@ -5630,7 +5646,7 @@ static void addArpeggio(ChordRest* cr, const QString& arpeggioType,
 static void addTremolo(ChordRest* cr,
                        const int tremoloNr, const QString& tremoloType, const int ticks,
                        Chord*& tremStart,
-                       MxmlLogger* logger, const QXmlStreamReader* const xmlreader)
+                       MxmlLogger* logger, const MxmlReader* const xmlreader)
       {
       if (!cr->isChord())
             return;
@@ -5686,7 +5702,7 @@ static void addTremolo(ChordRest* cr,
 static void addWavyLine(ChordRest* cr, const int tick,
                         const int wavyLineNo, const QString& wavyLineType,
                         MusicXmlSpannerMap& spanners, TrillStack& trills,
-                        MxmlLogger* logger, const QXmlStreamReader* const xmlreader)
+                        MxmlLogger* logger, const MxmlReader* const xmlreader)
       {
       if (!wavyLineType.isEmpty()) {
             const auto ticks = cr->duration().ticks();
@@ -5741,7 +5757,7 @@ static void addBreath(ChordRest* cr, const int tick, SymId breath)
 //---------------------------------------------------------
 
 static void addChordLine(Note* note, const QString& chordLineType,
-                         MxmlLogger* logger, const QXmlStreamReader* const xmlreader)
+                         MxmlLogger* logger, const MxmlReader* const xmlreader)
       {
       if (chordLineType != "") {
             if (note) {
@@ -5977,7 +5993,7 @@ void MusicXMLParserPass2::tuplet(MusicXmlTupletDesc& tupletDesc)
  MusicXMLParserDirection constructor.
  */
 
-MusicXMLParserDirection::MusicXMLParserDirection(QXmlStreamReader& e,
+MusicXMLParserDirection::MusicXMLParserDirection(MxmlReader& e,
                                                  Score* score,
                                                  const MusicXMLParserPass1& pass1,
                                                  MusicXMLParserPass2& pass2,
@@ -113,6 +113,7 @@ public:
       MusicXMLParserPass2(Score* score, MusicXMLParserPass1& pass1, MxmlLogger* logger);
       void initPartState(const QString& partId);
       Score::FileError parse(QIODevice* device);
+      Score::FileError parse(const MxmlTokens* tokens);
       Score::FileError parse();
       void scorePartwise();
       void partList();
@@ -174,7 +175,7 @@ public:
 private:
       // generic pass 2 data
 
-      QXmlStreamReader _e;
+      MxmlReader _e;
       int _divs;                          // the current divisions value
       Score* const _score;                // the score
       MusicXMLParserPass1& _pass1;        // the pass1 results
@@ -219,11 +220,11 @@ private:
 
 class MusicXMLParserDirection {
 public:
-      MusicXMLParserDirection(QXmlStreamReader& e, Score* score, const MusicXMLParserPass1& pass1, MusicXMLParserPass2& pass2, MxmlLogger* logger);
+      MusicXMLParserDirection(MxmlReader& e, Score* score, const MusicXMLParserPass1& pass1, MusicXMLParserPass2& pass2, MxmlLogger* logger);
       void direction(const QString& partId, Measure* measure, const int tick, MusicXmlSpannerMap& spanners);
 
 private:
-      QXmlStreamReader& _e;
+      MxmlReader& _e;
       Score* const _score;                      // the score
       const MusicXMLParserPass1& _pass1;        // the pass1 results
       MusicXMLParserPass2& _pass2;              // the pass2 results
@@ -0,0 +1,381 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2018 Werner Schweer and others
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "importmxmlreader.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   clear
+//---------------------------------------------------------
+
+void MxmlTokens::clear()
+      {
+      _tokens.clear();
+      _names.clear();
+      _texts.clear();
+      _values.clear();
+      _attributes.clear();
+      _nameIndex.clear();
+      _whitespaceIndex.clear();
+      _valueIndex.clear();
+      _whitespace = false;
+      }
+
+//---------------------------------------------------------
+//   bytes
+//    an estimate of the memory used by the recording
+//---------------------------------------------------------
+
+size_t MxmlTokens::bytes() const
+      {
+      size_t n = _tokens.capacity() * sizeof(Token) + _attributes.capacity() * sizeof(Attribute);
+      for (const std::deque<QString>* strings : { &_names, &_texts, &_values }) {
+            for (const QString& s : *strings)
+                  n += sizeof(QString) + s.capacity() * sizeof(QChar);
+            }
+      for (const QHash<QStringRef, int>* index : { &_nameIndex, &_whitespaceIndex, &_valueIndex })
+            n += index->capacity() * (sizeof(QStringRef) + sizeof(int) + 2 * sizeof(void*));
+      return n;
+      }
+
+//---------------------------------------------------------
+//   intern
+//---------------------------------------------------------
+
+/**
+ Return the index of \a s in \a strings, adding it if necessary.
+ The lookup does not copy \a s, only a new string is stored.
+ */
+
+int MxmlTokens::intern(const QStringRef& s, std::deque<QString>& strings, QHash<QStringRef, int>& index)
+      {
+      auto i = index.constFind(s);
+      if (i != index.constEnd())
+            return i.value();
+      int idx = int(strings.size());
+      strings.push_back(s.toString());
+      index.insert(QStringRef(&strings.back()), idx);
+      return idx;
+      }
+
+//---------------------------------------------------------
+//   append
+//---------------------------------------------------------
+
+/**
+ Record the current token of \a e.
+ */
+
+void MxmlTokens::append(const QXmlStreamReader& e)
+      {
+      Token t { e.tokenType(), -1, -1, 0, int(e.lineNumber()), int(e.columnNumber()) };
+      bool whitespace = false;
+      switch (t.type) {
+            case QXmlStreamReader::StartElement:
+                  // whitespace followed by an element is indentation
+                  if (_whitespace)
+                        _tokens.pop_back();
+                  t.name = intern(e.name(), _names, _nameIndex);
+                  if (!e.attributes().isEmpty()) {
+                        t.data  = int(_attributes.size());
+                        t.count = e.attributes().size();
+                        for (const QXmlStreamAttribute& a : e.attributes()) {
+                              _attributes.push_back({ intern(a.qualifiedName(), _names, _nameIndex),
+                                                      intern(a.value(), _values, _valueIndex) });
+                              }
+                        }
+                  break;
+            case QXmlStreamReader::EndElement:
+                  t.name = intern(e.name(), _names, _nameIndex);
+                  break;
+            case QXmlStreamReader::EntityReference:
+                  t.name = intern(e.name(), _names, _nameIndex);
+                  t.data = int(_texts.size());
+                  _texts.push_back(e.text().toString());
+                  break;
+            case QXmlStreamReader::Characters:
+                  if (e.isWhitespace()) {
+                        // whitespace after an element is indentation, whitespace
+                        // after a start tag is kept until the next token shows
+                        // whether it is the text of the element
+                        if (!_tokens.empty() && _tokens.back().type == QXmlStreamReader::EndElement)
+                              return;
+                        t.data = intern(e.text(), _texts, _whitespaceIndex);
+                        whitespace = true;
+                        }
+                  else {
+                        t.data = int(_texts.size());
+                        _texts.push_back(e.text().toString());
+                        }
+                  break;
+            default:
+                  break;
+            }
+      _tokens.push_back(t);
+      _whitespace = whitespace;
+      }
+
+//---------------------------------------------------------
+//   setDevice
+//---------------------------------------------------------
+
+/**
+ Read from \a device, recording the tokens if a recorder is set.
+ */
+
+void MxmlReader::setDevice(QIODevice* device)
+      {
+      _tokens = 0;
+      _e.setDevice(device);
+      if (_recorder)
+            _recorder->clear();
+      }
+
+//---------------------------------------------------------
+//   setTokens
+//---------------------------------------------------------
+
+/**
+ Replay \a tokens instead of reading from a device.
+ */
+
+void MxmlReader::setTokens(const MxmlTokens* tokens)
+      {
+      _tokens = tokens;
+      _pos = -1;
+      _error = false;
+      }
+
+//---------------------------------------------------------
+//   finishRecording
+//---------------------------------------------------------
+
+/**
+ Record the tokens the parser did not read (if it stopped early).
+ Return true if the recording covers the complete document,
+ which is not the case after an error.
+ */
+
+bool MxmlReader::finishRecording()
+      {
+      if (!_recorder || replaying())
+            return false;
+      while (!_recorder->isComplete() && readNext() != QXmlStreamReader::Invalid)
+            ;
+      MxmlTokens* tokens = _recorder;
+      _recorder = 0;
+      return tokens->isComplete();
+      }
+
+//---------------------------------------------------------
+//   readNext
+//---------------------------------------------------------
+
+QXmlStreamReader::TokenType MxmlReader::readNext()
+      {
+      if (replaying()) {
+            if (!_error && _pos < _tokens->size())
+                  ++_pos;
+            return tokenType();
+            }
+      QXmlStreamReader::TokenType t = _e.readNext();
+      if (_recorder && t != QXmlStreamReader::Invalid)
+            _recorder->append(_e);
+      return t;
+      }
+
+//---------------------------------------------------------
+//   readNextStartElement
+//    same as QXmlStreamReader::readNextStartElement()
+//---------------------------------------------------------
+
+bool MxmlReader::readNextStartElement()
+      {
+      while (readNext() != QXmlStreamReader::Invalid) {
+            if (isEndElement())
+                  return false;
+            else if (isStartElement())
+                  return true;
+            }
+      return false;
+      }
+
+//---------------------------------------------------------
+//   skipCurrentElement
+//    same as QXmlStreamReader::skipCurrentElement()
+//---------------------------------------------------------
+
+void MxmlReader::skipCurrentElement()
+      {
+      int depth = 1;
+      while (depth && readNext() != QXmlStreamReader::Invalid) {
+            if (isEndElement())
+                  --depth;
+            else if (isStartElement())
+                  ++depth;
+            }
+      }
+
+//---------------------------------------------------------
+//   readElementText
+//    same as QXmlStreamReader::readElementText()
+//    with ErrorOnUnexpectedElement
+//---------------------------------------------------------
+
+QString MxmlReader::readElementText()
+      {
+      if (!isStartElement())
+            return QString();
+      QString result;
+      for (;;) {
+            switch (readNext()) {
+                  case QXmlStreamReader::Characters:
+                  case QXmlStreamReader::EntityReference:
+                        result += text();
+                        break;
+                  case QXmlStreamReader::EndElement:
+                        return result;
+                  case QXmlStreamReader::ProcessingInstruction:
+                  case QXmlStreamReader::Comment:
+                        break;
+                  default:
+                        if (!hasError())
+                              raiseError(QObject::tr("Expected character data."));
+                        return result;
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   raiseError
+//---------------------------------------------------------
+
+void MxmlReader::raiseError(const QString& message)
+      {
+      if (replaying())
+            _error = true;
+      else
+            _e.raiseError(message);
+      }
+
+//---------------------------------------------------------
+//   hasError
+//---------------------------------------------------------
+
+bool MxmlReader::hasError() const
+      {
+      return replaying() ? _error : _e.hasError();
+      }
+
+//---------------------------------------------------------
+//   tokenType
+//---------------------------------------------------------
+
+QXmlStreamReader::TokenType MxmlReader::tokenType() const
+      {
+      if (!replaying())
+            return _e.tokenType();
+      if (_pos < 0)
+            return QXmlStreamReader::NoToken;
+      if (_error || _pos >= _tokens->size())
+            return QXmlStreamReader::Invalid;
+      return token().type;
+      }
+
+//---------------------------------------------------------
+//   tokenString
+//---------------------------------------------------------
+
+QString MxmlReader::tokenString() const
+      {
+      if (!replaying())
+            return _e.tokenString();
+      static const char* const names[] = {
+            "NoToken", "Invalid", "StartDocument", "EndDocument", "StartElement", "EndElement",
+            "Characters", "Comment", "DTD", "EntityReference", "ProcessingInstruction"
+            };
+      return QLatin1String(names[tokenType()]);
+      }
+
+//---------------------------------------------------------
+//   name
+//---------------------------------------------------------
+
+QStringRef MxmlReader::name() const
+      {
+      if (!replaying())
+            return _e.name();
+      if (tokenType() <= QXmlStreamReader::Invalid || token().name < 0)
+            return QStringRef();
+      return QStringRef(&_tokens->_names[token().name]);
+      }
+
+//---------------------------------------------------------
+//   text
+//---------------------------------------------------------
+
+QStringRef MxmlReader::text() const
+      {
+      if (!replaying())
+            return _e.text();
+      if (tokenType() <= QXmlStreamReader::Invalid || token().data < 0 || isStartElement())
+            return QStringRef();
+      return QStringRef(&_tokens->_texts[token().data]);
+      }
+
+//---------------------------------------------------------
+//   attributes
+//---------------------------------------------------------
+
+QXmlStreamAttributes MxmlReader::attributes() const
+      {
+      if (!replaying())
+            return _e.attributes();
+      QXmlStreamAttributes attributes;
+      if (!isStartElement() || token().data < 0)
+            return attributes;
+      attributes.reserve(token().count);
+      for (int i = token().data; i < token().data + token().count; ++i) {
+            const MxmlTokens::Attribute& a = _tokens->_attributes[i];
+            attributes.append(_tokens->_names[a.name], _tokens->_values[a.value]);
+            }
+      return attributes;
+      }
+
+//---------------------------------------------------------
+//   lineNumber
+//---------------------------------------------------------
+
+qint64 MxmlReader::lineNumber() const
+      {
+      if (!replaying())
+            return _e.lineNumber();
+      if (_pos < 0 || _tokens->size() == 0)
+            return 0;
+      return _tokens->_tokens[qMin(_pos, _tokens->size() - 1)].line;
+      }
+
+//---------------------------------------------------------
+//   columnNumber
+//---------------------------------------------------------
+
+qint64 MxmlReader::columnNumber() const
+      {
+      if (!replaying())
+            return _e.columnNumber();
+      if (_pos < 0 || _tokens->size() == 0)
+            return 0;
+      return _tokens->_tokens[qMin(_pos, _tokens->size() - 1)].column;
+      }
+
+} // namespace Ms
@@ -0,0 +1,124 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2018 Werner Schweer and others
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __IMPORTMXMLREADER_H__
+#define __IMPORTMXMLREADER_H__
+
+#include <deque>
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   MxmlTokens
+//---------------------------------------------------------
+
+/**
+ The tokens of a MusicXML document as recorded by MxmlReader.
+ Whitespace between elements is not recorded, the parser skips it.
+ Element and attribute names, attribute values and whitespace are
+ stored once. The strings are kept in deques, the index keys refer
+ to them and must not move.
+ */
+
+class MxmlTokens
+      {
+public:
+      struct Token {
+            QXmlStreamReader::TokenType type;
+            int name;                     ///< index in _names, -1 if none
+            int data;                     ///< index in _texts or of the first in _attributes, -1 if none
+            int count;                    ///< number of attributes
+            int line;
+            int column;
+            };
+
+      MxmlTokens() {}
+      MxmlTokens(const MxmlTokens&) = delete;
+      MxmlTokens& operator=(const MxmlTokens&) = delete;
+
+      void clear();
+      bool isComplete() const { return !_tokens.empty() && _tokens.back().type == QXmlStreamReader::EndDocument; }
+      int size() const { return int(_tokens.size()); }
+      size_t bytes() const;
+
+private:
+      friend class MxmlReader;
+      void append(const QXmlStreamReader& e);
+      static int intern(const QStringRef& s, std::deque<QString>& strings, QHash<QStringRef, int>& index);
+
+      struct Attribute {
+            int name;                     ///< index in _names of the qualified name
+            int value;                    ///< index in _values
+            };
+
+      std::vector<Token> _tokens;
+      std::deque<QString> _names;
+      std::deque<QString> _texts;
+      std::deque<QString> _values;
+      std::vector<Attribute> _attributes;
+      QHash<QStringRef, int> _nameIndex;        ///< keys refer to _names
+      QHash<QStringRef, int> _whitespaceIndex;  ///< keys refer to _texts
+      QHash<QStringRef, int> _valueIndex;       ///< keys refer to _values
+      bool _whitespace = false;                 ///< the last token is whitespace
+      };
+
+//---------------------------------------------------------
+//   MxmlReader
+//---------------------------------------------------------
+
+/**
+ The part of the QXmlStreamReader interface used by the MusicXML importer.
+ Reads from a device (optionally recording the tokens into MxmlTokens)
+ or replays the tokens recorded before, which allows pass 2 to skip
+ tokenizing the document a second time.
+ */
+
+class MxmlReader
+      {
+public:
+      MxmlReader() {}
+      void setDevice(QIODevice* device);
+      void setRecorder(MxmlTokens* tokens) { _recorder = tokens; }
+      void setTokens(const MxmlTokens* tokens);
+      bool finishRecording();
+
+      QXmlStreamReader::TokenType readNext();
+      bool readNextStartElement();
+      void skipCurrentElement();
+      QString readElementText();
+
+      QXmlStreamReader::TokenType tokenType() const;
+      QString tokenString() const;
+      bool isStartElement() const { return tokenType() == QXmlStreamReader::StartElement; }
+      bool isEndElement() const { return tokenType() == QXmlStreamReader::EndElement; }
+      QStringRef name() const;
+      QStringRef text() const;
+      QXmlStreamAttributes attributes() const;
+      qint64 lineNumber() const;
+      qint64 columnNumber() const;
+      bool hasError() const;
+
+private:
+      const MxmlTokens::Token& token() const { return _tokens->_tokens[_pos]; }
+      bool replaying() const { return _tokens; }
+      void raiseError(const QString& message);
+
+      QXmlStreamReader _e;
+      MxmlTokens* _recorder = 0;
+      const MxmlTokens* _tokens = 0;
+      int _pos = -1;
+      bool _error = false;                ///< replay only, the reader keeps its own error state
+      };
+
+} // namespace Ms
+
+#endif
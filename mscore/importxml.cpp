@@ -23,6 +23,7 @@
 
 #include "thirdparty/qzip/qzipreader_p.h"
 #include "importmxml.h"
+#include "preferences.h"
 
 namespace Ms {
 
@@ -55,16 +56,16 @@ static void tupletAssert()
 
 //---------------------------------------------------------
 //   initMusicXmlSchema
-//    return false on error
+//    return false on error, setting error
 //---------------------------------------------------------
 
-static bool initMusicXmlSchema(QXmlSchema& schema)
+static bool initMusicXmlSchema(QXmlSchema& schema, QString& error)
       {
       // read the MusicXML schema from the application resources
       QFile schemaFile(":/schema/musicxml.xsd");
       if (!schemaFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
             qDebug("initMusicXmlSchema() could not open resource musicxml.xsd");
-            MScore::lastError = QObject::tr("Internal error: Could not open resource musicxml.xsd\n");
+            error = QObject::tr("Internal error: Could not open resource musicxml.xsd\n");
             return false;
             }
 
@@ -85,7 +86,7 @@ static bool initMusicXmlSchema(QXmlSchema& schema)
       schema.load(schemaBa);
       if (!schema.isValid()) {
             qDebug("initMusicXmlSchema() internal error: MusicXML schema is invalid");
-            MScore::lastError = QObject::tr("Internal error: MusicXML schema is invalid\n");
+            error = QObject::tr("Internal error: MusicXML schema is invalid\n");
             return false;
             }
 
@@ -172,37 +173,72 @@ static bool extractRootfile(QFile* qf, QByteArray& data)
       }
 
 
+//---------------------------------------------------------
+//   ValidationResult
+//---------------------------------------------------------
+
+struct ValidationResult {
+      bool schemaOk = false;
+      bool valid = false;
+      QString schemaError;          ///< set if !schemaOk
+      QString errors;               ///< the validator messages
+      qint64 time = 0;              ///< ms
+      };
+
 //---------------------------------------------------------
 //   doValidate
 //---------------------------------------------------------
 
 /**
- Validate MusicXML data from file \a name contained in QIODevice \a dev.
+ Validate MusicXML \a data from file \a name.
+ Does not touch any global state, runs in a worker thread.
  */
 
-static Score::FileError doValidate(const QString& name, QIODevice* dev)
+static ValidationResult doValidate(const QString& name, QByteArray data)
       {
-      QTime t;
+      QElapsedTimer t;
       t.start();
+      ValidationResult r;
 
       // initialize the schema
       ValidatorMessageHandler messageHandler;
       QXmlSchema schema;
       schema.setMessageHandler(&messageHandler);
-      if (!initMusicXmlSchema(schema))
-            return Score::FileError::FILE_BAD_FORMAT;  // appropriate error message has been printed by initMusicXmlSchema
+      r.schemaOk = initMusicXmlSchema(schema, r.schemaError);
+      if (r.schemaOk) {
+            // validate the data
+            QBuffer buffer(&data);
+            buffer.open(QIODevice::ReadOnly);
+            QXmlSchemaValidator validator(schema);
+            r.valid = validator.validate(&buffer, QUrl::fromLocalFile(name));
+            r.errors = messageHandler.getErrors();
+            }
+      r.time = t.elapsed();
+      return r;
+      }
 
-      // validate the data
-      QXmlSchemaValidator validator(schema);
-      bool valid = validator.validate(dev, QUrl::fromLocalFile(name));
-      //qDebug("Validation time elapsed: %d ms", t.elapsed());
+//---------------------------------------------------------
+//   validationResult
+//---------------------------------------------------------
 
-      if (!valid) {
+/**
+ Report the validation result \a r for file \a name, asking the user
+ whether to keep the imported score if the file is invalid.
+ */
+
+static Score::FileError validationResult(const QString& name, const ValidationResult& r)
+      {
+      if (!r.schemaOk) {
+            MScore::lastError = r.schemaError;
+            return Score::FileError::FILE_BAD_FORMAT;  // appropriate error message has been printed by initMusicXmlSchema
+            }
+
+      if (!r.valid) {
             qDebug("importMusicXml() file '%s' is not a valid MusicXML file", qPrintable(name));
             MScore::lastError = QObject::tr("File '%1' is not a valid MusicXML file").arg(name);
             if (MScore::noGui)
                   return Score::FileError::FILE_NO_ERROR;   // might as well try anyhow in converter mode
-            if (musicXMLValidationErrorDialog(MScore::lastError, messageHandler.getErrors()) != QMessageBox::Yes)
+            if (musicXMLValidationErrorDialog(MScore::lastError, r.errors) != QMessageBox::Yes)
                   return Score::FileError::FILE_USER_ABORT;
             }
 
@@ -216,6 +252,8 @@ static Score::FileError doValidate(const QString& name, QIODevice* dev)
 
 /**
  Validate and import MusicXML data from file \a name contained in QIODevice \a dev into score \a score.
+ The (optional) validation against the schema runs in a worker thread
+ while the score is imported, an invalid file is reported afterwards.
  */
 
 static Score::FileError doValidateAndImport(Score* score, const QString& name, QIODevice* dev)
@@ -223,14 +261,37 @@ static Score::FileError doValidateAndImport(Score* score, const QString& name, Q
       // verify tuplet TDuration::DurationType dependencies
       tupletAssert();
 
-      // validate the file
-      Score::FileError res;
-      res = doValidate(name, dev);
-      if (res != Score::FileError::FILE_NO_ERROR)
-            return res;
+      QElapsedTimer t;
+      t.start();
+      dev->seek(0);
+      QByteArray data = dev->readAll();
+      QBuffer buffer(&data);
+      buffer.open(QIODevice::ReadOnly);
+
+      // validate a (shared) copy of the data
+      const bool validate = preferences.getBool(PREF_IMPORT_MUSICXML_VALIDATE);
+      QFuture<ValidationResult> validation;
+      if (validate)
+            validation = QtConcurrent::run(doValidate, name, data);
 
       // actually do the import
-      importMusicXMLfromBuffer(score, name, dev);
+      Score::FileError res = importMusicXMLfromBuffer(score, name, &buffer);
+      qint64 importTime = t.elapsed();
+      if (res != Score::FileError::FILE_NO_ERROR) {
+            // the validation works on its own copy of the data,
+            // it may finish in the background, its result is not needed
+            qDebug("importMusicXml() import failed after %lld ms", importTime);
+            return res;
+            }
+
+      if (validate) {
+            ValidationResult r = validation.result();
+            qDebug("importMusicXml() import %lld ms, validation %lld ms, total %lld ms",
+                   importTime, r.time, t.elapsed());
+            res = validationResult(name, r);
+            }
+      else
+            qDebug("importMusicXml() import %lld ms, not validated", importTime);
       //qDebug("importMusicXml() return %d", int(res));
       return res;
       }
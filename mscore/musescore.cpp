@@ -95,6 +95,8 @@
 #include "libmscore/excerpt.h"
 #include "libmscore/synthesizerstate.h"
 #include "libmscore/utils.h"
+#include "libmscore/trace.h"
+#include "libmscore/mempool.h"
 
 #include "driver.h"
 
@@ -155,6 +157,8 @@ static bool startWithNewScore = false;
 double guiScaling = 0.0;
 static double userDPI = 0.0;
 int trimMargin = -1;
+int audioExportThreads = 1;
+static int jobThreads = 1;
 bool noWebView = false;
 bool exportScoreParts = false;
 bool ignoreWarnings = false;
@@ -163,6 +167,7 @@ QString mscoreGlobalShare;
 
 static QString outFileName;
 static QString jsonFileName;
+static QString traceFileName;
 static QString audioDriver;
 static QString pluginName;
 static QString styleFile;
@@ -941,7 +946,8 @@ MuseScore::MuseScore()
                   guiScaling = 1.0;
             }
 
-      MScore::pixelRatio = DPI / screen->logicalDotsPerInch();
+      MScore::defaultPixelRatio = DPI / screen->logicalDotsPerInch();
+      MScore::pixelRatio = MScore::defaultPixelRatio;
 
       setObjectName("MuseScore");
       _sstate = STATE_INIT;
@@ -2785,6 +2791,7 @@ void MuseScore::removeTab(int i)
             f.remove();
             }
       delete score;
+      MemoryPool::report("close");
       // Shouldn't be necessary... but fix #21841
       update();
       }
@@ -3138,8 +3145,43 @@ static bool convert(const QString& inFile, const QString& outFile, const QString
       return true;
       }
 
+//---------------------------------------------------------
+//   JobInput
+//    the conversions of one input file; they share the
+//    score, which is read and laid out only once
+//---------------------------------------------------------
+
+struct JobInput {
+      QString inFile;
+      QString plugin;               // a plugin may change the score, it is not shared
+      QStringList outFiles;
+      };
+
+//---------------------------------------------------------
+//   readJobScore
+//    worker thread
+//---------------------------------------------------------
+
+static MasterScore* readJobScore(QString inFile)
+      {
+      // lay out like the main thread does outside of an export
+      MScore::pixelRatio  = MScore::defaultPixelRatio;
+      MScore::pdfPrinting = false;
+      MScore::svgPrinting = false;
+      MasterScore* score = readScoreFile(inFile);
+      if (score) {
+            for (Score* s : score->scoreList())
+                  s->moveToThread(qApp->thread());
+            }
+      return score;
+      }
+
 //---------------------------------------------------------
 //   doProcessJob
+//    The jobs are grouped by input file. The scores are
+//    read on up to jobThreads worker threads ahead of the
+//    exports, which run in the main thread in the order
+//    of the input files.
 //---------------------------------------------------------
 
 static bool doProcessJob(QString jsonFile)
@@ -3161,6 +3203,8 @@ static bool doProcessJob(QString jsonFile)
             return false;
             }
       QJsonArray a = doc.array();
+      std::vector<JobInput> inputs;
+      QHash<QString, int> inputIndex;
       for (const auto i : a) {
             QString inFile;
             QString outFile;
@@ -3183,10 +3227,60 @@ static bool doProcessJob(QString jsonFile)
                         return false;
                         }
                   }
-            if (!convert(inFile, outFile, plugin))
+            if (inFile.isEmpty() || (outFile.isEmpty() && plugin.isEmpty())) {
+                  fprintf(stderr, "cannot convert <%s> to <%s>\n", qPrintable(inFile), qPrintable(outFile));
                   return false;
+                  }
+            QString key = QFileInfo(inFile).absoluteFilePath();
+            if (plugin.isEmpty() && inputIndex.contains(key))
+                  inputs[inputIndex[key]].outFiles.append(outFile);
+            else {
+                  if (plugin.isEmpty())
+                        inputIndex[key] = int(inputs.size());
+                  inputs.push_back({ inFile, plugin, QStringList(outFile) });
+                  }
             }
-      return true;
+
+      // exporting score and parts adds the parts to the score,
+      // the other formats must not see them
+      if (exportScoreParts) {
+            for (JobInput& in : inputs) {
+                  std::stable_partition(in.outFiles.begin(), in.outFiles.end(), [](const QString& fn) {
+                        return !fn.endsWith(".pdf") && !fn.endsWith(".png");
+                        });
+                  }
+            }
+
+      QThreadPool pool;
+      pool.setMaxThreadCount(jobThreads);
+      std::vector<QFuture<MasterScore*>> scores(inputs.size());
+      auto startRead = [&](size_t i) {
+            if (i < inputs.size() && inputs[i].plugin.isEmpty())
+                  scores[i] = QtConcurrent::run(&pool, readJobScore, inputs[i].inFile);
+            };
+      for (int i = 0; i < jobThreads; ++i)
+            startRead(i);
+
+      bool rv = true;
+      for (size_t i = 0; i < inputs.size(); ++i) {
+            startRead(i + jobThreads);
+            const JobInput& in = inputs[i];
+            if (!in.plugin.isEmpty()) {
+                  rv = convert(in.inFile, in.outFiles.front(), in.plugin) && rv;
+                  continue;
+                  }
+            MasterScore* score = scores[i].result();
+            if (!score) {
+                  rv = false;
+                  continue;
+                  }
+            for (const QString& outFile : in.outFiles) {
+                  fprintf(stderr, "convert <%s> to <%s>\n", qPrintable(in.inFile), qPrintable(outFile));
+                  rv = doConvert(score, outFile) && rv;
+                  }
+            delete score;
+            }
+      return rv;
       }
 
 //---------------------------------------------------------
@@ -6000,11 +6094,6 @@ bool MuseScore::saveMp3(Score* score, const QString& name)
       Q_UNUSED(name);
       return false;
 #else
-      EventMap events;
-      score->renderMidi(&events);
-      if(events.size() == 0)
-            return false;
-
       MP3Exporter exporter;
       if (!exporter.loadLibrary(MP3Exporter::AskUser::MAYBE)) {
             QSettings settings;
@@ -6041,7 +6130,6 @@ bool MuseScore::saveMp3(Score* score, const QString& name)
 
       int channels = 2;
 
-      int oldSampleRate = MScore::sampleRate;
       int sampleRate = preferences.getInt(PREF_EXPORT_AUDIO_SAMPLERATE);
       exporter.setBitrate(preferences.getInt(PREF_EXPORT_MP3_BITRATE));
 
@@ -6053,7 +6141,6 @@ bool MuseScore::saveMp3(Score* score, const QString& name)
                      QString::null, QString::null);
                   }
             qDebug("Unable to initialize MP3 stream");
-            MScore::sampleRate = oldSampleRate;
             return false;
             }
 
@@ -6065,27 +6152,11 @@ bool MuseScore::saveMp3(Score* score, const QString& name)
                      tr("Unable to open target file for writing"),
                      QString::null, QString::null);
                   }
-            MScore::sampleRate = oldSampleRate;
             return false;
             }
 
       int bufferSize   = exporter.getOutBufferSize();
       uchar* bufferOut = new uchar[bufferSize];
-      MasterSynthesizer* synth = synthesizerFactory();
-      synth->init();
-      synth->setSampleRate(sampleRate);
-      if (MScore::noGui) { // use score settings if possible
-            bool r = synth->setState(score->synthesizerState());
-            if (!r)
-                  synth->init();
-            }
-      else { // use current synth settings
-            bool r = synth->setState(mscore->synthesizerState());
-            if (!r)
-                  synth->init();
-            }
-
-      MScore::sampleRate = sampleRate;
 
       QProgressDialog progress(this);
       progress.setWindowFlags(Qt::WindowFlags(Qt::Dialog | Qt::FramelessWindowHint | Qt::WindowTitleHint));
@@ -6093,170 +6164,51 @@ bool MuseScore::saveMp3(Score* score, const QString& name)
       //progress.setCancelButton(0);
       progress.setCancelButtonText(tr("Cancel"));
       progress.setLabelText(tr("Exporting..."));
+      progress.setRange(0, 1000);
       if (!MScore::noGui)
             progress.show();
 
-      static const int FRAMES = 512;
-      float bufferL[FRAMES];
-      float bufferR[FRAMES];
-
-      float  peak = 0.0;
-      double gain = 1.0;
-      EventMap::const_iterator endPos = events.cend();
-      --endPos;
-      const int et = (score->utick2utime(endPos->first) + 1) * MScore::sampleRate;
-      const int maxEndTime = (score->utick2utime(endPos->first) + 3) * MScore::sampleRate;
-      progress.setRange(0, et);
+      std::vector<float> bufferL;
+      std::vector<float> bufferR;
+      bool encoderError = false;
 
-      for (int pass = 0; pass < 2; ++pass) {
-            EventMap::const_iterator playPos;
-            playPos = events.cbegin();
-            synth->allSoundsOff(-1);
-
-            //
-            // init instruments
-            //
-            foreach(Part* part, score->parts()) {
-                  const InstrumentList* il = part->instruments();
-                  for(auto i = il->begin(); i!= il->end(); i++) {
-                        for (const Channel* a : i->second->channel()) {
-                              a->updateInitList();
-                              for (MidiCoreEvent e : a->init) {
-                                    if (e.type() == ME_INVALID)
-                                          continue;
-                                    e.setChannel(a->channel);
-                                    int syntiIdx= synth->index(score->masterScore()->midiMapping(a->channel)->articulation->synti);
-									synth->play(e, syntiIdx);
-                                    }
-                              }
-                        }
+      auto encode = [&](const float* buffer, unsigned frames) -> bool {
+            bufferL.resize(frames);
+            bufferR.resize(frames);
+            for (unsigned i = 0; i < frames; ++i) {
+                  bufferL[i] = *buffer++;
+                  bufferR[i] = *buffer++;
                   }
-
-            int playTime = 0.0;
-
-            for (;;) {
-                  unsigned frames = FRAMES;
-                  float max = 0;
-                  //
-                  // collect events for one segment
-                  //
-                  memset(bufferL, 0, sizeof(float) * FRAMES);
-                  memset(bufferR, 0, sizeof(float) * FRAMES);
-                  double endTime = playTime + frames;
-
-                  float* l = bufferL;
-                  float* r = bufferR;
-
-                  for (; playPos != events.cend(); ++playPos) {
-                        double f = score->utick2utime(playPos->first) * MScore::sampleRate;
-                        if (f >= endTime)
-                              break;
-                        int n = f - playTime;
-                        if (n) {
-#if (!defined (_MSCVER) && !defined (_MSC_VER))
-                              float bu[n * 2];
-                              memset(bu, 0, sizeof(float) * 2 * n);
-#else
-                              // MSVC does not support VLA. Replace with std::vector. If profiling determines that the
-                              //    heap allocation is slow, an optimization might be used.
-                              std::vector<float> vBu(n * 2, 0);   // Default initialized, memset() not required.
-                              float* bu = vBu.data();
-#endif
-
-                              synth->process(n, bu);
-                              float* sp = bu;
-                              for (int i = 0; i < n; ++i) {
-                                    *l++ = *sp++;
-                                    *r++ = *sp++;
-                                    }
-                              playTime  += n;
-                              frames    -= n;
-                              }
-                        const NPlayEvent& e = playPos->second;
-                        if (e.isChannelEvent()) {
-                              int channelIdx = e.channel();
-                              Channel* c = score->masterScore()->midiMapping(channelIdx)->articulation;
-                              if (!c->mute) {
-                                    synth->play(e, synth->index(c->synti));
-                                    }
-                              }
-                        }
-                  if (frames) {
-#if (!defined (_MSCVER) && !defined (_MSC_VER))
-                        float bu[frames * 2];
-                        memset(bu, 0, sizeof(float) * 2 * frames);
-#else
-                        // MSVC does not support VLA. Replace with std::vector. If profiling determines that the
-                        //    heap allocation is slow, an optimization might be used.
-                        std::vector<float> vBu(frames * 2, 0);   // Default initialized, memset() not required.
-                        float* bu = vBu.data();
-#endif
-                        synth->process(frames, bu);
-                        float* sp = bu;
-                        for (unsigned i = 0; i < frames; ++i) {
-                              *l++ = *sp++;
-                              *r++ = *sp++;
-                              }
-                        playTime += frames;
-                        }
-
-                  if (pass == 1) {
-                        for (int i = 0; i < FRAMES; ++i) {
-                              max = qMax(max, qAbs(bufferL[i]));
-                              max = qMax(max, qAbs(bufferR[i]));
-                              bufferL[i] *= gain;
-                              bufferR[i] *= gain;
-                              }
-                        long bytes;
-                        if (FRAMES < inSamples)
-                              bytes = exporter.encodeRemainder(bufferL, bufferR,  FRAMES , bufferOut);
-                        else
-                              bytes = exporter.encodeBuffer(bufferL, bufferR, bufferOut);
-                        if (bytes < 0) {
-                              if (MScore::noGui)
-                                    qDebug("exportmp3: error from encoder: %ld", bytes);
-                              else
-                                    QMessageBox::warning(0,
-                                       tr("Encoding Error"),
-                                       tr("Error %1 returned from MP3 encoder").arg(bytes),
-                                       QString::null, QString::null);
-                              break;
-                              }
-                        else
-                              file.write((char*)bufferOut, bytes);
-                        }
-                  else {
-                        for (int i = 0; i < FRAMES; ++i) {
-                              max = qMax(max, qAbs(bufferL[i]));
-                              max = qMax(max, qAbs(bufferR[i]));
-                              peak = qMax(peak, qAbs(bufferL[i]));
-                              peak = qMax(peak, qAbs(bufferR[i]));
-                              }
-                        }
-                  playTime = endTime;
-                  if (!MScore::noGui) {
-                        if (progress.wasCanceled())
-                              break;
-                        progress.setValue((pass * et + playTime) / 2);
-                        qApp->processEvents();
-                        }
-                  if (playTime >= et)
-                        synti->allNotesOff(-1);
-                  // create sound until the sound decays
-                  if (playTime >= et && max * peak < 0.000001)
-                        break;
-                  // hard limit
-                  if (playTime > maxEndTime)
-                        break;
+            long bytes;
+            if (int(frames) < inSamples)
+                  bytes = exporter.encodeRemainder(bufferL.data(), bufferR.data(), frames, bufferOut);
+            else
+                  bytes = exporter.encodeBuffer(bufferL.data(), bufferR.data(), bufferOut);
+            if (bytes < 0) {
+                  if (MScore::noGui)
+                        qDebug("exportmp3: error from encoder: %ld", bytes);
+                  else
+                        QMessageBox::warning(0,
+                           tr("Encoding Error"),
+                           tr("Error %1 returned from MP3 encoder").arg(bytes),
+                           QString::null, QString::null);
+                  encoderError = true;
+                  return false;
                   }
+            file.write((char*)bufferOut, bytes);
+            return true;
+            };
+      auto updateProgress = [&progress](float v) -> bool {
+            if (MScore::noGui)
+                  return true;
             if (progress.wasCanceled())
-                  break;
-            if (pass == 0 && peak == 0.0) {
-                  qDebug("song is empty");
-                  break;
-                  }
-            gain = 0.99 / peak;
-            }
+                  return false;
+            progress.setValue(v * 1000);
+            qApp->processEvents();
+            return true;
+            };
+      // encoder errors are reported by encode() and cancel the export
+      bool rv = renderAudio(score, true, encode, updateProgress) && !encoderError;
 
       long bytes = exporter.finishStream(bufferOut);
       if (bytes > 0L)
@@ -6264,13 +6216,11 @@ bool MuseScore::saveMp3(Score* score, const QString& name)
 
       bool wasCanceled = progress.wasCanceled();
       progress.close();
-      delete synth;
       delete[] bufferOut;
       file.close();
-      if (wasCanceled)
+      if (wasCanceled || encoderError)
             file.remove();
-      MScore::sampleRate = oldSampleRate;
-      return true;
+      return rv || wasCanceled;
 #endif
       }
 
@@ -6413,7 +6363,13 @@ int main(int argc, char* av[])
       parser.addOption(QCommandLineOption({"w", "no-webview"}, "No web view in start center"));
       parser.addOption(QCommandLineOption({"P", "export-score-parts"}, "Used with '-o <file>.pdf', export score and parts"));
       parser.addOption(QCommandLineOption(      "no-fallback-font", "Don't use Bravura as fallback musical font"));
+      parser.addOption(QCommandLineOption(      "layout-cache", "Save the page layout in .mscz files and reuse it when loading an unchanged score"));
+#ifdef MSCORE_TRACE
+      parser.addOption(QCommandLineOption(      "trace", "Time layout, playback and file i/o and save the trace in Chrome trace event format to 'file' on exit", "file"));
+#endif
       parser.addOption(QCommandLineOption({"f", "force"}, "Used with '-o <file>', ignore warnings reg. score being corrupted or from wrong version"));
+      parser.addOption(QCommandLineOption(      "job-threads", "Used with '-j <file>', read this many input files in parallel (0: number of cores)", "threads"));
+      parser.addOption(QCommandLineOption(      "audio-threads", "Used with '-o <file>.wav|ogg|flac|mp3', render the parts on this many synthesizers in parallel (0: number of cores)", "threads"));
       parser.addOption(QCommandLineOption({"b", "bitrate"}, "Used with '-o <file>.mp3', sets bitrate, in kbps", "bitrate"));
       parser.addOption(QCommandLineOption({"E", "install-extension"}, "Install an extension, load soundfont as default unless if -e is passed too", "extension file"));
 
@@ -6440,6 +6396,15 @@ int main(int argc, char* av[])
       midiInputTrace = parser.isSet("I");
       midiOutputTrace = parser.isSet("O");
       MScore::useFallbackFont = !parser.isSet("no-fallback-font");
+      MScore::layoutCache = parser.isSet("layout-cache");
+#ifdef MSCORE_TRACE
+      if (parser.isSet("trace")) {
+            traceFileName = parser.value("trace");
+            if (traceFileName.isEmpty())
+                  parser.showHelp(EXIT_FAILURE);
+            Trace::start();
+            }
+#endif
 
       if ((converterMode = parser.isSet("o"))) {
             MScore::noGui = true;
@@ -6489,6 +6454,26 @@ int main(int argc, char* av[])
                   trimMargin = -1;
                   }
            }
+      if (parser.isSet("job-threads")) {
+            QString temp = parser.value("job-threads");
+            bool ok = false;
+            jobThreads = temp.toInt(&ok);
+            if (!ok || jobThreads < 0) {
+                  fprintf(stderr, "Job threads value '%s' not recognized, using a single thread.\n", qPrintable(temp));
+                  jobThreads = 1;
+                  }
+            if (jobThreads == 0)
+                  jobThreads = QThread::idealThreadCount();
+            }
+      if (parser.isSet("audio-threads")) {
+            QString temp = parser.value("audio-threads");
+            bool ok = false;
+            audioExportThreads = temp.toInt(&ok);
+            if (!ok || audioExportThreads < 0) {
+                  fprintf(stderr, "Audio threads value '%s' not recognized, using a single thread.\n", qPrintable(temp));
+                  audioExportThreads = 1;
+                  }
+            }
       if (parser.isSet("x")) {
             QString temp = parser.value("x");
             if (temp.isEmpty())
@@ -6783,7 +6768,10 @@ int main(int argc, char* av[])
             // see issue #28706: Hangup in converter mode with MusicXML source
             qApp->processEvents();
 #endif
-            exit(processNonGui(argv) ? 0 : EXIT_FAILURE);
+            bool rv = processNonGui(argv);
+            if (!traceFileName.isEmpty())
+                  Trace::save(traceFileName);
+            exit(rv ? 0 : EXIT_FAILURE);
             }
       else {
             mscore->readSettings();
@@ -6874,6 +6862,9 @@ int main(int argc, char* av[])
       if (settings.value("mixerVisible", false).toBool())
             mscore->showMixer(true);
 
-      return qApp->exec();
+      int rv = qApp->exec();
+      if (!traceFileName.isEmpty())
+            Trace::save(traceFileName);
+      return rv;
       }
 
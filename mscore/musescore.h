@@ -668,6 +668,7 @@ class MuseScore : public QMainWindow, public MuseScoreCore {
       void addImage(Score*, Element*);
 
       bool savePng(Score*, const QString& name, bool screenshot, bool transparent, double convDpi, int trimMargin, QImage::Format format);
+      bool renderAudio(Score*, bool normalize, std::function<bool(const float*, unsigned)> write, std::function<bool(float)> updateProgress);
       bool saveAudio(Score*, QIODevice *device, std::function<bool(float)> updateProgress = nullptr);
       bool saveAudio(Score*, const QString& name);
       bool canSaveMp3();
@@ -818,6 +819,7 @@ extern Score::FileError importBB(MasterScore*, const QString& name);
 extern Score::FileError importCapella(MasterScore*, const QString& name);
 extern Score::FileError importCapXml(MasterScore*, const QString& name);
 extern Score::FileError readScore(MasterScore* score, QString name, bool ignoreVersionError);
+extern MasterScore* readScoreFile(const QString& name);
 
 } // namespace Ms
 
@@ -19,6 +19,7 @@
 #include "libmscore/mscore.h"
 #include "libmscore/system.h"
 #include "libmscore/measurebase.h"
+#include "libmscore/tilecache.h"
 
 namespace Ms {
 
@@ -124,6 +125,12 @@ Navigator::Navigator(NScrollArea* sa, QWidget* parent)
       sa->setWidget(this);
       sa->setWidgetResizable(false);
       _previewOnly = false;
+      tiles        = new TileCache;
+      }
+
+Navigator::~Navigator()
+      {
+      delete tiles;
       }
 
 //---------------------------------------------------------
@@ -149,6 +156,7 @@ void Navigator::setScoreView(ScoreView* v)
             disconnect(_cv, SIGNAL(viewRectChanged()), this, SLOT(updateViewRect()));
             }
       _cv = QPointer<ScoreView>(v);
+      tiles->clear();
       if (v) {
             _score  = v->score();
             rescale();
@@ -173,6 +181,7 @@ void Navigator::setScore(Score* v)
       {
       _cv    = 0;
       _score = v;
+      tiles->clear();
       rescale();
       updateViewRect();
       update();
@@ -202,6 +211,7 @@ void Navigator::rescale()
             qreal m = width() / scoreWidth;
             setFixedHeight(int(scoreHeight * m));
             matrix = QTransform(m, 0, 0, m, 0, 0);
+            tiles->setScale(m);
             }
       else {
             qreal scoreWidth  = lp->x() + lp->width();
@@ -211,6 +221,7 @@ void Navigator::rescale()
             qreal m  = height() / scoreHeight;
             setFixedWidth(int(scoreWidth * m));
             matrix = QTransform(m, 0, 0, m, 0, 0);
+            tiles->setScale(m);
             }
       }
 
@@ -333,6 +344,8 @@ void Navigator::layoutChanged()
       {
       if (_score && !_score->pages().isEmpty())
             rescale();
+      if (_score)
+            tiles->prune(_score);
       update();
       }
 
@@ -375,11 +388,13 @@ void Navigator::paintEvent(QPaintEvent* ev)
 
             p.fillRect(pr, Qt::white);
             p.translate(pos);
-            for (System* s  : page->systems()) {
-                  for (MeasureBase* m : s->measures())
-                        m->scanElements(&p, paintElement, false);
+            if (_score->layoutMode() == LayoutMode::LINE) {
+                  // one page with one system, too large for a tile
+                  for (Element* e : page->items(fr.translated(-pos)))
+                        paintElement(&p, e);
                   }
-            page->scanElements(&p, paintElement, false);
+            else
+                  tiles->paintPage(&p, page);
             if (page->score()->layoutMode() == LayoutMode::PAGE) {
                   p.setFont(font);
                   p.setPen(MScore::layoutBreakColor);
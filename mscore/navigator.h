@@ -27,6 +27,7 @@ class Score;
 class ScoreView;
 class Page;
 class Navigator;
+class TileCache;
 
 //---------------------------------------------------------
 //   NScrollArea
@@ -72,6 +73,7 @@ class Navigator : public QWidget {
       QPoint startMove;
       QTransform matrix;
       bool _previewOnly;
+      TileCache* tiles;
 
       void rescale();
 
@@ -89,6 +91,7 @@ class Navigator : public QWidget {
 
    public:
       Navigator(NScrollArea* sa, QWidget* parent = 0);
+      ~Navigator();
       void setScoreView(ScoreView*);
       void setScore(Score*);
       void setPreviewOnly(bool b) { _previewOnly = b; }
@@ -104,6 +104,7 @@ void Preferences::init(bool storeInMemoryOnly)
             {PREF_IMPORT_GUITARPRO_CHARSET,                        new StringPreference("UTF-8", false)},
             {PREF_IMPORT_MUSICXML_IMPORTBREAKS,                    new BoolPreference(true, false)},
             {PREF_IMPORT_MUSICXML_IMPORTLAYOUT,                    new BoolPreference(true, false)},
+            {PREF_IMPORT_MUSICXML_VALIDATE,                        new BoolPreference(true)},
             {PREF_IMPORT_OVERTURE_CHARSET,                         new StringPreference("GBK", false)},
             {PREF_IMPORT_STYLE_STYLEFILE,                          new StringPreference("", false)},
             {PREF_IO_ALSA_DEVICE,                                  new StringPreference("default", false)},
@@ -134,6 +135,8 @@ void Preferences::init(bool storeInMemoryOnly)
             {PREF_IO_PORTMIDI_OUTPUTDEVICE,                        new StringPreference("")},
             {PREF_IO_PORTMIDI_OUTPUTLATENCYMILLISECONDS,           new IntPreference(0)},
             {PREF_IO_PULSEAUDIO_USEPULSEAUDIO,                     new BoolPreference(defaultUsePulseAudio, false)},
+            {PREF_IO_SYNTHESIZER_RENDERTHREADS,                    new IntPreference(0 /* 0: number of cores */, false)},
+            {PREF_IO_ZERBERUS_PRELOADTIME,                         new IntPreference(0 /* ms, 0: load completely */, false)},
             {PREF_SCORE_CHORD_PLAYONADDNOTE,                       new BoolPreference(true, false)},
             {PREF_SCORE_MAGNIFICATION,                             new DoublePreference(1.0, false)},
             {PREF_SCORE_NOTE_PLAYONCLICK,                          new BoolPreference(true, false)},
@@ -111,6 +111,7 @@ enum class MusicxmlExportBreaks : char {
 #define PREF_IMPORT_GUITARPRO_CHARSET                       "import/guitarpro/charset"
 #define PREF_IMPORT_MUSICXML_IMPORTBREAKS                   "import/musicXML/importBreaks"
 #define PREF_IMPORT_MUSICXML_IMPORTLAYOUT                   "import/musicXML/importLayout"
+#define PREF_IMPORT_MUSICXML_VALIDATE                       "import/musicXML/validate"
 #define PREF_IMPORT_OVERTURE_CHARSET                        "import/overture/charset"
 #define PREF_IMPORT_STYLE_STYLEFILE                         "import/style/styleFile"
 #define PREF_IO_ALSA_DEVICE                                 "io/alsa/device"
@@ -142,6 +143,8 @@ enum class MusicxmlExportBreaks : char {
 #define PREF_IO_PORTMIDI_OUTPUTDEVICE                       "io/portMidi/outputDevice"
 #define PREF_IO_PORTMIDI_OUTPUTLATENCYMILLISECONDS          "io/portMidi/outputLatencyMilliseconds"
 #define PREF_IO_PULSEAUDIO_USEPULSEAUDIO                    "io/pulseAudio/usePulseAudio"
+#define PREF_IO_SYNTHESIZER_RENDERTHREADS                   "io/synthesizer/renderThreads"
+#define PREF_IO_ZERBERUS_PRELOADTIME                        "io/zerberus/preloadTime"
 #define PREF_SCORE_CHORD_PLAYONADDNOTE                      "score/chord/playOnAddNote"
 #define PREF_SCORE_MAGNIFICATION                            "score/magnification"
 #define PREF_SCORE_NOTE_PLAYONCLICK                         "score/note/playOnClick"
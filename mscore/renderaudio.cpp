@@ -0,0 +1,293 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2009 Werner Schweer and others
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "renderaudio.h"
+#include "libmscore/score.h"
+#include "libmscore/part.h"
+#include "libmscore/instrument.h"
+#include "libmscore/mscore.h"
+#include "synthesizer/event.h"
+#include "synthesizer/msynthesizer.h"
+
+#include <numeric>
+
+namespace Ms {
+
+static const unsigned EXPORT_FRAMES = 512;      // frames per synthesizer call
+static const unsigned EXPORT_BLOCK  = 64;       // chunks rendered per worker round
+
+//---------------------------------------------------------
+//   AudioExportGroup
+//    parts rendered by one synthesizer instance
+//---------------------------------------------------------
+
+struct AudioExportGroup {
+      MasterSynthesizer* synth { 0 };
+      EventMap events;
+      EventMap::const_iterator playPos;
+      std::vector<int> synti;             // synthesizer index by channel, -1 if muted
+      int playTime             { 0 };
+      int nevents              { 0 };
+      int et                   { 0 };
+      std::vector<float> buffer;          // EXPORT_BLOCK chunks
+
+      void render(Score* score, unsigned chunks);
+      };
+
+//---------------------------------------------------------
+//   render
+//    render chunks of EXPORT_FRAMES frames into buffer
+//---------------------------------------------------------
+
+void AudioExportGroup::render(Score* score, unsigned chunks)
+      {
+      for (unsigned chunk = 0; chunk < chunks; ++chunk) {
+            unsigned frames = EXPORT_FRAMES;
+            float* p = buffer.data() + chunk * EXPORT_FRAMES * 2;
+            memset(p, 0, sizeof(float) * EXPORT_FRAMES * 2);
+            int endTime = playTime + frames;
+            for (; playPos != events.cend(); ++playPos) {
+                  int f = score->utick2utime(playPos->first) * MScore::sampleRate;
+                  if (f >= endTime)
+                        break;
+                  int n = f - playTime;
+                  if (n) {
+                        synth->process(n, p);
+                        p += 2 * n;
+                        }
+                  playTime  += n;
+                  frames    -= n;
+                  const NPlayEvent& e = playPos->second;
+                  if (e.isChannelEvent()) {
+                        int idx = synti[e.channel()];
+                        if (idx != -1)
+                              synth->play(e, idx);
+                        }
+                  }
+            if (frames) {
+                  synth->process(frames, p);
+                  playTime += frames;
+                  }
+            playTime = endTime;
+            if (playTime >= et)
+                  synth->allNotesOff(-1);
+            }
+      }
+
+//---------------------------------------------------------
+//   renderScoreAudio
+//    Render the score at sampleRate as interleaved stereo
+//    float samples and pass them to write() in chunks of
+//    EXPORT_FRAMES frames.
+//
+//    The parts are distributed over up to threads groups,
+//    each group has its own synthesizer made by
+//    createSynthesizer() and is rendered in a worker thread,
+//    EXPORT_BLOCK chunks at a time, before the chunks are
+//    mixed. The cores left over by the groups render the
+//    voices of each synthesizer in parallel. With one group
+//    the output is that of the serial export loop.
+//
+//    With normalization the mix is spooled to a temporary
+//    file and scaled by the peak gain while it is streamed
+//    to write(), so the score is rendered once and memory
+//    use does not depend on the length of the score.
+//
+//    If updateProgress() or write() return false, the export
+//    is canceled.
+//---------------------------------------------------------
+
+bool renderScoreAudio(Score* score, int sampleRate, int threads, bool normalize,
+   std::function<MasterSynthesizer*(int renderThreads)> createSynthesizer,
+   std::function<bool(const float*, unsigned)> write, std::function<bool(float)> updateProgress)
+      {
+      EventMap events;
+      score->renderMidi(&events);
+      if (events.size() == 0)
+            return false;
+
+      MasterScore* ms = score->masterScore();
+
+      //
+      // distribute the parts over the groups, largest part first
+      // into the group with the fewest events
+      //
+      QList<Part*> parts = score->parts();
+      std::map<int, int> channelPart;
+      for (int i = 0; i < parts.size(); ++i) {
+            for (const auto& ii : *parts[i]->instruments()) {
+                  for (const Channel* a : ii.second->channel())
+                        channelPart[a->channel] = i;
+                  }
+            }
+      std::vector<int> partEvents(parts.size(), 0);
+      for (const auto& ev : events) {
+            if (!ev.second.isChannelEvent())
+                  continue;
+            auto i = channelPart.find(ev.second.channel());
+            if (i != channelPart.end())
+                  ++partEvents[i->second];
+            }
+      int ngroups = qBound(1, threads, qMax(1, parts.size()));
+      std::vector<AudioExportGroup> groups(ngroups);
+      std::vector<int> partGroup(parts.size(), 0);
+      std::vector<int> order(parts.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(), [&partEvents](int a, int b) { return partEvents[a] > partEvents[b]; });
+      for (int pi : order) {
+            auto g = std::min_element(groups.begin(), groups.end(),
+               [](const AudioExportGroup& a, const AudioExportGroup& b) { return a.nevents < b.nevents; });
+            partGroup[pi] = int(g - groups.begin());
+            g->nevents   += partEvents[pi];
+            }
+
+      EventMap::const_iterator endPos = events.cend();
+      --endPos;
+      int oldSampleRate  = MScore::sampleRate;
+      MScore::sampleRate = sampleRate;
+      const int et         = (score->utick2utime(endPos->first) + 1) * MScore::sampleRate;
+      const int maxEndTime = (score->utick2utime(endPos->first) + 3) * MScore::sampleRate;
+
+      if (ngroups == 1)
+            groups[0].events.swap(events);
+      else {
+            // only channel events are played
+            for (const auto& ev : events) {
+                  if (!ev.second.isChannelEvent())
+                        continue;
+                  auto i = channelPart.find(ev.second.channel());
+                  EventMap& em = groups[i == channelPart.end() ? 0 : partGroup[i->second]].events;
+                  em.insert(em.end(), ev);
+                  }
+            events.clear();
+            }
+
+      for (int gi = 0; gi < ngroups; ++gi) {
+            AudioExportGroup& g = groups[gi];
+            g.synth   = createSynthesizer(qMax(1, RenderPool::defaultThreads() / ngroups));
+            g.playPos = g.events.cbegin();
+            g.et      = et;
+            g.buffer.resize(EXPORT_BLOCK * EXPORT_FRAMES * 2);
+            g.synti.resize(ms->midiMapping()->size());
+            for (int idx = 0; idx < int(g.synti.size()); ++idx) {
+                  const Channel* c = ms->midiMapping(idx)->articulation;
+                  g.synti[idx] = c->mute ? -1 : g.synth->index(c->synti);
+                  }
+            g.synth->allSoundsOff(-1);
+
+            //
+            // init instruments
+            //
+            for (int pi = 0; pi < parts.size(); ++pi) {
+                  if (partGroup[pi] != gi && ngroups > 1)
+                        continue;
+                  const InstrumentList* il = parts[pi]->instruments();
+                  for (auto i = il->begin(); i!= il->end(); i++) {
+                        for (const Channel* a : i->second->channel()) {
+                              a->updateInitList();
+                              for (MidiCoreEvent e : a->init) {
+                                    if (e.type() == ME_INVALID)
+                                          continue;
+                                    e.setChannel(a->channel);
+                                    int syntiIdx = g.synth->index(ms->midiMapping(a->channel)->articulation->synti);
+                                    g.synth->play(e, syntiIdx);
+                                    }
+                              }
+                        }
+                  }
+            }
+
+      QTemporaryFile spool;
+      if (normalize && !spool.open()) {
+            qDebug("cannot open temporary file for audio export");
+            normalize = false;
+            }
+      const float renderShare = normalize ? 0.5 : 1.0;
+
+      bool cancelled = false;
+      float peak     = 0.0;
+      int playTime   = 0;
+      float mix[EXPORT_FRAMES * 2];
+
+      for (bool done = false; !done && !cancelled;) {
+            QtConcurrent::blockingMap(groups, [score](AudioExportGroup& g) { g.render(score, EXPORT_BLOCK); });
+
+            for (unsigned chunk = 0; chunk < EXPORT_BLOCK; ++chunk) {
+                  const unsigned offset = chunk * EXPORT_FRAMES * 2;
+                  memcpy(mix, groups[0].buffer.data() + offset, sizeof(mix));
+                  for (int gi = 1; gi < ngroups; ++gi) {
+                        const float* p = groups[gi].buffer.data() + offset;
+                        for (unsigned i = 0; i < EXPORT_FRAMES * 2; ++i)
+                              mix[i] += p[i];
+                        }
+                  float max = 0.0;
+                  for (unsigned i = 0; i < EXPORT_FRAMES * 2; ++i) {
+                        max  = qMax(max, qAbs(mix[i]));
+                        peak = qMax(peak, qAbs(mix[i]));
+                        }
+                  if (normalize) {
+                        if (spool.write(reinterpret_cast<const char*>(mix), sizeof(mix)) != qint64(sizeof(mix))) {
+                              qDebug("write to temporary file failed");
+                              cancelled = true;
+                              break;
+                              }
+                        }
+                  else if (!write(mix, EXPORT_FRAMES)) {
+                        cancelled = true;
+                        break;
+                        }
+                  playTime += EXPORT_FRAMES;
+                  // create sound until the sound decays, hard limit at maxEndTime
+                  if ((playTime >= et && max * peak < 0.000001) || playTime > maxEndTime) {
+                        done = true;
+                        break;
+                        }
+                  }
+            if (updateProgress && !updateProgress(renderShare * qMin(1.0f, float(playTime) / float(et))))
+                  cancelled = true;
+            }
+
+      for (AudioExportGroup& g : groups)
+            delete g.synth;
+      MScore::sampleRate = oldSampleRate;
+
+      if (normalize && !cancelled) {
+            if (peak == 0.0)
+                  qDebug("song is empty");
+            else {
+                  double gain = 0.99 / peak;
+                  qint64 size = spool.size();
+                  spool.seek(0);
+                  for (qint64 pos = 0; pos < size; pos += sizeof(mix)) {
+                        if (spool.read(reinterpret_cast<char*>(mix), sizeof(mix)) != qint64(sizeof(mix))) {
+                              qDebug("read from temporary file failed");
+                              cancelled = true;
+                              break;
+                              }
+                        for (unsigned i = 0; i < EXPORT_FRAMES * 2; ++i)
+                              mix[i] *= gain;
+                        if (!write(mix, EXPORT_FRAMES)) {
+                              cancelled = true;
+                              break;
+                              }
+                        if (updateProgress && (pos % (sizeof(mix) * EXPORT_BLOCK)) == 0
+                           && !updateProgress(0.5 + 0.5 * float(pos) / float(size))) {
+                              cancelled = true;
+                              break;
+                              }
+                        }
+                  }
+            }
+      return !cancelled;
+      }
+
+}     // namespace Ms
@@ -0,0 +1,26 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2009 Werner Schweer and others
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __RENDERAUDIO_H__
+#define __RENDERAUDIO_H__
+
+namespace Ms {
+
+class Score;
+class MasterSynthesizer;
+
+extern bool renderScoreAudio(Score*, int sampleRate, int threads, bool normalize,
+   std::function<MasterSynthesizer*(int renderThreads)> createSynthesizer,
+   std::function<bool(const float*, unsigned)> write, std::function<bool(float)> updateProgress);
+
+}     // namespace Ms
+#endif
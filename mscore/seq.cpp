@@ -40,6 +40,7 @@
 #include "libmscore/utils.h"
 #include "libmscore/repeatlist.h"
 #include "libmscore/audio.h"
+#include "libmscore/trace.h"
 #include "synthcontrol.h"
 #include "pianoroll.h"
 #include "pianotools.h"
@@ -155,6 +156,7 @@ Seq::Seq()
       state    = Transport::STOP;
       oggInit  = false;
       _driver  = 0;
+      _synti   = 0;
       playPos  = events.cbegin();
       playFrame  = 0;
       metronomeVolume = 0.3;
@@ -221,6 +223,7 @@ void Seq::setScoreView(ScoreView* v)
             heartBeatTimer->start(20);    // msec
 
       playlistChanged = true;
+      playlistCache.clear();
       _synti->reset();
       if (cs) {
             initInstruments();
@@ -235,12 +238,19 @@ void Seq::setScoreView(ScoreView* v)
 
 bool Seq::init(bool hotPlug)
       {
+      if (_synti) {
+            int threads = preferences.getInt(PREF_IO_SYNTHESIZER_RENDERTHREADS);
+            _synti->setRenderThreads(threads > 0 ? threads : RenderPool::defaultThreads());
+            }
       if (!_driver || !_driver->start(hotPlug)) {
             qDebug("Cannot start I/O");
             running = false;
             return false;
             }
       running = true;
+      // synthesizer changes are done by the audio thread from now on
+      if (_synti)
+            _synti->setRealtime(true);
       return true;
       }
 
@@ -256,6 +266,8 @@ void Seq::exit()
             stopWait();
             delete _driver;
             _driver = 0;
+            if (_synti)
+                  _synti->setRealtime(false);
             }
       }
 
@@ -669,6 +681,9 @@ void Seq::addCountInClicks()
 
 void Seq::process(unsigned framesPerPeriod, float* buffer)
       {
+      TRACE_SCOPE("playback", "Seq::process");
+      // synthesizer commands sent from here (e.g. all notes off while seeking) are executed at once
+      _synti->setAudioThread();
       unsigned framesRemain = framesPerPeriod; // the number of frames remaining to be processed by this call to Seq::process
       Transport driverState = _driver->getState();
       // Checking for the reposition from JACK Transport
@@ -1000,9 +1015,13 @@ void Seq::collectEvents()
       if (state ==  Transport::PLAY)
             return;
       mutex.lock();
-      events.clear();
-
-      cs->renderMidi(&events);
+      // render only the part of the score changed since
+      // the last call, if possible
+      if (!cs->renderMidi(&events, cs->playlistRange(), &playlistCache)) {
+            events.clear();
+            cs->renderMidi(&events, &playlistCache);
+            }
+      cs->resetPlaylistRange();
       endUTick = 0;
 
       if (!events.empty()) {
@@ -27,6 +27,7 @@
 #include "driver.h"
 #include "libmscore/fifo.h"
 #include "libmscore/tempo.h"
+#include "libmscore/score.h"
 
 class QTimer;
 
@@ -123,6 +124,7 @@ class Seq : public QObject, public Sequencer {
 
       bool oggInit;
       bool playlistChanged;
+      PlaylistCache playlistCache;        // what events were rendered with, to patch them
 
       SeqMsgFifo toSeq;
       SeqMsgFifo fromSeq;
@@ -0,0 +1,524 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include <functional>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#if defined(Q_OS_MAC)
+#include <mach/mach.h>
+#endif
+#endif
+
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/page.h"
+#include "libmscore/measure.h"
+#include "libmscore/segment.h"
+#include "libmscore/chord.h"
+#include "libmscore/note.h"
+#include "mscore/preferences.h"
+#include "mscore/svggenerator.h"
+#include "synthesizer/event.h"
+#include "zerberus/zerberus.h"
+#include "effects/zita1/zita.h"
+
+namespace Ms {
+extern Score::FileError importMusicXml(MasterScore*, const QString&);
+extern Score::FileError importMusicXMLfromBuffer(Score*, const QString&, QIODevice*, bool);
+extern bool saveXml(Score*, const QString&);
+}
+
+using namespace Ms;
+
+static const int SAMPLERATE    = 44100;
+static const int FRAMES        = 256;      // frames per process() call
+static const int AUDIO_SECONDS = 30;       // audio rendered per score
+static const int PNG_DPI       = 300;      // default of the png export
+
+//---------------------------------------------------------
+//   CorpusScore
+//---------------------------------------------------------
+
+struct CorpusScore {
+      const char* name;
+      const char* description;
+      const char* path;                    // relative to mtest
+      };
+
+static const CorpusScore corpus[] = {
+      { "chamber",   "3 parts, 42 measures",        "libmscore/midi/testKantataBWV140Excerpts.mscx"     },
+      { "piano",     "oboe and piano",              "libmscore/midi/testAndanteExcerpts.mscx"           },
+      { "tablature", "guitar with tablature",       "guitarpro/timer.gpx-ref.mscx"                      },
+      { "repeats",   "many repeats and voltas",     "libmscore/repeat/repeat36.mscx"                    },
+      { "orchestra", "16 parts with drums",         "libmscore/midimapping/test1withDrums.mscx"         },
+      { "parts",     "4 parts with linked parts",   "libmscore/parts/part-all-parts.mscx"               },
+      { "huge",      "6 parts, 1296 measures",      "libmscore/concertpitch/concertpitchbenchmark.mscx" },
+      };
+
+//---------------------------------------------------------
+//   TestBenchmarkSuite
+//    time the load, layout, edit, export and playback
+//    paths for a corpus of scores and write the results
+//    as json, to compare them between releases.
+//    Not part of the default ctest run, use
+//    ctest -C benchmark -R tst_benchmarksuite
+//
+//    MSCORE_BENCHMARK_JSON   output file, no file if unset
+//    MSCORE_BENCHMARK_RUNS   runs per phase, default 3
+//
+//    The memory of a phase is the resident set size before
+//    its first and after its last run, and the largest
+//    growth during one run. processPeakRssKb is the peak of
+//    the whole process up to the end of the phase, which
+//    the phases run before it may have set.
+//---------------------------------------------------------
+
+class TestBenchmarkSuite : public QObject, public MTest
+      {
+      Q_OBJECT
+      int runs { 3 };
+      QTemporaryDir tmp;
+      QJsonArray results;
+
+      bool measure(QJsonArray& phases, const char* phase, const std::function<void()>& f);
+      Note* middleNote(Score*);
+      void edit(Score*, Note*);
+      void exportSvg(Score*, const QString& name);
+      void exportPng(Score*, const QString& name);
+      bool renderAudio(Score*, const EventMap&);
+
+   private slots:
+      void initTestCase();
+      void cleanupTestCase();
+      void benchmark_data();
+      void benchmark();
+      };
+
+//---------------------------------------------------------
+//   peakRss
+//    peak resident set size of the process in kB
+//---------------------------------------------------------
+
+static qint64 peakRss()
+      {
+#if defined(Q_OS_WIN)
+      PROCESS_MEMORY_COUNTERS pmc;
+      if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+            return 0;
+      return qint64(pmc.PeakWorkingSetSize) / 1024;
+#else
+      struct rusage ru;
+      if (getrusage(RUSAGE_SELF, &ru))
+            return 0;
+#if defined(Q_OS_MAC)
+      return qint64(ru.ru_maxrss) / 1024;       // bytes
+#else
+      return qint64(ru.ru_maxrss);
+#endif
+#endif
+      }
+
+//---------------------------------------------------------
+//   currentRss
+//    current resident set size of the process in kB,
+//    0 if it is not known
+//---------------------------------------------------------
+
+static qint64 currentRss()
+      {
+#if defined(Q_OS_WIN)
+      PROCESS_MEMORY_COUNTERS pmc;
+      if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+            return 0;
+      return qint64(pmc.WorkingSetSize) / 1024;
+#elif defined(Q_OS_MAC)
+      mach_task_basic_info info;
+      mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+      if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, task_info_t(&info), &count) != KERN_SUCCESS)
+            return 0;
+      return qint64(info.resident_size) / 1024;
+#else
+      // size and resident pages
+      QFile f("/proc/self/statm");
+      if (!f.open(QIODevice::ReadOnly))
+            return 0;
+      QList<QByteArray> fields = f.readAll().split(' ');
+      if (fields.size() < 2)
+            return 0;
+      return fields[1].toLongLong() * (sysconf(_SC_PAGESIZE) / 1024);
+#endif
+      }
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::initTestCase()
+      {
+      initMTest();
+      preferences.setPreference(PREF_APP_PATHS_MYSOUNDFONTS, root);
+      int n = qEnvironmentVariableIntValue("MSCORE_BENCHMARK_RUNS");
+      if (n > 0)
+            runs = n;
+      QVERIFY(tmp.isValid());
+      }
+
+//---------------------------------------------------------
+//   cleanupTestCase
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::cleanupTestCase()
+      {
+      QJsonObject o;
+      o["version"]   = VERSION;
+      o["date"]      = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+      o["os"]        = QSysInfo::prettyProductName();
+      o["cpu"]       = QSysInfo::currentCpuArchitecture();
+      o["threads"]   = QThread::idealThreadCount();
+      o["runs"]      = runs;
+      o["processPeakRssKb"] = peakRss();
+      o["scores"]    = results;
+
+      if (!qEnvironmentVariableIsSet("MSCORE_BENCHMARK_JSON"))
+            return;
+      QFile f(QString::fromLocal8Bit(qgetenv("MSCORE_BENCHMARK_JSON")));
+      QVERIFY(f.open(QIODevice::WriteOnly));
+      f.write(QJsonDocument(o).toJson());
+      qDebug("results written to %s", qPrintable(QFileInfo(f).absoluteFilePath()));
+      }
+
+//---------------------------------------------------------
+//   measure
+//    run f and append the fastest and the median time and
+//    the memory to phases. Return false if a check in f
+//    failed.
+//---------------------------------------------------------
+
+bool TestBenchmarkSuite::measure(QJsonArray& phases, const char* phase, const std::function<void()>& f)
+      {
+      std::vector<qint64> ns;
+      qint64 rssBefore = currentRss();
+      qint64 rssGrowth = 0;
+      for (int i = 0; i < runs; ++i) {
+            qint64 rss = currentRss();
+            QElapsedTimer timer;
+            timer.start();
+            f();
+            ns.push_back(timer.nsecsElapsed());
+            rssGrowth = qMax(rssGrowth, currentRss() - rss);
+            if (QTest::currentTestFailed())
+                  return false;
+            }
+      std::sort(ns.begin(), ns.end());
+      QJsonObject o;
+      o["phase"]     = phase;
+      o["minMs"]     = ns.front() / 1e6;
+      o["medianMs"]  = ns[ns.size() / 2] / 1e6;
+      o["rssBeforeKb"] = rssBefore;
+      o["rssAfterKb"]  = currentRss();
+      o["rssGrowthKb"] = rssGrowth;
+      o["processPeakRssKb"] = peakRss();
+      qDebug("   %-16s %10.2f ms %8lld kB", phase, ns[ns.size() / 2] / 1e6, rssGrowth);
+      phases.append(o);
+      return true;
+      }
+
+//---------------------------------------------------------
+//   middleNote
+//    top note of the first chord from the middle measure
+//    on, or from the start if the second half has none
+//---------------------------------------------------------
+
+Note* TestBenchmarkSuite::middleNote(Score* score)
+      {
+      Measure* middle = score->firstMeasure();
+      for (int i = score->nmeasures() / 2; i > 0 && middle->nextMeasure(); --i)
+            middle = middle->nextMeasure();
+      for (Measure* start : { middle, score->firstMeasure() }) {
+            for (Measure* m = start; m; m = m->nextMeasure()) {
+                  for (Segment* s = m->first(SegmentType::ChordRest); s; s = s->next(SegmentType::ChordRest)) {
+                        for (int track = 0; track < score->ntracks(); ++track) {
+                              Element* e = s->element(track);
+                              if (e && e->isChord())
+                                    return toChord(e)->upNote();
+                              }
+                        }
+                  }
+            }
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   edit
+//    transpose a note and flip its stem, then undo both
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::edit(Score* score, Note* note)
+      {
+      score->startCmd();
+      score->select(note);
+      score->upDown(true, UpDownMode::OCTAVE);
+      score->endCmd();
+
+      score->startCmd();
+      score->select(note);
+      score->cmdFlip();
+      score->endCmd();
+
+      score->undoRedo(true, 0);
+      score->undoRedo(true, 0);
+      }
+
+//---------------------------------------------------------
+//   paintPage
+//---------------------------------------------------------
+
+static void paintPage(QPainter& p, Page* page, SvgGenerator* svg = 0)
+      {
+      QList<Element*> ell = page->items(page->abbox());
+      qStableSort(ell.begin(), ell.end(), elementLessThan);
+      for (const Element* e : ell) {
+            if (!e->visible())
+                  continue;
+            if (svg)
+                  svg->setElement(e);
+            p.save();
+            p.translate(e->pagePos());
+            e->draw(&p);
+            p.restore();
+            }
+      }
+
+//---------------------------------------------------------
+//   exportSvg
+//    one file per page, as the svg export does
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::exportSvg(Score* score, const QString& name)
+      {
+      score->setPrinting(true);
+      MScore::pdfPrinting = true;
+      MScore::svgPrinting = true;
+      const QList<Page*>& pl = score->pages();
+      for (int i = 0; i < pl.size(); ++i) {
+            Page* page = pl.at(i);
+            SvgGenerator printer;
+            printer.setFileName(QString("%1-%2.svg").arg(name).arg(i + 1));
+            QRectF r = page->abbox();
+            printer.setSize(QSize(r.width(), r.height()));
+            printer.setViewBox(QRectF(0, 0, r.width(), r.height()));
+            QPainter p(&printer);
+            p.setRenderHint(QPainter::Antialiasing, true);
+            p.setRenderHint(QPainter::TextAntialiasing, true);
+            paintPage(p, page, &printer);
+            p.end();
+            }
+      MScore::svgPrinting = false;
+      MScore::pdfPrinting = false;
+      score->setPrinting(false);
+      }
+
+//---------------------------------------------------------
+//   exportPng
+//    one image per page, as the png export does
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::exportPng(Score* score, const QString& name)
+      {
+      score->setPrinting(true);
+      MScore::pdfPrinting = true;
+      const double mag = double(PNG_DPI) / DPI;
+      const QList<Page*>& pl = score->pages();
+      for (int i = 0; i < pl.size(); ++i) {
+            Page* page = pl.at(i);
+            QRectF r = page->abbox();
+            QImage image(lrint(r.width() * mag), lrint(r.height() * mag), QImage::Format_ARGB32_Premultiplied);
+            image.setDotsPerMeterX(lrint(PNG_DPI * 1000 / INCH));
+            image.setDotsPerMeterY(lrint(PNG_DPI * 1000 / INCH));
+            image.fill(Qt::transparent);
+            QPainter p(&image);
+            p.setRenderHint(QPainter::Antialiasing, true);
+            p.setRenderHint(QPainter::TextAntialiasing, true);
+            p.scale(mag, mag);
+            paintPage(p, page);
+            p.end();
+            image.save(QString("%1-%2.png").arg(name).arg(i + 1), "png");
+            }
+      MScore::pdfPrinting = false;
+      score->setPrinting(false);
+      }
+
+//---------------------------------------------------------
+//   renderAudio
+//    play the first AUDIO_SECONDS of the score through
+//    zerberus and the reverb. No soundfont is shipped with
+//    the sources, so all channels use the test instrument.
+//    Return false if the instrument cannot be loaded.
+//---------------------------------------------------------
+
+bool TestBenchmarkSuite::renderAudio(Score* score, const EventMap& events)
+      {
+      Zerberus synth;
+      synth.init(SAMPLERATE);
+      if (!synth.loadInstrument("renderPoolTest.sfz"))
+            return false;
+      ZitaReverb reverb;
+      reverb.init(SAMPLERATE);
+
+      std::vector<float> dry(FRAMES * 2);
+      std::vector<float> wet(FRAMES * 2);
+      auto ev = events.cbegin();
+      for (int frame = 0; frame < AUDIO_SECONDS * SAMPLERATE; frame += FRAMES) {
+            for (; ev != events.cend(); ++ev) {
+                  if (lrint(score->utick2utime(ev->first) * SAMPLERATE) >= frame + FRAMES)
+                        break;
+                  const NPlayEvent& e = ev->second;
+                  if (e.type() == ME_NOTEON || e.type() == ME_NOTEOFF)
+                        synth.play(PlayEvent(e.type(), e.channel() % MAX_CHANNEL, e.dataA(), e.dataB()));
+                  }
+            std::fill(dry.begin(), dry.end(), 0.0f);
+            synth.process(FRAMES, dry.data(), 0, 0);
+            reverb.process(FRAMES, dry.data(), wet.data());
+            }
+      return true;
+      }
+
+//---------------------------------------------------------
+//   benchmark
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::benchmark_data()
+      {
+      QTest::addColumn<QString>("path");
+      QTest::addColumn<QString>("description");
+      for (const CorpusScore& cs : corpus)
+            QTest::newRow(cs.name) << QString(cs.path) << QString(cs.description);
+      }
+
+void TestBenchmarkSuite::benchmark()
+      {
+      QFETCH(QString, path);
+      QFETCH(QString, description);
+      const QString file = root + "/" + path;
+      const QString out  = tmp.path() + "/" + QTest::currentDataTag();
+      qDebug("%s: %s", QTest::currentDataTag(), qPrintable(description));
+
+      QJsonArray phases;
+      if (!measure(phases, "load", [&]() {
+            MasterScore* s = new MasterScore(mscore->baseStyle());
+            s->setName(QFileInfo(file).completeBaseName());
+            Score::isScoreLoaded() = true;
+            Score::FileError rv = s->loadMsc(file, false);
+            Score::isScoreLoaded() = false;
+            delete s;
+            QVERIFY(rv == Score::FileError::FILE_NO_ERROR);
+            }))
+            return;
+
+      std::unique_ptr<MasterScore> score(readScore(path));
+      QVERIFY(score);
+      if (!measure(phases, "layout", [&]() {
+            score->doLayout();
+            }))
+            return;
+
+      Note* note = middleNote(score.get());
+      QVERIFY(note);
+      if (!measure(phases, "edit", [&]() {
+            edit(score.get(), note);
+            }))
+            return;
+
+      if (!measure(phases, "save", [&]() {
+            QBuffer buffer;
+            buffer.open(QIODevice::WriteOnly);
+            QVERIFY(score->saveFile(&buffer, false));
+            }))
+            return;
+      score->cmdSelectAll();
+      if (!measure(phases, "copy", [&]() {
+            QVERIFY(!score->selection().mimeData().isEmpty());
+            }))
+            return;
+      score->deselectAll();
+
+      EventMap events;
+      if (!measure(phases, "renderMidi", [&]() {
+            events.clear();
+            score->renderMidi(&events);
+            }))
+            return;
+      QVERIFY(!events.empty());
+
+      if (!measure(phases, "exportPdf", [&]() {
+            QVERIFY(savePdf(score.get(), out + ".pdf"));
+            }))
+            return;
+      if (!measure(phases, "exportSvg", [&]() {
+            exportSvg(score.get(), out);
+            }))
+            return;
+      if (!measure(phases, "exportPng", [&]() {
+            exportPng(score.get(), out);
+            }))
+            return;
+      if (!measure(phases, "exportMusicXml", [&]() {
+            QVERIFY(saveXml(score.get(), out + ".xml"));
+            }))
+            return;
+      if (!measure(phases, "importMusicXml", [&]() {
+            MasterScore* s = new MasterScore(mscore->baseStyle());
+            s->setName(QFileInfo(file).completeBaseName());
+            Score::isScoreLoaded() = true;
+            Score::FileError rv = importMusicXml(s, out + ".xml");
+            Score::isScoreLoaded() = false;
+            delete s;
+            QVERIFY(rv == Score::FileError::FILE_NO_ERROR);
+            }))
+            return;
+      // without validation, pass 2 replaying the tokens of pass 1 or parsing again
+      for (bool replay : { true, false }) {
+            if (!measure(phases, replay ? "importMusicXmlReplay" : "importMusicXmlReparse", [&]() {
+                  QFile f(out + ".xml");
+                  QVERIFY(f.open(QIODevice::ReadOnly));
+                  MasterScore* s = new MasterScore(mscore->baseStyle());
+                  s->setName(QFileInfo(file).completeBaseName());
+                  Score::isScoreLoaded() = true;
+                  Score::FileError rv = importMusicXMLfromBuffer(s, f.fileName(), &f, replay);
+                  Score::isScoreLoaded() = false;
+                  delete s;
+                  QVERIFY(rv == Score::FileError::FILE_NO_ERROR);
+                  }))
+                  return;
+            }
+      if (!measure(phases, "renderAudio", [&]() {
+            QVERIFY(renderAudio(score.get(), events));
+            }))
+            return;
+
+      QJsonObject o;
+      o["name"]     = QTest::currentDataTag();
+      o["file"]     = path;
+      o["parts"]    = score->parts().size();
+      o["measures"] = score->nmeasures();
+      o["pages"]    = score->npages();
+      o["phases"]   = phases;
+      results.append(o);
+      }
+
+QTEST_MAIN(TestBenchmarkSuite)
+#include "tst_benchmarksuite.moc"
@@ -0,0 +1,172 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include <cmath>
+#include <memory>
+#include <random>
+
+#include "effects/zita1/zita.h"
+#include "effects/compressor/compressor.h"
+
+using namespace Ms;
+
+static const int FRAMES  = 256;           // frames per process() call
+static const int SECONDS = 4;             // audio processed per measurement
+
+//---------------------------------------------------------
+//   TestEffects
+//    the output of an effect must not depend on the number
+//    of frames per process() call, nor on the vector code.
+//    Run every effect over noise at the usual sample rates
+//    and report the time per frame.
+//---------------------------------------------------------
+
+class TestEffects : public QObject
+      {
+      Q_OBJECT
+      std::vector<float> noise;
+
+      Effect* createEffect(const QString& name, bool vectorized = true);
+      std::vector<float> processed(const QString& name, int sampleRate, const std::vector<int>& frames, bool vectorized = true);
+
+   private slots:
+      void initTestCase();
+      void blockSizes_data();
+      void blockSizes();
+      void benchmarkEffect_data();
+      void benchmarkEffect();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestEffects::initTestCase()
+      {
+      std::mt19937 rnd(4711);
+      std::uniform_real_distribution<float> value(-0.5f, 0.5f);
+      noise.resize(FRAMES * 2 * 64);
+      for (float& v : noise)
+            v = value(rnd);
+      }
+
+//---------------------------------------------------------
+//   createEffect
+//    without vectorized the effect runs its scalar code
+//---------------------------------------------------------
+
+Effect* TestEffects::createEffect(const QString& name, bool vectorized)
+      {
+      if (name == "Zita1") {
+            ZitaReverb* zita = new ZitaReverb;
+            zita->setVectorized(vectorized);
+            return zita;
+            }
+      if (name == "SC4")
+            return new Compressor;
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   processed
+//    the noise processed by a new effect, calling process()
+//    with the given numbers of frames in turn
+//---------------------------------------------------------
+
+std::vector<float> TestEffects::processed(const QString& name, int sampleRate, const std::vector<int>& frames, bool vectorized)
+      {
+      std::unique_ptr<Effect> e(createEffect(name, vectorized));
+      e->init(sampleRate);
+      std::vector<float> out(noise.size());
+      const int total = int(noise.size()) / 2;
+      for (int frame = 0, i = 0; frame < total; ++i) {
+            const int n = qMin(frames[i % frames.size()], total - frame);
+            e->process(n, noise.data() + frame * 2, out.data() + frame * 2);
+            frame += n;
+            }
+      return out;
+      }
+
+//---------------------------------------------------------
+//   blockSizes
+//    the scalar code called with one frame at a time is
+//    the reference, the scalar and the vector code must
+//    give bit-identical results with any block size
+//---------------------------------------------------------
+
+void TestEffects::blockSizes_data()
+      {
+      QTest::addColumn<QString>("effect");
+      QTest::addColumn<int>("sampleRate");
+      for (const char* effect : { "Zita1", "SC4" }) {
+            for (int sampleRate : { 44100, 96000 })
+                  QTest::newRow(qPrintable(QString("%1 %2").arg(effect).arg(sampleRate))) << QString(effect) << sampleRate;
+            }
+      }
+
+void TestEffects::blockSizes()
+      {
+      QFETCH(QString, effect);
+      QFETCH(int, sampleRate);
+      const std::vector<float> single = processed(effect, sampleRate, { 1 }, false);
+      QVERIFY(std::all_of(single.begin(), single.end(), [](float v) { return std::isfinite(v); }));
+      QVERIFY(std::any_of(single.begin(), single.end(), [](float v) { return v != 0.0f; }));
+      for (bool vectorized : { false, true }) {
+            QVERIFY(processed(effect, sampleRate, { 1 }, vectorized) == single);
+            QVERIFY(processed(effect, sampleRate, { FRAMES }, vectorized) == single);
+            QVERIFY(processed(effect, sampleRate, { int(noise.size()) / 2 }, vectorized) == single);
+            QVERIFY(processed(effect, sampleRate, { 3, 64, 1, 63, 65, 255, 257, 7 }, vectorized) == single);
+            }
+      }
+
+//---------------------------------------------------------
+//   benchmarkEffect
+//---------------------------------------------------------
+
+void TestEffects::benchmarkEffect_data()
+      {
+      QTest::addColumn<QString>("effect");
+      QTest::addColumn<int>("sampleRate");
+      for (const char* effect : { "Zita1", "SC4" }) {
+            for (int sampleRate : { 44100, 48000, 96000 })
+                  QTest::newRow(qPrintable(QString("%1 %2").arg(effect).arg(sampleRate))) << QString(effect) << sampleRate;
+            }
+      }
+
+void TestEffects::benchmarkEffect()
+      {
+      QFETCH(QString, effect);
+      QFETCH(int, sampleRate);
+      std::unique_ptr<Effect> e(createEffect(effect));
+      QVERIFY(e);
+      e->init(sampleRate);
+
+      std::vector<float> out(FRAMES * 2);
+      const int blocks   = SECONDS * sampleRate / FRAMES;
+      const int nblocks  = int(noise.size()) / (FRAMES * 2);
+      // warm up, the delay lines and envelopes are filled
+      for (int i = 0; i < nblocks; ++i)
+            e->process(FRAMES, noise.data() + i * FRAMES * 2, out.data());
+
+      QElapsedTimer timer;
+      timer.start();
+      for (int i = 0; i < blocks; ++i)
+            e->process(FRAMES, noise.data() + (i % nblocks) * FRAMES * 2, out.data());
+      qint64 ns = timer.nsecsElapsed();
+
+      QVERIFY(std::all_of(out.begin(), out.end(), [](float v) { return std::isfinite(v); }));
+      qDebug("%s at %d Hz: %.1f ns/frame", qPrintable(effect), sampleRate, double(ns) / (double(blocks) * FRAMES));
+      }
+
+QTEST_MAIN(TestEffects)
+
+#include "tst_effects.moc"
@@ -0,0 +1,251 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+
+#include "libmscore/score.h"
+#include "libmscore/part.h"
+#include "libmscore/instrument.h"
+#include "mscore/preferences.h"
+#include "mscore/renderaudio.h"
+#include "synthesizer/event.h"
+#include "synthesizer/msynthesizer.h"
+#include "zerberus/zerberus.h"
+#include "effects/zita1/zita.h"
+
+using namespace Ms;
+
+static const int SAMPLERATE = 44100;
+
+//---------------------------------------------------------
+//   TestExportAudio
+//    the export of one synthesizer group must give exactly
+//    the output of the serial export loop it replaced
+//---------------------------------------------------------
+
+class TestExportAudio : public QObject, public MTest
+      {
+      Q_OBJECT
+      MasterScore* score { 0 };
+
+      static MasterSynthesizer* synthesizer(int renderThreads);
+      std::vector<float> serialExport();
+      std::vector<float> exported(bool normalize);
+
+   private slots:
+      void initTestCase();
+      void cleanupTestCase();
+      void singleGroup();
+      void singleGroupNormalized();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestExportAudio::initTestCase()
+      {
+      initMTest();
+      preferences.setPreference(PREF_APP_PATHS_MYSOUNDFONTS, root);
+      score = readScore("libmscore/midi/testKantataBWV140Excerpts.mscx");
+      QVERIFY(score);
+      QVERIFY(score->parts().size() > 1);
+      }
+
+//---------------------------------------------------------
+//   cleanupTestCase
+//---------------------------------------------------------
+
+void TestExportAudio::cleanupTestCase()
+      {
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   synthesizer
+//    zerberus with the test instrument, which plays all
+//    channels, and the reverb
+//---------------------------------------------------------
+
+MasterSynthesizer* TestExportAudio::synthesizer(int renderThreads)
+      {
+      MasterSynthesizer* synth = new MasterSynthesizer();
+      Zerberus* zerberus = new Zerberus();
+      synth->registerSynthesizer(zerberus);
+      zerberus->init(SAMPLERATE);
+      zerberus->loadInstrument("renderPoolTest.sfz");
+      ZitaReverb* reverb = new ZitaReverb();
+      reverb->init(SAMPLERATE);
+      synth->registerEffect(0, reverb);
+      synth->setEffect(0, 0);
+      synth->setRenderThreads(renderThreads);
+      return synth;
+      }
+
+//---------------------------------------------------------
+//   serialExport
+//    the export loop of MuseScore::saveAudio() before the
+//    synthesizer groups, without normalization
+//---------------------------------------------------------
+
+std::vector<float> TestExportAudio::serialExport()
+      {
+      std::vector<float> out;
+      EventMap events;
+      score->renderMidi(&events);
+
+      MasterSynthesizer* synth = synthesizer(RenderPool::defaultThreads());
+      int oldSampleRate  = MScore::sampleRate;
+      MScore::sampleRate = SAMPLERATE;
+
+      float peak  = 0.0;
+      EventMap::const_iterator endPos = events.cend();
+      --endPos;
+      const int et = (score->utick2utime(endPos->first) + 1) * MScore::sampleRate;
+      const int maxEndTime = (score->utick2utime(endPos->first) + 3) * MScore::sampleRate;
+
+      EventMap::const_iterator playPos;
+      playPos = events.cbegin();
+      synth->allSoundsOff(-1);
+
+      //
+      // init instruments
+      //
+      foreach(Part* part, score->parts()) {
+            const InstrumentList* il = part->instruments();
+            for(auto i = il->begin(); i!= il->end(); i++) {
+                  for (const Channel* a : i->second->channel()) {
+                        a->updateInitList();
+                        for (MidiCoreEvent e : a->init) {
+                              if (e.type() == ME_INVALID)
+                                    continue;
+                              e.setChannel(a->channel);
+                              int syntiIdx = synth->index(score->masterScore()->midiMapping(a->channel)->articulation->synti);
+                              synth->play(e, syntiIdx);
+                              }
+                        }
+                  }
+            }
+
+      static const unsigned FRAMES = 512;
+      float buffer[FRAMES * 2];
+      int playTime = 0;
+
+      for (;;) {
+            unsigned frames = FRAMES;
+            //
+            // collect events for one segment
+            //
+            float max = 0.0;
+            memset(buffer, 0, sizeof(float) * FRAMES * 2);
+            int endTime = playTime + frames;
+            float* p = buffer;
+            for (; playPos != events.cend(); ++playPos) {
+                  int f = score->utick2utime(playPos->first) * MScore::sampleRate;
+                  if (f >= endTime)
+                        break;
+                  int n = f - playTime;
+                  if (n) {
+                        synth->process(n, p);
+                        p += 2 * n;
+                        }
+
+                  playTime  += n;
+                  frames    -= n;
+                  const NPlayEvent& e = playPos->second;
+                  if (e.isChannelEvent()) {
+                        int channelIdx = e.channel();
+                        Channel* c = score->masterScore()->midiMapping(channelIdx)->articulation;
+                        if (!c->mute) {
+                              synth->play(e, synth->index(c->synti));
+                              }
+                        }
+                  }
+            if (frames) {
+                  synth->process(frames, p);
+                  playTime += frames;
+                  }
+            for (unsigned i = 0; i < FRAMES * 2; ++i) {
+                  max = qMax(max, qAbs(buffer[i]));
+                  peak = qMax(peak, qAbs(buffer[i]));
+                  }
+            out.insert(out.end(), buffer, buffer + FRAMES * 2);
+            playTime = endTime;
+            if (playTime >= et)
+                  synth->allNotesOff(-1);
+            // create sound until the sound decays
+            if (playTime >= et && max*peak < 0.000001)
+                  break;
+            // hard limit
+            if (playTime > maxEndTime)
+                  break;
+            }
+
+      MScore::sampleRate = oldSampleRate;
+      delete synth;
+      return out;
+      }
+
+//---------------------------------------------------------
+//   exported
+//    the output of renderScoreAudio() with one group
+//---------------------------------------------------------
+
+std::vector<float> TestExportAudio::exported(bool normalize)
+      {
+      std::vector<float> out;
+      bool ok = renderScoreAudio(score, SAMPLERATE, 1, normalize, &TestExportAudio::synthesizer,
+         [&out](const float* p, unsigned frames) {
+               out.insert(out.end(), p, p + frames * 2);
+               return true;
+               },
+         nullptr);
+      return ok ? out : std::vector<float>();
+      }
+
+//---------------------------------------------------------
+//   singleGroup
+//---------------------------------------------------------
+
+void TestExportAudio::singleGroup()
+      {
+      std::vector<float> expected = serialExport();
+      QVERIFY(std::any_of(expected.begin(), expected.end(), [](float v) { return v != 0.0f; }));
+      std::vector<float> result = exported(false);
+      QCOMPARE(result.size(), expected.size());
+      QVERIFY(memcmp(result.data(), expected.data(), expected.size() * sizeof(float)) == 0);
+      }
+
+//---------------------------------------------------------
+//   singleGroupNormalized
+//    the serial loop rendered the score a second time and
+//    scaled it by the gain of the peak of the first pass
+//---------------------------------------------------------
+
+void TestExportAudio::singleGroupNormalized()
+      {
+      std::vector<float> expected = serialExport();
+      float peak = 0.0;
+      for (float v : expected)
+            peak = qMax(peak, qAbs(v));
+      QVERIFY(peak > 0.0);
+      double gain = 0.99 / peak;
+      for (float& v : expected)
+            v *= gain;
+      std::vector<float> result = exported(true);
+      QCOMPARE(result.size(), expected.size());
+      QVERIFY(memcmp(result.data(), expected.data(), expected.size() * sizeof(float)) == 0);
+      }
+
+QTEST_MAIN(TestExportAudio)
+
+#include "tst_exportaudio.moc"
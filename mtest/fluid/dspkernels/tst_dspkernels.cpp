@@ -0,0 +1,166 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include <random>
+
+#include "fluid/dspkernels.h"
+
+using namespace FluidS;
+
+Q_DECLARE_METATYPE(FluidS::DspIsa)
+
+static const int FRAMES  = 1024;
+
+//---------------------------------------------------------
+//   TestDspKernels
+//    the kernels must give exactly the results of the
+//    loop at the end of Voice::effects() they replace
+//---------------------------------------------------------
+
+class TestDspKernels : public QObject
+      {
+      Q_OBJECT
+      std::vector<float> buf;
+
+      std::vector<float> mixed(DspIsa);
+      std::vector<float> voiceMixed();
+
+   private slots:
+      void initTestCase();
+      void cleanupTestCase();
+      void mix_data();
+      void mix();
+      void benchmarkMix_data();
+      void benchmarkMix();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestDspKernels::initTestCase()
+      {
+      std::mt19937 rnd(1);
+      std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+      buf.resize(FRAMES + 3);
+      for (float& v : buf)
+            v = value(rnd);
+      }
+
+//---------------------------------------------------------
+//   cleanupTestCase
+//---------------------------------------------------------
+
+void TestDspKernels::cleanupTestCase()
+      {
+      initDspKernels();
+      }
+
+//---------------------------------------------------------
+//   mixed
+//    buf mixed by the kernel in pieces of 1, 3, 7, ...
+//    frames into out, reverb and chorus
+//---------------------------------------------------------
+
+std::vector<float> TestDspKernels::mixed(DspIsa isa)
+      {
+      std::vector<float> out(FRAMES * 6, 0.25f);
+      setDspIsa(isa);
+      float* o = out.data();
+      for (int start = 0, n = 1; start + n <= int(buf.size()); start += n, n = n * 2 + 1)
+            dspKernels()->mix(buf.data() + start, n, o + start * 2, o + FRAMES * 2 + start * 2, o + FRAMES * 4 + start * 2,
+               0.7f, 0.3f, 0.2f, 0.1f);
+      return out;
+      }
+
+//---------------------------------------------------------
+//   voiceMixed
+//    the same with the loop Voice::effects() had before
+//    the kernels
+//---------------------------------------------------------
+
+std::vector<float> TestDspKernels::voiceMixed()
+      {
+      std::vector<float> result(FRAMES * 6, 0.25f);
+      const float amp_left   = 0.7f;
+      const float amp_right  = 0.3f;
+      const float amp_reverb = 0.2f;
+      const float amp_chorus = 0.1f;
+      for (int startBufIdx = 0, count = 1; startBufIdx + count <= int(buf.size()); startBufIdx += count, count = count * 2 + 1) {
+            float* out    = result.data() + startBufIdx * 2;
+            float* reverb = result.data() + FRAMES * 2 + startBufIdx * 2;
+            float* chorus = result.data() + FRAMES * 4 + startBufIdx * 2;
+            for (int i = startBufIdx; i < startBufIdx + count; ++i) {
+                  float v    = buf[i];
+
+                  float vv   = v  * amp_left;
+                  *out++     += vv;
+                  *reverb++  += vv * amp_reverb;
+                  *chorus++  += vv * amp_chorus;
+
+                  vv         = v  * amp_right;
+                  *out++     += vv;
+                  *reverb++  += vv * amp_reverb;
+                  *chorus++  += vv * amp_chorus;
+                  }
+            }
+      return result;
+      }
+
+//---------------------------------------------------------
+//   mix
+//---------------------------------------------------------
+
+void TestDspKernels::mix_data()
+      {
+      QTest::addColumn<DspIsa>("isa");
+      QTest::newRow("scalar") << DspIsa::SCALAR;
+      QTest::newRow("sse2") << DspIsa::SSE2;
+      }
+
+void TestDspKernels::mix()
+      {
+      QFETCH(DspIsa, isa);
+      if (!dspIsaSupported(isa))
+            QSKIP("not supported by this cpu");
+      std::vector<float> expected = voiceMixed();
+      std::vector<float> result   = mixed(isa);
+      QVERIFY(memcmp(result.data(), expected.data(), expected.size() * sizeof(float)) == 0);
+      }
+
+//---------------------------------------------------------
+//   benchmarkMix
+//---------------------------------------------------------
+
+void TestDspKernels::benchmarkMix_data()
+      {
+      QTest::addColumn<DspIsa>("isa");
+      QTest::newRow("scalar") << DspIsa::SCALAR;
+      QTest::newRow("sse2") << DspIsa::SSE2;
+      }
+
+void TestDspKernels::benchmarkMix()
+      {
+      QFETCH(DspIsa, isa);
+      if (!dspIsaSupported(isa))
+            QSKIP("not supported by this cpu");
+      setDspIsa(isa);
+      std::vector<float> out(FRAMES * 6);
+      float* o = out.data();
+      QBENCHMARK {
+            dspKernels()->mix(buf.data(), FRAMES, o, o + FRAMES * 2, o + FRAMES * 4, 0.7f, 0.3f, 0.2f, 0.1f);
+            }
+      }
+
+QTEST_MAIN(TestDspKernels)
+
+#include "tst_dspkernels.moc"
@@ -0,0 +1,231 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+
+#include "fluid/fluid.h"
+#include "fluid/sfont.h"
+
+using namespace FluidS;
+
+static const char* SOUNDFONT = TESTROOT "/share/sound/FluidR3Mono_GM.sf3";
+
+//---------------------------------------------------------
+//   TestSampleCache
+//    the decoded samples of two sound fonts read from the
+//    same file are shared, they are decoded by load(),
+//    which selecting a preset calls
+//---------------------------------------------------------
+
+class TestSampleCache : public QObject
+      {
+      Q_OBJECT
+      Fluid synth;
+      SFont* a = 0;
+      SFont* b = 0;
+
+   private slots:
+      void initTestCase();
+      void cleanupTestCase();
+      void cleanup();
+      void sharedLoad();
+      void noteOnLookup();
+      void evictReleased();
+      void reloadEvicted();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestSampleCache::initTestCase()
+      {
+#ifndef SOUNDFONT3
+      QSKIP("built without SOUNDFONT3");
+#endif
+      if (!QFileInfo(SOUNDFONT).exists())
+            QSKIP("no sf3 sound font");
+      synth.init(44100);
+      a = new SFont(&synth);
+      b = new SFont(&synth);
+      QVERIFY(a->read(SOUNDFONT));
+      QVERIFY(b->read(SOUNDFONT));
+      QVERIFY(a->samples().size() > 2);
+      QCOMPARE(a->samples().size(), b->samples().size());
+      }
+
+//---------------------------------------------------------
+//   cleanupTestCase
+//---------------------------------------------------------
+
+void TestSampleCache::cleanupTestCase()
+      {
+      delete a;
+      delete b;
+#ifdef SOUNDFONT3
+      QCOMPARE(SampleCache::instance()->cachedBytes(), size_t(0));
+      SampleCache::instance()->setMaxSize(SampleCache::defaultMaxSize);
+#endif
+      }
+
+//---------------------------------------------------------
+//   cleanup
+//    start every test with an empty cache
+//---------------------------------------------------------
+
+void TestSampleCache::cleanup()
+      {
+#ifdef SOUNDFONT3
+      SampleCache::instance()->setMaxSize(0);
+      SampleCache::instance()->setMaxSize(SampleCache::defaultMaxSize);
+#endif
+      }
+
+#ifdef SOUNDFONT3
+
+//---------------------------------------------------------
+//   sharedLoad
+//    the second font gets the data decoded for the first
+//---------------------------------------------------------
+
+void TestSampleCache::sharedLoad()
+      {
+      SampleCache* cache = SampleCache::instance();
+      Sample* sa = a->samples()[0];
+      Sample* sb = b->samples()[0];
+      QCOMPARE(cache->cachedBytes(), size_t(0));
+
+      sa->load();
+      QVERIFY(sa->data);
+      size_t bytes = cache->cachedBytes();
+      QCOMPARE(bytes, size_t(sa->end + 1) * sizeof(short));
+
+      sb->load();
+      QCOMPARE(sb->data, sa->data);
+      QCOMPARE(sb->end, sa->end);
+      QCOMPARE(cache->cachedBytes(), bytes);
+
+      QVERIFY(sa->acquire());
+      QVERIFY(sb->acquire());
+      QCOMPARE(int(sa->refCount), 1);
+      QCOMPARE(int(sb->refCount), 1);
+      sa->release();
+      sb->release();
+      QCOMPARE(int(sa->refCount), 0);
+      QCOMPARE(int(sb->refCount), 0);
+
+      // unloaded data stays cached below the size limit
+      sa->unload();
+      sb->unload();
+      QVERIFY(sa->data);
+      QCOMPARE(cache->cachedBytes(), bytes);
+      }
+
+//---------------------------------------------------------
+//   noteOnLookup
+//    a voice only gets data which was loaded before
+//---------------------------------------------------------
+
+void TestSampleCache::noteOnLookup()
+      {
+      SampleCache* cache = SampleCache::instance();
+      Sample* s = a->samples()[1];
+      QVERIFY(!s->acquire());
+      QVERIFY(!s->data);
+      QCOMPARE(cache->cachedBytes(), size_t(0));
+
+      s->load();
+      QVERIFY(s->acquire());
+      s->release();
+      s->unload();
+      }
+
+//---------------------------------------------------------
+//   evictReleased
+//    only data which no preset uses and no voice plays is
+//    dropped
+//---------------------------------------------------------
+
+void TestSampleCache::evictReleased()
+      {
+      SampleCache* cache = SampleCache::instance();
+      Sample* playing = a->samples()[0];
+      Sample* shared  = b->samples()[0];
+      Sample* other   = a->samples()[1];
+      Sample* loaded  = a->samples()[2];
+
+      playing->load();
+      QVERIFY(playing->acquire());
+      playing->unload();
+      shared->load();
+      shared->unload();
+      other->load();
+      other->unload();
+      loaded->load();
+      size_t bytes = size_t(playing->end + 1) * sizeof(short) + size_t(loaded->end + 1) * sizeof(short);
+
+      cache->setMaxSize(0);
+      QVERIFY(playing->data);
+      QCOMPARE(shared->data, playing->data);
+      QVERIFY(loaded->data);
+      QVERIFY(!other->data);
+      QCOMPARE(cache->cachedBytes(), bytes);
+
+      playing->release();
+      cache->setMaxSize(0);
+      QVERIFY(!playing->data);
+      QVERIFY(!shared->data);
+      QVERIFY(loaded->data);
+
+      // dropped as soon as it is unloaded
+      loaded->unload();
+      QVERIFY(!loaded->data);
+      QCOMPARE(cache->cachedBytes(), size_t(0));
+      }
+
+//---------------------------------------------------------
+//   reloadEvicted
+//    evicted data is decoded again on the next load
+//---------------------------------------------------------
+
+void TestSampleCache::reloadEvicted()
+      {
+      SampleCache* cache = SampleCache::instance();
+      Sample* s = a->samples()[1];
+      s->load();
+      QVERIFY(s->data);
+      std::vector<short> decoded(s->data, s->data + s->end + 1);
+      s->unload();
+
+      cache->setMaxSize(0);
+      QVERIFY(!s->data);
+      cache->setMaxSize(SampleCache::defaultMaxSize);
+
+      s->load();
+      QVERIFY(s->data);
+      QCOMPARE(size_t(s->end + 1), decoded.size());
+      QVERIFY(std::equal(decoded.begin(), decoded.end(), s->data));
+      QCOMPARE(cache->cachedBytes(), decoded.size() * sizeof(short));
+      s->unload();
+      }
+
+#else
+
+void TestSampleCache::sharedLoad()    {}
+void TestSampleCache::noteOnLookup()  {}
+void TestSampleCache::evictReleased() {}
+void TestSampleCache::reloadEvicted() {}
+
+#endif
+
+QTEST_MAIN(TestSampleCache)
+
+#include "tst_samplecache.moc"
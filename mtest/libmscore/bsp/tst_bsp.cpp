@@ -0,0 +1,280 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/page.h"
+#include "libmscore/measure.h"
+#include "libmscore/segment.h"
+#include "libmscore/chord.h"
+#include "libmscore/note.h"
+#include "libmscore/rest.h"
+#include "libmscore/symbol.h"
+
+#define DIR QString("libmscore/concertpitch/")
+
+using namespace Ms;
+
+Q_DECLARE_METATYPE(Ms::LayoutMode)
+
+//---------------------------------------------------------
+//   TestBsp
+//    after a layout of a range, the page must find the
+//    same elements as with a tree built from scratch
+//---------------------------------------------------------
+
+class TestBsp : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      Note* findNote(Score*, int measureNo);
+      void moveNote(Score*, Note*);
+
+   private slots:
+      void initTestCase();
+      void incremental_data();
+      void incremental();
+      void dragRest();
+      void benchmarkLine();
+      };
+
+//---------------------------------------------------------
+//   sorted
+//---------------------------------------------------------
+
+static QList<Element*> sorted(QList<Element*> l)
+      {
+      std::sort(l.begin(), l.end());
+      return l;
+      }
+
+//---------------------------------------------------------
+//   rects
+//---------------------------------------------------------
+
+static std::vector<QRectF> rects(const QList<Element*>& el)
+      {
+      std::vector<QRectF> r;
+      for (Element* e : el)
+            r.push_back(e->pageBoundingRect());
+      return r;
+      }
+
+//---------------------------------------------------------
+//   queries
+//    the elements found in and at the center of each rect
+//---------------------------------------------------------
+
+static QList<QList<Element*>> queries(Page* page, const std::vector<QRectF>& rects)
+      {
+      QList<QList<Element*>> q;
+      for (const QRectF& r : rects) {
+            q.append(sorted(page->items(r)));
+            q.append(sorted(page->items(r.center())));
+            }
+      return q;
+      }
+
+//---------------------------------------------------------
+//   sameQueries
+//    the current tree of page answers the queries like a
+//    tree built from scratch
+//---------------------------------------------------------
+
+static bool sameQueries(Page* page, const std::vector<QRectF>& rects)
+      {
+      QList<QList<Element*>> incremental = queries(page, rects);
+      page->rebuildBspTree();
+      return incremental == queries(page, rects);
+      }
+
+//---------------------------------------------------------
+//   measureElements
+//---------------------------------------------------------
+
+static QList<Element*> measureElements(Measure* m)
+      {
+      QList<Element*> el;
+      m->scanElements(&el, collectElements, false);
+      return el;
+      }
+
+//---------------------------------------------------------
+//   sample
+//    the rects of every 8th element of the page
+//---------------------------------------------------------
+
+static std::vector<QRectF> sample(Page* page)
+      {
+      QList<Element*> el = page->elements();
+      std::vector<QRectF> r;
+      for (int i = 0; i < el.size(); i += 8)
+            r.push_back(el[i]->pageBoundingRect());
+      return r;
+      }
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestBsp::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   findNote
+//    first note of measure measureNo
+//---------------------------------------------------------
+
+Note* TestBsp::findNote(Score* score, int measureNo)
+      {
+      Measure* m = score->firstMeasure();
+      for (int i = 0; i < measureNo && m->nextMeasure(); ++i)
+            m = m->nextMeasure();
+      for (Segment* s = m->first(SegmentType::ChordRest); s; s = s->next(SegmentType::ChordRest)) {
+            for (int track = 0; track < score->ntracks(); ++track) {
+                  Element* e = s->element(track);
+                  if (e && e->isChord())
+                        return toChord(e)->upNote();
+                  }
+            }
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   moveNote
+//---------------------------------------------------------
+
+void TestBsp::moveNote(Score* score, Note* note)
+      {
+      score->startCmd();
+      score->select(note);
+      score->upDown(true, UpDownMode::OCTAVE);
+      score->endCmd();
+      }
+
+//---------------------------------------------------------
+//   incremental
+//---------------------------------------------------------
+
+void TestBsp::incremental_data()
+      {
+      QTest::addColumn<LayoutMode>("mode");
+      QTest::newRow("page") << LayoutMode::PAGE;
+      QTest::newRow("line") << LayoutMode::LINE;
+      }
+
+void TestBsp::incremental()
+      {
+      QFETCH(LayoutMode, mode);
+      MasterScore* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      QVERIFY(score);
+      score->setLayoutMode(mode);
+      score->doLayout();
+      const QRectF all(-1e6, -1e6, 2e6, 2e6);
+      for (Page* page : score->pages()) {
+            page->items(all);
+            QVERIFY(sameQueries(page, sample(page)));
+            }
+
+      for (int measureNo : { 30, 2, 31 }) {
+            Note* note = findNote(score, measureNo);
+            QVERIFY(note);
+            // where the elements of the measure were and are
+            std::vector<QRectF> edited = rects(measureElements(note->chord()->measure()));
+            moveNote(score, note);
+            for (const QRectF& r : rects(measureElements(note->chord()->measure())))
+                  edited.push_back(r);
+
+            for (Page* page : score->pages()) {
+                  QList<Element*> incremental = sorted(page->items(all));
+                  std::vector<QRectF> r = sample(page);
+                  r.insert(r.end(), edited.begin(), edited.end());
+                  QVERIFY(sameQueries(page, r));
+                  QList<Element*> full = sorted(page->items(all));
+                  QVERIFY(!full.empty());
+                  QVERIFY(incremental == full);
+                  }
+            Page* page = note->chord()->measure()->system()->page();
+            QVERIFY(page->items(note->pageBoundingRect().center()).contains(note));
+            }
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   dragRest
+//    a dragged rest is moved in the tree without a layout,
+//    together with the symbols attached to it
+//---------------------------------------------------------
+
+void TestBsp::dragRest()
+      {
+      MasterScore* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      QVERIFY(score);
+      Rest* rest = 0;
+      for (Segment* s = score->firstMeasure()->first(SegmentType::ChordRest); s && !rest; s = s->next1(SegmentType::ChordRest)) {
+            if (s->element(0) && s->element(0)->isRest())
+                  rest = toRest(s->element(0));
+            }
+      QVERIFY(rest);
+      Symbol* sym = new Symbol(score);
+      sym->setSym(SymId::fermataAbove);
+      sym->setParent(rest);
+      score->startCmd();
+      score->undoAddElement(sym);
+      score->endCmd();
+      QVERIFY(Page::bspItems(rest).size() >= 2);
+
+      Page* page = rest->measure()->system()->page();
+      page->items(QRectF(-1e6, -1e6, 2e6, 2e6));
+      QList<Element*> moved;
+      for (const auto& i : Page::bspItems(rest))
+            moved.append(i.first);
+      std::vector<QRectF> r = rects(moved);
+      QRectF symRect = sym->pageBoundingRect();
+
+      EditData ed;
+      ed.delta = QPointF(0.0, -4 * rest->spatium());
+      rest->drag(ed);
+      QVERIFY(sym->pageBoundingRect() != symRect);
+
+      QVERIFY(page->items(sym->pageBoundingRect()).contains(sym));
+      std::vector<QRectF> after = rects(moved);
+      r.insert(r.end(), after.begin(), after.end());
+      std::vector<QRectF> s = sample(page);
+      r.insert(r.end(), s.begin(), s.end());
+      QVERIFY(sameQueries(page, r));
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   benchmarkLine
+//    edit and hit test in continuous view
+//---------------------------------------------------------
+
+void TestBsp::benchmarkLine()
+      {
+      MasterScore* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      score->setLayoutMode(LayoutMode::LINE);
+      score->doLayout();
+      Note* note = findNote(score, 30);
+      QVERIFY(note);
+      QBENCHMARK {
+            moveNote(score, note);
+            score->pages().front()->items(note->pageBoundingRect().center());
+            }
+      delete score;
+      }
+
+QTEST_MAIN(TestBsp)
+#include "tst_bsp.moc"
@@ -23,9 +23,12 @@
 #include "libmscore/harmony.h"
 #include "libmscore/duration.h"
 #include "libmscore/durationtype.h"
+#include "libmscore/chordlist.h"
 
 #define DIR QString("libmscore/chordsymbol/")
 
+#define STYLES QString(TESTROOT "/share/styles/")
+
 using namespace Ms;
 
 //---------------------------------------------------------
@@ -47,6 +50,8 @@ class TestChordSymbol : public QObject, public MTest {
       void testNoSystem();
       void testTranspose();
       void testTransposePart();
+      void testSharedChordList();
+      void testParseCache();
       };
 
 //---------------------------------------------------------
@@ -195,5 +200,67 @@ void TestChordSymbol::testTransposePart()
       test_post(score, "transpose-part");
       }
 
+void TestChordSymbol::testSharedChordList()
+      {
+      ChordList cl1;
+      ChordList cl2;
+      QVERIFY(cl1.read(STYLES + "chords.xml"));
+      QVERIFY(cl1.read(STYLES + "chords_std.xml"));
+      QVERIFY(cl2.read(STYLES + "chords.xml"));
+      QVERIFY(cl2.read(STYLES + "chords_std.xml"));
+      QVERIFY(cl1.loaded());
+      QVERIFY(cl1.isSharedWith(cl2));
+
+      // a change only affects the list changed
+      int n = cl1.size();
+      ChordDescription cd("Xyz");
+      cl2.insert(cd.id, cd);
+      QVERIFY(!cl1.isSharedWith(cl2));
+      QCOMPARE(cl1.size(), n);
+      QCOMPARE(cl2.size(), n + 1);
+
+      // and the changed list is not taken from the cache again
+      QVERIFY(cl2.read(STYLES + "chords_jazz.xml"));
+      ChordList cl3;
+      QVERIFY(cl3.read(STYLES + "chords.xml"));
+      QVERIFY(cl3.read(STYLES + "chords_std.xml"));
+      QVERIFY(cl3.isSharedWith(cl1));
+      }
+
+void TestChordSymbol::testParseCache()
+      {
+      ChordList cl;
+      QVERIFY(cl.read(STYLES + "chords.xml"));
+      for (const char* s : { "C7", "Bbmaj7(#11)", "F#m7b5/E", "Gsus", "Ebm", "Ddim7", "A+", "xyz" }) {
+            for (int flags = 0; flags < 8; ++flags) {
+                  const ChordList* list = (flags & 1) ? &cl : 0;
+                  const bool syntaxOnly  = flags & 2;
+                  const bool preferMinor = flags & 4;
+                  ParsedChord expected;
+                  bool rv = expected.doParse(s, list, syntaxOnly, preferMinor);
+                  // the first parse may fill the cache, the second one is taken from it
+                  for (int i = 0; i < 2; ++i) {
+                        ParsedChord p;
+                        QCOMPARE(p.parse(s, list, syntaxOnly, preferMinor), rv);
+                        QCOMPARE(p.parseable(), expected.parseable());
+                        QCOMPARE(p.understandable(), expected.understandable());
+                        QCOMPARE(p.handle(), expected.handle());
+                        QCOMPARE(p.name(), expected.name());
+                        QCOMPARE(p.quality(), expected.quality());
+                        QCOMPARE(p.extension(), expected.extension());
+                        QCOMPARE(p.modifiers(), expected.modifiers());
+                        QCOMPARE(p.xmlKind(), expected.xmlKind());
+                        QCOMPARE(p.xmlText(), expected.xmlText());
+                        QCOMPARE(p.xmlSymbols(), expected.xmlSymbols());
+                        QCOMPARE(p.xmlParens(), expected.xmlParens());
+                        QCOMPARE(p.xmlDegrees(), expected.xmlDegrees());
+                        QCOMPARE(p.keys(), expected.keys());
+                        if (list)
+                              QCOMPARE(p.renderList(list).size(), expected.renderList(list).size());
+                        }
+                  }
+            }
+      }
+
 QTEST_MAIN(TestChordSymbol)
 #include "tst_chordsymbol.moc"
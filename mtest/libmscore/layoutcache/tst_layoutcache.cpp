@@ -0,0 +1,296 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/page.h"
+#include "libmscore/system.h"
+#include "libmscore/measure.h"
+#include "libmscore/layoutbreak.h"
+#include "libmscore/layoutcache.h"
+#include "libmscore/xml.h"
+
+#define DIR QString("libmscore/concertpitch/")
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestLayoutCache
+//    a score laid out with the cache saved in the .mscz
+//    file must look like a score laid out from scratch
+//---------------------------------------------------------
+
+class TestLayoutCache : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      QString saved;          // the .mscz file with the layout cache
+
+      QStringList layout(Score*);
+      MasterScore* load(bool cache);
+      int firstSystem(Score*);
+      LayoutCache* shortSystem(Score*, int systemIdx);
+
+   private slots:
+      void initTestCase();
+      void cleanupTestCase();
+      void contentKey();
+      void reload();
+      void cacheUsed();
+      void mismatch();
+      void styleChange();
+      void edit();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestLayoutCache::initTestCase()
+      {
+      initMTest();
+      MScore::layoutCache = true;
+      MasterScore* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      QVERIFY(score);
+      QVERIFY(score->systems().size() > 1);
+      saved = "layoutcache.mscz";
+      QFileInfo fi(saved);
+      QVERIFY(score->saveCompressedFile(fi, false));
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   cleanupTestCase
+//---------------------------------------------------------
+
+void TestLayoutCache::cleanupTestCase()
+      {
+      MScore::layoutCache = false;
+      }
+
+//---------------------------------------------------------
+//   layout
+//    the position of every page, system and measure
+//---------------------------------------------------------
+
+QStringList TestLayoutCache::layout(Score* score)
+      {
+      QStringList sl;
+      for (Page* page : score->pages()) {
+            sl.append(QString("page %1 %2,%3").arg(page->no()).arg(page->x()).arg(page->y()));
+            for (System* system : page->systems()) {
+                  sl.append(QString("  system %1,%2 width %3").arg(system->pagePos().x()).arg(system->pagePos().y()).arg(system->width()));
+                  for (MeasureBase* mb : system->measures())
+                        sl.append(QString("    measure %1 %2,%3 width %4").arg(mb->tick()).arg(mb->x()).arg(mb->y()).arg(mb->width()));
+                  }
+            }
+      return sl;
+      }
+
+//---------------------------------------------------------
+//   load
+//    the saved score, laid out with or without the cache
+//---------------------------------------------------------
+
+MasterScore* TestLayoutCache::load(bool cache)
+      {
+      MScore::layoutCache = cache;
+      MasterScore* score = readCreatedScore(saved);
+      MScore::layoutCache = true;
+      return score;
+      }
+
+//---------------------------------------------------------
+//   firstSystem
+//    the index of the first system with more than one
+//    measure, -1 if there is none
+//---------------------------------------------------------
+
+int TestLayoutCache::firstSystem(Score* score)
+      {
+      for (int i = 0; i < score->systems().size(); ++i) {
+            if (score->systems()[i]->measures().size() > 1)
+                  return i;
+            }
+      return -1;
+      }
+
+//---------------------------------------------------------
+//   shortSystem
+//    a cache for score which puts one measure less into
+//    system systemIdx than the layout would
+//---------------------------------------------------------
+
+LayoutCache* TestLayoutCache::shortSystem(Score* score, int systemIdx)
+      {
+      LayoutCache lc;
+      lc.create(score, "key");
+      QBuffer buffer;
+      buffer.open(QIODevice::ReadWrite);
+      XmlWriter xml(score, &buffer);
+      lc.write(xml);
+      xml.flush();
+
+      // drop the last width of the system
+      QString s = QString::fromUtf8(buffer.data());
+      int pos = -1;
+      for (int i = 0; i <= systemIdx; ++i)
+            pos = s.indexOf("<System", pos + 1);
+      int end = s.indexOf("</System>", pos);
+      int space = s.lastIndexOf(' ', end);
+      if (pos == -1 || space < s.indexOf('>', pos))
+            return 0;
+      s.remove(space, end - space);
+
+      LayoutCache* cache = new LayoutCache;
+      XmlReader e(s.toUtf8());
+      if (!cache->read(e) || cache->measures(systemIdx) != lc.measures(systemIdx) - 1) {
+            delete cache;
+            return 0;
+            }
+      return cache;
+      }
+
+//---------------------------------------------------------
+//   contentKey
+//---------------------------------------------------------
+
+void TestLayoutCache::contentKey()
+      {
+      QCOMPARE(LayoutCache::contentKey("<museScore/>"), LayoutCache::contentKey("<museScore/>"));
+      QVERIFY(LayoutCache::contentKey("<museScore/>") != LayoutCache::contentKey("<museScore />"));
+      }
+
+//---------------------------------------------------------
+//   reload
+//    the cache is read with the score and gives the
+//    same layout as a fresh one
+//---------------------------------------------------------
+
+void TestLayoutCache::reload()
+      {
+      MasterScore* cached = load(true);
+      MasterScore* fresh = load(false);
+      QVERIFY(cached);
+      QVERIFY(fresh);
+      QVERIFY(cached->layoutCache());
+      QVERIFY(!fresh->layoutCache());
+      QCOMPARE(cached->layoutCache()->systems(), fresh->systems().size());
+      QCOMPARE(layout(cached), layout(fresh));
+      delete cached;
+      delete fresh;
+      }
+
+//---------------------------------------------------------
+//   cacheUsed
+//    the layout follows the breaks of the cache, here
+//    one recorded with a line break which is gone
+//---------------------------------------------------------
+
+void TestLayoutCache::cacheUsed()
+      {
+      MasterScore* score = load(false);
+      QVERIFY(score);
+      int idx = firstSystem(score);
+      QVERIFY(idx != -1);
+      System* system = score->systems()[idx];
+      int measures = int(system->measures().size());
+      MeasureBase* mb = system->measures()[measures - 2];
+      QVERIFY(mb->isMeasure());
+      QStringList fresh = layout(score);
+
+      LayoutBreak* lb = new LayoutBreak(score);
+      lb->setLayoutBreakType(LayoutBreak::Type::LINE);
+      lb->setTrack(0);
+      lb->setParent(mb);
+      score->startCmd();
+      score->undoAddElement(lb);
+      score->endCmd();
+      score->doLayout();
+      QCOMPARE(int(score->systems()[idx]->measures().size()), measures - 1);
+      LayoutCache* cache = new LayoutCache;
+      cache->create(score, "key");
+
+      score->startCmd();
+      score->undoRemoveElement(lb);
+      score->endCmd();
+      score->doLayout();
+      QCOMPARE(layout(score), fresh);
+
+      score->setLayoutCache(cache);
+      score->doLayout();
+      QCOMPARE(int(score->systems()[idx]->measures().size()), measures - 1);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   mismatch
+//    a cache whose widths do not match the layout is not
+//    applied, the system is collected without it
+//---------------------------------------------------------
+
+void TestLayoutCache::mismatch()
+      {
+      MasterScore* score = load(false);
+      QVERIFY(score);
+      int idx = firstSystem(score);
+      QVERIFY(idx != -1);
+      QStringList fresh = layout(score);
+      LayoutCache* cache = shortSystem(score, idx);
+      QVERIFY(cache);
+      score->setLayoutCache(cache);
+      score->doLayout();
+      QCOMPARE(layout(score), fresh);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   styleChange
+//    the cache is ignored after a style change
+//---------------------------------------------------------
+
+void TestLayoutCache::styleChange()
+      {
+      MasterScore* score = load(false);
+      QVERIFY(score);
+      int idx = firstSystem(score);
+      QVERIFY(idx != -1);
+      int measures = int(score->systems()[idx]->measures().size());
+      LayoutCache* cache = shortSystem(score, idx);
+      QVERIFY(cache);
+      score->setLayoutCache(cache);
+      score->setStyleValue(Sid::dividerLeft, !score->styleB(Sid::dividerLeft));
+      QVERIFY(LayoutCache::styleKey(score) != cache->styleKey());
+      score->doLayout();
+      QCOMPARE(int(score->systems()[idx]->measures().size()), measures);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   edit
+//    the cache is dropped by the first edit
+//---------------------------------------------------------
+
+void TestLayoutCache::edit()
+      {
+      MasterScore* score = load(true);
+      QVERIFY(score);
+      QVERIFY(score->layoutCache());
+      score->startCmd();
+      score->endCmd();
+      QVERIFY(!score->layoutCache());
+      delete score;
+      }
+
+QTEST_MAIN(TestLayoutCache)
+
+#include "tst_layoutcache.moc"
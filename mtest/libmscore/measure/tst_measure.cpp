@@ -60,6 +60,8 @@ class TestMeasure : public QObject, public MTest
 
       void gap();
       void checkMeasure();
+      void tick2measureIndex();
+      void tick2measureIndexMMRest();
       };
 
 //---------------------------------------------------------
@@ -497,6 +499,95 @@ void TestMeasure::undoDelInitialVBox_269919()
       delete score;
       }
 
+//---------------------------------------------------------
+///   tick2measureIndex
+///   tick lookup must find every measure and follow
+///   structural changes of the measure list
+//---------------------------------------------------------
+
+void TestMeasure::tick2measureIndex()
+      {
+      MasterScore* score = readScore(DIR + "measure-1.mscx");
+
+      for (Measure* m = score->firstMeasure(); m; m = m->nextMeasure()) {
+            QCOMPARE(score->tick2measure(m->tick()), m);
+            QCOMPARE(score->tick2measure(m->endTick() - 1), m);
+            }
+      QCOMPARE(score->tick2measure(score->lastMeasure()->endTick()), score->lastMeasure());
+      QVERIFY(score->tick2measure(score->lastMeasure()->endTick() + 1) == 0);
+
+      int rebuilds = score->measures()->tickIndexRebuilds();
+      score->startCmd();
+      score->insertMeasure(ElementType::MEASURE, score->firstMeasure()->nextMeasure());
+      score->endCmd();
+      QVERIFY(score->measures()->tickIndexRebuilds() > rebuilds);
+
+      for (Measure* m = score->firstMeasure(); m; m = m->nextMeasure()) {
+            QCOMPARE(score->tick2measure(m->tick()), m);
+            QCOMPARE(score->tick2measureMM(m->tick()), m);
+            }
+      delete score;
+      }
+
+//---------------------------------------------------------
+///   tick2measureIndexMMRest
+///   with multi measure rests tick2measureMM must find the
+///   measure the chain of multi measure rests has at a tick,
+///   inside and at the edges of the rests
+//---------------------------------------------------------
+
+void TestMeasure::tick2measureIndexMMRest()
+      {
+      MasterScore* score = readScore(DIR + "measure-1.mscx");
+      score->startCmd();
+      for (int i = 0; i < 3; ++i)
+            score->insertMeasure(ElementType::MEASURE, score->firstMeasure()->nextMeasure());
+      score->appendMeasures(3);
+      score->undoChangeStyleVal(Sid::createMultiMeasureRests, true);
+      score->endCmd();
+
+      // the lookup before the index, along the chain
+      auto walk = [score](int tick) {
+            Measure* lm = 0;
+            for (Measure* m = score->firstMeasureMM(); m; m = m->nextMeasureMM()) {
+                  if (tick < m->tick())
+                        return lm;
+                  lm = m;
+                  }
+            if (lm && tick >= lm->tick() && tick <= lm->endTick())
+                  return lm;
+            return (Measure*)0;
+            };
+
+      int mmRests = 0;
+      for (Measure* m = score->firstMeasureMM(); m; m = m->nextMeasureMM()) {
+            if (!m->isMMRest())
+                  continue;
+            ++mmRests;
+            QCOMPARE(score->tick2measureMM(m->tick()), m);
+            QCOMPARE(score->tick2measureMM(m->tick() + 1), m);
+            QCOMPARE(score->tick2measureMM(m->endTick() - 1), m);
+            Measure* next = m->nextMeasureMM();
+            QCOMPARE(score->tick2measureMM(m->endTick()), next ? next : m);
+            if (m->prevMeasureMM())
+                  QCOMPARE(score->tick2measureMM(m->tick() - 1), m->prevMeasureMM());
+            // the measures it replaces are still found without MM
+            for (Measure* mm = score->tick2measure(m->tick()); mm && mm->tick() < m->endTick(); mm = mm->nextMeasure()) {
+                  QVERIFY(!mm->isMMRest());
+                  QCOMPARE(score->tick2measure(mm->tick()), mm);
+                  QCOMPARE(score->tick2measureMM(mm->tick()), m);
+                  QCOMPARE(score->tick2measureMM(mm->endTick() - 1), m);
+                  }
+            }
+      QCOMPARE(mmRests, 2);
+      QVERIFY(score->lastMeasureMM()->isMMRest());
+
+      for (Measure* m = score->firstMeasure(); m; m = m->nextMeasure()) {
+            for (int tick : { m->tick(), m->tick() + m->ticks() / 2, m->endTick() - 1, m->endTick() })
+                  QCOMPARE(score->tick2measureMM(tick), walk(tick));
+            }
+      delete score;
+      }
 
 QTEST_MAIN(TestMeasure)
 
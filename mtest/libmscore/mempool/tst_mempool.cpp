@@ -0,0 +1,109 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/note.h"
+#include "libmscore/rest.h"
+#include "libmscore/repeat.h"
+#include "libmscore/mempool.h"
+
+#define DIR QString("libmscore/concertpitch/")
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestMemoryPool
+//---------------------------------------------------------
+
+class TestMemoryPool : public QObject, public MTest
+      {
+      Q_OBJECT
+
+   private slots:
+      void initTestCase();
+      void reuse();
+      void derived();
+      void loadAndClose();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestMemoryPool::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   reuse
+//    a deleted note is reused by the next new Note
+//---------------------------------------------------------
+
+void TestMemoryPool::reuse()
+      {
+      qint64 inUse = Note::pool()->inUse();
+      Note* n1 = new Note(score);
+      QCOMPARE(Note::pool()->inUse(), inUse + 1);
+      QCOMPARE(quintptr(n1) % alignof(std::max_align_t), quintptr(0));
+      delete n1;
+      QCOMPARE(Note::pool()->inUse(), inUse);
+      Note* n2 = new Note(score);
+#ifndef MSCORE_NO_MEMORY_POOLS
+      QCOMPARE(n2, n1);
+#endif
+      delete n2;
+      }
+
+//---------------------------------------------------------
+//   derived
+//    a RepeatMeasure is bigger than a Rest, it must not
+//    come from the pool of Rest
+//---------------------------------------------------------
+
+void TestMemoryPool::derived()
+      {
+      QVERIFY(sizeof(RepeatMeasure) != sizeof(Rest));
+      qint64 allocs = Rest::pool()->allocs();
+      Rest* rm = new RepeatMeasure(score);
+      QCOMPARE(Rest::pool()->allocs(), allocs);
+      Rest* r = new Rest(score);
+      QCOMPARE(Rest::pool()->allocs(), allocs + 1);
+
+      qint64 frees = Rest::pool()->frees();
+      delete rm;
+      QCOMPARE(Rest::pool()->frees(), frees);
+      delete r;
+      QCOMPARE(Rest::pool()->frees(), frees + 1);
+      }
+
+//---------------------------------------------------------
+//   loadAndClose
+//    the notes of a score go back to the pool
+//---------------------------------------------------------
+
+void TestMemoryPool::loadAndClose()
+      {
+      qint64 notes = Note::pool()->inUse();
+      qint64 segments = Segment::pool()->inUse();
+      MasterScore* s = readScore(DIR + "concertpitchbenchmark.mscx");
+      QVERIFY(s);
+      QVERIFY(Note::pool()->inUse() > notes);
+      QVERIFY(Segment::pool()->inUse() > segments);
+      delete s;
+      QCOMPARE(Note::pool()->inUse(), notes);
+      QVERIFY(Segment::pool()->frees() > 0);
+      }
+
+QTEST_MAIN(TestMemoryPool)
+#include "tst_mempool.moc"
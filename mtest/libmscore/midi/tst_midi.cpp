@@ -23,6 +23,8 @@
 #include "libmscore/chord.h"
 #include "libmscore/note.h"
 #include "libmscore/keysig.h"
+#include "libmscore/ottava.h"
+#include "libmscore/undo.h"
 #include "mscore/exportmidi.h"
 #include <QIODevice>
 
@@ -44,6 +46,7 @@ class TestMidi : public QObject, public MTest
       {
       Q_OBJECT
       void midiExportTestRef(const QString& file);
+      QStringList eventList(const EventMap& events);
 
    private slots:
       void initTestCase();
@@ -52,6 +55,9 @@ class TestMidi : public QObject, public MTest
       void midi03();
       void events_data();
       void events();
+      void patchedEvents_data();
+      void patchedEvents();
+      void ottavaEvents();
       void midiBendsExport1() { midiExportTestRef("testBends1"); }
       void midiBendsExport2() { midiExportTestRef("testBends2"); }      // Play property test
       void midiPortExport()   { midiExportTestRef("testMidiPort"); }
@@ -397,6 +403,162 @@ void TestMidi::events()
      // QVERIFY(saveCompareScore(score, writeFile, reference));
       }
 
+//---------------------------------------------------------
+//   eventList
+//    events as sorted text, the order of events at the
+//    same tick does not matter
+//---------------------------------------------------------
+
+QStringList TestMidi::eventList(const EventMap& events)
+      {
+      QStringList sl;
+      for (const auto& i : events) {
+            const NPlayEvent& ev = i.second;
+            sl.append(QString("%1 %2 %3 %4 %5").arg(i.first).arg(ev.type()).arg(ev.channel()).arg(ev.dataA()).arg(ev.dataB()));
+            }
+      sl.sort();
+      return sl;
+      }
+
+//---------------------------------------------------------
+//   patchedEvents
+//    the playlist patched after an edit must be the
+//    playlist rendered completely, also if the score was
+//    rendered for an export in between
+//---------------------------------------------------------
+
+void TestMidi::patchedEvents_data()
+      {
+      QTest::addColumn<QString>("file");
+      QTest::addColumn<bool>("velocity");
+      QTest::newRow("repeats pitch")       << "testPausesRepeats"    << false;
+      QTest::newRow("repeats velocity")    << "testPausesRepeats"    << true;
+      QTest::newRow("swing pitch")         << "testSwing8thSimple"   << false;
+      QTest::newRow("tremolo velocity")    << "testMultiNoteTremolo" << true;
+      }
+
+void TestMidi::patchedEvents()
+      {
+      QFETCH(QString, file);
+      QFETCH(bool, velocity);
+
+      MasterScore* score = readScore(DIR + file + ".mscx");
+      QVERIFY(score);
+      PlaylistCache cache;
+      EventMap events;
+      score->renderMidi(&events, &cache);
+      score->resetPlaylistRange();
+
+      // first note of the second measure, or of the score
+      Measure* m = score->firstMeasure()->nextMeasure() ? score->firstMeasure()->nextMeasure() : score->firstMeasure();
+      Note* note = 0;
+      for (Segment* s = m->first(SegmentType::ChordRest); s && !note; s = s->next1(SegmentType::ChordRest)) {
+            if (s->element(0) && s->element(0)->isChord())
+                  note = toChord(s->element(0))->upNote();
+            }
+      QVERIFY(note);
+
+      score->startCmd();
+      if (velocity)
+            note->undoChangeProperty(Pid::VELO_OFFSET, note->veloOffset() + 40);
+      else
+            note->undoChangeProperty(Pid::PITCH, note->pitch() + 2);
+      score->endCmd();
+      QVERIFY(!score->playlistRange().all());
+
+      // an export render must not change what the playlist was rendered with
+      EventMap exported;
+      score->renderMidi(&exported);
+
+      QVERIFY(score->renderMidi(&events, score->playlistRange(), &cache));
+      score->resetPlaylistRange();
+
+      EventMap full;
+      score->renderMidi(&full);
+      QCOMPARE(eventList(events), eventList(full));
+      QCOMPARE(eventList(exported), eventList(full));
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   ottavaEvents
+//    adding or removing an ottava changes the pitch of all
+//    notes it covers, not only of those at its start
+//---------------------------------------------------------
+
+static bool noteOn(const EventMap& events, int tick, int pitch)
+      {
+      auto r = events.equal_range(tick);
+      for (auto i = r.first; i != r.second; ++i) {
+            if (i->second.type() == ME_NOTEON && i->second.dataA() == pitch && i->second.velo() > 0)
+                  return true;
+            }
+      return false;
+      }
+
+void TestMidi::ottavaEvents()
+      {
+      MasterScore* score = readScore(DIR + "testGlissando.mscx");
+      QVERIFY(score);
+      PlaylistCache cache;
+      EventMap events;
+      score->renderMidi(&events, &cache);
+      score->resetPlaylistRange();
+
+      // from the second to the end of the fifth measure
+      Measure* sm = score->firstMeasure()->nextMeasure();
+      QVERIFY(sm);
+      Measure* em = sm;
+      for (int i = 0; i < 3; ++i) {
+            em = em->nextMeasure();
+            QVERIFY(em);
+            }
+      Chord* last = 0;
+      for (Segment* s = em->first(SegmentType::ChordRest); s; s = s->next(SegmentType::ChordRest)) {
+            if (s->element(0) && s->element(0)->isChord())
+                  last = toChord(s->element(0));
+            }
+      QVERIFY(last);
+      Note* note = last->upNote();
+      int pitch = note->ppitch();
+      int tick = last->tick();
+      QVERIFY(noteOn(events, tick, pitch));
+
+      Ottava* ottava = new Ottava(score);
+      ottava->setOttavaType(OttavaType::OTTAVA_8VA);
+      ottava->setTrack(0);
+      ottava->setTrack2(0);
+      ottava->setTick(sm->tick());
+      ottava->setTick2(em->endTick());
+
+      score->startCmd();
+      score->undoAddElement(ottava);
+      score->endCmd();
+      QCOMPARE(note->ppitch(), pitch + 12);
+      QVERIFY(!score->playlistRange().all());
+      QVERIFY(score->renderMidi(&events, score->playlistRange(), &cache));
+      score->resetPlaylistRange();
+      QVERIFY(noteOn(events, tick, pitch + 12));
+
+      EventMap full;
+      score->renderMidi(&full);
+      QCOMPARE(eventList(events), eventList(full));
+
+      score->startCmd();
+      score->undoRemoveElement(ottava);
+      score->endCmd();
+      QCOMPARE(note->ppitch(), pitch);
+      QVERIFY(!score->playlistRange().all());
+      QVERIFY(score->renderMidi(&events, score->playlistRange(), &cache));
+      score->resetPlaylistRange();
+      QVERIFY(noteOn(events, tick, pitch));
+
+      full.clear();
+      score->renderMidi(&full);
+      QCOMPARE(eventList(events), eventList(full));
+      delete score;
+      }
+
 //---------------------------------------------------------
 //   midiExportTest
 //   read a MuseScore mscx file, write to a MIDI file and verify against reference
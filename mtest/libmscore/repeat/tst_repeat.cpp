@@ -16,6 +16,7 @@
 #include "libmscore/score.h"
 #include "libmscore/measure.h"
 #include "libmscore/repeatlist.h"
+#include "libmscore/tempo.h"
 
 #define DIR QString("libmscore/repeat/")
 
@@ -29,6 +30,7 @@ class TestRepeat : public QObject, public MTest
       {
       Q_OBJECT
       void repeat(const char* f1, const QString & ref);
+      void tickLookup(const char* f1);
 
    private slots:
       void initTestCase();
@@ -101,6 +103,9 @@ class TestRepeat : public QObject, public MTest
       void repeat49() { repeat("repeat49.mscx", "1;2;3;1;2;3;4;5;6;3;1;2;3;4;7"); } // D.S. with playRepeats
       void repeat50() { repeat("repeat50.mscx", "1;2;3;4;1;2;3;4;5;6;1;2;3;4;1;2;3;7"); } // D.S. with playRepeats with ToCoda inside the repeat
       void repeat51() { repeat("repeat51.mscx", "1;2;3;4;5;6;3;4;7;8;9;3;4;10;11"); } //#270332 twice D.S. with playRepeats to same target with different Coda
+
+      void tickLookup14() { tickLookup("repeat14.mscx"); }  // complex roadmap with tempo changes
+      void tickLookup36() { tickLookup("repeat36.mscx"); }  // many sections
       };
 
 //---------------------------------------------------------
@@ -140,5 +145,53 @@ void TestRepeat::repeat(const char* f1, const QString & ref)
       }
 
 
+//---------------------------------------------------------
+//   tickLookup
+//    compare the indexed tick and time lookups of the
+//    repeat list with a linear search
+//---------------------------------------------------------
+
+void TestRepeat::tickLookup(const char* f1)
+      {
+      Score* score = readScore(DIR + f1);
+      QVERIFY(score);
+      score->tempomap()->setTempo(score->lastMeasure()->tick(), 3.0);
+      score->updateRepeatList(true);
+      const RepeatList* rl = score->repeatList();
+      const TempoMap* tm   = score->tempomap();
+
+      for (int tick = 0; tick < score->lastMeasure()->endTick(); tick += 60) {
+            int utick = -1;
+            for (const RepeatSegment* s : *rl) {
+                  if (tick >= s->tick && tick < s->tick + s->len()) {
+                        utick = s->utick + (tick - s->tick);
+                        break;
+                        }
+                  }
+            if (utick != -1)
+                  QCOMPARE(rl->tick2utick(tick), utick);
+            }
+
+      for (int utick = 0; utick < rl->ticks(); utick += 60) {
+            const RepeatSegment* rs = 0;
+            for (const RepeatSegment* s : *rl) {
+                  if (utick >= s->utick)
+                        rs = s;
+                  }
+            QVERIFY(rs);
+            int tick   = utick - (rs->utick - rs->tick);
+            qreal time = tm->tick2time(tick) + rs->timeOffset;
+            QCOMPARE(rl->utick2tick(utick), tick);
+            QCOMPARE(rl->utick2utime(utick), time);
+
+            for (const RepeatSegment* s : *rl) {
+                  if (time >= s->utime)
+                        rs = s;
+                  }
+            QCOMPARE(rl->utime2utick(time), tm->time2tick(time - rs->timeOffset) + (rs->utick - rs->tick));
+            }
+      delete score;
+      }
+
 QTEST_MAIN(TestRepeat)
 #include "tst_repeat.moc"
@@ -0,0 +1,185 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2018 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/measure.h"
+#include "libmscore/segment.h"
+#include "libmscore/system.h"
+#include "libmscore/shape.h"
+
+#define DIR QString("../vtest/")
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestShape
+//---------------------------------------------------------
+
+class TestShape : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      QList<QPair<Shape, Shape>> hpairs;        // shapes placed left/right of each other
+      QList<QPair<Shape, Shape>> vpairs;        // shapes placed above/below each other
+
+      void collectShapes(const QString& file);
+
+   private slots:
+      void initTestCase();
+      void horizontalDistance();
+      void verticalDistance();
+      void zeroExtent();
+      void benchmarkPairwise();
+      void benchmarkSorted();
+      };
+
+//---------------------------------------------------------
+//   collectShapes
+//    collect the shapes compared during layout of a score:
+//    neighbour segments of a staff and neighbour staves
+//    of a system, the latter as a whole
+//---------------------------------------------------------
+
+void TestShape::collectShapes(const QString& file)
+      {
+      MasterScore* score = readScore(DIR + file);
+      QVERIFY(score);
+      score->doLayout();
+      int nstaves = score->nstaves();
+      for (Segment* s = score->firstSegment(SegmentType::All); s; s = s->next1()) {
+            Segment* ns = s->next();
+            if (!ns)
+                  continue;
+            for (int staffIdx = 0; staffIdx < nstaves; ++staffIdx)
+                  hpairs.append(qMakePair(s->staffShape(staffIdx), ns->staffShape(staffIdx).translated(QPointF(ns->x() - s->x(), 0.0))));
+            }
+      for (System* system : score->systems()) {
+            for (int staffIdx = 0; staffIdx < nstaves - 1; ++staffIdx) {
+                  Shape s1;
+                  Shape s2;
+                  for (MeasureBase* mb : system->measures()) {
+                        if (!mb->isMeasure())
+                              continue;
+                        Measure* m = toMeasure(mb);
+                        s1.add(m->staffShape(staffIdx).translated(m->pos()));
+                        s2.add(m->staffShape(staffIdx + 1).translated(m->pos()));
+                        }
+                  vpairs.append(qMakePair(s1, s2.translated(QPointF(0.0, system->staff(staffIdx + 1)->y() - system->staff(staffIdx)->y()))));
+                  }
+            }
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestShape::initTestCase()
+      {
+      initMTest();
+      for (const char* file : { "chord-layout-1.mscx", "chord-layout-11.mscx", "layout-1.mscx",
+         "lyrics-1.mscx", "system-1.mscx", "staff-1.mscx", "bravura-10.mscx" })
+            collectShapes(file);
+      QVERIFY(!hpairs.empty());
+      QVERIFY(!vpairs.empty());
+      }
+
+//---------------------------------------------------------
+//   horizontalDistance
+//---------------------------------------------------------
+
+void TestShape::horizontalDistance()
+      {
+      for (const auto& p : hpairs) {
+            QCOMPARE(p.first.minHorizontalDistanceSorted(p.second), p.first.minHorizontalDistancePairwise(p.second));
+            QCOMPARE(p.second.minHorizontalDistanceSorted(p.first), p.second.minHorizontalDistancePairwise(p.first));
+            }
+      }
+
+//---------------------------------------------------------
+//   verticalDistance
+//---------------------------------------------------------
+
+void TestShape::verticalDistance()
+      {
+      for (const auto& p : vpairs) {
+            QCOMPARE(p.first.minVerticalDistanceSorted(p.second), p.first.minVerticalDistancePairwise(p.second));
+            QCOMPARE(p.second.minVerticalDistanceSorted(p.first), p.second.minVerticalDistancePairwise(p.first));
+            }
+      }
+
+//---------------------------------------------------------
+//   zeroExtent
+//    elements of zero width or height follow special rules
+//    for horizontal distance
+//---------------------------------------------------------
+
+void TestShape::zeroExtent()
+      {
+      Shape s1;
+      Shape s2;
+      for (int i = 0; i < 10; ++i) {
+            s1.add(QRectF(i, i * 10.0, 5.0, 5.0));
+            s2.add(QRectF(i + 20.0, i * 10.0 + 5.0, 5.0, 5.0));
+            }
+      QCOMPARE(s1.minHorizontalDistanceSorted(s2), s1.minHorizontalDistancePairwise(s2));
+
+      s1.add(QRectF(3.0, 200.0, 4.0, 0.0));           // zero height, same line
+      s2.add(QRectF(1.0, 200.0, 2.0, 0.0));
+      QCOMPARE(s1.minHorizontalDistancePairwise(s2), 6.0);
+      QCOMPARE(s1.minHorizontalDistanceSorted(s2), 6.0);
+
+      s1.add(QRectF(12.0, 500.0, 0.0, 1.0));          // zero width collides with everything
+      QCOMPARE(s1.minHorizontalDistancePairwise(s2), 11.0);
+      QCOMPARE(s1.minHorizontalDistanceSorted(s2), 11.0);
+
+      s2.add(QRectF(0.0, 700.0, 0.0, 0.0));
+      QCOMPARE(s1.minHorizontalDistanceSorted(s2), s1.minHorizontalDistancePairwise(s2));
+      QCOMPARE(s1.minVerticalDistanceSorted(s2), s1.minVerticalDistancePairwise(s2));
+      }
+
+//---------------------------------------------------------
+//   benchmarkPairwise
+//---------------------------------------------------------
+
+void TestShape::benchmarkPairwise()
+      {
+      qreal d = 0.0;
+      QBENCHMARK {
+            for (const auto& p : hpairs)
+                  d += p.first.minHorizontalDistancePairwise(p.second);
+            for (const auto& p : vpairs)
+                  d += p.first.minVerticalDistancePairwise(p.second);
+            }
+      Q_UNUSED(d);
+      }
+
+//---------------------------------------------------------
+//   benchmarkSorted
+//---------------------------------------------------------
+
+void TestShape::benchmarkSorted()
+      {
+      qreal d = 0.0;
+      QBENCHMARK {
+            for (const auto& p : hpairs)
+                  d += p.first.minHorizontalDistanceSorted(p.second);
+            for (const auto& p : vpairs)
+                  d += p.first.minVerticalDistanceSorted(p.second);
+            }
+      Q_UNUSED(d);
+      }
+
+QTEST_MAIN(TestShape)
+#include "tst_shape.moc"
@@ -0,0 +1,97 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include <QtConcurrent>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/page.h"
+
+#define DIR QString("libmscore/concertpitch/")
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestThreadLayout
+//    the converter reads and lays out the scores of a job
+//    file (-j) on worker threads, the result must be the
+//    layout of the main thread (-o)
+//---------------------------------------------------------
+
+class TestThreadLayout : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      QString layout();
+
+   private slots:
+      void initTestCase();
+      void workerThread();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestThreadLayout::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   layout
+//    read the score and list the position of every
+//    element on its page
+//---------------------------------------------------------
+
+QString TestThreadLayout::layout()
+      {
+      MasterScore* s = readScore(DIR + "concertpitchbenchmark.mscx");
+      if (!s)
+            return QString();
+      QString result;
+      QTextStream out(&result);
+      out << "pixelRatio " << MScore::pixelRatio << "\n";
+      for (Page* page : s->pages()) {
+            out << "page " << page->no() << "\n";
+            for (Element* e : page->elements()) {
+                  QRectF r = e->pageBoundingRect();
+                  out << e->name() << " " << r.x() << " " << r.y() << " " << r.width() << " " << r.height() << "\n";
+                  }
+            }
+      delete s;
+      return result;
+      }
+
+//---------------------------------------------------------
+//   workerThread
+//---------------------------------------------------------
+
+void TestThreadLayout::workerThread()
+      {
+      const double defaultPixelRatio = MScore::defaultPixelRatio;
+      // as set from the screen resolution at startup
+      MScore::defaultPixelRatio = 1.25;
+      MScore::pixelRatio = MScore::defaultPixelRatio;
+
+      QString expected = layout();
+      QVERIFY(!expected.isEmpty());
+
+      QThreadPool pool;                   // new threads
+      QString result = QtConcurrent::run(&pool, [this]() { return layout(); }).result();
+
+      MScore::defaultPixelRatio = defaultPixelRatio;
+      MScore::pixelRatio = defaultPixelRatio;
+      QCOMPARE(result, expected);
+      }
+
+QTEST_MAIN(TestThreadLayout)
+#include "tst_threadlayout.moc"
@@ -0,0 +1,200 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/page.h"
+#include "libmscore/system.h"
+#include "libmscore/measure.h"
+#include "libmscore/segment.h"
+#include "libmscore/rest.h"
+#include "libmscore/tilecache.h"
+
+#define DIR QString("libmscore/concertpitch/")
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestTileCache
+//    a page put together from tiles must look like the
+//    printed page
+//---------------------------------------------------------
+
+class TestTileCache : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      QImage image(Page*, qreal scale);
+      QImage printed(Page*, qreal scale);
+      QImage cached(TileCache*, Page*);
+      Rest* firstRest(Score*);
+
+   private slots:
+      void initTestCase();
+      void pageImage_data();
+      void pageImage();
+      void dragRest();
+      void thumbnail();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestTileCache::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   image
+//    an empty page image
+//---------------------------------------------------------
+
+QImage TestTileCache::image(Page* page, qreal scale)
+      {
+      QImage image(int(page->width() * scale), int(page->height() * scale), QImage::Format_ARGB32_Premultiplied);
+      int dpm = lrint(DPMM * 1000.0);
+      image.setDotsPerMeterX(dpm);
+      image.setDotsPerMeterY(dpm);
+      image.fill(0xffffffff);
+      return image;
+      }
+
+//---------------------------------------------------------
+//   printed
+//    the page as Score::print() paints it, in one piece
+//---------------------------------------------------------
+
+QImage TestTileCache::printed(Page* page, qreal scale)
+      {
+      QImage im = image(page, scale);
+      QPainter p(&im);
+      p.setRenderHint(QPainter::Antialiasing, true);
+      p.setRenderHint(QPainter::TextAntialiasing, true);
+      p.scale(scale, scale);
+      page->score()->print(&p, page->no());
+      p.end();
+      return im;
+      }
+
+//---------------------------------------------------------
+//   cached
+//    the page painted from the tiles of the cache
+//---------------------------------------------------------
+
+QImage TestTileCache::cached(TileCache* tiles, Page* page)
+      {
+      QImage im = image(page, tiles->scale());
+      QPainter p(&im);
+      p.scale(tiles->scale(), tiles->scale());
+      tiles->paintPage(&p, page);
+      p.end();
+      return im;
+      }
+
+//---------------------------------------------------------
+//   firstRest
+//    the first rest of the first voice
+//---------------------------------------------------------
+
+Rest* TestTileCache::firstRest(Score* score)
+      {
+      for (Segment* s = score->firstMeasure()->first(SegmentType::ChordRest); s; s = s->next1(SegmentType::ChordRest)) {
+            if (s->element(0) && s->element(0)->isRest())
+                  return toRest(s->element(0));
+            }
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   pageImage
+//---------------------------------------------------------
+
+void TestTileCache::pageImage_data()
+      {
+      QTest::addColumn<qreal>("scale");
+      QTest::newRow("thumbnail") << 0.13;
+      QTest::newRow("navigator") << 0.31;
+      QTest::newRow("large")     << 1.0;
+      }
+
+void TestTileCache::pageImage()
+      {
+      QFETCH(qreal, scale);
+      MasterScore* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      QVERIFY(score);
+      Page* page = score->pages().front();
+      QVERIFY(page->systems().size() > 1);
+      TileCache tiles;
+      tiles.setScale(scale);
+      QCOMPARE(tiles.pageImage(page), printed(page, scale));
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   dragRest
+//    a rest is moved without a layout, its tile must be
+//    painted again
+//---------------------------------------------------------
+
+void TestTileCache::dragRest()
+      {
+      MasterScore* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      QVERIFY(score);
+      Page* page = score->pages().front();
+      TileCache tiles;
+      tiles.setScale(0.31);
+      QImage before = cached(&tiles, page);
+      QCOMPARE(before, printed(page, tiles.scale()));
+
+      Rest* rest = firstRest(score);
+      QVERIFY(rest);
+      QCOMPARE(rest->measure()->system()->page(), page);
+      EditData ed;
+      ed.delta = QPointF(0.0, -4 * rest->spatium());
+      rest->drag(ed);
+
+      QImage after = cached(&tiles, page);
+      QVERIFY(after != before);
+      QCOMPARE(after, printed(page, tiles.scale()));
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   thumbnail
+//    the thumbnail is painted from tiles kept by the
+//    score, again after an edit
+//---------------------------------------------------------
+
+void TestTileCache::thumbnail()
+      {
+      MasterScore* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      QVERIFY(score);
+      Page* page = score->pages().front();
+      qreal mag  = 256.0 / qMax(page->abbox().width(), page->abbox().height());
+      QImage first = score->createThumbnail();
+      QCOMPARE(first, printed(page, mag));
+      QCOMPARE(score->createThumbnail(), first);
+
+      Rest* rest = firstRest(score);
+      QVERIFY(rest);
+      EditData ed;
+      ed.delta = QPointF(0.0, -4 * rest->spatium());
+      rest->drag(ed);
+      QCOMPARE(score->createThumbnail(), printed(page, mag));
+      delete score;
+      }
+
+QTEST_MAIN(TestTileCache)
+
+#include "tst_tilecache.moc"
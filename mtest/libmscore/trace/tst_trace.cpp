@@ -0,0 +1,196 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include <thread>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/trace.h"
+#include "synthesizer/event.h"
+
+#define DIR QString("libmscore/concertpitch/")
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestTrace
+//---------------------------------------------------------
+
+class TestTrace : public QObject, public MTest
+      {
+      Q_OBJECT
+
+   private slots:
+      void initTestCase();
+      void chromeTrace();
+      void disabled();
+      void full();
+      void finishedThreads();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestTrace::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   chromeTrace
+//    the phases of load, layout and renderMidi must be in
+//    the saved trace, nested in their callers
+//---------------------------------------------------------
+
+void TestTrace::chromeTrace()
+      {
+#ifndef MSCORE_TRACE
+      QSKIP("built without MSCORE_TRACE");
+#endif
+      Trace::clear();
+      Trace::start();
+      MasterScore* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      QVERIFY(score);
+      EventMap events;
+      score->renderMidi(&events);
+      Trace::stop();
+      delete score;
+
+      QTemporaryDir dir;
+      QString path = dir.path() + "/trace.json";
+      QVERIFY(Trace::save(path));
+      QFile f(path);
+      QVERIFY(f.open(QIODevice::ReadOnly));
+      QJsonParseError error;
+      QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &error);
+      QCOMPARE(error.error, QJsonParseError::NoError);
+
+      QMap<QString, QJsonObject> first;
+      int counters = 0;
+      for (const QJsonValue& v : doc.object()["traceEvents"].toArray()) {
+            QJsonObject e = v.toObject();
+            if (e["ph"].toString() == "C")
+                  ++counters;
+            else if (e["ph"].toString() == "X" && !first.contains(e["name"].toString()))
+                  first[e["name"].toString()] = e;
+            }
+      for (const char* name : { "loadMsc", "read", "doLayoutRange", "getNextMeasure",
+         "collectSystem", "collectPage", "layoutLyrics", "renderMidi" })
+            QVERIFY2(first.contains(name), name);
+      QVERIFY(counters >= 3);
+
+      // the first collectPage runs within the first doLayoutRange
+      QJsonObject outer = first["doLayoutRange"];
+      QJsonObject inner = first["collectPage"];
+      QVERIFY(inner["ts"].toDouble() >= outer["ts"].toDouble());
+      QVERIFY(inner["ts"].toDouble() + inner["dur"].toDouble()
+         <= outer["ts"].toDouble() + outer["dur"].toDouble());
+      }
+
+//---------------------------------------------------------
+//   disabled
+//    nothing is recorded unless the trace is started
+//---------------------------------------------------------
+
+void TestTrace::disabled()
+      {
+      Trace::clear();
+      MasterScore* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      QVERIFY(score);
+      delete score;
+
+      QTemporaryDir dir;
+      QString path = dir.path() + "/trace.json";
+      QVERIFY(Trace::save(path));
+      QFile f(path);
+      QVERIFY(f.open(QIODevice::ReadOnly));
+      QJsonArray events = QJsonDocument::fromJson(f.readAll()).object()["traceEvents"].toArray();
+      QCOMPARE(events.size(), 1);         // process name only
+      }
+
+//---------------------------------------------------------
+//   full
+//    the oldest events of a thread are dropped when its
+//    buffer is full, and reported
+//---------------------------------------------------------
+
+void TestTrace::full()
+      {
+      Trace::clear();
+      Trace::start();
+      for (int i = 0; i < Trace::BUFFER_SIZE + 100; ++i)
+            Trace::counter("test", "full", i);
+      Trace::stop();
+      QCOMPARE(Trace::dropped(), qint64(100));
+
+      QTemporaryDir dir;
+      QString path = dir.path() + "/trace.json";
+      QVERIFY(Trace::save(path));
+      QFile f(path);
+      QVERIFY(f.open(QIODevice::ReadOnly));
+      QJsonObject trace  = QJsonDocument::fromJson(f.readAll()).object();
+      QJsonArray events  = trace["traceEvents"].toArray();
+      QCOMPARE(events.size(), Trace::BUFFER_SIZE + 1);
+      QCOMPARE(events[1].toObject()["args"].toObject()["full"].toInt(), 100);
+      QCOMPARE(events.last().toObject()["args"].toObject()["full"].toInt(), Trace::BUFFER_SIZE + 99);
+      QCOMPARE(trace["otherData"].toObject()["droppedEvents"].toInt(), 100);
+      f.close();
+
+      Trace::clear();
+      QCOMPARE(Trace::dropped(), qint64(0));
+      Trace::start();
+      Trace::counter("test", "full", -1);
+      Trace::stop();
+      QVERIFY(Trace::save(path));
+      QVERIFY(f.open(QIODevice::ReadOnly));
+      trace  = QJsonDocument::fromJson(f.readAll()).object();
+      events = trace["traceEvents"].toArray();
+      QCOMPARE(events.size(), 2);
+      QVERIFY(!trace.contains("otherData"));
+      Trace::clear();
+      }
+
+//---------------------------------------------------------
+//   finishedThreads
+//    the buffer of a finished thread is taken over by the
+//    next one, its events are kept
+//---------------------------------------------------------
+
+void TestTrace::finishedThreads()
+      {
+      Trace::clear();
+      Trace::start();
+      const int n = Trace::MAX_THREADS + 8;
+      for (int i = 0; i < n; ++i) {
+            std::thread t([i]() { Trace::counter("test", "thread", i); });
+            t.join();
+            }
+      Trace::stop();
+      QCOMPARE(Trace::dropped(), qint64(0));
+
+      QTemporaryDir dir;
+      QString path = dir.path() + "/trace.json";
+      QVERIFY(Trace::save(path));
+      QFile f(path);
+      QVERIFY(f.open(QIODevice::ReadOnly));
+      QSet<int> threads;
+      for (const QJsonValue& v : QJsonDocument::fromJson(f.readAll()).object()["traceEvents"].toArray()) {
+            QJsonObject e = v.toObject();
+            if (e["name"].toString() == "thread")
+                  threads.insert(e["tid"].toInt());
+            }
+      QCOMPARE(threads.size(), n);
+      Trace::clear();
+      }
+
+QTEST_MAIN(TestTrace)
+#include "tst_trace.moc"
@@ -0,0 +1,113 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/xml.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestXmlReader
+//---------------------------------------------------------
+
+class TestXmlReader : public QObject, public MTest
+      {
+      Q_OBJECT
+
+   private slots:
+      void initTestCase();
+      void tagId();
+      void typedValues();
+      void attributes();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestXmlReader::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   tagId
+//---------------------------------------------------------
+
+void TestXmlReader::tagId()
+      {
+      XmlReader e(QByteArray("<Measure><Chord/><tpc/><tpc2/><Tpc/><grace8after/><unknownTag/><z/><vspacerUp/></Measure>"));
+      QVERIFY(e.readNextStartElement());
+      QCOMPARE(e.tagId(), XmlTag::UNKNOWN);
+      const XmlTag tags[] = { XmlTag::CHORD, XmlTag::TPC, XmlTag::TPC2, XmlTag::UNKNOWN,
+         XmlTag::GRACE8AFTER, XmlTag::UNKNOWN, XmlTag::Z, XmlTag::VSPACER_UP };
+      for (XmlTag t : tags) {
+            QVERIFY(e.readNextStartElement());
+            QCOMPARE(e.tagId(), t);
+            e.skipCurrentElement();
+            }
+      QVERIFY(!e.readNextStartElement());
+      }
+
+//---------------------------------------------------------
+//   typedValues
+//    must read the same as readElementText(), also if the
+//    text is split by entities or comments
+//---------------------------------------------------------
+
+void TestXmlReader::typedValues()
+      {
+      XmlReader e(QByteArray("<a>"
+                             "<i>480</i><i>-3</i><i>1<!-- c -->2</i><i/><i>x</i>"
+                             "<d>0.25</d><d>1&#x35;</d><d>7</d>"
+                             "<f>3/8</f><f z=\"2\" n=\"4\"/><f>1<!-- c -->/16</f>"
+                             "</a>"));
+      QVERIFY(e.readNextStartElement());
+      for (int i : { 480, -3, 12, 0, 0 }) {
+            QVERIFY(e.readNextStartElement());
+            QCOMPARE(e.readInt(), i);
+            }
+      for (double d : { 0.25, 15.0, 7.0 }) {
+            QVERIFY(e.readNextStartElement());
+            QCOMPARE(e.readDouble(), d);
+            }
+      for (const Fraction& f : { Fraction(3, 8), Fraction(2, 4), Fraction(1, 16) }) {
+            QVERIFY(e.readNextStartElement());
+            Fraction r = e.readFraction();
+            QCOMPARE(r.numerator(), f.numerator());
+            QCOMPARE(r.denominator(), f.denominator());
+            }
+      QVERIFY(!e.readNextStartElement());
+      QVERIFY(!e.hasError());
+      }
+
+//---------------------------------------------------------
+//   attributes
+//---------------------------------------------------------
+
+void TestXmlReader::attributes()
+      {
+      XmlReader e(QByteArray("<a id=\"7\" x=\"1.5\" name=\"n\" empty=\"\"/>"));
+      QVERIFY(e.readNextStartElement());
+      QCOMPARE(e.intAttribute("id"), 7);
+      QCOMPARE(e.intAttribute("missing", 3), 3);
+      QCOMPARE(e.doubleAttribute("x"), 1.5);
+      QCOMPARE(e.doubleAttribute("y", 2.5), 2.5);
+      QCOMPARE(e.attribute("name"), QString("n"));
+      QCOMPARE(e.attribute("missing", "d"), QString("d"));
+      QCOMPARE(e.attribute("empty", "d"), QString(""));
+      QVERIFY(e.hasAttribute("empty"));
+      QVERIFY(!e.hasAttribute("missing"));
+      }
+
+QTEST_MAIN(TestXmlReader)
+#include "tst_xmlreader.moc"
@@ -0,0 +1,178 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/xml.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestXmlWriter
+//---------------------------------------------------------
+
+class TestXmlWriter : public QObject, public MTest
+      {
+      Q_OBJECT
+
+   private slots:
+      void initTestCase();
+      void typedTags();
+      void indentation();
+      void flushed();
+      void benchmarkTags_data();
+      void benchmarkTags();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestXmlWriter::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   typedTags
+//    the typed tag() must write the same as tag() with
+//    a QVariant
+//---------------------------------------------------------
+
+void TestXmlWriter::typedTags()
+      {
+      QBuffer typed;
+      QBuffer variant;
+      typed.open(QIODevice::WriteOnly);
+      variant.open(QIODevice::WriteOnly);
+      {
+      XmlWriter t(score, &typed);
+      XmlWriter v(score, &variant);
+      t.stag("Test");
+      v.stag("Test");
+      for (int i : { 0, 1, -1, 480, 2147483647 }) {
+            t.tag("int", i);
+            v.tag("int", QVariant(i));
+            }
+      t.tag("bool", true);
+      v.tag("bool", QVariant(true));
+      t.tag("uint", 7u);
+      v.tag("uint", QVariant(7u));
+      for (double d : { 0.0, 1.5, -0.1, 1e-7, 1.0 / 3.0, 123456789.0 }) {
+            t.tag("double", d);
+            v.tag("double", QVariant(d));
+            t.sTag("spatium", Spatium(d));
+            v.tag("spatium", QVariant(d));
+            }
+      t.tag("text", QString("a < b & \"c\" \x01"));
+      v.tag("text", QVariant(QString("a < b & \"c\" \x01")));
+      t.tag("name", "Fl\xc3\xb6te");
+      v.tag("name", QVariant("Fl\xc3\xb6te"));
+      t.tag("Harmony id=\"2\"", 3);
+      v.tag("Harmony id=\"2\"", QVariant(3));
+      t.etag();
+      v.etag();
+      }
+      QCOMPARE(typed.data(), variant.data());
+      QVERIFY(typed.data().contains("<Harmony id=\"2\">3</Harmony>\n"));
+      QVERIFY(typed.data().contains("<text>a &lt; b &amp; &quot;c&quot; </text>\n"));
+      }
+
+//---------------------------------------------------------
+//   indentation
+//    two spaces per level, also for deep nesting
+//---------------------------------------------------------
+
+void TestXmlWriter::indentation()
+      {
+      QBuffer buffer;
+      buffer.open(QIODevice::WriteOnly);
+      const int levels = 50;
+      {
+      XmlWriter xml(score, &buffer);
+      for (int i = 0; i < levels; ++i)
+            xml.stag(QString("l%1 n=\"%1\"").arg(i));
+      xml.tag("v", 1);
+      for (int i = 0; i < levels; ++i)
+            xml.etag();
+      }
+      QList<QByteArray> lines = buffer.data().split('\n');
+      QCOMPARE(lines[levels], QByteArray(levels * 2, ' ') + "<v>1</v>");
+      QCOMPARE(lines[levels + 1], QByteArray((levels - 1) * 2, ' ') + "</l49>");
+      QCOMPARE(lines[2 * levels], QByteArray("</l0>"));
+      }
+
+//---------------------------------------------------------
+//   flushed
+//    the device holds the complete document once the
+//    outermost element is closed
+//---------------------------------------------------------
+
+void TestXmlWriter::flushed()
+      {
+      QBuffer buffer;
+      buffer.open(QIODevice::WriteOnly);
+      XmlWriter xml(score, &buffer);
+      xml.header();
+      xml.stag("museScore version=\"3.00\"");
+      xml.tag("programVersion", "3.0");
+      xml.etag();
+      QCOMPARE(buffer.data(), QByteArray("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                                         "<museScore version=\"3.00\">\n"
+                                         "  <programVersion>3.0</programVersion>\n"
+                                         "</museScore>\n"));
+      }
+
+//---------------------------------------------------------
+//   benchmarkTags
+//    the tags of a note, written typed and through a
+//    QVariant as before the typed tag()
+//---------------------------------------------------------
+
+void TestXmlWriter::benchmarkTags_data()
+      {
+      QTest::addColumn<bool>("typed");
+      QTest::newRow("variant") << false;
+      QTest::newRow("typed") << true;
+      }
+
+void TestXmlWriter::benchmarkTags()
+      {
+      QFETCH(bool, typed);
+      QBENCHMARK {
+            QBuffer buffer;
+            buffer.open(QIODevice::WriteOnly);
+            XmlWriter xml(score, &buffer);
+            xml.stag("Staff id=\"1\"");
+            for (int i = 0; i < 10000; ++i) {
+                  xml.stag("Note");
+                  if (typed) {
+                        xml.tag("pitch", 60 + i % 12);
+                        xml.tag("tpc", 14 + i % 7);
+                        xml.tag("velocity", 80);
+                        xml.tag("offset", 0.5 * (i % 3));
+                        xml.tag("text", "Fl\xc3\xb6te");
+                        }
+                  else {
+                        xml.tag("pitch", QVariant(60 + i % 12));
+                        xml.tag("tpc", QVariant(14 + i % 7));
+                        xml.tag("velocity", QVariant(80));
+                        xml.tag("offset", QVariant(0.5 * (i % 3)));
+                        xml.tag("text", QVariant("Fl\xc3\xb6te"));
+                        }
+                  xml.etag();
+                  }
+            xml.etag();
+            }
+      }
+
+QTEST_MAIN(TestXmlWriter)
+#include "tst_xmlwriter.moc"
@@ -15,6 +15,7 @@
 #include "mtest/testutils.h"
 #include "libmscore/score.h"
 #include "mscore/preferences.h"
+#include "mscore/importmxmlreader.h"
 // start includes required for fixupScore()
 #include "libmscore/measure.h"
 #include "libmscore/staff.h"
@@ -23,6 +24,7 @@
 
 namespace Ms {
       extern bool saveMxl(Score*, const QString&);
+      extern Score::FileError importMusicXMLfromBuffer(Score*, const QString&, QIODevice*, bool);
       }
 
 #define DIR QString("musicxml/io/")
@@ -42,6 +44,8 @@ class TestMxmlIO : public QObject, public MTest
       void mxmlMscxExportTestRef(const char* file);
       void mxmlReadTestCompr(const char* file);
       void mxmlReadWriteTestCompr(const char* file);
+      void mxmlReplayTest(const char* file);
+      MasterScore* importXml(const QString& file, bool replay, Score::FileError& rv);
 
 
       // The list of MusicXML regression tests
@@ -178,6 +182,9 @@ private slots:
       void words2() { mxmlIoTest("testWords2"); }
       void sound1() { mxmlIoTestRef("testSound1"); }
       void sound2() { mxmlIoTestRef("testSound2"); }
+      void replayEntities() { mxmlReplayTest("testReplayEntities"); }
+      void replayXmlError() { mxmlReplayTest("testReplayXmlError"); }
+      void replayTokens();
       };
 
 //---------------------------------------------------------
@@ -277,6 +284,135 @@ void TestMxmlIO::mxmlIoTestRef(const char* file)
       delete score;
       }
 
+//---------------------------------------------------------
+//   importXml
+//   import MusicXML file, pass 2 either replaying the tokens of pass 1
+//   or parsing the file again
+//---------------------------------------------------------
+
+MasterScore* TestMxmlIO::importXml(const QString& file, bool replay, Score::FileError& rv)
+      {
+      QFile f(root + "/" + file);
+      if (!f.open(QIODevice::ReadOnly)) {
+            rv = Score::FileError::FILE_OPEN_ERROR;
+            return 0;
+            }
+      MasterScore* score = new MasterScore(mscore->baseStyle());
+      score->setName(QFileInfo(file).completeBaseName());
+      Score::isScoreLoaded() = true;
+      rv = importMusicXMLfromBuffer(score, file, &f, replay);
+      Score::isScoreLoaded() = false;
+      if (rv != Score::FileError::FILE_NO_ERROR) {
+            delete score;
+            return 0;
+            }
+      fixupScore(score);
+      score->doLayout();
+      return score;
+      }
+
+//---------------------------------------------------------
+//   mxmlReplayTest
+//   read a MusicXML file replaying the tokens in pass 2 and
+//   parsing it again, verify the exported files are identical
+//---------------------------------------------------------
+
+void TestMxmlIO::mxmlReplayTest(const char* file)
+      {
+      MScore::debugMode = true;
+      preferences.setCustomPreference<MusicxmlExportBreaks>(PREF_EXPORT_MUSICXML_EXPORTBREAKS, MusicxmlExportBreaks::MANUAL);
+      preferences.setPreference(PREF_IMPORT_MUSICXML_IMPORTBREAKS, true);
+      preferences.setPreference(PREF_EXPORT_MUSICXML_EXPORTLAYOUT, false);
+      Score::FileError replayedRv;
+      Score::FileError parsedRv;
+      MasterScore* replayed = importXml(DIR + file + ".xml", true, replayedRv);
+      MasterScore* parsed = importXml(DIR + file + ".xml", false, parsedRv);
+      QCOMPARE(int(replayedRv), int(parsedRv));
+      QVERIFY(replayed);
+      QVERIFY(parsed);
+      QString replayedName = QString(file) + "_replayed.xml";
+      QString parsedName = QString(file) + "_parsed.xml";
+      QVERIFY(saveMusicXml(replayed, replayedName));
+      QVERIFY(saveMusicXml(parsed, parsedName));
+      QFile replayedFile(replayedName);
+      QFile parsedFile(parsedName);
+      QVERIFY(replayedFile.open(QIODevice::ReadOnly));
+      QVERIFY(parsedFile.open(QIODevice::ReadOnly));
+      QByteArray replayedXml = replayedFile.readAll();
+      QCOMPARE(replayedXml, parsedFile.readAll());
+      // the entities are resolved
+      QVERIFY(replayedXml.contains("Fish &amp; chips &lt;3 caf\xc3\xa9"));
+      delete replayed;
+      delete parsed;
+      }
+
+//---------------------------------------------------------
+//   readTokens
+//   the elements, attributes and texts read by the reader
+//---------------------------------------------------------
+
+static void readTokens(MxmlReader& e, QStringList& sl)
+      {
+      while (e.readNextStartElement()) {
+            QString s = e.name().toString();
+            for (const QXmlStreamAttribute& a : e.attributes())
+                  s += QString(" %1=%2").arg(a.qualifiedName().toString()).arg(a.value().toString());
+            if (e.name() == "work-title" || e.name() == "work-number" || e.name() == "part-name") {
+                  sl.append(s + " '" + e.readElementText() + "'");
+                  continue;
+                  }
+            sl.append(s);
+            readTokens(e, sl);
+            }
+      }
+
+//---------------------------------------------------------
+//   replayTokens
+//   the replayed tokens read like the parsed ones, the
+//   indentation is not recorded but the whitespace text
+//   of an element is
+//---------------------------------------------------------
+
+void TestMxmlIO::replayTokens()
+      {
+      QByteArray data(
+         "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+         "<score-partwise version=\"3.1\">\n"
+         "  <work>\n"
+         "    <work-title> </work-title>\n"
+         "    <work-number>No. 1</work-number>\n"
+         "    </work>\n"
+         "  <part-list>\n"
+         "    <score-part id=\"P1\"><part-name print-object=\"no\">Flute</part-name></score-part>\n"
+         "    <score-part id=\"P2\">\n"
+         "      <part-name print-object=\"no\">Oboe</part-name>\n"
+         "      </score-part>\n"
+         "    </part-list>\n"
+         "  </score-partwise>\n");
+      QBuffer buffer(&data);
+      QVERIFY(buffer.open(QIODevice::ReadOnly));
+      MxmlTokens tokens;
+      MxmlReader parser;
+      parser.setRecorder(&tokens);
+      parser.setDevice(&buffer);
+      QStringList parsed;
+      readTokens(parser, parsed);
+      QVERIFY(parser.finishRecording());
+      QVERIFY(!parser.hasError());
+
+      MxmlReader replayer;
+      replayer.setTokens(&tokens);
+      QStringList replayed;
+      readTokens(replayer, replayed);
+      QVERIFY(!replayer.hasError());
+      QCOMPARE(replayed, parsed);
+      QVERIFY(parsed.contains("work-title ' '"));
+      QVERIFY(parsed.contains("part-name print-object=no 'Oboe'"));
+
+      // StartDocument, 9 start and end elements, 4 texts, EndDocument
+      QCOMPARE(tokens.size(), 1 + 2 * 9 + 4 + 1);
+      }
+
 //---------------------------------------------------------
 //   mxmlMscxExportTestRef
 //   read a MuseScore mscx file, write to a MusicXML file and verify against reference
@@ -0,0 +1,142 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <thread>
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "synthesizer/commandfifo.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   AudioThread
+//    calls process() like MasterSynthesizer::process()
+//    until stopped
+//---------------------------------------------------------
+
+struct AudioThread {
+      SynthCommandFifo* fifo;
+      std::atomic<bool> quit { false };
+      std::function<void()> block;        // called after process(), like Seq::process()
+      std::thread thread;
+
+      AudioThread(SynthCommandFifo* f, std::function<void()> b = std::function<void()>())
+         : fifo(f), block(b) {
+            thread = std::thread([this]() {
+                  while (!quit) {
+                        fifo->process();
+                        if (block)
+                              block();
+                        std::this_thread::yield();
+                        }
+                  });
+            }
+      ~AudioThread() {
+            quit = true;
+            thread.join();
+            }
+      };
+
+//---------------------------------------------------------
+//   TestCommandFifo
+//---------------------------------------------------------
+
+class TestCommandFifo : public QObject, public MTest
+      {
+      Q_OBJECT
+
+   private slots:
+      void initTestCase();
+      void fromAudioThread();
+      void manyWriters();
+      void stopRealtime();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestCommandFifo::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   fromAudioThread
+//    a command sent by the audio thread itself, e.g. all
+//    notes off while seeking, must not wait for itself
+//---------------------------------------------------------
+
+void TestCommandFifo::fromAudioThread()
+      {
+      SynthCommandFifo fifo;
+      fifo.setRealtime(true);
+      std::atomic<int> n { 0 };
+      {
+      AudioThread audio(&fifo, [&fifo, &n]() {
+            if (n < 100)
+                  fifo.execute([&n]() { ++n; });
+            });
+      QTRY_COMPARE(n.load(), 100);
+      }
+      fifo.setRealtime(false);
+      }
+
+//---------------------------------------------------------
+//   manyWriters
+//    every command is executed exactly once
+//---------------------------------------------------------
+
+void TestCommandFifo::manyWriters()
+      {
+      SynthCommandFifo fifo;
+      fifo.setRealtime(true);
+      int n = 0;                    // only changed by the audio thread
+      {
+      AudioThread audio(&fifo);
+      std::vector<std::thread> writers;
+      for (int i = 0; i < 4; ++i) {
+            writers.emplace_back([&fifo, &n]() {
+                  for (int k = 0; k < 1000; ++k)
+                        fifo.execute([&n]() { ++n; });
+                  });
+            }
+      for (std::thread& t : writers)
+            t.join();
+      }
+      fifo.setRealtime(false);
+      QCOMPARE(n, 4000);
+      }
+
+//---------------------------------------------------------
+//   stopRealtime
+//    without an audio thread commands run directly
+//---------------------------------------------------------
+
+void TestCommandFifo::stopRealtime()
+      {
+      SynthCommandFifo fifo;
+      int n = 0;
+      fifo.execute([&n]() { ++n; });
+      QCOMPARE(n, 1);
+      fifo.setRealtime(true);
+      {
+      AudioThread audio(&fifo);
+      fifo.execute([&n]() { ++n; });
+      }
+      fifo.setRealtime(false);
+      fifo.execute([&n]() { ++n; });
+      QCOMPARE(n, 3);
+      }
+
+QTEST_MAIN(TestCommandFifo)
+
+#include "tst_commandfifo.moc"
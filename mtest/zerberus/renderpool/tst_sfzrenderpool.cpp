@@ -0,0 +1,157 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+
+#include "zerberus/zerberus.h"
+#include "mscore/preferences.h"
+#include "synthesizer/event.h"
+#include "synthesizer/renderpool.h"
+
+using namespace Ms;
+
+static const int FRAMES = 256;
+static const int BLOCKS = 40;
+
+//---------------------------------------------------------
+//   TestSfzRenderPool
+//    voices rendered on several threads must give exactly
+//    the output of one thread
+//---------------------------------------------------------
+
+class TestSfzRenderPool : public QObject, public MTest
+      {
+      Q_OBJECT
+      float samplerate = 44100;
+
+      std::vector<float> render(int threads);
+
+   private slots:
+      void initTestCase();
+      void testThreads_data();
+      void testThreads();
+      void testSlowWorker();
+      void benchmarkRender_data();
+      void benchmarkRender();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestSfzRenderPool::initTestCase()
+      {
+      initMTest();
+      preferences.setPreference(PREF_APP_PATHS_MYSOUNDFONTS, root);
+      }
+
+//---------------------------------------------------------
+//   render
+//    play 60 notes, release some of them while playing
+//---------------------------------------------------------
+
+std::vector<float> TestSfzRenderPool::render(int threads)
+      {
+      RenderPool pool(threads);
+      Zerberus synth;
+      synth.init(samplerate);
+      synth.setRenderPool(&pool);
+      if (!synth.loadInstrument("renderPoolTest.sfz"))
+            return std::vector<float>();
+      for (int key = 30; key < 90; ++key)
+            synth.play(PlayEvent(ME_NOTEON, 0, key, 20 + key));
+      std::vector<float> buffer(BLOCKS * FRAMES * 2, 0.0f);
+      for (int i = 0; i < BLOCKS; ++i) {
+            if (i % 4 == 1)
+                  synth.play(PlayEvent(ME_NOTEOFF, 0, 30 + i, 0));
+            synth.process(FRAMES, buffer.data() + i * FRAMES * 2, 0, 0);
+            }
+      return buffer;
+      }
+
+//---------------------------------------------------------
+//   testThreads
+//---------------------------------------------------------
+
+void TestSfzRenderPool::testThreads_data()
+      {
+      QTest::addColumn<int>("threads");
+      QTest::newRow("2") << 2;
+      QTest::newRow("3") << 3;
+      QTest::newRow("8") << 8;
+      }
+
+void TestSfzRenderPool::testThreads()
+      {
+      QFETCH(int, threads);
+      std::vector<float> expected = render(1);
+      QVERIFY(!expected.empty());
+      QVERIFY(std::any_of(expected.begin(), expected.end(), [](float v) { return v != 0.0f; }));
+      std::vector<float> result = render(threads);
+      QCOMPARE(result.size(), expected.size());
+      QVERIFY(memcmp(result.data(), expected.data(), expected.size() * sizeof(float)) == 0);
+      }
+
+//---------------------------------------------------------
+//   testSlowWorker
+//    a worker which takes longer than the calling thread
+//    waits must not change the result; the calling thread
+//    takes over the voices it did not get to
+//---------------------------------------------------------
+
+void TestSfzRenderPool::testSlowWorker()
+      {
+      const int voices = 64;
+      std::vector<float> expected(FRAMES * 2, 0.0f);
+      std::vector<float> result(FRAMES * 2, 0.0f);
+      auto value = [](int v, unsigned i) { return float((v * 31 + i) % 97) / 97.0f - 0.5f; };
+      RenderPool::RenderFn fn = [&value](int v, unsigned frames, float* out, float*, float*) {
+            for (unsigned i = 0; i < frames * 2; ++i)
+                  out[i] += value(v, i);
+            };
+      RenderPool serial(1);
+      serial.render(voices, FRAMES, expected.data(), 0, 0, fn);
+
+      RenderPool pool(4);
+      QThread* caller = QThread::currentThread();
+      std::atomic<int> slow { 0 };
+      RenderPool::RenderFn slowFn = [&](int v, unsigned frames, float* out, float* e1, float* e2) {
+            if (QThread::currentThread() != caller && slow++ == 0)
+                  QThread::msleep(20 * RenderPool::WAIT_MS);
+            fn(v, frames, out, e1, e2);
+            };
+      pool.render(voices, FRAMES, result.data(), 0, 0, slowFn);
+      QVERIFY(memcmp(result.data(), expected.data(), expected.size() * sizeof(float)) == 0);
+      }
+
+//---------------------------------------------------------
+//   benchmarkRender
+//---------------------------------------------------------
+
+void TestSfzRenderPool::benchmarkRender_data()
+      {
+      QTest::addColumn<int>("threads");
+      QTest::newRow("1") << 1;
+      QTest::newRow("all") << RenderPool::defaultThreads();
+      }
+
+void TestSfzRenderPool::benchmarkRender()
+      {
+      QFETCH(int, threads);
+      QBENCHMARK {
+            render(threads);
+            }
+      }
+
+QTEST_MAIN(TestSfzRenderPool)
+
+#include "tst_sfzrenderpool.moc"
@@ -0,0 +1,181 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+
+#include "zerberus/instrument.h"
+#include "zerberus/zerberus.h"
+#include "zerberus/zone.h"
+#include "zerberus/sample.h"
+#include "mscore/preferences.h"
+#include "synthesizer/event.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestSfzStreaming
+//---------------------------------------------------------
+
+class TestSfzStreaming : public QObject, public MTest
+      {
+      Q_OBJECT
+      float samplerate = 44100;
+      Zerberus* synth;              // samples in memory
+      Zerberus* streamSynth;        // samples streamed after 1ms
+      Zerberus* offsetSynth;        // zones with different offsets, streamed
+
+      void render(Zerberus*, float* data, int frames);
+
+   private slots:
+      void initTestCase();
+      void testSharedSamples();
+      void testStreamedAudio();
+      void testHeadReuse();
+      void testStreamRings();
+   public:
+      ~TestSfzStreaming();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestSfzStreaming::initTestCase()
+      {
+      initMTest();
+      preferences.setPreference(PREF_APP_PATHS_MYSOUNDFONTS, root);
+      // load the streamed instrument first, a sample in memory
+      // would be shared with it
+      preferences.setPreference(PREF_IO_ZERBERUS_PRELOADTIME, 1);
+      streamSynth = new Zerberus();
+      streamSynth->init(samplerate);
+      streamSynth->loadInstrument("preloadTest.sfz");
+      offsetSynth = new Zerberus();
+      offsetSynth->init(samplerate);
+      offsetSynth->loadInstrument("offsetTest.sfz");
+      preferences.setPreference(PREF_IO_ZERBERUS_PRELOADTIME, 0);
+
+      synth = new Zerberus();
+      synth->init(samplerate);
+      synth->loadInstrument("streamTest.sfz");
+      }
+
+//---------------------------------------------------------
+//   testSharedSamples
+//---------------------------------------------------------
+
+void TestSfzStreaming::testSharedSamples()
+      {
+      QCOMPARE(synth->instrument(0)->zones().size(), (size_t) 2);
+      Sample* s = synth->instrument(0)->zones().front()->sample;
+      QVERIFY(s);
+      QCOMPARE(synth->instrument(0)->zones().back()->sample, s);
+      QVERIFY(!s->streamed());
+
+      QCOMPARE(streamSynth->instrument(0)->zones().size(), (size_t) 2);
+      Sample* ss = streamSynth->instrument(0)->zones().front()->sample;
+      QVERIFY(ss);
+      QCOMPARE(streamSynth->instrument(0)->zones().back()->sample, ss);
+      QVERIFY(ss->streamed());
+      QCOMPARE(ss->headFrames(), 44LL);
+      QCOMPARE(ss->frames(), s->frames());
+      }
+
+//---------------------------------------------------------
+//   render
+//    let the streamer read ahead after the note on
+//---------------------------------------------------------
+
+void TestSfzStreaming::render(Zerberus* z, float* data, int frames)
+      {
+      z->play(Ms::PlayEvent(ME_PROGRAM, 0, 0, 0));
+      z->play(Ms::PlayEvent(ME_NOTEON, 0, 20, 127));
+      z->process(1, data, nullptr, nullptr);
+      SampleStreamer::instance()->sync();
+      z->process(frames - 1, data + 2, nullptr, nullptr);
+      z->play(Ms::PlayEvent(ME_NOTEON, 0, 20, 0));
+      }
+
+//---------------------------------------------------------
+//   testStreamedAudio
+//    streaming must not change the sound
+//---------------------------------------------------------
+
+void TestSfzStreaming::testStreamedAudio()
+      {
+      float data[2 * 110];
+      float streamData[2 * 110];
+      memset(data, 0, sizeof(data));
+      memset(streamData, 0, sizeof(streamData));
+      render(synth, data, 100);
+      render(streamSynth, streamData, 100);
+      QVERIFY(data[20 * 2] != 0.0f);
+      for (int i = 0; i < 2 * 100; ++i)
+            QCOMPARE(streamData[i], data[i]);
+      }
+
+//---------------------------------------------------------
+//   testHeadReuse
+//    a zone with a larger offset needs a longer head, it
+//    gets a new sample starting with the shorter head
+//---------------------------------------------------------
+
+void TestSfzStreaming::testHeadReuse()
+      {
+      Sample* head   = 0;
+      Sample* longer = 0;
+      for (Zone* z : offsetSynth->instrument(0)->zones())
+            (z->offset ? longer : head) = z->sample;
+      QVERIFY(head);
+      QVERIFY(longer);
+      QVERIFY(head != longer);
+      QCOMPARE(head->headFrames(), 44LL);
+      QCOMPARE(longer->headFrames(), 74LL);
+
+      Sample* s = synth->instrument(0)->zones().front()->sample;
+      QVERIFY(std::equal(head->data(), head->data() + 44 * s->channel(), s->data()));
+      QVERIFY(std::equal(longer->data(), longer->data() + 74 * s->channel(), s->data()));
+      }
+
+//---------------------------------------------------------
+//   testStreamRings
+//    only synthesizers with streamed samples have rings, a
+//    voice holds one while it plays
+//---------------------------------------------------------
+
+void TestSfzStreaming::testStreamRings()
+      {
+      float data[2 * 100];
+      QCOMPARE(synth->streamRings()->freeRings(), 0);
+      StreamRings* rings = streamSynth->streamRings();
+      streamSynth->process(100, data, nullptr, nullptr);
+      QCOMPARE(rings->freeRings(), StreamRings::RINGS);
+
+      streamSynth->play(Ms::PlayEvent(ME_NOTEON, 0, 21, 127));
+      streamSynth->process(1, data, nullptr, nullptr);
+      QCOMPARE(rings->freeRings(), StreamRings::RINGS - 1);
+
+      streamSynth->play(Ms::PlayEvent(ME_NOTEON, 0, 21, 0));
+      streamSynth->process(100, data, nullptr, nullptr);
+      QCOMPARE(rings->freeRings(), StreamRings::RINGS);
+      }
+
+TestSfzStreaming::~TestSfzStreaming()
+      {
+      delete offsetSynth;
+      delete streamSynth;
+      delete synth;
+      }
+
+QTEST_MAIN(TestSfzStreaming)
+
+#include "tst_sfzstreaming.moc"
@@ -0,0 +1,190 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+
+#include "zerberus/instrument.h"
+#include "zerberus/zerberus.h"
+#include "zerberus/zone.h"
+#include "zerberus/voice.h"
+#include "mscore/preferences.h"
+#include "synthesizer/event.h"
+
+using namespace Ms;
+
+static const int KEYS        = 100;
+static const int VELO_LAYERS = 20;
+
+//---------------------------------------------------------
+//   TestSfzZoneLookup
+//    instrument with 2000 regions, one for every
+//    key and velocity layer, and a few regions overlapping
+//    them
+//---------------------------------------------------------
+
+class TestSfzZoneLookup : public QObject, public MTest
+      {
+      Q_OBJECT
+      float samplerate = 44100;
+      QTemporaryDir dir;
+      Zerberus* synth;
+      ZInstrument* instr;
+
+      void chords(std::function<void(int key, int velo)> noteOn);
+
+   private slots:
+      void initTestCase();
+      void testZoneIndex();
+      void benchmarkNoteOn();
+      void benchmarkZoneScan();
+      void benchmarkZoneIndex();
+   public:
+      ~TestSfzZoneLookup();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestSfzZoneLookup::initTestCase()
+      {
+      initMTest();
+      QVERIFY(dir.isValid());
+      QVERIFY(QFile::copy(root + "/zerberus/sample.wav", dir.path() + "/sample.wav"));
+      QFile f(dir.path() + "/lookupTest.sfz");
+      QVERIFY(f.open(QIODevice::WriteOnly));
+      QTextStream os(&f);
+      for (int key = 24; key < 24 + KEYS; ++key) {
+            for (int layer = 0; layer < VELO_LAYERS; ++layer) {
+                  os << "<region> sample=sample.wav lokey=" << key << " hikey=" << key
+                     << " lovel=" << layer * 128 / VELO_LAYERS << " hivel=" << (layer + 1) * 128 / VELO_LAYERS - 1 << "\n";
+                  }
+            }
+      os << "<region> sample=sample.wav lokey=0 hikey=127 lovel=100 hivel=127\n";
+      os << "<region> sample=sample.wav lokey=60 hikey=71\n";
+      os << "<region> sample=sample.wav lokey=50 hikey=40\n";      // matches nothing
+      os << "<region> sample=sample.wav on_locc64=64 on_hicc64=127\n";
+      f.close();
+
+      preferences.setPreference(PREF_APP_PATHS_MYSOUNDFONTS, dir.path());
+      synth = new Zerberus();
+      synth->init(samplerate);
+      QVERIFY(synth->loadInstrument("lookupTest.sfz"));
+      instr = synth->instrument(0);
+      QVERIFY(instr);
+      QCOMPARE(instr->zones().size(), size_t(KEYS * VELO_LAYERS + 4));
+      }
+
+//---------------------------------------------------------
+//   testZoneIndex
+//    the index has to give exactly the zones a scan
+//    would find, in the same order
+//---------------------------------------------------------
+
+void TestSfzZoneLookup::testZoneIndex()
+      {
+      for (int key = 0; key < 128; ++key) {
+            for (int velo = 0; velo < 128; ++velo) {
+                  std::vector<Zone*> expected;
+                  for (Zone* z : instr->zones()) {
+                        if (z->trigger != Trigger::CC && z->keyLo <= key && key <= z->keyHi && z->veloLo <= velo && velo <= z->veloHi)
+                              expected.push_back(z);
+                        }
+                  ZoneRange r = instr->zones(key, velo);
+                  QCOMPARE(std::vector<Zone*>(r.begin(), r.end()), expected);
+                  }
+            }
+      QCOMPARE(instr->zones(-1, 64).size(), 0);
+      QCOMPARE(instr->ccZones().size(), 1);
+      QCOMPARE(*instr->ccZones().begin(), instr->zones().back());
+      }
+
+//---------------------------------------------------------
+//   chords
+//---------------------------------------------------------
+
+void TestSfzZoneLookup::chords(std::function<void(int key, int velo)> noteOn)
+      {
+      for (int velo = 10; velo < 128; velo += 20) {
+            for (int key = 24; key < 24 + KEYS - 12; key += 5) {
+                  for (int interval : { 0, 4, 7, 11 })
+                        noteOn(key + interval, velo);
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   benchmarkNoteOn
+//---------------------------------------------------------
+
+void TestSfzZoneLookup::benchmarkNoteOn()
+      {
+      float data[2];
+      QBENCHMARK {
+            chords([this, &data](int key, int velo) {
+                  synth->play(PlayEvent(ME_NOTEON, 0, key, velo));
+                  if (key % 2) {
+                        for (Voice* v = synth->getActiveVoices(); v; v = v->next())
+                              v->off();
+                        synth->process(1, data, nullptr, nullptr);
+                        }
+                  });
+            }
+      }
+
+//---------------------------------------------------------
+//   benchmarkZoneScan
+//    zone selection as done without the index
+//---------------------------------------------------------
+
+void TestSfzZoneLookup::benchmarkZoneScan()
+      {
+      Channel* c = synth->channel(0);
+      int n = 0;
+      QBENCHMARK {
+            chords([this, c, &n](int key, int velo) {
+                  for (Zone* z : instr->zones())
+                        n += z->match(c, key, velo, Trigger::ATTACK, 0.5, -1, -1);
+                  });
+            }
+      QVERIFY(n > 0);
+      }
+
+//---------------------------------------------------------
+//   benchmarkZoneIndex
+//---------------------------------------------------------
+
+void TestSfzZoneLookup::benchmarkZoneIndex()
+      {
+      Channel* c = synth->channel(0);
+      int n = 0;
+      QBENCHMARK {
+            chords([this, c, &n](int key, int velo) {
+                  for (Zone* z : instr->zones(key, velo))
+                        n += z->match(c, key, velo, Trigger::ATTACK, 0.5, -1, -1);
+                  });
+            }
+      QVERIFY(n > 0);
+      }
+
+//---------------------------------------------------------
+//   ~TestSfzZoneLookup
+//---------------------------------------------------------
+
+TestSfzZoneLookup::~TestSfzZoneLookup()
+      {
+      delete synth;
+      }
+
+QTEST_MAIN(TestSfzZoneLookup)
+
+#include "tst_sfzzonelookup.moc"
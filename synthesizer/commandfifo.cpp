@@ -0,0 +1,108 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2018 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QThread>
+#include "commandfifo.h"
+
+namespace Ms {
+
+// true while a thread executes commands, commands issued
+// by a command are executed at once
+static thread_local bool executing = false;
+
+// poll interval of a writer waiting for a free slot or for
+// its command to be done, in microseconds
+static const unsigned long POLL = 200;
+
+//---------------------------------------------------------
+//   execute
+//---------------------------------------------------------
+
+void SynthCommandFifo::execute(const std::function<void()>& fn)
+      {
+      // the audio thread cannot wait for itself, e.g. for all
+      // notes off sent by Seq::process() while seeking
+      if (executing || (_realtime && _audioThread.load(std::memory_order_relaxed) == QThread::currentThreadId())) {
+            fn();
+            return;
+            }
+      std::atomic<bool> done { false };
+      for (;;) {
+            {
+            QMutexLocker locker(&mutex);
+            if (!_realtime) {
+                  executing = true;
+                  fn();
+                  executing = false;
+                  return;
+                  }
+            if (!isFull()) {
+                  commands[widx] = Command { &fn, &done };
+                  push();
+                  break;
+                  }
+            }
+            // wait for a free slot without holding the mutex
+            QThread::usleep(POLL);
+            }
+      while (!done.load(std::memory_order_acquire))
+            QThread::usleep(POLL);
+      }
+
+//---------------------------------------------------------
+//   process
+//    audio thread, called at the start of every block
+//---------------------------------------------------------
+
+void SynthCommandFifo::process()
+      {
+      setAudioThread();
+      runCommands();
+      }
+
+//---------------------------------------------------------
+//   runCommands
+//---------------------------------------------------------
+
+void SynthCommandFifo::runCommands()
+      {
+      if (empty())
+            return;
+      executing = true;
+      while (!empty()) {
+            Command c = commands[ridx];
+            pop();
+            (*c.fn)();
+            c.done->store(true, std::memory_order_release);
+            }
+      executing = false;
+      }
+
+//---------------------------------------------------------
+//   setRealtime
+//    Called when the audio thread starts or has stopped
+//    calling process(). Commands still in the fifo are
+//    executed by the calling thread.
+//---------------------------------------------------------
+
+void SynthCommandFifo::setRealtime(bool val)
+      {
+      QMutexLocker locker(&mutex);
+      _realtime = val;
+      if (!val) {
+            runCommands();
+            _audioThread = 0;
+            }
+      }
+
+}
+
@@ -0,0 +1,63 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2018 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __COMMANDFIFO_H__
+#define __COMMANDFIFO_H__
+
+#include <atomic>
+#include <functional>
+#include <QMutex>
+#include <QThread>
+#include "libmscore/fifo.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   SynthCommandFifo
+//    Changes of the synthesizer state made by other
+//    threads are executed by the audio thread before it
+//    renders the next block, so it never has to wait for
+//    a lock. Any thread may call execute(), which returns
+//    when the command is done. Writers are serialized by
+//    a mutex, the audio thread is the only reader. It
+//    never blocks: it signals a done command by an atomic
+//    flag the writer polls.
+//    If no audio thread is running, or if the audio thread
+//    itself calls execute(), commands are executed directly.
+//---------------------------------------------------------
+
+class SynthCommandFifo : public FifoBase {
+      static const int SIZE = 64;
+
+      struct Command {
+            const std::function<void()>* fn;
+            std::atomic<bool>* done;
+            };
+      Command commands[SIZE];
+      QMutex mutex { QMutex::Recursive };
+      std::atomic<bool> _realtime { false };
+      std::atomic<Qt::HANDLE> _audioThread { 0 };
+
+      void runCommands();
+
+   public:
+      SynthCommandFifo()        { maxCount = SIZE; clear(); }
+      void execute(const std::function<void()>&);
+      void process();
+      void setRealtime(bool);
+      bool realtime() const     { return _realtime; }
+      void setAudioThread()     { _audioThread.store(QThread::currentThreadId(), std::memory_order_relaxed); }
+      };
+
+}
+#endif
+
@@ -29,6 +29,7 @@ extern QString dataPath;
 MasterSynthesizer::MasterSynthesizer()
    : QObject(0)
       {
+      _renderPool = new RenderPool;
       }
 
 //---------------------------------------------------------
@@ -71,6 +72,27 @@ MasterSynthesizer::~MasterSynthesizer()
                   delete e;
             // delete _effect[i];   // _effect takes from _effectList
             }
+      delete _renderPool;
+      }
+
+//---------------------------------------------------------
+//   setRenderThreads
+//    render the voices on n threads, including the audio
+//    thread; the output does not depend on n
+//---------------------------------------------------------
+
+void MasterSynthesizer::setRenderThreads(int n)
+      {
+      if (n == _renderPool->threads())
+            return;
+      RenderPool* pool = new RenderPool(n);
+      RenderPool* old  = _renderPool;
+      commands.execute([this, pool] {
+            _renderPool = pool;
+            for (Synthesizer* s : _synthesizer)
+                  s->setRenderPool(pool);
+            });
+      delete old;
       }
 
 //---------------------------------------------------------
@@ -176,6 +198,8 @@ Synthesizer* MasterSynthesizer::synthesizer(const QString& name)
 
 void MasterSynthesizer::registerSynthesizer(Synthesizer* s)
       {
+      s->setCommandFifo(&commands);
+      s->setRenderPool(_renderPool);
       _synthesizer.push_back(s);
       }
 
@@ -198,15 +222,7 @@ void MasterSynthesizer::setEffect(int ab, int idx)
             qDebug("MasterSynthesizer::setEffect: bad idx %d %d", ab, idx);
             return;
             }
-      lock2 = true;
-      while(lock1)
-#if (!defined (_MSCVER) && !defined (_MSC_VER))
-         sleep(1);
-#else
-         Sleep(1000);      // MS-equivalent function, time in ms instead of seconds.
-#endif
-      _effect[ab] = _effectList[ab][idx];
-      lock2 = false;
+      commands.execute([this, ab, idx]() { _effect[ab] = _effectList[ab][idx]; });
       }
 
 //---------------------------------------------------------
@@ -233,8 +249,6 @@ void MasterSynthesizer::setSampleRate(float val)
             e->init(_sampleRate);
       for (Effect* e : _effectList[1])
             e->init(_sampleRate);
-      lock2 = false;
-      lock1 = false;
       }
 
 //---------------------------------------------------------
@@ -243,13 +257,7 @@ void MasterSynthesizer::setSampleRate(float val)
 
 void MasterSynthesizer::process(unsigned n, float* p)
       {
-      if (lock2)
-            return;
-      lock1 = true;
-      if (lock2) {
-            lock1 = false;
-            return;
-            }
+      commands.process();
       // avoid overflow
       if (n > MAX_BUFFERSIZE / 2)
             return;
@@ -273,7 +281,6 @@ void MasterSynthesizer::process(unsigned n, float* p)
       float g = _gain * _boost;
       for (unsigned i = 0; i < n * 2; ++i)
             *p++ *= g;
-      lock1 = false;
       }
 
 //---------------------------------------------------------
@@ -337,9 +344,9 @@ bool MasterSynthesizer::setState(const SynthesizerState& ss)
                         }
                   else {
                         if (effect(0) && effect(0)->name() == g.name())
-                              effect(0)->setState(g);
+                              commands.execute([this, &g]() { effect(0)->setState(g); });
                         else if (effect(1) && effect(1)->name() == g.name())
-                              effect(1)->setState(g);
+                              commands.execute([this, &g]() { effect(1)->setState(g); });
                         else
                               qDebug("MasterSynthesizer::setState: unknown <%s>", qPrintable(g.name()));
                         }
@@ -408,8 +415,10 @@ void MasterSynthesizer::setGain(float f)
 void MasterSynthesizer::setMasterTuning(double val)
       {
       _masterTuning = val;
-      for (Synthesizer* s : _synthesizer)
-            s->setMasterTuning(_masterTuning);
+      commands.execute([this]() {
+            for (Synthesizer* s : _synthesizer)
+                  s->setMasterTuning(_masterTuning);
+            });
       }
 }
 
@@ -16,6 +16,8 @@
 #include <atomic>
 #include "effects/effect.h"
 #include "libmscore/synthesizerstate.h"
+#include "commandfifo.h"
+#include "renderpool.h"
 
 namespace Ms {
 
@@ -42,8 +44,8 @@ class MasterSynthesizer : public QObject {
       static const int MAX_EFFECTS = 2;
 
    private:
-      std::atomic<bool> lock1      { false };
-      std::atomic<bool> lock2      { true  };
+      SynthCommandFifo commands;
+      RenderPool* _renderPool;
       std::vector<Synthesizer*> _synthesizer;
       std::vector<Effect*> _effectList[MAX_EFFECTS];
       Effect* _effect[MAX_EFFECTS]  { nullptr, nullptr };
@@ -73,6 +75,10 @@ class MasterSynthesizer : public QObject {
       void setSampleRate(float val);
 
       void process(unsigned, float*);
+      void setRealtime(bool val)    { commands.setRealtime(val); }
+      void setAudioThread()         { commands.setAudioThread(); }
+      void setRenderThreads(int);
+      int renderThreads() const     { return _renderPool->threads(); }
       void play(const NPlayEvent&, unsigned);
 
       void setMasterTuning(double val);
@@ -0,0 +1,232 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2018 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <string.h>
+#include <QThread>
+#include "renderpool.h"
+
+namespace Ms {
+
+static const int STRIDE = RenderPool::MAX_FRAMES * 2;    // floats of a scratch buffer
+
+//---------------------------------------------------------
+//   Worker
+//---------------------------------------------------------
+
+class RenderPool::Worker : public QThread {
+      RenderPool* pool;
+
+      virtual void run() override { pool->work(); }
+
+   public:
+      Worker(RenderPool* p) : pool(p) {}
+      };
+
+//---------------------------------------------------------
+//   RenderPool
+//    threads includes the calling thread
+//---------------------------------------------------------
+
+RenderPool::RenderPool(int threads)
+      {
+      scratch.resize(MAX_GROUPS * 3 * STRIDE);
+      for (auto& p : progress)
+            p.store(0, std::memory_order_relaxed);
+      for (int i = 1; i < qMin(threads, int(MAX_GROUPS)); ++i) {
+            Worker* w = new Worker(this);
+            workers.push_back(w);
+            w->start(QThread::TimeCriticalPriority);
+            }
+      }
+
+//---------------------------------------------------------
+//   ~RenderPool
+//---------------------------------------------------------
+
+RenderPool::~RenderPool()
+      {
+      mutex.lock();
+      quit = true;
+      mutex.unlock();
+      wake.wakeAll();
+      for (Worker* w : workers) {
+            w->wait();
+            delete w;
+            }
+      }
+
+//---------------------------------------------------------
+//   defaultThreads
+//---------------------------------------------------------
+
+int RenderPool::defaultThreads()
+      {
+      return qBound(1, QThread::idealThreadCount(), int(MAX_GROUPS));
+      }
+
+//---------------------------------------------------------
+//   renderGroup
+//    claim the next group of job and render it, return
+//    false if there is none left
+//---------------------------------------------------------
+
+bool RenderPool::renderGroup(unsigned j)
+      {
+      unsigned long long s = state.load(std::memory_order_acquire);
+      int g;
+      do {
+            if (unsigned(s >> 32) != j)
+                  return false;
+            g = int((s >> 16) & 0xffff);
+            if (g >= int(s & 0xffff))
+                  return false;
+            } while (!state.compare_exchange_weak(s, pack(j, g + 1, int(s & 0xffff)),
+               std::memory_order_acq_rel, std::memory_order_acquire));
+      renderSteps(j, g, 0);
+      return true;
+      }
+
+//---------------------------------------------------------
+//   renderSteps
+//    Render group g of job j from step on, as long as no
+//    other thread takes the steps over. Step 0 clears the
+//    scratch buffers of the group, step i renders its
+//    voice i - 1. The steps of a group are done one after
+//    the other, so the sum does not depend on the thread.
+//---------------------------------------------------------
+
+void RenderPool::renderSteps(unsigned j, int g, int step)
+      {
+      float* out = scratch.data() + g * 3 * STRIDE;
+      float* e1  = effect1 ? out + STRIDE : 0;
+      float* e2  = effect2 ? out + 2 * STRIDE : 0;
+      int first  = g * voices / groups;
+      int steps  = (g + 1) * voices / groups - first + 1;
+      for (; step < steps; ++step) {
+            unsigned long long idle = packStep(j, step, false);
+            if (!progress[g].compare_exchange_strong(idle, packStep(j, step, true),
+               std::memory_order_acq_rel, std::memory_order_acquire))
+                  return;
+            if (step == 0) {
+                  memset(out, 0, frames * 2 * sizeof(float));
+                  if (e1)
+                        memset(e1, 0, frames * 2 * sizeof(float));
+                  if (e2)
+                        memset(e2, 0, frames * 2 * sizeof(float));
+                  }
+            else
+                  (*fn)(first + step - 1, frames, out, e1, e2);
+            progress[g].store(packStep(j, step + 1, false), std::memory_order_release);
+            if (step + 1 == steps)
+                  finished.release();
+            }
+      }
+
+//---------------------------------------------------------
+//   takeOver
+//    calling thread, render the steps of job j the workers
+//    did not get to in time
+//---------------------------------------------------------
+
+void RenderPool::takeOver(unsigned j)
+      {
+      for (int g = 0; g < groups; ++g) {
+            unsigned long long p = progress[g].load(std::memory_order_acquire);
+            if (!(p & 1))
+                  renderSteps(j, g, int((p & 0xffffffff) >> 1));
+            }
+      }
+
+//---------------------------------------------------------
+//   work
+//    worker thread
+//---------------------------------------------------------
+
+void RenderPool::work()
+      {
+      mutex.lock();
+      unsigned seen = job;
+      mutex.unlock();
+      for (;;) {
+            mutex.lock();
+            while (!quit && job == seen)
+                  wake.wait(&mutex);
+            bool stop = quit;
+            seen = job;
+            mutex.unlock();
+            if (stop)
+                  return;
+            while (renderGroup(seen))
+                  ;
+            }
+      }
+
+//---------------------------------------------------------
+//   render
+//    add nvoices voices to out, effect1 and effect2, which
+//    may be null
+//---------------------------------------------------------
+
+void RenderPool::render(int nvoices, unsigned n, float* out, float* e1, float* e2, const RenderFn& f)
+      {
+      if (nvoices <= 0)
+            return;
+      while (n > unsigned(MAX_FRAMES)) {
+            render(nvoices, MAX_FRAMES, out, e1, e2, f);
+            n   -= MAX_FRAMES;
+            out += STRIDE;
+            if (e1)
+                  e1 += STRIDE;
+            if (e2)
+                  e2 += STRIDE;
+            }
+      int ngroups = qBound(1, nvoices / GROUP_SIZE, int(MAX_GROUPS));
+      fn      = &f;
+      voices  = nvoices;
+      groups  = ngroups;
+      frames  = n;
+      effect1 = e1;
+      effect2 = e2;
+      unsigned j = ++jobs;
+      for (int g = 0; g < ngroups; ++g)
+            progress[g].store(packStep(j, 0, false), std::memory_order_relaxed);
+      state.store(pack(j, 0, ngroups), std::memory_order_release);
+      if (ngroups > 1 && !workers.empty()) {
+            mutex.lock();
+            job = j;
+            mutex.unlock();
+            wake.wakeAll();
+            }
+      while (renderGroup(j))
+            ;
+      // the remaining groups are in progress, take over what
+      // the workers do not render in time
+      while (!finished.tryAcquire(ngroups, WAIT_MS))
+            takeOver(j);
+
+      for (int g = 0; g < ngroups; ++g) {
+            const float* p = scratch.data() + g * 3 * STRIDE;
+            for (unsigned i = 0; i < n * 2; ++i)
+                  out[i] += p[i];
+            if (e1) {
+                  for (unsigned i = 0; i < n * 2; ++i)
+                        e1[i] += p[STRIDE + i];
+                  }
+            if (e2) {
+                  for (unsigned i = 0; i < n * 2; ++i)
+                        e2[i] += p[2 * STRIDE + i];
+                  }
+            }
+      }
+
+}
+
@@ -0,0 +1,100 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2018 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __RENDERPOOL_H__
+#define __RENDERPOOL_H__
+
+#include <atomic>
+#include <functional>
+#include <vector>
+#include <QMutex>
+#include <QSemaphore>
+#include <QWaitCondition>
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   RenderPool
+//    Renders the voices of a synthesizer on worker threads.
+//    The voices are split into groups in list order, which
+//    only depends on the number of voices. Every group is
+//    rendered into its own scratch buffers and the groups
+//    are added to the output in order, so the result does
+//    not depend on the number of threads or on which thread
+//    rendered a group.
+//    The calling thread renders groups too and then waits
+//    up to WAIT_MS at a time for the groups the workers
+//    started. A group is rendered in steps, one voice at a
+//    time, and after each timeout the calling thread takes
+//    over the remaining steps of every group, so it only
+//    waits for voices which are being rendered.
+//    If the workers are not scheduled in time, the calling
+//    thread renders all groups itself.
+//---------------------------------------------------------
+
+class RenderPool {
+   public:
+      // render voice into out, effect1 and effect2 (which may be null)
+      typedef std::function<void(int voice, unsigned frames, float* out, float* effect1, float* effect2)> RenderFn;
+
+      static const int MAX_FRAMES  = 4096;
+      static const int MAX_GROUPS  = 32;
+      static const int GROUP_SIZE  = 4;         // minimum voices per group
+      static const int WAIT_MS     = 1;         // wait for the workers before taking over
+
+   private:
+      class Worker;
+
+      std::vector<Worker*> workers;
+      QMutex mutex;                             // protects job and quit
+      QWaitCondition wake;
+      unsigned job  { 0 };                      // last job the workers were woken for
+      bool quit     { false };
+      unsigned jobs { 0 };                      // jobs started, calling thread only
+
+      // the current job, written by the calling thread before
+      // it publishes the job in state
+      const RenderFn* fn { 0 };
+      int voices         { 0 };
+      int groups         { 0 };
+      unsigned frames    { 0 };
+      bool effect1       { false };
+      bool effect2       { false };
+      std::vector<float> scratch;               // out, effect1, effect2 of every group
+
+      std::atomic<unsigned long long> state { 0 };    // job, next group, groups
+      std::atomic<unsigned long long> progress[MAX_GROUPS];   // job, next step, busy
+      QSemaphore finished;                            // released once per rendered group
+
+      static unsigned long long pack(unsigned job, int next, int groups) {
+            return ((unsigned long long)job << 32) | ((unsigned long long)next << 16) | (unsigned long long)groups;
+            }
+      static unsigned long long packStep(unsigned job, int step, bool busy) {
+            return ((unsigned long long)job << 32) | ((unsigned long long)step << 1) | (busy ? 1 : 0);
+            }
+      bool renderGroup(unsigned job);
+      void renderSteps(unsigned job, int group, int step);
+      void takeOver(unsigned job);
+      void work();
+
+   public:
+      RenderPool(int threads = 1);
+      ~RenderPool();
+      int threads() const           { return int(workers.size()) + 1; }
+      void render(int voices, unsigned frames, float* out, float* effect1, float* effect2, const RenderFn&);
+
+      static int defaultThreads();
+      };
+
+}
+#endif
+
@@ -14,6 +14,8 @@
 #define __SYNTHESIZER_H__
 
 #include "libmscore/synthesizerstate.h"
+#include "commandfifo.h"
+#include "renderpool.h"
 
 namespace Ms {
 
@@ -28,11 +30,32 @@ class SynthesizerGui;
 
 class Synthesizer {
       bool _active;
+      SynthCommandFifo* _commands { 0 };
+      RenderPool* _renderPool     { 0 };
 
    protected:
       float _sampleRate;
       SynthesizerGui* _gui;
 
+      // run fn in the audio thread if there is one, see SynthCommandFifo
+      void execute(const std::function<void()>& fn) {
+            if (_commands)
+                  _commands->execute(fn);
+            else
+                  fn();
+            }
+
+      // add voices 0 to n-1 rendered by fn to the buffers, on the
+      // threads of the render pool if there is one
+      void renderVoices(int n, unsigned frames, float* out, float* effect1, float* effect2, const RenderPool::RenderFn& fn) {
+            if (_renderPool)
+                  _renderPool->render(n, frames, out, effect1, effect2, fn);
+            else {
+                  for (int i = 0; i < n; ++i)
+                        fn(i, frames, out, effect1, effect2);
+                  }
+            }
+
    public:
       Synthesizer() : _active(false) { _gui = 0; }
       virtual ~Synthesizer() {}
@@ -69,6 +92,8 @@ class Synthesizer {
       virtual void allNotesOff(int /*channel*/) {}
 
       virtual SynthesizerGui* gui()  { return _gui; }
+      void setCommandFifo(SynthCommandFifo* f) { _commands = f; }
+      void setRenderPool(RenderPool* p)        { _renderPool = p; }
       };
 
 }
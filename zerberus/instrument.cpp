@@ -17,6 +17,7 @@
 #include <QStringList>
 
 #include "libmscore/xml.h"
+#include "mscore/preferences.h"
 #include "audiofile/audiofile.h"
 #include "thirdparty/qzip/qzipreader_p.h"
 
@@ -27,66 +28,31 @@
 QByteArray ZInstrument::buf;
 int ZInstrument::idx;
 
-//---------------------------------------------------------
-//   Sample
-//---------------------------------------------------------
-
-Sample::~Sample()
-      {
-      delete[] _data;
-      }
-
 //---------------------------------------------------------
 //   readSample
+//    Samples of files are shared by all instruments, see
+//    SampleCache. offset and loopEnd of the region tell
+//    which part has to be in memory if the sample is
+//    streamed.
 //---------------------------------------------------------
 
-Sample* ZInstrument::readSample(const QString& s, MQZipReader* uz)
+Sample* ZInstrument::readSample(const QString& s, MQZipReader* uz, long long offset, long long loopEnd)
       {
-      if (uz) {
-            QVector<MQZipReader::FileInfo> fi = uz->fileInfoList();
+      if (!uz)
+            return SampleCache::instance()->sample(s, offset, loopEnd, Ms::preferences.getInt(PREF_IO_ZERBERUS_PRELOADTIME));
 
-            buf = uz->fileData(s);
-            if (buf.isEmpty()) {
-                  printf("Sample::read: cannot read sample data <%s>\n", qPrintable(s));
-                  return 0;
-                  }
-            }
-      else {
-            QFile f(s);
-            if (!f.open(QIODevice::ReadOnly)) {
-                  printf("Sample::read: open <%s> failed\n", qPrintable(s));
-                  return 0;
-                  }
-            buf = f.readAll();
+      buf = uz->fileData(s);
+      if (buf.isEmpty()) {
+            printf("Sample::read: cannot read sample data <%s>\n", qPrintable(s));
+            return 0;
             }
-
       AudioFile a;
       if (!a.open(buf)) {
             printf("open <%s> failed: %s\n", qPrintable(s), a.error());
             return 0;
             }
-
-      int channel = a.channels();
-      sf_count_t frames  = a.frames();
-      int sr      = a.samplerate();
-
-      short* data = new short[(frames + 3) * channel];
-      Sample* sa  = new Sample(channel, data, frames, sr);
-      sa->setLoopStart(a.loopStart());
-      sa->setLoopEnd(a.loopEnd());
-      sa->setLoopMode(a.loopMode());
-
-      if (frames != a.readData(data + channel, frames)) {
-            qDebug("Sample read failed: %s\n", a.error());
-            delete sa;
-            sa = 0;
-            }
-      for (int i = 0; i < channel; ++i) {
-            data[i]                        = data[channel + i];
-            data[(frames-1) * channel + i] = data[(frames-3) * channel + i];
-            data[(frames-2) * channel + i] = data[(frames-3) * channel + i];
-            }
-      return sa;
+      Sample* sa = Sample::read(a, s, -1);
+      return sa ? SampleCache::instance()->add(sa) : 0;
       }
 
 //---------------------------------------------------------
@@ -98,6 +64,8 @@ ZInstrument::ZInstrument(Zerberus* z)
       zerberus  = z;
       for (int i =0; i < 128; i++)
             _setcc[i] = -1;
+      memset(_cell, 0, sizeof(_cell));
+      _cellStart.assign(2, 0);
       _program  = -1;
       _refCount = 0;
       }
@@ -112,6 +80,20 @@ ZInstrument::~ZInstrument()
             delete z;
       }
 
+//---------------------------------------------------------
+//   streamed
+//    true if a sample of the instrument is streamed
+//---------------------------------------------------------
+
+bool ZInstrument::streamed() const
+      {
+      for (const Zone* z : _zones) {
+            if (z->sample && z->sample->streamed())
+                  return true;
+            }
+      return false;
+      }
+
 //---------------------------------------------------------
 //   load
 //    return true on success
@@ -122,12 +104,102 @@ bool ZInstrument::load(const QString& path)
       instrumentPath = path;
       QFileInfo fi(path);
       _name = fi.completeBaseName();
+      bool ok;
       if (fi.isFile())
-            return loadFromFile(path);
-      if (fi.isDir())
-            return loadFromDir(path);
-      qDebug("not file nor dir %s", qPrintable(path));
-      return false;
+            ok = loadFromFile(path);
+      else if (fi.isDir())
+            ok = loadFromDir(path);
+      else {
+            qDebug("not file nor dir %s", qPrintable(path));
+            return false;
+            }
+      buildZoneIndex();
+      return ok;
+      }
+
+//---------------------------------------------------------
+//   bands
+//    split 0-127 at the given borders, band[i] is the
+//    band of value i, return the number of bands
+//---------------------------------------------------------
+
+static int bands(const std::vector<bool>& border, int* band)
+      {
+      int n = 0;
+      for (int i = 0; i < 128; ++i) {
+            if (i && border[i])
+                  ++n;
+            band[i] = n;
+            }
+      return n + 1;
+      }
+
+//---------------------------------------------------------
+//   buildZoneIndex
+//    A zone is added to every cell its key and velocity
+//    range covers, zones with an empty range to none.
+//---------------------------------------------------------
+
+void ZInstrument::buildZoneIndex()
+      {
+      std::vector<bool> keyBorder(129, false);
+      std::vector<bool> veloBorder(129, false);
+      for (Zone* z : _zones) {
+            if (z->trigger == Trigger::CC || z->keyLo > z->keyHi || z->veloLo > z->veloHi)
+                  continue;
+            keyBorder[qBound(0, int(z->keyLo), 128)]      = true;
+            keyBorder[qBound(0, z->keyHi + 1, 128)]       = true;
+            veloBorder[qBound(0, int(z->veloLo), 128)]    = true;
+            veloBorder[qBound(0, z->veloHi + 1, 128)]     = true;
+            }
+      int keyBand[128];
+      int veloBand[128];
+      int keyBands  = bands(keyBorder, keyBand);
+      int veloBands = bands(veloBorder, veloBand);
+
+      std::vector<std::vector<Zone*>> cells(keyBands * veloBands);
+      _ccZones.clear();
+      for (Zone* z : _zones) {
+            if (z->trigger == Trigger::CC) {
+                  _ccZones.push_back(z);
+                  continue;
+                  }
+            int keyLo  = qMax(0, int(z->keyLo));
+            int keyHi  = qMin(127, int(z->keyHi));
+            int veloLo = qMax(0, int(z->veloLo));
+            int veloHi = qMin(127, int(z->veloHi));
+            if (keyLo > keyHi || veloLo > veloHi)
+                  continue;
+            for (int k = keyBand[keyLo]; k <= keyBand[keyHi]; ++k) {
+                  for (int v = veloBand[veloLo]; v <= veloBand[veloHi]; ++v)
+                        cells[k * veloBands + v].push_back(z);
+                  }
+            }
+
+      _cellStart.clear();
+      _cellZones.clear();
+      for (const std::vector<Zone*>& c : cells) {
+            _cellStart.push_back(int(_cellZones.size()));
+            _cellZones.insert(_cellZones.end(), c.begin(), c.end());
+            }
+      _cellStart.push_back(int(_cellZones.size()));
+      for (int key = 0; key < 128; ++key) {
+            for (int velo = 0; velo < 128; ++velo)
+                  _cell[key][velo] = keyBand[key] * veloBands + veloBand[velo];
+            }
+      }
+
+//---------------------------------------------------------
+//   zones
+//    zones which may match key and velo
+//---------------------------------------------------------
+
+ZoneRange ZInstrument::zones(int key, int velo) const
+      {
+      if (key < 0 || key > 127 || velo < 0 || velo > 127)
+            return ZoneRange(0, 0);
+      int cell = _cell[key][velo];
+      return ZoneRange(_cellZones.data() + _cellStart[cell], _cellZones.data() + _cellStart[cell + 1]);
       }
 
 //---------------------------------------------------------
@@ -14,6 +14,7 @@
 #define __MINSTRUMENT_H__
 
 #include <list>
+#include <vector>
 #include <QString>
 
 class Zerberus;
@@ -23,8 +24,28 @@ struct Zone;
 struct SfzRegion;
 class Sample;
 
+//---------------------------------------------------------
+//   ZoneRange
+//---------------------------------------------------------
+
+class ZoneRange {
+      Zone* const* _begin;
+      Zone* const* _end;
+
+   public:
+      ZoneRange(Zone* const* b, Zone* const* e) : _begin(b), _end(e) {}
+      Zone* const* begin() const { return _begin; }
+      Zone* const* end() const   { return _end;   }
+      int size() const           { return int(_end - _begin); }
+      };
+
 //---------------------------------------------------------
 //   ZInstrument
+//    Every key/velocity pair is mapped to a cell of
+//    zones which can match it. Cells are formed by the
+//    key and velocity borders of all zones, the zones of
+//    all cells are stored in one vector, in the order of
+//    _zones.
 //---------------------------------------------------------
 
 class ZInstrument {
@@ -36,6 +57,12 @@ class ZInstrument {
       std::list<Zone*> _zones;
       int _setcc[128];
 
+      unsigned short _cell[128][128];     // key, velocity -> cell
+      std::vector<int> _cellStart;        // cell -> first zone in _cellZones, one extra entry
+      std::vector<Zone*> _cellZones;
+      std::vector<Zone*> _ccZones;        // zones triggered by controllers
+
+      void buildZoneIndex();
       bool loadFromFile(const QString&);
       bool loadSfz(const QString&);
       bool loadFromDir(const QString&);
@@ -53,7 +80,10 @@ class ZInstrument {
       QString path() const                  { return instrumentPath; }
       const std::list<Zone*>& zones() const { return _zones;  }
       std::list<Zone*>& zones()             { return _zones;  }
-      Sample* readSample(const QString& s, MQZipReader* uz);
+      ZoneRange zones(int key, int velo) const;
+      bool streamed() const;
+      ZoneRange ccZones() const             { return ZoneRange(_ccZones.data(), _ccZones.data() + _ccZones.size()); }
+      Sample* readSample(const QString& s, MQZipReader* uz, long long offset = 0, long long loopEnd = -1);
       void addZone(Zone* z)                 { _zones.push_back(z); }
       void addRegion(SfzRegion&);
       int getSetCC(int v)                   { return _setcc[v]; }
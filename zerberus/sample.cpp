@@ -0,0 +1,449 @@
+//=============================================================================
+//  Zerberus
+//  Zample player
+//
+//  Copyright (C) 2013 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <stdio.h>
+#include <algorithm>
+#include <QFile>
+
+#include "audiofile/audiofile.h"
+
+#include "sample.h"
+
+static const int STREAM_CHUNK = 4096;     // frames read at once by the streamer
+
+//---------------------------------------------------------
+//   Sample
+//---------------------------------------------------------
+
+Sample::~Sample()
+      {
+      if (streamed())
+            SampleStreamer::instance()->removeSample(this);
+      delete[] _data;
+      }
+
+//---------------------------------------------------------
+//   read
+//    read the first headFrames frames of an opened audio
+//    file or all frames if headFrames is negative or not
+//    smaller than the file. The frames of a shorter head
+//    of the same file are copied, not read again.
+//---------------------------------------------------------
+
+Sample* Sample::read(AudioFile& a, const QString& name, long long headFrames, const Sample* head)
+      {
+      int channel = a.channels();
+      sf_count_t frames  = a.frames();
+      int sr      = a.samplerate();
+      if (headFrames < 0 || headFrames >= frames)
+            headFrames = frames;
+
+      short* data = new short[(headFrames + 3) * channel];
+      Sample* sa  = new Sample(channel, data, frames, sr);
+      sa->setLoopStart(a.loopStart());
+      sa->setLoopEnd(a.loopEnd());
+      sa->setLoopMode(a.loopMode());
+
+      long long done = 0;
+      if (head && head->_channel == channel && head->_headFrames < headFrames) {
+            done = head->_headFrames;
+            memcpy(data + channel, head->_data + channel, done * channel * sizeof(short));
+            if (!a.seekFrame(done)) {
+                  qDebug("Sample seek failed: %s\n", a.error());
+                  delete sa;
+                  return 0;
+                  }
+            }
+      if (headFrames - done != a.readData(data + channel + done * channel, headFrames - done)) {
+            qDebug("Sample read failed: %s\n", a.error());
+            delete sa;
+            return 0;
+            }
+      if (headFrames < frames) {
+            sa->_headFrames = headFrames;
+            sa->_path       = name;
+            for (int i = 0; i < channel; ++i)
+                  data[i] = data[channel + i];
+            SampleStreamer::instance()->addSample(sa);
+            return sa;
+            }
+      for (int i = 0; i < channel; ++i) {
+            data[i]                        = data[channel + i];
+            data[(frames-1) * channel + i] = data[(frames-3) * channel + i];
+            data[(frames-2) * channel + i] = data[(frames-3) * channel + i];
+            }
+      return sa;
+      }
+
+//---------------------------------------------------------
+//   instance
+//---------------------------------------------------------
+
+SampleCache* SampleCache::instance()
+      {
+      static SampleCache cache;
+      return &cache;
+      }
+
+//---------------------------------------------------------
+//   sample
+//    Return the sample of file path, shared with other
+//    zones if possible. With a preloadTime (ms), only the
+//    frames from the start up to offset + preloadTime and
+//    up to loopEnd are read, the rest is streamed.
+//---------------------------------------------------------
+
+Sample* SampleCache::sample(const QString& path, long long offset, long long loopEnd, int preloadTime)
+      {
+      QMutexLocker locker(&mutex);
+      auto i = samples.find(path);
+      if (i != samples.end() && !i->second->streamed()) {
+            ++i->second->_refCount;
+            return i->second;
+            }
+
+      AudioFile a;
+      Sample* sa = 0;
+      if (preloadTime > 0) {
+            if (!a.open(path)) {
+                  printf("open <%s> failed: %s\n", qPrintable(path), a.error());
+                  return 0;
+                  }
+            long long headFrames = offset + (long long)a.samplerate() * preloadTime / 1000;
+            if (loopEnd < 0)
+                  loopEnd = int(a.loopEnd());
+            // the looped part is always in memory, it cannot be streamed
+            if (loopEnd > 0)
+                  headFrames = qMax(headFrames, loopEnd + 4);
+            if (i != samples.end() && i->second->headFrames() >= headFrames) {
+                  ++i->second->_refCount;
+                  return i->second;
+                  }
+            sa = Sample::read(a, path, headFrames, i != samples.end() ? i->second : 0);
+            }
+      else {
+            QFile f(path);
+            if (!f.open(QIODevice::ReadOnly)) {
+                  printf("Sample::read: open <%s> failed\n", qPrintable(path));
+                  return 0;
+                  }
+            if (!a.open(f.readAll())) {
+                  printf("open <%s> failed: %s\n", qPrintable(path), a.error());
+                  return 0;
+                  }
+            sa = Sample::read(a, path, -1);
+            }
+      if (!sa)
+            return 0;
+      // a sample with a shorter head stays alive as long as its zones
+      samples[path] = sa;
+      sa->_refCount = 1;
+      return sa;
+      }
+
+//---------------------------------------------------------
+//   add
+//    add a sample which is not shared
+//---------------------------------------------------------
+
+Sample* SampleCache::add(Sample* sa)
+      {
+      QMutexLocker locker(&mutex);
+      sa->_refCount = 1;
+      return sa;
+      }
+
+//---------------------------------------------------------
+//   release
+//---------------------------------------------------------
+
+void SampleCache::release(Sample* sa)
+      {
+      QMutexLocker locker(&mutex);
+      if (--sa->_refCount > 0)
+            return;
+      for (auto i = samples.begin(); i != samples.end(); ++i) {
+            if (i->second == sa) {
+                  samples.erase(i);
+                  break;
+                  }
+            }
+      delete sa;
+      }
+
+//---------------------------------------------------------
+//   SampleStream::start
+//    audio thread; without a ring the stream stays stopped
+//    and the voice gets silence after the head
+//---------------------------------------------------------
+
+void SampleStream::start(Sample* s, long long pos, short* r)
+      {
+      unsigned g = generation.load(std::memory_order_relaxed);
+      if (r) {
+            g |= 1;
+            if (g == generation.load(std::memory_order_relaxed))
+                  g += 2;
+            }
+      ring.store(r, std::memory_order_relaxed);
+      sample.store(s, std::memory_order_relaxed);
+      written.store(tag(g, s->headFrames()), std::memory_order_relaxed);
+      readPos.store(pos, std::memory_order_relaxed);
+      generation.store(g, std::memory_order_release);
+      }
+
+//---------------------------------------------------------
+//   SampleStream::stop
+//    audio thread, return the ring to give back; the
+//    streamer may still finish a read into it, but it
+//    reads for one stream at a time, so the next owner
+//    only sees its own data
+//---------------------------------------------------------
+
+short* SampleStream::stop()
+      {
+      if (generation.load(std::memory_order_relaxed) & 1)
+            generation.fetch_add(1, std::memory_order_release);
+      return ring.exchange(0, std::memory_order_relaxed);
+      }
+
+//---------------------------------------------------------
+//   StreamRings::allocate
+//---------------------------------------------------------
+
+void StreamRings::allocate()
+      {
+      if (!rings.empty())
+            return;
+      unused.reserve(RINGS);
+      for (int i = 0; i < RINGS; ++i) {
+            rings.push_back(std::unique_ptr<short[]>(new short[SampleStream::RING_SIZE]));
+            unused.push_back(rings.back().get());
+            }
+      }
+
+//---------------------------------------------------------
+//   StreamRings::acquire
+//    audio thread
+//---------------------------------------------------------
+
+short* StreamRings::acquire()
+      {
+      if (unused.empty())
+            return 0;
+      short* r = unused.back();
+      unused.pop_back();
+      return r;
+      }
+
+//---------------------------------------------------------
+//   instance
+//---------------------------------------------------------
+
+SampleStreamer* SampleStreamer::instance()
+      {
+      static SampleStreamer streamer;
+      return &streamer;
+      }
+
+//---------------------------------------------------------
+//   ~SampleStreamer
+//---------------------------------------------------------
+
+SampleStreamer::~SampleStreamer()
+      {
+      quit = true;
+      wakeup.release();
+      wait();
+      for (auto i : files)
+            delete i.second;
+      }
+
+//---------------------------------------------------------
+//   add
+//    register the ring buffer of a voice
+//---------------------------------------------------------
+
+void SampleStreamer::add(SampleStream* s)
+      {
+      QMutexLocker locker(&mutex);
+      streams.push_back(s);
+      }
+
+//---------------------------------------------------------
+//   remove
+//---------------------------------------------------------
+
+void SampleStreamer::remove(SampleStream* s)
+      {
+      QMutexLocker locker(&mutex);
+      while (curStream == s)
+            idle.wait(&mutex);
+      streams.erase(std::remove(streams.begin(), streams.end(), s), streams.end());
+      }
+
+//---------------------------------------------------------
+//   addSample
+//---------------------------------------------------------
+
+void SampleStreamer::addSample(Sample* s)
+      {
+      QMutexLocker locker(&mutex);
+      files[s] = 0;
+      if (!isRunning())
+            start();
+      }
+
+//---------------------------------------------------------
+//   removeSample
+//    the streamer does not touch s after this returns
+//---------------------------------------------------------
+
+void SampleStreamer::removeSample(Sample* s)
+      {
+      QMutexLocker locker(&mutex);
+      while (curSample == s)
+            idle.wait(&mutex);
+      auto i = files.find(s);
+      if (i != files.end()) {
+            delete i->second;
+            files.erase(i);
+            }
+      }
+
+//---------------------------------------------------------
+//   wake
+//    audio thread, wake the streamer after a voice started
+//    or advanced; does not block
+//---------------------------------------------------------
+
+void SampleStreamer::wake()
+      {
+      if (!woken.exchange(true, std::memory_order_acq_rel))
+            wakeup.release();
+      }
+
+//---------------------------------------------------------
+//   sync
+//    wait until the streamer has read ahead as far as
+//    possible for all voices
+//---------------------------------------------------------
+
+void SampleStreamer::sync()
+      {
+      QMutexLocker locker(&mutex);
+      if (!isRunning())
+            return;
+      unsigned pass = passes;
+      wake();
+      while (int(idlePass - pass) <= 0)
+            idle.wait(&mutex);
+      }
+
+//---------------------------------------------------------
+//   fill
+//    read ahead for one voice, return true if there was
+//    something to read
+//---------------------------------------------------------
+
+bool SampleStreamer::fill(SampleStream* s)
+      {
+      QMutexLocker locker(&mutex);
+      if (std::find(streams.begin(), streams.end(), s) == streams.end())
+            return false;                 // voice was deleted
+      unsigned gen = s->generation.load(std::memory_order_acquire);
+      if (!(gen & 1))
+            return false;
+      Sample* sa = s->sample.load(std::memory_order_relaxed);
+      auto fi = files.find(sa);
+      if (fi == files.end())
+            return false;                 // sample was deleted
+      unsigned long long t = s->written.load(std::memory_order_relaxed);
+      if (SampleStream::gen(t) != (gen & 0xffffff))
+            return false;
+      short* ring = s->ring.load(std::memory_order_relaxed);
+      if (!ring)
+            return false;
+      int ch             = sa->channel();
+      long long capacity = SampleStream::RING_SIZE / ch;
+      long long pos      = SampleStream::pos(t);
+      long long end      = qMin(s->readPos.load(std::memory_order_relaxed) + capacity, sa->frames());
+      if (pos >= end)
+            return false;
+      long long n = qMin(end - pos, (long long)STREAM_CHUNK);
+
+      // remove() and removeSample() wait for the read to finish
+      AudioFile* a = fi->second;
+      curStream    = s;
+      curSample    = sa;
+      locker.unlock();
+
+      if (!a) {
+            a = new AudioFile;
+            if (!a->open(sa->path())) {
+                  qDebug("SampleStreamer: open <%s> failed", qPrintable(sa->path()));
+                  delete a;
+                  a = 0;
+                  }
+            }
+      if (a) {
+            buffer.resize(n * ch);
+            if (!a->seekFrame(pos) || a->readData(buffer.data(), n) != n) {
+                  qDebug("SampleStreamer: read <%s> failed", qPrintable(sa->path()));
+                  memset(buffer.data(), 0, n * ch * sizeof(short));
+                  }
+            long long idx = pos * ch;
+            for (long long i = 0; i < n * ch; ++i)
+                  ring[(idx + i) & (SampleStream::RING_SIZE - 1)] = buffer[i];
+            // publish only if the voice still plays the same sample
+            s->written.compare_exchange_strong(t, SampleStream::tag(gen, pos + n), std::memory_order_release);
+            }
+
+      locker.relock();
+      if (a)
+            files[sa] = a;
+      else
+            files.erase(sa);
+      curStream = 0;
+      curSample = 0;
+      idle.wakeAll();
+      return a != 0;
+      }
+
+//---------------------------------------------------------
+//   run
+//---------------------------------------------------------
+
+void SampleStreamer::run()
+      {
+      std::vector<SampleStream*> work;
+      while (!quit) {
+            unsigned pass;
+            {
+            QMutexLocker locker(&mutex);
+            work = streams;
+            pass = ++passes;
+            }
+            bool busy = false;
+            for (SampleStream* s : work)
+                  busy |= fill(s);
+            if (!busy) {
+                  {
+                  QMutexLocker locker(&mutex);
+                  idlePass = pass;
+                  idle.wakeAll();
+                  }
+                  wakeup.acquire();
+                  woken.store(false, std::memory_order_release);
+                  }
+            }
+      }
@@ -13,8 +13,23 @@
 #ifndef __SAMPLE_H__
 #define __SAMPLE_H__
 
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+#include <QMutex>
+#include <QSemaphore>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+
+class AudioFile;
+
 //---------------------------------------------------------
 //   Sample
+//    If the sample is streamed, only the first headFrames()
+//    frames are in memory, the rest is read from the file
+//    by the SampleStreamer while the sample is played.
 //---------------------------------------------------------
 
 class Sample {
@@ -26,11 +41,15 @@ class Sample {
       long long _loopEnd;
       int _loopMode;
 
+      QString _path;                // file name of a streamed sample
+      long long _headFrames;        // frames in _data
+      int _refCount = 0;            // zones using the sample
+
    public:
       Sample(int ch, short* val, int f, int sr)
-         : _channel(ch), _data(val), _frames(f), _sampleRate(sr) {}
+         : _channel(ch), _data(val), _frames(f), _sampleRate(sr), _headFrames(f) {}
       ~Sample();
-      bool read(const QString&);
+      static Sample* read(AudioFile&, const QString& name, long long headFrames, const Sample* head = 0);
       long long frames() const     { return _frames;          }
       short* data() const    { return _data + _channel; }
       int channel() const    { return _channel;         }
@@ -42,6 +61,124 @@ class Sample {
       long long loopStart()           { return _loopStart; }
       long long loopEnd()             { return _loopEnd; }
       int loopMode()            { return _loopMode; }
+
+      const QString& path() const     { return _path;       }
+      long long headFrames() const    { return _headFrames; }
+      bool streamed() const           { return _headFrames < _frames; }
+
+      friend class SampleCache;
+      };
+
+//---------------------------------------------------------
+//   SampleCache
+//    Samples of all instruments, shared by file name. A
+//    sample is deleted when the last zone releases it.
+//---------------------------------------------------------
+
+class SampleCache {
+      QMutex mutex;
+      std::map<QString, Sample*> samples;
+
+   public:
+      static SampleCache* instance();
+      Sample* sample(const QString& path, long long offset, long long loopEnd, int preloadTime);
+      Sample* add(Sample*);
+      void release(Sample*);
+      };
+
+//---------------------------------------------------------
+//   SampleStream
+//    Ring buffer of a voice playing a streamed sample.
+//    The voice makes generation odd when it starts to play
+//    a sample and even when it stops. The streamer fills
+//    the ring ahead of readPos and publishes the new end in
+//    written, tagged with the generation it was read for.
+//    The ring is taken from the StreamRings of the synthesizer
+//    by start() and given back by stop().
+//---------------------------------------------------------
+
+struct SampleStream {
+      static const int RING_SIZE = 1 << 16;     // values, a power of two
+      static const int POS_BITS  = 40;
+
+      std::atomic<short*> ring { 0 };           // 0 if no ring was free
+      std::atomic<Sample*> sample { 0 };
+      std::atomic<unsigned> generation { 0 };
+      std::atomic<unsigned long long> written { 0 };  // generation tag, frames read up to this position
+      std::atomic<long long> readPos { 0 };           // first frame the voice still needs
+
+      static unsigned long long tag(unsigned gen, long long pos) {
+            return ((unsigned long long)(gen & 0xffffff) << POS_BITS) | (unsigned long long)pos;
+            }
+      static long long pos(unsigned long long t)  { return t & ((1ULL << POS_BITS) - 1); }
+      static unsigned gen(unsigned long long t)   { return unsigned(t >> POS_BITS); }
+
+      void start(Sample*, long long pos, short* ring);
+      short* stop();
+      short value(long long idx, int ch) const {      // idx counts values, not frames
+            if (idx >= pos(written.load(std::memory_order_acquire)) * ch)
+                  return 0;                           // not read in time
+            return ring.load(std::memory_order_relaxed)[idx & (RING_SIZE - 1)];
+            }
+      };
+
+//---------------------------------------------------------
+//   StreamRings
+//    Ring buffers of the voices of one synthesizer which
+//    play a streamed sample. They are allocated by allocate()
+//    before the first streamed instrument is added; acquire()
+//    and release() are called by the audio thread and do not
+//    allocate. A voice which finds no free ring plays only
+//    the head of its sample.
+//---------------------------------------------------------
+
+class StreamRings {
+      std::vector<std::unique_ptr<short[]>> rings;
+      std::vector<short*> unused;
+
+   public:
+      static const int RINGS = 64;              // streamed voices playing at the same time
+
+      void allocate();
+      short* acquire();
+      void release(short* r)  { if (r) unused.push_back(r); }
+      int freeRings() const   { return int(unused.size()); }
+      };
+
+//---------------------------------------------------------
+//   SampleStreamer
+//    background thread reading streamed samples into the
+//    ring buffers of the voices. The thread sleeps until
+//    the audio thread wakes it; files are read without
+//    holding the lock.
+//---------------------------------------------------------
+
+class SampleStreamer : public QThread {
+      QMutex mutex;                             // protects streams, files and the current read
+      QWaitCondition idle;                      // a read or a pass without work is done
+      std::vector<SampleStream*> streams;
+      std::map<Sample*, AudioFile*> files;      // open files of streamed samples
+      SampleStream* curStream = 0;              // being read, must not be removed
+      Sample* curSample = 0;
+      unsigned passes = 0;                      // passes over the streams started
+      unsigned idlePass = 0;                    // last pass which found nothing to read
+      std::vector<short> buffer;
+      QSemaphore wakeup;
+      std::atomic<bool> woken { false };
+      std::atomic<bool> quit { false };
+
+      bool fill(SampleStream*);
+      virtual void run() override;
+
+   public:
+      ~SampleStreamer();
+      static SampleStreamer* instance();
+      void add(SampleStream*);
+      void remove(SampleStream*);
+      void addSample(Sample*);
+      void removeSample(Sample*);
+      void wake();
+      void sync();
       };
 
 #endif
@@ -300,7 +300,8 @@ void ZInstrument::addRegion(SfzRegion& r)
                   }
             }
       Zone* z = new Zone;
-      z->sample = readSample(r.sample, 0);
+      bool loop = r.loop_mode == LoopMode::CONTINUOUS || r.loop_mode == LoopMode::SUSTAIN;
+      z->sample = readSample(r.sample, 0, r.offset, loop ? r.loopEnd : 0);
       if (z->sample) {
             //qDebug("Sample Loop - start %ll, end %ll, mode %d", z->sample->loopStart(), z->sample->loopEnd(), z->sample->loopMode());
             // if there is no opcode defining loop ranges, use sample definitions as fallback (according to spec)
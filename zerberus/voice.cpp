@@ -47,6 +47,12 @@ void Envelope::setTime(float ms, int sampleRate)
 Voice::Voice(Zerberus* z)
       {
       _zerberus = z;
+      SampleStreamer::instance()->add(&stream);
+      }
+
+Voice::~Voice()
+      {
+      SampleStreamer::instance()->remove(&stream);
       }
 
 //---------------------------------------------------------
@@ -62,6 +68,16 @@ void Voice::stop(float time)
       currentEnvelope = V1Envelopes::RELEASE;
       }
 
+//---------------------------------------------------------
+//   release
+//    give the stream ring back, the voice is free
+//---------------------------------------------------------
+
+void Voice::release()
+      {
+      _zerberus->streamRings()->release(stream.stop());
+      }
+
 //---------------------------------------------------------
 //   init
 //---------------------------------------------------------
@@ -100,6 +116,14 @@ void Voice::start(Channel* c, int key, int v, const Zone* zone, double durSinceN
       data      = s->data() + z->offset * audioChan;
       //avoid processing sample if offset is bigger than sample length
       eidx      = std::max((s->frames() - z->offset - 1) * audioChan, 0ll);
+      dataOffset = z->offset * audioChan;
+      if (s->streamed()) {
+            headEnd = (s->headFrames() - z->offset) * audioChan;
+            stream.start(s, z->offset, _zerberus->streamRings()->acquire());
+            SampleStreamer::instance()->wake();
+            }
+      else
+            headEnd = std::numeric_limits<long long>::max();
       _loopMode = z->loopMode;
       _loopStart = z->loopStart;
       _loopEnd   = z->loopEnd;
@@ -288,6 +312,10 @@ void Voice::process(int frames, float* p)
                   _samplesSinceStart++;
                   }
             }
+      if (z->sample->streamed()) {
+            stream.readPos.store(z->offset + phase.index() - 1, std::memory_order_relaxed);
+            SampleStreamer::instance()->wake();
+            }
       }
 
 //---------------------------------------------------------
@@ -317,7 +345,7 @@ short Voice::getData(long long pos) {
             return 0;
 
       if (!_looping)
-            return data[pos];
+            return pos < headEnd ? data[pos] : streamData(pos);
 
       long long loopEnd = _loopEnd * audioChan;
       long long loopStart = _loopStart * audioChan;
@@ -16,6 +16,7 @@
 #include <cstdint>
 #include <math.h>
 #include "filter.h"
+#include "sample.h"
 
 // Disable warning C4201: nonstandard extension used: nameless struct/union in VS2017
 #if (defined (_MSCVER) || defined (_MSC_VER))
@@ -24,7 +25,6 @@
 
 class Channel;
 struct Zone;
-class Sample;
 class Zerberus;
 
 enum class LoopMode : char;
@@ -127,6 +127,9 @@ class Voice {
 
       short* data;
       long long eidx;
+      long long headEnd;      // values in data before the streamed part
+      long long dataOffset;   // position of data in the sample, in values
+      SampleStream stream;
       LoopMode _loopMode;
       OffMode _offMode;
       int _offBy;
@@ -148,8 +151,11 @@ class Voice {
 
       const Zone* z;
 
+      short streamData(long long pos) const { return stream.value(pos + dataOffset, audioChan); }
+
    public:
       Voice(Zerberus*);
+      ~Voice();
       Voice* next() const         { return _next; }
       void setNext(Voice* v)      { _next = v; }
 
@@ -171,6 +177,7 @@ class Voice {
       void stop(float time);
       void sustained()            { _state = VoiceState::SUSTAINED; }
       void off()                  { _state = VoiceState::OFF;       }
+      void release();
       const char* state() const;
       LoopMode loopMode() const   { return _loopMode; }
       int getSamplesSinceStart()  { return _samplesSinceStart;    }
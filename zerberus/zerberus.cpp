@@ -49,9 +49,9 @@ Zerberus::Zerberus()
             }
       
       freeVoices.init(this);
+      renderList.reserve(MAX_VOICES);
       for (int i = 0; i < MAX_CHANNEL; ++i)
             _channel[i] = new Channel(this, i);
-      busy = true;      // no sf loaded yet
       }
 
 //---------------------------------------------------------
@@ -60,7 +60,6 @@ Zerberus::Zerberus()
 
 Zerberus::~Zerberus()
       {
-      busy = true;
       while (!instruments.empty()) {
             auto i  = instruments.front();
             auto it = instruments.begin();
@@ -96,7 +95,8 @@ void Zerberus::trigger(Channel* channel, int key, int velo, Trigger trigger, int
       {
       ZInstrument* i = channel->instrument();
       double random = (double) rand() / (double) RAND_MAX;
-      for (Zone* z : i->zones()) {
+      ZoneRange zones = trigger == Trigger::CC ? i->ccZones() : i->zones(key, velo);
+      for (Zone* z : zones) {
             if (z->match(channel, key, velo, trigger, random, cc, ccVal)) {
                   //
                   // handle offBy voices
@@ -174,8 +174,6 @@ void Zerberus::processNoteOn(Channel* cp, int key, int velo)
 
 void Zerberus::play(const Ms::PlayEvent& event)
       {
-      if (busy)
-            return;
       if (event.channel() >= MAX_CHANNEL)
             return;
       Channel* cp = _channel[int(event.channel())];
@@ -217,17 +215,21 @@ void Zerberus::play(const Ms::PlayEvent& event)
 
 void Zerberus::process(unsigned frames, float* p, float*, float*)
       {
-      if (busy)
-            return;
+      renderList.clear();
+      for (Voice* v = activeVoices; v; v = v->next())
+            renderList.push_back(v);
+      renderVoices(int(renderList.size()), frames, p, 0, 0,
+         [this](int i, unsigned n, float* out, float*, float*) { renderList[i]->process(n, out); });
+
       Voice* v = activeVoices;
       Voice* pv = 0;
       while (v) {
-            v->process(frames, p);
             if (v->isOff()) {
                   if (pv)
                         pv->setNext(v->next());
                   else
                         activeVoices = v->next();
+                  v->release();
                   freeVoices.push(v);
                   }
             else
@@ -278,12 +280,37 @@ void Zerberus::allSoundsOff(int channel)
 
 void Zerberus::allNotesOff(int channel)
       {
-      busy = true;
-      for (Voice* v = activeVoices; v; v = v->next()) {
-            if (channel == -1 || (v->channel()->idx() == channel))
-                  v->stop();
+      execute([this, channel]() {
+            for (Voice* v = activeVoices; v; v = v->next()) {
+                  if (channel == -1 || (v->channel()->idx() == channel))
+                        v->stop();
+                  }
+            });
+      }
+
+//---------------------------------------------------------
+//   removeVoices
+//    free all voices playing instrument i
+//---------------------------------------------------------
+
+void Zerberus::removeVoices(ZInstrument* i)
+      {
+      Voice* pv = 0;
+      for (Voice* v = activeVoices; v;) {
+            Voice* nv = v->next();
+            if (v->channel()->instrument() == i) {
+                  if (pv)
+                        pv->setNext(nv);
+                  else
+                        activeVoices = nv;
+                  v->off();
+                  v->release();
+                  freeVoices.push(v);
+                  }
+            else
+                  pv = v;
+            v = nv;
             }
-      busy = false;
       }
 
 //---------------------------------------------------------
@@ -345,17 +372,20 @@ bool Zerberus::removeSoundFont(const QString& s)
                   auto it = find(instruments.begin(), instruments.end(), i);
                   if (it == instruments.end())
                         return false;
-                  instruments.erase(it);
-                  for (int k = 0; k < MAX_CHANNEL; ++k) {
-                        if (_channel[k]->instrument() == i)
-                              _channel[k]->setInstrument(0);
-                        }
-                  if (!instruments.empty()) {
-                        for (int ii = 0; ii < MAX_CHANNEL; ++ii) {
-                              if (_channel[ii]->instrument() == 0)
-                                    _channel[ii]->setInstrument(instruments.front());
+                  execute([this, i, it]() {
+                        removeVoices(i);
+                        instruments.erase(it);
+                        for (int k = 0; k < MAX_CHANNEL; ++k) {
+                              if (_channel[k]->instrument() == i)
+                                    _channel[k]->setInstrument(0);
                               }
-                        }
+                        if (!instruments.empty()) {
+                              for (int ii = 0; ii < MAX_CHANNEL; ++ii) {
+                                    if (_channel[ii]->instrument() == 0)
+                                          _channel[ii]->setInstrument(instruments.front());
+                                    }
+                              }
+                        });
                   i->setRefCount(i->refCount() - 1);
                   if (i->refCount() <= 0) {
                         auto it1 = find(globalInstruments.begin(), globalInstruments.end(), i);
@@ -412,6 +442,28 @@ ZInstrument* Zerberus::instrument(int n) const
       return 0;
       }
 
+//---------------------------------------------------------
+//   addInstrument
+//    make a loaded instrument playable
+//---------------------------------------------------------
+
+void Zerberus::addInstrument(ZInstrument* instr)
+      {
+      // voices cannot play a streamed sample before the instrument is added
+      if (instr->streamed())
+            _streamRings.allocate();
+      execute([this, instr]() {
+            instruments.push_back(instr);
+            //
+            // set default instrument for all channels:
+            //
+            if (instruments.size() == 1) {
+                  for (int i = 0; i < MAX_CHANNEL; ++i)
+                        _channel[i]->setInstrument(instr);
+                  }
+            });
+      }
+
 //---------------------------------------------------------
 //   loadInstrument
 //    return true on success
@@ -430,13 +482,8 @@ bool Zerberus::loadInstrument(const QString& s)
             }
       for (ZInstrument* instr : globalInstruments) {
             if (QFileInfo(instr->path()).fileName() == fileName) {
-                  instruments.push_back(instr);
                   instr->setRefCount(instr->refCount() + 1);
-                  if (instruments.size() == 1) {
-                        for (int i = 0; i < MAX_CHANNEL; ++i)
-                              _channel[i]->setInstrument(instr);
-                        }
-                  busy = false;
+                  addInstrument(instr);
                   return true;
                   }
             }
@@ -449,22 +496,13 @@ bool Zerberus::loadInstrument(const QString& s)
                   break;
                   }
             }
-      busy = true;
       ZInstrument* instr = new ZInstrument(this);
 
       try {
             if (instr->load(path)) {
                   globalInstruments.push_back(instr);
-                  instruments.push_back(instr);
                   instr->setRefCount(1);
-                  //
-                  // set default instrument for all channels:
-                  //
-                  if (instruments.size() == 1) {
-                        for (int i = 0; i < MAX_CHANNEL; ++i)
-                              _channel[i]->setInstrument(instr);
-                        }
-                  busy = false;
+                  addInstrument(instr);
                   return true;
                   }
             }
@@ -477,7 +515,6 @@ bool Zerberus::loadInstrument(const QString& s)
       catch (...) {
             }
       qDebug("Zerberus::loadInstrument failed");
-      busy = false;
       delete instr;
       return false;
       }
@@ -19,6 +19,7 @@
 #include <list>
 #include <memory>
 #include <queue>
+#include <vector>
 
 #include "synthesizer/synthesizer.h"
 #include "synthesizer/event.h"
@@ -76,14 +77,15 @@ class Zerberus : public Ms::Synthesizer {
       static std::list<ZInstrument*> globalInstruments;
 
       double _masterTuning = 440.0;
-      std::atomic<bool> busy;
 
       std::list<ZInstrument*> instruments;
       Channel* _channel[MAX_CHANNEL];
 
       int allocatedVoices = 0;
+      StreamRings _streamRings;           // must outlive the voices
       VoiceFifo freeVoices;
       Voice* activeVoices = 0;
+      std::vector<Voice*> renderList;     // activeVoices while they are rendered
       int _loadProgress = 0;
       bool _loadWasCanceled = false;
 
@@ -93,6 +95,8 @@ class Zerberus : public Ms::Synthesizer {
       void trigger(Channel*, int key, int velo, Trigger, int cc, int ccVal, double durSinceNoteOn);
       void processNoteOff(Channel*, int pitch);
       void processNoteOn(Channel* cp, int key, int velo);
+      void removeVoices(ZInstrument*);
+      void addInstrument(ZInstrument*);
 
    public:
       Zerberus();
@@ -106,6 +110,7 @@ class Zerberus : public Ms::Synthesizer {
       ZInstrument* instrument(int program) const;
       Voice* getActiveVoices()      { return activeVoices; }
       Channel* channel(int n)       { return _channel[n]; }
+      StreamRings* streamRings()    { return &_streamRings; }
       int loadProgress()            { return _loadProgress; }
       void setLoadProgress(int val) { _loadProgress = val; }
       bool loadWasCanceled()        { return _loadWasCanceled; }
@@ -35,7 +35,8 @@ Zone::Zone()
 
 Zone::~Zone()
       {
-      delete sample;
+      if (sample)
+            SampleCache::instance()->release(sample);
       }
 
 //---------------------------------------------------------